@@ -0,0 +1,315 @@
+// JobSystemBench_Main.cpp
+// Main Entry point of the Job System benchmark, checking scheduling under random dependencies then timing it per worker count.
+
+#include "ServerFramework/JobSystem.h"
+#include "ServerFramework/StdThreads.h"
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+#include "Tests/ToolArguments.h"
+
+#include "atomic"
+#include "chrono"
+#include "cmath"
+#include "cstdint"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "thread"
+#include "vector"
+
+struct JobBenchSettings
+{
+	uint64_t Seed = 1;
+	size_t CycleCount = 2000; // Random dependency graphs run by the stress check.
+	size_t MaxWorkerCount = 16; // Timings run at every power of two up to this.
+	size_t ItemCount = 1 << 22; // Items of the timed parallel-for. 0 skips timings.
+	size_t RepeatCount = 5; // Timings keep the best of this many runs.
+};
+
+#define BENCH_HEAP_SIZE (1024 * 1024 * 64) // 64mb
+#define BENCH_MAX_JOB_COUNT 4096
+#define STRESS_WORKER_COUNT 4
+#define STRESS_MAX_GROUP_COUNT 40
+#define STRESS_MAX_GROUP_SIZE 50
+#define NESTED_OUTER_COUNT 256
+#define NESTED_INNER_SIZE 64
+#define OVERHEAD_JOB_COUNT 4000
+#define OVERHEAD_REPEAT_COUNT 100
+
+// Small, fast generator so that a failing graph can be replayed from the printed seed.
+struct BenchRandom
+{
+	uint64_t State;
+
+	uint64_t Next()
+	{
+		// SplitMix64
+		uint64_t Value = (State += 0x9E3779B97F4A7C15ull);
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	// Returns a value in [Min, Max].
+	size_t Range(size_t Min, size_t Max)
+	{
+		return Min + static_cast<size_t>(Next() % (Max - Min + 1));
+	}
+};
+
+// A group of the stress check: every index it runs over is counted once, and only after its dependency completed.
+struct StressGroup
+{
+	JobSystem* Jobs;
+	JobGroupID Dependency;
+	std::atomic<uint32_t> Counters[STRESS_MAX_GROUP_SIZE];
+	std::atomic<uint32_t>* DependencyViolationCount;
+};
+
+static void StressJob(void* Context, size_t BeginIndex, size_t EndIndex)
+{
+	StressGroup& Group = *static_cast<StressGroup*>(Context);
+	if (!Group.Jobs->IsComplete(Group.Dependency))
+	{
+		Group.DependencyViolationCount->fetch_add(1);
+	}
+	for (size_t Index = BeginIndex; Index < EndIndex; Index++)
+	{
+		Group.Counters[Index].fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+// Outer jobs schedule a group of inner jobs each and wait on it, from whatever worker they run on.
+struct NestedContext
+{
+	JobSystem* Jobs;
+	std::atomic<uint32_t>* Counters; // NESTED_INNER_SIZE per outer index.
+};
+
+static void NestedInnerJob(void* Context, size_t BeginIndex, size_t EndIndex)
+{
+	std::atomic<uint32_t>* Counters = static_cast<std::atomic<uint32_t>*>(Context);
+	for (size_t Index = BeginIndex; Index < EndIndex; Index++)
+	{
+		Counters[Index].fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+static void NestedOuterJob(void* Context, size_t BeginIndex, size_t EndIndex)
+{
+	NestedContext& Nested = *static_cast<NestedContext*>(Context);
+	for (size_t OuterIndex = BeginIndex; OuterIndex < EndIndex; OuterIndex++)
+	{
+		JobGroupID Inner = Nested.Jobs->Schedule(NestedInnerJob, Nested.Counters + OuterIndex * NESTED_INNER_SIZE, NESTED_INNER_SIZE, 8);
+		Nested.Jobs->Wait(Inner);
+	}
+}
+
+// Runs random dependency graphs, nested waits and an exhausted job pool. Returns false on any miscounted index or job
+// started before its dependency completed.
+static bool RunStressCheck(const JobBenchSettings& Settings, JobSystem& Jobs)
+{
+	std::atomic<uint32_t> DependencyViolationCount = { 0 };
+	std::vector<StressGroup> Groups(STRESS_MAX_GROUP_COUNT);
+	std::vector<size_t> GroupSizes(STRESS_MAX_GROUP_COUNT);
+	std::vector<JobGroupID> GroupIDs(STRESS_MAX_GROUP_COUNT);
+	size_t MiscountedIndexCount = 0;
+
+	for (size_t Cycle = 0; Cycle < Settings.CycleCount; Cycle++)
+	{
+		BenchRandom Random = { Settings.Seed * 0x100000001B3ull + Cycle };
+		size_t GroupCount = Random.Range(1, STRESS_MAX_GROUP_COUNT);
+		for (size_t GroupIndex = 0; GroupIndex < GroupCount; GroupIndex++)
+		{
+			StressGroup& Group = Groups[GroupIndex];
+			Group.Jobs = &Jobs;
+			Group.Dependency = GroupIndex > 0 && Random.Range(0, 2) > 0 ? GroupIDs[Random.Range(0, GroupIndex - 1)] : NO_JOB_GROUP;
+			Group.DependencyViolationCount = &DependencyViolationCount;
+			for (std::atomic<uint32_t>& Counter : Group.Counters)
+			{
+				Counter.store(0, std::memory_order_relaxed);
+			}
+
+			GroupSizes[GroupIndex] = Random.Range(1, STRESS_MAX_GROUP_SIZE);
+			GroupIDs[GroupIndex] = Jobs.Schedule(StressJob, &Group, GroupSizes[GroupIndex], Random.Range(1, 8), Group.Dependency);
+			if (Random.Range(0, 9) == 0)
+			{
+				Jobs.Wait(GroupIDs[GroupIndex]);
+			}
+		}
+		Jobs.WaitForAllJobs();
+
+		for (size_t GroupIndex = 0; GroupIndex < GroupCount; GroupIndex++)
+		{
+			for (size_t Index = 0; Index < STRESS_MAX_GROUP_SIZE; Index++)
+			{
+				uint32_t Expected = Index < GroupSizes[GroupIndex] ? 1 : 0;
+				MiscountedIndexCount += Groups[GroupIndex].Counters[Index].load() != Expected ? 1 : 0;
+			}
+		}
+	}
+
+	std::vector<std::atomic<uint32_t>> NestedCounters(NESTED_OUTER_COUNT * NESTED_INNER_SIZE);
+	NestedContext Nested = { &Jobs, NestedCounters.data() };
+	Jobs.Schedule(NestedOuterJob, &Nested, NESTED_OUTER_COUNT, 1);
+	Jobs.WaitForAllJobs();
+	for (std::atomic<uint32_t>& Counter : NestedCounters)
+	{
+		MiscountedIndexCount += Counter.load() != 1 ? 1 : 0;
+	}
+
+	// Right after a wait point, a group filling the whole pool is queued; one more job than the pool holds runs inline.
+	std::vector<std::atomic<uint32_t>> FullPoolCounters(BENCH_MAX_JOB_COUNT);
+	JobGroupID FullPoolGroup = Jobs.Schedule(NestedInnerJob, FullPoolCounters.data(), FullPoolCounters.size(), 1);
+	Jobs.WaitForAllJobs();
+	for (std::atomic<uint32_t>& Counter : FullPoolCounters)
+	{
+		MiscountedIndexCount += Counter.load() != 1 ? 1 : 0;
+	}
+
+	std::vector<std::atomic<uint32_t>> OverflowCounters(BENCH_MAX_JOB_COUNT + 1);
+	JobGroupID OverflowGroup = Jobs.Schedule(NestedInnerJob, OverflowCounters.data(), OverflowCounters.size(), 1);
+	Jobs.WaitForAllJobs();
+	for (std::atomic<uint32_t>& Counter : OverflowCounters)
+	{
+		MiscountedIndexCount += Counter.load() != 1 ? 1 : 0;
+	}
+
+	std::cout << "Stress: " << Settings.CycleCount << " random dependency graphs, " << NESTED_OUTER_COUNT << " nested waits, "
+		<< FullPoolCounters.size() << " pool-filling jobs and " << OverflowCounters.size() << " overflowing jobs at " << STRESS_WORKER_COUNT << " workers: " << MiscountedIndexCount
+		<< " miscounted indices, " << DependencyViolationCount.load() << " dependency violations.\n";
+	if (FullPoolGroup == NO_JOB_GROUP)
+	{
+		std::cerr << "FAILED: a group of exactly " << BENCH_MAX_JOB_COUNT << " jobs ran inline instead of filling the pool.\n";
+	}
+	return MiscountedIndexCount == 0 && DependencyViolationCount.load() == 0 && FullPoolGroup != NO_JOB_GROUP
+		&& OverflowGroup == NO_JOB_GROUP;
+}
+
+static float* WorkItems = nullptr;
+
+// Some floating point work per item, so that batches take long enough to be worth spreading.
+static void WorkJob(void* Context, size_t BeginIndex, size_t EndIndex)
+{
+	for (size_t Index = BeginIndex; Index < EndIndex; Index++)
+	{
+		float Value = Index * 0.001f;
+		for (int Step = 0; Step < 16; Step++)
+		{
+			Value = std::sin(Value) * 1.3f + 0.1f;
+		}
+		WorkItems[Index] = Value;
+	}
+}
+
+static void EmptyJob(void* Context, size_t BeginIndex, size_t EndIndex)
+{
+}
+
+// Times a parallel-for over every item, and the overhead of scheduling and running empty jobs.
+static void RunTimings(const JobBenchSettings& Settings, JobSystem& Jobs)
+{
+	double BestWorkTime = 0.0;
+	for (size_t Repeat = 0; Repeat < Settings.RepeatCount; Repeat++)
+	{
+		auto BeginTime = std::chrono::steady_clock::now();
+		Jobs.Schedule(WorkJob, nullptr, Settings.ItemCount, (Settings.ItemCount + 255) / 256);
+		Jobs.WaitForAllJobs();
+		double WorkTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - BeginTime).count();
+		BestWorkTime = Repeat == 0 || WorkTime < BestWorkTime ? WorkTime : BestWorkTime;
+	}
+
+	auto BeginTime = std::chrono::steady_clock::now();
+	for (size_t Repeat = 0; Repeat < OVERHEAD_REPEAT_COUNT; Repeat++)
+	{
+		Jobs.Schedule(EmptyJob, nullptr, OVERHEAD_JOB_COUNT, 1);
+		Jobs.WaitForAllJobs();
+	}
+	double OverheadTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - BeginTime).count();
+
+	std::cout << "Workers " << Jobs.WorkerCount << ": parallel-for over " << Settings.ItemCount << " items " << BestWorkTime * 1000.0
+		<< " ms, empty job overhead " << OverheadTime * 1e9 / (OVERHEAD_JOB_COUNT * OVERHEAD_REPEAT_COUNT) << " ns/job.\n";
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, JobBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, Cycles, MaxWorkers, Items, Repeats", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.Seed = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Cycles")) { OutSettings.CycleCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("MaxWorkers")) { OutSettings.MaxWorkerCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Items")) { OutSettings.ItemCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Repeats")) { OutSettings.RepeatCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+// Sets a Job System of WorkerCount workers up over Heap, which every run reuses from scratch.
+static bool InitializeBenchJobs(std::vector<byte>& Heap, const ServerPlatform& Platform, size_t WorkerCount,
+	MemorySubsystem& OutMemory, JobSystem& OutJobs)
+{
+	return OutMemory.Initialize(Heap.data(), Heap.size())
+		&& OutJobs.Initialize(OutMemory, Platform, WorkerCount, BENCH_MAX_JOB_COUNT);
+}
+
+int main(int argc, char** argv)
+{
+	JobBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.RepeatCount == 0)
+	{
+		std::cerr << "Usage: FracturedPlaneJobSystemBench [Seed=1] [Cycles=2000] [MaxWorkers=16] [Items=4194304] [Repeats=5]\n";
+		return 1;
+	}
+
+	// Timings only mean anything next to the core count: more workers than cores only adds overhead.
+	std::cout << "Running on " << std::thread::hardware_concurrency() << " processor(s).\n";
+
+	ServerPlatform Platform;
+	Platform.CreateThread = StdThreads_CreateThread;
+	Platform.DestroyThread = StdThreads_DestroyThread;
+	std::vector<byte> Heap(BENCH_HEAP_SIZE);
+
+	{
+		MemorySubsystem Memory;
+		JobSystem Jobs;
+		if (!InitializeBenchJobs(Heap, Platform, STRESS_WORKER_COUNT, Memory, Jobs))
+		{
+			std::cerr << "Failed to initialize the Job System. Ending program...\n";
+			return 1;
+		}
+
+		bool bPassed = RunStressCheck(Settings, Jobs);
+		Jobs.Shutdown();
+		if (!bPassed)
+		{
+			std::cerr << "FAILED: the Job System lost, repeated or misordered jobs (seed " << Settings.Seed << ").\n";
+			return 1;
+		}
+	}
+
+	if (Settings.ItemCount == 0)
+	{
+		return 0;
+	}
+
+	std::vector<float> Items(Settings.ItemCount);
+	WorkItems = Items.data();
+	for (size_t WorkerCount = 1; WorkerCount <= Settings.MaxWorkerCount; WorkerCount *= 2)
+	{
+		MemorySubsystem Memory;
+		JobSystem Jobs;
+		if (!InitializeBenchJobs(Heap, Platform, WorkerCount, Memory, Jobs))
+		{
+			std::cerr << "Failed to initialize the Job System. Ending program...\n";
+			return 1;
+		}
+
+		RunTimings(Settings, Jobs);
+		Jobs.Shutdown();
+	}
+	return 0;
+}
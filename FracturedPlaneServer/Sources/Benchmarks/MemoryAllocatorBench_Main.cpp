@@ -0,0 +1,192 @@
+// MemoryAllocatorBench_Main.cpp
+// Main Entry point of the Memory Subsystem benchmark, timing allocations and frees on a fragmented heap.
+
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+#include "Tests/ToolArguments.h"
+
+#include "chrono"
+#include "cstdint"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "utility"
+#include "vector"
+
+struct AllocatorBenchSettings
+{
+	uint64_t Seed = 1;
+	size_t MaxLiveCount = 20000; // Timings run with 2, 20, 200... live allocations, up to this.
+	size_t OperationCount = 1000000; // Frees, each followed by an allocation, timed per run.
+	size_t RepeatCount = 5; // Timings keep the best of this many runs.
+};
+
+#define BENCH_HEAP_SIZE (1024 * 1024 * 256) // 256mb
+#define BENCH_MIN_ALLOCATION_SIZE 32
+#define BENCH_MAX_ALLOCATION_SIZE 2048
+
+// Small, fast generator so that a failing run can be replayed from the printed seed.
+struct BenchRandom
+{
+	uint64_t State;
+
+	uint64_t Next()
+	{
+		// SplitMix64
+		uint64_t Value = (State += 0x9E3779B97F4A7C15ull);
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	// Returns a value in [Min, Max].
+	size_t Range(size_t Min, size_t Max)
+	{
+		return Min + static_cast<size_t>(Next() % (Max - Min + 1));
+	}
+};
+
+// A live allocation, tagged with its slot index over its first and last bytes so that overlapping allocations show up.
+struct LiveAllocation
+{
+	uint8_t* Data;
+	size_t Size;
+};
+
+static bool AllocateTagged(MemorySubsystem& Memory, BenchRandom& Random, uint32_t SlotIndex, LiveAllocation& OutAllocation)
+{
+	OutAllocation.Size = Random.Range(BENCH_MIN_ALLOCATION_SIZE, BENCH_MAX_ALLOCATION_SIZE);
+	OutAllocation.Data = static_cast<uint8_t*>(Memory.Allocate(OutAllocation.Size));
+	if (nullptr == OutAllocation.Data)
+	{
+		return false;
+	}
+
+	memcpy(OutAllocation.Data, &SlotIndex, sizeof(SlotIndex));
+	memcpy(OutAllocation.Data + OutAllocation.Size - sizeof(SlotIndex), &SlotIndex, sizeof(SlotIndex));
+	return true;
+}
+
+static bool IsTagIntact(const LiveAllocation& Allocation, uint32_t SlotIndex)
+{
+	return memcmp(Allocation.Data, &SlotIndex, sizeof(SlotIndex)) == 0
+		&& memcmp(Allocation.Data + Allocation.Size - sizeof(SlotIndex), &SlotIndex, sizeof(SlotIndex)) == 0;
+}
+
+// Fragments a fresh heap by allocating twice LiveCount blocks then freeing a random half of them, then times frees of
+// random live allocations, each followed by a new allocation of random size. Returns false on a failed allocation or an
+// overwritten tag.
+static bool RunAllocations(const AllocatorBenchSettings& Settings, std::vector<uint8_t>& Heap, size_t LiveCount, double& OutTime)
+{
+	MemorySubsystem Memory;
+	if (!Memory.Initialize(Heap.data(), Heap.size()))
+	{
+		std::cerr << "Failed to initialize the Memory Subsystem.\n";
+		return false;
+	}
+
+	BenchRandom Random = { Settings.Seed * 0x100000001B3ull + LiveCount };
+	std::vector<LiveAllocation> Allocations(LiveCount * 2);
+	for (uint32_t SlotIndex = 0; SlotIndex < Allocations.size(); SlotIndex++)
+	{
+		if (!AllocateTagged(Memory, Random, SlotIndex, Allocations[SlotIndex]))
+		{
+			std::cerr << "FAILED: the heap ran out while fragmenting it.\n";
+			return false;
+		}
+	}
+
+	size_t OverwrittenCount = 0;
+	for (uint32_t SlotIndex = 0; SlotIndex < Allocations.size(); SlotIndex++)
+	{
+		OverwrittenCount += IsTagIntact(Allocations[SlotIndex], SlotIndex) ? 0 : 1;
+	}
+
+	// Free a random half, keeping the other half packed at the front of the slots.
+	for (size_t SlotIndex = Allocations.size() - 1; SlotIndex > 0; SlotIndex--)
+	{
+		std::swap(Allocations[SlotIndex], Allocations[Random.Range(0, SlotIndex)]);
+	}
+	for (size_t SlotIndex = LiveCount; SlotIndex < Allocations.size(); SlotIndex++)
+	{
+		Memory.Free(Allocations[SlotIndex].Data);
+	}
+	Allocations.resize(LiveCount);
+
+	// Tags now have to match the slots allocations ended up in.
+	for (uint32_t SlotIndex = 0; SlotIndex < LiveCount; SlotIndex++)
+	{
+		memcpy(Allocations[SlotIndex].Data, &SlotIndex, sizeof(SlotIndex));
+		memcpy(Allocations[SlotIndex].Data + Allocations[SlotIndex].Size - sizeof(SlotIndex), &SlotIndex, sizeof(SlotIndex));
+	}
+
+	auto BeginTime = std::chrono::steady_clock::now();
+	for (size_t Operation = 0; Operation < Settings.OperationCount; Operation++)
+	{
+		uint32_t SlotIndex = static_cast<uint32_t>(Random.Range(0, LiveCount - 1));
+		OverwrittenCount += IsTagIntact(Allocations[SlotIndex], SlotIndex) ? 0 : 1;
+		Memory.Free(Allocations[SlotIndex].Data);
+		if (!AllocateTagged(Memory, Random, SlotIndex, Allocations[SlotIndex]))
+		{
+			std::cerr << "FAILED: an allocation failed with " << LiveCount << " live allocations.\n";
+			return false;
+		}
+	}
+	OutTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - BeginTime).count();
+
+	for (uint32_t SlotIndex = 0; SlotIndex < LiveCount; SlotIndex++)
+	{
+		OverwrittenCount += IsTagIntact(Allocations[SlotIndex], SlotIndex) ? 0 : 1;
+	}
+	if (OverwrittenCount > 0)
+	{
+		std::cerr << "FAILED: " << OverwrittenCount << " allocations were overwritten by others (seed " << Settings.Seed << ").\n";
+		return false;
+	}
+	return true;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, AllocatorBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, MaxLive, Operations, Repeats", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.Seed = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("MaxLive")) { OutSettings.MaxLiveCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Operations")) { OutSettings.OperationCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Repeats")) { OutSettings.RepeatCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	AllocatorBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.MaxLiveCount < 2 || Settings.OperationCount == 0 || Settings.RepeatCount == 0)
+	{
+		std::cerr << "Usage: FracturedPlaneMemoryAllocatorBench [Seed=1] [MaxLive=20000] [Operations=1000000] [Repeats=5]\n";
+		return 1;
+	}
+
+	std::vector<uint8_t> Heap(BENCH_HEAP_SIZE);
+	for (size_t LiveCount = 2; LiveCount <= Settings.MaxLiveCount; LiveCount *= 10)
+	{
+		double BestTime = 0.0;
+		for (size_t Repeat = 0; Repeat < Settings.RepeatCount; Repeat++)
+		{
+			double Time;
+			if (!RunAllocations(Settings, Heap, LiveCount, Time))
+			{
+				return 1;
+			}
+			BestTime = Repeat == 0 || Time < BestTime ? Time : BestTime;
+		}
+
+		std::cout << LiveCount << " live allocations of " << BENCH_MIN_ALLOCATION_SIZE << "-" << BENCH_MAX_ALLOCATION_SIZE << " bytes: "
+			<< BestTime * 1e6 / Settings.OperationCount << " us per free and allocation.\n";
+	}
+	return 0;
+}
@@ -0,0 +1,527 @@
+// NetEchoBench_Main.cpp
+// Main Entry point of the Net echo benchmark, driving the Linux Net Platform tick after tick like the Server does, and
+// echoing every packet loopback clients send back to them.
+
+#include "ServerFramework/NetStreamReassembler.h"
+#include "ServerFramework/ServerConfig.h"
+#include "ServerFramework/ServerPlatform.h"
+#include "Tests/ToolArguments.h"
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "algorithm"
+#include "cerrno"
+#include "cstdint"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "vector"
+
+extern bool LinuxNet_Init(const ServerConfig& Config);
+extern void LinuxNet_RegisterPlatformFunctions(ServerPlatform& Platform);
+extern void LinuxNet_Shutdown();
+
+struct EchoBenchSettings
+{
+	uint16_t Port = 25000;
+	size_t ClientCount = 256; // Loopback connections, opened by a client process of their own.
+	double MessageRate = 60.0; // Bursts sent per second by each client. 0 sends as many packets as the sockets take.
+	size_t BurstSize = 1; // Packets each client sends at once, MessageRate times per second.
+	size_t BodySize = 64; // Bytes in each packet body, the first of which carry the time it was sent.
+	size_t EchoCount = 1; // Echoes written for every received packet, one pass over the tick's packets each. 0 only receives.
+	double Duration = 10.0; // Seconds clients send for.
+	double TickMs = 16.7; // Time between two ticks of the echo loop.
+	size_t WorkerCount = 1; // Net Workers receiving the clients' data, each handing over a reception shard of its own.
+	size_t UseIoUring = 0; // 1 to have the Platform go through io_uring rather than epoll, when the kernel allows it.
+};
+
+#define MAX_BENCH_BODY_SIZE 1024
+#define MAX_BENCH_BURST_SIZE 4096
+#define FLOOD_PACKETS_PER_SEND 64 // Packets queued at once by a client sending as many as its socket takes.
+#define CLIENT_RECEIVE_BUFFER_SIZE (1024 * 64)
+#define CLIENT_CONNECT_TIMEOUT 5.0 // Seconds clients keep retrying while the Platform starts listening.
+#define CLIENT_DRAIN_TIMEOUT 2.0 // Seconds clients wait for the last echoes once done sending.
+#define MAX_EPOLL_EVENTS_PER_WAIT 256
+
+// A loopback client, sending packets stamped with their send time and timing the echoes it gets back.
+struct EchoClient
+{
+	int SocketHandle;
+	NetStreamReassembler Reassembler;
+
+	// Packets queued but not taken by the socket yet. Nothing new is queued until they are.
+	std::vector<byte> QueuedData;
+	size_t FirstUnsentByte;
+	size_t UnsentByteCount;
+};
+
+static double GetMonotonicTimeSeconds()
+{
+	timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return static_cast<double>(Time.tv_sec) + static_cast<double>(Time.tv_nsec) / 1e9;
+}
+
+static double GetThreadCPUTimeSeconds()
+{
+	timespec Time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time);
+	return static_cast<double>(Time.tv_sec) + static_cast<double>(Time.tv_nsec) / 1e9;
+}
+
+// CPU time of every thread of the process, Platform threads included.
+static double GetProcessCPUTimeSeconds()
+{
+	rusage Usage;
+	getrusage(RUSAGE_SELF, &Usage);
+	return static_cast<double>(Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec) + static_cast<double>(Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec) / 1e6;
+}
+
+// Prints the percentiles of the passed samples to Output, in the unit they're scaled to.
+static void PrintPercentiles(FILE* Output, const char* Name, std::vector<double>& Samples, double Scale, const char* Unit)
+{
+	if (Samples.empty())
+	{
+		fprintf(Output, "%-20s no samples\n", Name);
+		return;
+	}
+
+	std::sort(Samples.begin(), Samples.end());
+	auto Percentile = [&](double Fraction) { return Samples[static_cast<size_t>(Fraction * (Samples.size() - 1) + 0.5)] * Scale; };
+	fprintf(Output, "%-20s p50 %9.1f %s  p99 %9.1f %s  max %9.1f %s  (%zu samples)\n", Name, Percentile(0.5), Unit, Percentile(0.99), Unit,
+		Samples.back() * Scale, Unit, Samples.size());
+}
+
+// Opens a blocking connection to the Platform, retrying while it isn't listening yet, then makes it non-blocking.
+static bool ConnectClient(const EchoBenchSettings& Settings, EchoClient& Client)
+{
+	sockaddr_in ServerAddress = {};
+	ServerAddress.sin_family = AF_INET;
+	ServerAddress.sin_port = htons(Settings.Port);
+	ServerAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	double GiveUpTime = GetMonotonicTimeSeconds() + CLIENT_CONNECT_TIMEOUT;
+	while (true)
+	{
+		Client.SocketHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (Client.SocketHandle < 0)
+		{
+			return false;
+		}
+		if (connect(Client.SocketHandle, reinterpret_cast<sockaddr*>(&ServerAddress), sizeof(ServerAddress)) == 0)
+		{
+			break;
+		}
+
+		int ConnectError = errno;
+		close(Client.SocketHandle);
+		if (ConnectError != ECONNREFUSED || GetMonotonicTimeSeconds() > GiveUpTime)
+		{
+			return false;
+		}
+		usleep(10000);
+	}
+
+	int NoDelay = 1;
+	setsockopt(Client.SocketHandle, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+	return fcntl(Client.SocketHandle, F_SETFL, fcntl(Client.SocketHandle, F_GETFL, 0) | O_NONBLOCK) == 0;
+}
+
+// Sends what the client has left, after queuing PacketCount new packets stamped with Now if it had nothing left. Sets
+// OutQueuedCount to the number of new packets. Returns false if the connection failed.
+static bool SendClientPackets(const EchoBenchSettings& Settings, EchoClient& Client, size_t PacketCount, double Now, size_t& OutQueuedCount)
+{
+	OutQueuedCount = 0;
+	if (Client.UnsentByteCount == 0 && PacketCount > 0)
+	{
+		FPCore::Net::NetEncodedPacketHead Head = {};
+		Head.BodyType = FPCore::Net::PacketBodyType::MESSAGE;
+		Head.BodySize = static_cast<FPCore::Net::PacketBodySize_t>(Settings.BodySize);
+
+		size_t PacketSize = sizeof(Head) + Settings.BodySize;
+		for (size_t PacketIndex = 0; PacketIndex < PacketCount; PacketIndex++)
+		{
+			byte* Packet = Client.QueuedData.data() + PacketIndex * PacketSize;
+			memcpy(Packet, &Head, sizeof(Head));
+			memcpy(Packet + sizeof(Head), &Now, sizeof(Now));
+		}
+		Client.FirstUnsentByte = 0;
+		Client.UnsentByteCount = PacketCount * PacketSize;
+		OutQueuedCount = PacketCount;
+	}
+
+	if (Client.UnsentByteCount == 0)
+	{
+		return true;
+	}
+
+	ssize_t SentBytes = send(Client.SocketHandle, Client.QueuedData.data() + Client.FirstUnsentByte, Client.UnsentByteCount, MSG_NOSIGNAL);
+	if (SentBytes < 0)
+	{
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+	Client.FirstUnsentByte += SentBytes;
+	Client.UnsentByteCount -= SentBytes;
+	return true;
+}
+
+// Runs the loopback clients until they're done sending and got their echoes back, then writes their report to
+// ReportHandle. Returns the exit code of the process.
+static int RunClients(const EchoBenchSettings& Settings, int ReportHandle)
+{
+	std::vector<EchoClient> Clients(Settings.ClientCount);
+	std::vector<byte> PendingData(Settings.ClientCount * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+	int EpollHandle = epoll_create1(0);
+	size_t PacketSize = sizeof(FPCore::Net::NetEncodedPacketHead) + Settings.BodySize;
+	for (size_t ClientIndex = 0; ClientIndex < Clients.size(); ClientIndex++)
+	{
+		EchoClient& Client = Clients[ClientIndex];
+		if (!ConnectClient(Settings, Client))
+		{
+			std::cerr << "FAILED: client " << ClientIndex << " couldn't connect to port " << Settings.Port << ". Error Code: " << errno << "\n";
+			return 1;
+		}
+
+		Client.Reassembler.Initialize(PendingData.data() + ClientIndex * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+		Client.QueuedData.assign(std::max<size_t>(FLOOD_PACKETS_PER_SEND, Settings.BurstSize) * PacketSize, 'a');
+		Client.FirstUnsentByte = 0;
+		Client.UnsentByteCount = 0;
+
+		epoll_event Event = {};
+		Event.events = EPOLLIN;
+		Event.data.u64 = ClientIndex;
+		epoll_ctl(EpollHandle, EPOLL_CTL_ADD, Client.SocketHandle, &Event);
+	}
+
+	uint64_t SentCount = 0;
+	uint64_t SkippedCount = 0;
+	uint64_t ReceivedCount = 0;
+	uint64_t FailedCount = 0;
+	std::vector<double> RoundTrips;
+	RoundTrips.reserve(Settings.MessageRate > 0.0 ? static_cast<size_t>(Settings.Duration * Settings.MessageRate + 1) * Clients.size() * Settings.BurstSize * Settings.EchoCount : 0);
+
+	double StartTime = GetMonotonicTimeSeconds();
+	double NextSendTime = StartTime;
+	double Now = StartTime;
+	while (true)
+	{
+		bool bSending = Now - StartTime < Settings.Duration;
+		if (!bSending && (ReceivedCount >= SentCount * Settings.EchoCount || Now - StartTime > Settings.Duration + CLIENT_DRAIN_TIMEOUT))
+		{
+			break;
+		}
+
+		// Packets due this time around, for every client.
+		size_t DuePacketCount = 0;
+		if (bSending && Settings.MessageRate <= 0.0)
+		{
+			DuePacketCount = FLOOD_PACKETS_PER_SEND;
+		}
+		else if (bSending && Now >= NextSendTime)
+		{
+			DuePacketCount = Settings.BurstSize;
+			NextSendTime += 1.0 / Settings.MessageRate;
+		}
+
+		for (EchoClient& Client : Clients)
+		{
+			if (Client.SocketHandle < 0 || (DuePacketCount == 0 && Client.UnsentByteCount == 0))
+			{
+				continue;
+			}
+
+			size_t QueuedCount;
+			if (!SendClientPackets(Settings, Client, DuePacketCount, Now, QueuedCount))
+			{
+				close(Client.SocketHandle);
+				Client.SocketHandle = -1;
+				FailedCount++;
+				continue;
+			}
+			SentCount += QueuedCount;
+			SkippedCount += Settings.MessageRate > 0.0 ? DuePacketCount - QueuedCount : 0;
+		}
+
+		int WaitMs = 10;
+		if (bSending)
+		{
+			WaitMs = Settings.MessageRate <= 0.0 ? 0 : std::max(0, static_cast<int>((NextSendTime - GetMonotonicTimeSeconds()) * 1000.0));
+		}
+
+		epoll_event Events[MAX_EPOLL_EVENTS_PER_WAIT];
+		int EventCount = epoll_wait(EpollHandle, Events, MAX_EPOLL_EVENTS_PER_WAIT, WaitMs);
+		Now = GetMonotonicTimeSeconds();
+		for (int EventIndex = 0; EventIndex < EventCount; EventIndex++)
+		{
+			static byte ReceiveBuffer[CLIENT_RECEIVE_BUFFER_SIZE];
+			EchoClient& Client = Clients[Events[EventIndex].data.u64];
+			while (Client.SocketHandle >= 0)
+			{
+				ssize_t ReceivedBytes = recv(Client.SocketHandle, ReceiveBuffer, sizeof(ReceiveBuffer), 0);
+				if (ReceivedBytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				{
+					break;
+				}
+
+				bool bValidStream = ReceivedBytes > 0 && Client.Reassembler.Consume(ReceiveBuffer, ReceivedBytes,
+					[&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+					{
+						double SendTime;
+						memcpy(&SendTime, Body, sizeof(SendTime));
+						RoundTrips.push_back(Now - SendTime);
+						ReceivedCount++;
+					});
+				if (!bValidStream)
+				{
+					close(Client.SocketHandle);
+					Client.SocketHandle = -1;
+					FailedCount++;
+				}
+			}
+		}
+	}
+
+	// The Platform logs to the standard output all along: the report goes to the echo loop, which prints it last.
+	FILE* Report = fdopen(ReportHandle, "w");
+	fprintf(Report, "Clients: %llu packets sent (%llu skipped on backed up sockets), %llu echoes received of %llu, %llu connections failed.\n",
+		static_cast<unsigned long long>(SentCount), static_cast<unsigned long long>(SkippedCount), static_cast<unsigned long long>(ReceivedCount),
+		static_cast<unsigned long long>(SentCount * Settings.EchoCount), static_cast<unsigned long long>(FailedCount));
+	PrintPercentiles(Report, "Echo RTT:", RoundTrips, 1000.0, "ms");
+	fclose(Report);
+
+	for (EchoClient& Client : Clients)
+	{
+		if (Client.SocketHandle >= 0)
+		{
+			close(Client.SocketHandle);
+		}
+	}
+	close(EpollHandle);
+	return FailedCount > 0 ? 1 : 0;
+}
+
+// Runs the Platform like UpdateServer does, once per tick, until the client process exits. Every received packet is
+// written back to its connection EchoCount times. Echoes that don't fit the tick's sending buffer are dropped, much like
+// the Server would keep them for the next tick. The clients' report is read from ReportHandle. Returns the exit code of
+// the process.
+static int RunEchoLoop(const EchoBenchSettings& Settings, pid_t ClientProcessID, int ReportHandle)
+{
+	ServerConfig Config;
+	Config.ListenPort = Settings.Port;
+	Config.MaxConnectionCount = Settings.ClientCount;
+	Config.NetWorkerCount = Settings.WorkerCount;
+	Config.NetUseIoUring = Settings.UseIoUring;
+
+	ServerPlatform Platform;
+	if (!LinuxNet_Init(Config))
+	{
+		std::cerr << "Failed to initialize the Linux Net Platform.\n";
+		kill(ClientProcessID, SIGTERM);
+		waitpid(ClientProcessID, nullptr, 0);
+		return 1;
+	}
+	LinuxNet_RegisterPlatformFunctions(Platform);
+
+	uint64_t ReceivedCount = 0;
+	uint64_t EchoedCount = 0;
+	uint64_t EchoedByteCount = 0;
+	uint64_t UnsentEchoCount = 0;
+	std::vector<double> TickTimes;
+	std::vector<double> TickCPUTimes;
+	double FirstPacketTime = 0.0;
+	double FirstPacketCPUTime = 0.0;
+
+	int ClientExitStatus = 0;
+	timespec NextTickTime;
+	clock_gettime(CLOCK_MONOTONIC, &NextTickTime);
+	while (waitpid(ClientProcessID, &ClientExitStatus, WNOHANG) == 0)
+	{
+		double TickStartTime = GetMonotonicTimeSeconds();
+		double TickStartCPUTime = GetThreadCPUTimeSeconds();
+
+		const ServerPlatform::ConnectionID* NewConnectionIDs;
+		const ServerPlatform::ConnectionID* DisconnectedIDs;
+		size_t ConnectedCount;
+		size_t DisconnectedCount;
+		Platform.ReadPlatformNetEvents(NewConnectionIDs, ConnectedCount, DisconnectedIDs, DisconnectedCount);
+		Platform.ReleasePlatformNetEvents();
+
+		const NetReceptionShard* Shards;
+		size_t ShardCount;
+		Platform.ReadPlatformNetReceptionBuffers(Shards, ShardCount);
+
+		byte* SendingBuffer;
+		size_t SendingBufferSize;
+		Platform.WriteToPlatformNetSendingBuffer(SendingBuffer, SendingBufferSize);
+		size_t WrittenByteCount = 0;
+		size_t TickPacketCount = 0;
+		for (size_t ShardIndex = 0; ShardIndex < ShardCount; ShardIndex++)
+		{
+			TickPacketCount += Shards[ShardIndex].PacketCount;
+		}
+		for (size_t Echo = 0; Echo < Settings.EchoCount; Echo++)
+		{
+			for (size_t ShardIndex = 0; ShardIndex < ShardCount; ShardIndex++)
+			{
+				const NetReceptionShard& Shard = Shards[ShardIndex];
+				for (size_t PacketIndex = 0; PacketIndex < Shard.PacketCount; PacketIndex++)
+				{
+					const NetPacketDescriptor& Packet = Shard.Packets[PacketIndex];
+
+					FPCore::Net::PacketHead Head = {};
+					Head.ConnectionID = Packet.ConnectionID;
+					Head.BodyType = Packet.BodyType;
+					Head.BodySize = Packet.BodySize;
+					size_t PacketSize = sizeof(Head) + Packet.BodySize;
+					if (SendingBufferSize - WrittenByteCount < PacketSize)
+					{
+						UnsentEchoCount++;
+						continue;
+					}
+
+					memcpy(SendingBuffer + WrittenByteCount, &Head, sizeof(Head));
+					memcpy(SendingBuffer + WrittenByteCount + sizeof(Head), Shard.ReceptionData + Packet.BodyOffset, Packet.BodySize);
+					WrittenByteCount += PacketSize;
+					EchoedCount++;
+					EchoedByteCount += sizeof(FPCore::Net::NetEncodedPacketHead) + Packet.BodySize;
+				}
+			}
+		}
+
+		Platform.ReleasePlatformNetReceptionBuffers();
+		Platform.ReleasePlatformNetSendingBuffer(WrittenByteCount);
+		ReceivedCount += TickPacketCount;
+
+		// Only ticks from the first packet on are timed.
+		if (TickPacketCount > 0 && FirstPacketTime == 0.0)
+		{
+			FirstPacketTime = TickStartTime;
+			FirstPacketCPUTime = GetProcessCPUTimeSeconds();
+		}
+		if (FirstPacketTime != 0.0)
+		{
+			TickTimes.push_back(GetMonotonicTimeSeconds() - TickStartTime);
+			TickCPUTimes.push_back(GetThreadCPUTimeSeconds() - TickStartCPUTime);
+		}
+
+		long long TickNanoseconds = static_cast<long long>(Settings.TickMs * 1e6);
+		NextTickTime.tv_sec += (NextTickTime.tv_nsec + TickNanoseconds) / 1000000000;
+		NextTickTime.tv_nsec = (NextTickTime.tv_nsec + TickNanoseconds) % 1000000000;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &NextTickTime, nullptr);
+	}
+
+	double EchoTime = GetMonotonicTimeSeconds() - FirstPacketTime;
+	double EchoCPUTime = GetProcessCPUTimeSeconds() - FirstPacketCPUTime;
+	NetReceptionStats ReceptionStats;
+	Platform.ReadPlatformNetReceptionStats(ReceptionStats);
+	LinuxNet_Shutdown();
+
+	printf("Echo loop: %zu ticks over %zu shard(s), %llu packets received (%llu dropped by the Platform), %llu echoes written (%llu didn't fit the sending buffer).\n",
+		TickTimes.size(), ReceptionStats.ShardCount, static_cast<unsigned long long>(ReceivedCount), static_cast<unsigned long long>(ReceptionStats.DroppedReceptionCount),
+		static_cast<unsigned long long>(EchoedCount), static_cast<unsigned long long>(UnsentEchoCount));
+	if (FirstPacketTime != 0.0 && ReceivedCount > 0)
+	{
+		printf("Echoed %.1f MB/s. Process CPU %.2f s, %.2f us per received packet.\n", EchoedByteCount / EchoTime / 1e6, EchoCPUTime,
+			EchoCPUTime * 1e6 / ReceivedCount);
+	}
+	PrintPercentiles(stdout, "Tick time:", TickTimes, 1e6, "us");
+	PrintPercentiles(stdout, "Tick CPU time:", TickCPUTimes, 1e6, "us");
+
+	char ReportData[4096];
+	ssize_t ReportSize;
+	while ((ReportSize = read(ReportHandle, ReportData, sizeof(ReportData))) > 0)
+	{
+		fwrite(ReportData, 1, ReportSize, stdout);
+	}
+	close(ReportHandle);
+
+	bool bClientsPassed = WIFEXITED(ClientExitStatus) && WEXITSTATUS(ClientExitStatus) == 0;
+	if (!bClientsPassed || ReceivedCount == 0)
+	{
+		std::cerr << "FAILED: " << (bClientsPassed ? "no packet was received.\n" : "the clients failed.\n");
+		return 1;
+	}
+	return 0;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, EchoBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Port, Clients, Rate, Burst, Body, Echoes, Duration, TickMs, Workers, IoUring", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Port")) { OutSettings.Port = static_cast<uint16_t>(strtoul(Argument.Value, nullptr, 10)); }
+		else if (Argument.KeyIs("Clients")) { OutSettings.ClientCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Rate")) { OutSettings.MessageRate = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("Burst")) { OutSettings.BurstSize = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Body")) { OutSettings.BodySize = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Echoes")) { OutSettings.EchoCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Duration")) { OutSettings.Duration = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("TickMs")) { OutSettings.TickMs = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("Workers")) { OutSettings.WorkerCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("IoUring")) { OutSettings.UseIoUring = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	EchoBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.Port == 0 || Settings.ClientCount == 0 || Settings.ClientCount >= ServerPlatform::INVALID_ID
+		|| Settings.BurstSize == 0 || Settings.BurstSize > MAX_BENCH_BURST_SIZE || Settings.BodySize < sizeof(double) || Settings.BodySize > MAX_BENCH_BODY_SIZE
+		|| Settings.Duration <= 0.0 || Settings.TickMs <= 0.0 || Settings.WorkerCount == 0)
+	{
+		std::cerr << "Usage: FracturedPlaneNetEchoBench [Port=25000] [Clients=256] [Rate=60] [Burst=1] [Body=64] [Echoes=1] [Duration=10] [TickMs=16.7] [Workers=1] [IoUring=0]\n"
+			<< "Body is " << sizeof(double) << " to " << MAX_BENCH_BODY_SIZE << " bytes, Burst 1 to " << MAX_BENCH_BURST_SIZE << " packets.\n"
+			<< "Rate=0 has clients send as many packets as their sockets take. Echoes=0 only receives them.\n";
+		return 1;
+	}
+
+	// Clients and the Platform each hold a file descriptor per connection.
+	rlimit FileDescriptorLimit;
+	rlim_t RequiredFileDescriptorCount = Settings.ClientCount * 2 + 256;
+	if (getrlimit(RLIMIT_NOFILE, &FileDescriptorLimit) == 0 && FileDescriptorLimit.rlim_cur < RequiredFileDescriptorCount)
+	{
+		FileDescriptorLimit.rlim_cur = std::min(FileDescriptorLimit.rlim_max, RequiredFileDescriptorCount);
+		setrlimit(RLIMIT_NOFILE, &FileDescriptorLimit);
+	}
+
+	printf("%zu clients sending %s packets of %zu bytes for %.1f s, echoed %zu time(s) every %.1f ms, received by %zu Net Worker(s).\n",
+		Settings.ClientCount, Settings.MessageRate > 0.0 ? "paced" : "as many", Settings.BodySize, Settings.Duration, Settings.EchoCount, Settings.TickMs,
+		Settings.WorkerCount);
+	if (Settings.MessageRate > 0.0)
+	{
+		printf("Each client sends %zu packet(s) at once, %.1f times per second.\n", Settings.BurstSize, Settings.MessageRate);
+	}
+	fflush(stdout);
+
+	// Clients run in a process of their own, forked before the Platform starts any thread, so that the CPU time measured
+	// is the Platform's alone.
+	int ReportHandles[2];
+	pid_t ClientProcessID = pipe(ReportHandles) == 0 ? fork() : -1;
+	if (ClientProcessID < 0)
+	{
+		std::cerr << "Failed to start the client process. Error Code: " << errno << "\n";
+		return 1;
+	}
+	if (ClientProcessID == 0)
+	{
+		close(ReportHandles[0]);
+		return RunClients(Settings, ReportHandles[1]);
+	}
+	close(ReportHandles[1]);
+	return RunEchoLoop(Settings, ClientProcessID, ReportHandles[0]);
+}
@@ -0,0 +1,242 @@
+// NetReceptionBench_Main.cpp
+// Main Entry point of the Net reception benchmark, timing how received bytes are turned into packets the Server reads,
+// in place through descriptors against the copying layout they replaced.
+
+#include "ServerFramework/NetStreamReassembler.h"
+#include "ServerFramework/ServerPlatform.h"
+#include "Tests/ToolArguments.h"
+
+#include "chrono"
+#include "cstdint"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "vector"
+
+struct ReceptionBenchSettings
+{
+	size_t BodySize = 0; // Bytes in each packet body. 0 runs every size of ReceptionBodySizes.
+	size_t ConnectionCount = 64; // Connections the tick's data is received from, in turn.
+	size_t TickByteCount = 60000; // Bytes received per tick.
+	double Duration = 2.0; // Seconds each path is timed for, per body size.
+};
+
+// Bodies of chat messages, small gameplay packets, and the largest landscape syncs.
+static const size_t ReceptionBodySizes[] = { 16, 64, 1254 };
+
+// Small bodies are received several at once, as a client sends them in bursts.
+#define SMALL_BODY_SIZE 200
+#define SMALL_BODIES_PER_READ 9
+
+enum class ReceptionPath : uint8_t
+{
+	COPY = 0, // Reads land in a scratch buffer, and every body is copied behind a PacketHead, walked with GetNextPacketFromBuffer.
+	IN_PLACE, // Reads land in the reception buffer, and every packet is described where it landed.
+};
+
+static const char* ReceptionPathNames[] = { "copy", "in place" };
+
+// A tick of received data, made of one read per connection in turn.
+struct ReceptionTick
+{
+	std::vector<std::vector<byte>> Reads;
+	size_t ByteCount = 0;
+	size_t PacketCount = 0;
+};
+
+// Fills a tick with reads of whole packets until it holds about TickByteCount bytes.
+static void BuildReceptionTick(const ReceptionBenchSettings& Settings, size_t BodySize, ReceptionTick& OutTick)
+{
+	size_t PacketsPerRead = BodySize < SMALL_BODY_SIZE ? SMALL_BODIES_PER_READ : 1;
+	size_t ReadSize = PacketsPerRead * (sizeof(FPCore::Net::NetEncodedPacketHead) + BodySize);
+
+	FPCore::Net::NetEncodedPacketHead Head = {};
+	Head.BodyType = FPCore::Net::PacketBodyType::MESSAGE;
+	Head.BodySize = static_cast<FPCore::Net::PacketBodySize_t>(BodySize);
+
+	OutTick = {};
+	while (OutTick.Reads.empty() || OutTick.ByteCount + ReadSize <= Settings.TickByteCount)
+	{
+		std::vector<byte> Read;
+		for (size_t PacketIndex = 0; PacketIndex < PacketsPerRead; PacketIndex++)
+		{
+			Read.insert(Read.end(), reinterpret_cast<const byte*>(&Head), reinterpret_cast<const byte*>(&Head) + sizeof(Head));
+			for (size_t ByteIndex = 0; ByteIndex < BodySize; ByteIndex++)
+			{
+				Read.push_back(static_cast<byte>(ByteIndex * 7 + OutTick.Reads.size()));
+			}
+		}
+		OutTick.ByteCount += Read.size();
+		OutTick.PacketCount += PacketsPerRead;
+		OutTick.Reads.push_back(std::move(Read));
+	}
+}
+
+// Receives and reads the tick over and over for the settings' duration. Every body is read at both ends, as handlers
+// would. Returns the time a single tick took, and a checksum of what was read.
+static double TimeReceptionPath(const ReceptionBenchSettings& Settings, const ReceptionTick& Tick, ReceptionPath Path, uint64_t& OutChecksum,
+	size_t& OutReceptionByteCount)
+{
+	std::vector<byte> PendingData(Settings.ConnectionCount * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+	std::vector<NetStreamReassembler> Reassemblers(Settings.ConnectionCount);
+	for (size_t ConnectionIndex = 0; ConnectionIndex < Reassemblers.size(); ConnectionIndex++)
+	{
+		Reassemblers[ConnectionIndex].Initialize(PendingData.data() + ConnectionIndex * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+	}
+
+	// The copying layout takes a full PacketHead per packet: room for the smallest bodies at worst.
+	std::vector<byte> ScratchBuffer(Tick.ByteCount);
+	std::vector<byte> ReceptionBuffer(Tick.ByteCount + Tick.PacketCount * sizeof(FPCore::Net::PacketHead));
+	std::vector<NetPacketDescriptor> Descriptors(Tick.PacketCount);
+
+	size_t TickCount = 0;
+	uint64_t Checksum = 0;
+	auto BeginTime = std::chrono::steady_clock::now();
+	double Time = 0.0;
+	while (Time < Settings.Duration)
+	{
+		size_t ReceivedByteCount = 0;
+		size_t DescriptorCount = 0;
+		for (size_t ReadIndex = 0; ReadIndex < Tick.Reads.size(); ReadIndex++)
+		{
+			const std::vector<byte>& Read = Tick.Reads[ReadIndex];
+			FPCore::Net::PacketConnectionID_t ConnectionID = static_cast<FPCore::Net::PacketConnectionID_t>(ReadIndex % Settings.ConnectionCount);
+			NetStreamReassembler& Reassembler = Reassemblers[ConnectionID];
+
+			// The memcpy of the read stands in for the kernel's.
+			if (Path == ReceptionPath::COPY)
+			{
+				memcpy(ScratchBuffer.data(), Read.data(), Read.size());
+				Reassembler.Consume(ScratchBuffer.data(), Read.size(), [&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+				{
+					FPCore::Net::PacketHead ReceivedPacket = {};
+					ReceivedPacket.ConnectionID = ConnectionID;
+					ReceivedPacket.BodyType = Head.BodyType;
+					ReceivedPacket.BodySize = Head.BodySize;
+					ReceivedPacket.BodyStart = ReceptionBuffer.data() + ReceivedByteCount + sizeof(ReceivedPacket);
+					memcpy(ReceptionBuffer.data() + ReceivedByteCount, &ReceivedPacket, sizeof(ReceivedPacket));
+					memcpy(ReceivedPacket.BodyStart, Body, Head.BodySize);
+					ReceivedByteCount += sizeof(ReceivedPacket) + Head.BodySize;
+				});
+			}
+			else
+			{
+				byte* ReadLocation = ReceptionBuffer.data() + ReceivedByteCount;
+				size_t PendingByteCount = Reassembler.CopyPendingTo(ReadLocation);
+				memcpy(ReadLocation + PendingByteCount, Read.data(), Read.size());
+				Reassembler.ConsumeInPlace(ReadLocation, PendingByteCount + Read.size(), [&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+				{
+					NetPacketDescriptor& Descriptor = Descriptors[DescriptorCount++];
+					Descriptor.ConnectionID = ConnectionID;
+					Descriptor.BodySize = Head.BodySize;
+					Descriptor.BodyOffset = static_cast<uint32_t>(Body - ReceptionBuffer.data());
+					Descriptor.BodyType = Head.BodyType;
+				});
+				ReceivedByteCount += PendingByteCount + Read.size();
+			}
+		}
+
+		// The Server's side, reading every packet.
+		if (Path == ReceptionPath::COPY)
+		{
+			const byte* NextPacket = ReceptionBuffer.data();
+			const byte* ReceptionEnd = ReceptionBuffer.data() + ReceivedByteCount;
+			while (NextPacket < ReceptionEnd)
+			{
+				FPCore::Net::PacketHead ReceivedPacket;
+				NextPacket = FPCore::Net::GetNextPacketFromBuffer(NextPacket, ReceptionEnd, ReceivedPacket);
+				if (nullptr == NextPacket)
+				{
+					break;
+				}
+				const byte* Body = static_cast<const byte*>(ReceivedPacket.BodyStart);
+				Checksum += Body[0] + Body[ReceivedPacket.BodySize - 1] + ReceivedPacket.ConnectionID;
+			}
+		}
+		else
+		{
+			for (size_t DescriptorIndex = 0; DescriptorIndex < DescriptorCount; DescriptorIndex++)
+			{
+				const NetPacketDescriptor& Descriptor = Descriptors[DescriptorIndex];
+				FPCore::Net::PacketHead ReceivedPacket;
+				ReceivedPacket.ConnectionID = Descriptor.ConnectionID;
+				ReceivedPacket.BodyType = Descriptor.BodyType;
+				ReceivedPacket.BodySize = Descriptor.BodySize;
+				ReceivedPacket.BodyStart = ReceptionBuffer.data() + Descriptor.BodyOffset;
+				const byte* Body = static_cast<const byte*>(ReceivedPacket.BodyStart);
+				Checksum += Body[0] + Body[ReceivedPacket.BodySize - 1] + ReceivedPacket.ConnectionID;
+			}
+		}
+
+		OutReceptionByteCount = ReceivedByteCount;
+		TickCount++;
+		Time = std::chrono::duration<double>(std::chrono::steady_clock::now() - BeginTime).count();
+	}
+
+	OutChecksum = Checksum / TickCount;
+	return Time / TickCount;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, ReceptionBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Body, Connections, TickBytes, Duration", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Body")) { OutSettings.BodySize = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Connections")) { OutSettings.ConnectionCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("TickBytes")) { OutSettings.TickByteCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Duration")) { OutSettings.Duration = strtod(Argument.Value, nullptr); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	ReceptionBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.BodySize > static_cast<FPCore::Net::PacketBodySize_t>(~0)
+		|| Settings.ConnectionCount == 0 || Settings.ConnectionCount > ServerPlatform::INVALID_ID || Settings.Duration <= 0.0)
+	{
+		std::cerr << "Usage: FracturedPlaneNetReceptionBench [Body=0] [Connections=64] [TickBytes=60000] [Duration=2]\n"
+			<< "Body=0 runs bodies of 16, 64 and 1254 bytes.\n";
+		return 1;
+	}
+
+	std::vector<size_t> BodySizes;
+	if (Settings.BodySize == 0)
+	{
+		BodySizes.assign(std::begin(ReceptionBodySizes), std::end(ReceptionBodySizes));
+	}
+	else
+	{
+		BodySizes.push_back(Settings.BodySize);
+	}
+
+	for (size_t BodySize : BodySizes)
+	{
+		ReceptionTick Tick;
+		BuildReceptionTick(Settings, BodySize, Tick);
+
+		uint64_t Checksums[2];
+		for (int PathIndex = 0; PathIndex < 2; PathIndex++)
+		{
+			size_t ReceptionByteCount = 0;
+			double TickTime = TimeReceptionPath(Settings, Tick, static_cast<ReceptionPath>(PathIndex), Checksums[PathIndex], ReceptionByteCount);
+			printf("Body %4zu bytes, %-8s: %7.1f us/MB, %6.1f ns per packet, %zu reception bytes for %zu received.\n", BodySize,
+				ReceptionPathNames[PathIndex], TickTime * 1e6 / (Tick.ByteCount / 1e6), TickTime * 1e9 / Tick.PacketCount, ReceptionByteCount,
+				Tick.ByteCount);
+		}
+
+		// Both paths have to hand the Server the same packets.
+		if (Checksums[0] != Checksums[1])
+		{
+			std::cerr << "FAILED: both paths don't read the same packets with bodies of " << BodySize << " bytes.\n";
+			return 1;
+		}
+	}
+	return 0;
+}
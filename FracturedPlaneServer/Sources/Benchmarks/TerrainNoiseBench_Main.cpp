@@ -0,0 +1,91 @@
+// TerrainNoiseBench_Main.cpp
+// Main Entry point of the Terrain Noise benchmark, timing how many tiles every kernel generates per second on one core.
+
+#include "ServerFramework/TerrainNoise.h"
+#include "Tests/ToolArguments.h"
+
+#include "chrono"
+#include "cstdint"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "vector"
+
+struct NoiseBenchSettings
+{
+	uint32_t Seed = 12345;
+	size_t ZoneCount = 20; // Zones generated per run, along a line of the world.
+	size_t RepeatCount = 5; // Timings keep the best of this many runs.
+};
+
+#define KERNEL_COUNT 3
+
+// Same noise settings as the World's Islands.
+#define BENCH_CELL_SIZE_SHIFT 7
+#define BENCH_OCTAVE_COUNT 6
+#define BENCH_VOID_THRESHOLD -0.25f
+
+static const char* KernelNames[KERNEL_COUNT] = { "scalar", "SSE2", "AVX2" };
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, NoiseBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, Zones, Repeats", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.Seed = static_cast<uint32_t>(strtoul(Argument.Value, nullptr, 10)); }
+		else if (Argument.KeyIs("Zones")) { OutSettings.ZoneCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Repeats")) { OutSettings.RepeatCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	NoiseBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.ZoneCount == 0 || Settings.RepeatCount == 0)
+	{
+		std::cerr << "Usage: FracturedPlaneTerrainNoiseBench [Seed=12345] [Zones=20] [Repeats=5]\n";
+		return 1;
+	}
+
+	std::vector<uint16_t> Elevations(FPCore::World::TILES_PER_ZONE);
+	std::vector<byte> VoidTileBitmask(FPCore::World::TILES_PER_ZONE / 8);
+
+	TerrainNoiseKernel BestKernel = TerrainNoise::GetBestKernel();
+	for (int KernelIndex = 0; KernelIndex < KERNEL_COUNT; KernelIndex++)
+	{
+		if (KernelIndex > static_cast<int>(BestKernel))
+		{
+			std::cout << KernelNames[KernelIndex] << ": not supported here.\n";
+			continue;
+		}
+
+		TerrainNoise Terrain;
+		if (!Terrain.Initialize(Settings.Seed, BENCH_CELL_SIZE_SHIFT, BENCH_OCTAVE_COUNT, BENCH_VOID_THRESHOLD, static_cast<TerrainNoiseKernel>(KernelIndex)))
+		{
+			return 1;
+		}
+
+		double BestTime = 0.0;
+		for (size_t Repeat = 0; Repeat < Settings.RepeatCount; Repeat++)
+		{
+			auto BeginTime = std::chrono::steady_clock::now();
+			for (size_t ZoneIndex = 0; ZoneIndex < Settings.ZoneCount; ZoneIndex++)
+			{
+				Terrain.GenerateZone(static_cast<uint32_t>(ZoneIndex) * FPCore::World::ZONE_SIZE_TILES, 3 * FPCore::World::ZONE_SIZE_TILES,
+					0, 3000, Elevations.data(), VoidTileBitmask.data());
+			}
+			double Time = std::chrono::duration<double>(std::chrono::steady_clock::now() - BeginTime).count();
+			BestTime = Repeat == 0 || Time < BestTime ? Time : BestTime;
+		}
+
+		double TileCount = static_cast<double>(Settings.ZoneCount) * FPCore::World::TILES_PER_ZONE;
+		std::cout << KernelNames[KernelIndex] << ": " << BestTime * 1000.0 / Settings.ZoneCount << " ms per zone, "
+			<< TileCount / BestTime / 1e6 << " Mtiles/s.\n";
+	}
+	return 0;
+}
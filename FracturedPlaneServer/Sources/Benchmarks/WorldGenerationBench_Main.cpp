@@ -0,0 +1,183 @@
+// WorldGenerationBench_Main.cpp
+// Main Entry point of the World generation benchmark, timing how fast an Island's zones are opened per worker count.
+
+#include "ServerFramework/JobSystem.h"
+#include "ServerFramework/StdThreads.h"
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+#include "ServerFramework/Subsystems/Core/WorldSubsystem.h"
+#include "ServerFramework/TimerWheel.h"
+#include "Tests/ToolArguments.h"
+
+#include "chrono"
+#include "cstdint"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "thread"
+#include "vector"
+
+struct GenerationBenchSettings
+{
+	int64_t IslandSeed = 12345;
+	uint16_t BoundsSize = 16; // Zones along each side of the Island, every one of them opened at once.
+	size_t MaxWorkerCount = 16; // Runs at every power of two up to this.
+	size_t RepeatCount = 5; // Timings keep the best of this many runs.
+};
+
+#define BENCH_HEAP_SIZE (1024 * 1024 * 64) // 64mb
+#define BENCH_MAX_JOB_COUNT 4096
+#define BENCH_WORLD_SEED 1
+#define BENCH_TIMER_TICK_DURATION 0.05
+
+// FNV-1a, continued from Hash.
+static uint64_t HashBytes(uint64_t Hash, const void* Data, size_t Size)
+{
+	const byte* Bytes = static_cast<const byte*>(Data);
+	for (size_t ByteIndex = 0; ByteIndex < Size; ByteIndex++)
+	{
+		Hash = (Hash ^ Bytes[ByteIndex]) * 0x100000001B3ull;
+	}
+	return Hash;
+}
+
+// Hashes zone definitions and the tiles of every zone, which have to be resident.
+static uint64_t HashIsland(const Cluster::Island& Island)
+{
+	uint64_t Hash = HashBytes(0xCBF29CE484222325ull, Island.Zones, Island.ZoneCount * sizeof(FPCore::World::ZoneDef));
+	for (size_t ZoneIndex = 0; ZoneIndex < Island.ZoneCount; ZoneIndex++)
+	{
+		Hash = HashBytes(Hash, Island.ZoneResidencies[ZoneIndex].Tiles, sizeof(ZoneTiles));
+	}
+	return Hash;
+}
+
+// Generates the Island on a fresh World running WorkerCount workers, then opens all of its zones at once, over and over.
+// Returns false if anything couldn't be initialized or opened.
+static bool RunGeneration(const GenerationBenchSettings& Settings, std::vector<byte>& Heap, const ServerPlatform& Platform,
+	size_t WorkerCount, uint64_t& OutHash)
+{
+	size_t ZoneCount = static_cast<size_t>(Settings.BoundsSize) * Settings.BoundsSize;
+
+	MemorySubsystem Memory;
+	JobSystem Jobs;
+	TimerWheel Timers;
+	WorldSubsystem World;
+	if (!Memory.Initialize(Heap.data(), Heap.size())
+		|| !Jobs.Initialize(Memory, Platform, WorkerCount, BENCH_MAX_JOB_COUNT)
+		|| !Timers.Initialize(Memory, ZoneCount, BENCH_TIMER_TICK_DURATION)
+		|| !World.Initialize(Memory, 1, BENCH_WORLD_SEED, Jobs, Timers, ZoneCount, 0.0))
+	{
+		std::cerr << "Failed to initialize the World.\n";
+		return false;
+	}
+
+	IslandGenerationInfo GenInfo;
+	GenInfo.BoundsSize = { Settings.BoundsSize, Settings.BoundsSize };
+	GenInfo.RandomGenSeed = Settings.IslandSeed;
+	if (!World.GenerateIsland(Memory, GenInfo))
+	{
+		std::cerr << "Failed to generate the Island.\n";
+		Jobs.Shutdown();
+		return false;
+	}
+	Cluster::Island& Island = World.IslandClusters[GenInfo.ClusterID].Islands[GenInfo.ID];
+
+	std::vector<FPCore::World::Coordinates> ZoneCoords;
+	for (uint16_t ZoneX = 0; ZoneX < Settings.BoundsSize; ZoneX++)
+	{
+		for (uint16_t ZoneY = 0; ZoneY < Settings.BoundsSize; ZoneY++)
+		{
+			ZoneCoords.push_back({ ZoneX, ZoneY });
+		}
+	}
+
+	double BestTime = 0.0;
+	bool bOpened = true;
+	for (size_t Repeat = 0; bOpened && Repeat < Settings.RepeatCount; Repeat++)
+	{
+		auto BeginTime = std::chrono::steady_clock::now();
+		bOpened = World.OpenZones(Island, ZoneCoords.data(), ZoneCoords.size());
+		double Time = std::chrono::duration<double>(std::chrono::steady_clock::now() - BeginTime).count();
+		BestTime = Repeat == 0 || Time < BestTime ? Time : BestTime;
+
+		if (bOpened)
+		{
+			OutHash = HashIsland(Island);
+		}
+
+		// Evicted zones get generated anew by the next run.
+		for (uint32_t ZoneIndex = 0; ZoneIndex < ZoneCount; ZoneIndex++)
+		{
+			World.EvictZone(Island, ZoneIndex);
+		}
+	}
+	Jobs.Shutdown();
+
+	if (!bOpened)
+	{
+		std::cerr << "Failed to open the Island's zones.\n";
+		return false;
+	}
+
+	double TileCount = static_cast<double>(ZoneCount) * FPCore::World::TILES_PER_ZONE;
+	std::cout << "Workers " << WorkerCount << ": " << ZoneCount << " zones opened in " << BestTime * 1000.0 << " ms, "
+		<< TileCount / BestTime / 1e6 << " Mtiles/s, hash " << std::hex << OutHash << std::dec << ".\n";
+	return true;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, GenerationBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, Bounds, MaxWorkers, Repeats", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.IslandSeed = strtoll(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Bounds")) { OutSettings.BoundsSize = static_cast<uint16_t>(strtoul(Argument.Value, nullptr, 10)); }
+		else if (Argument.KeyIs("MaxWorkers")) { OutSettings.MaxWorkerCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Repeats")) { OutSettings.RepeatCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	GenerationBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.IslandSeed == 0 || Settings.BoundsSize == 0 || Settings.RepeatCount == 0)
+	{
+		std::cerr << "Usage: FracturedPlaneWorldGenerationBench [Seed=12345] [Bounds=16] [MaxWorkers=16] [Repeats=5]\n";
+		return 1;
+	}
+
+	// Timings only mean anything next to the core count: more workers than cores only adds overhead.
+	std::cout << "Running on " << std::thread::hardware_concurrency() << " processor(s).\n";
+
+	ServerPlatform Platform;
+	Platform.CreateThread = StdThreads_CreateThread;
+	Platform.DestroyThread = StdThreads_DestroyThread;
+	std::vector<byte> Heap(BENCH_HEAP_SIZE);
+
+	// Zones are generated by whatever worker picks them up: the World has to come out the same at every worker count.
+	uint64_t FirstHash = 0;
+	for (size_t WorkerCount = 1; WorkerCount <= Settings.MaxWorkerCount; WorkerCount *= 2)
+	{
+		uint64_t Hash = 0;
+		if (!RunGeneration(Settings, Heap, Platform, WorkerCount, Hash))
+		{
+			return 1;
+		}
+
+		if (WorkerCount == 1)
+		{
+			FirstHash = Hash;
+		}
+		else if (Hash != FirstHash)
+		{
+			std::cerr << "FAILED: the Island generated with " << WorkerCount << " workers differs from the one generated with 1.\n";
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -10,6 +10,7 @@
 
 #include "WorldSyncPackets.h"
 #include "AuthenticationPackets.h"
+#include "HeartbeatPackets.h"
 
 // -- 
 
@@ -73,6 +74,13 @@ void FPCore::Net::InitializePacketBodyTypeFunctionsDefMap(PacketBodyFuncMap& Map
 	{
 
 	};
+
+	Map[PacketBodyType::HEARTBEAT] =
+	{
+		GetMarshalledSizeFunc_Simple<PacketBodyDef_Heartbeat>,
+		MarshalFunc_Simple<PacketBodyDef_Heartbeat>,
+		MusterFunc_Simple
+	};
 }
 
 // AUTHENTICATION
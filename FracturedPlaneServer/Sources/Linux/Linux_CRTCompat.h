@@ -0,0 +1,65 @@
+// Linux_CRTCompat.h
+// Provides the subset of the MSVC "secure" CRT functions used by Server and FPCore code, which glibc does not implement.
+// Force-included into every compilation unit of the Linux build (see CMakeLists.txt).
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+typedef int errno_t;
+
+// Copies Count bytes from Src to Dest if Dest can hold them. Otherwise, zeroes out Dest and returns an error.
+inline errno_t memcpy_s(void* Dest, size_t DestSize, const void* Src, size_t Count)
+{
+	if (Count == 0)
+	{
+		return 0;
+	}
+
+	if (nullptr == Dest)
+	{
+		return EINVAL;
+	}
+
+	if (nullptr == Src || DestSize < Count)
+	{
+		memset(Dest, 0, DestSize);
+		return nullptr == Src ? EINVAL : ERANGE;
+	}
+
+	memcpy(Dest, Src, Count);
+	return 0;
+}
+
+// Copies the null-terminated Src string into Dest if it fits, terminator included. Otherwise, empties Dest and returns an error.
+inline errno_t strcpy_s(char* Dest, size_t DestSize, const char* Src)
+{
+	if (nullptr == Dest || DestSize == 0)
+	{
+		return EINVAL;
+	}
+
+	if (nullptr == Src)
+	{
+		Dest[0] = '\0';
+		return EINVAL;
+	}
+
+	size_t SrcLength = strnlen(Src, DestSize);
+	if (SrcLength == DestSize)
+	{
+		Dest[0] = '\0';
+		return ERANGE;
+	}
+
+	memcpy(Dest, Src, SrcLength + 1);
+	return 0;
+}
+
+// Returns the length of Str, reading at most MaxCount characters. Returns 0 for a null string.
+inline size_t strnlen_s(const char* Str, size_t MaxCount)
+{
+	return nullptr == Str ? 0 : strnlen(Str, MaxCount);
+}
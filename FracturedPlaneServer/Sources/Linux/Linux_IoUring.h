@@ -0,0 +1,288 @@
+// Linux_IoUring.h
+// Minimal io_uring interface built straight on top of the system calls, used by the io_uring Net backend.
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "cerrno"
+#include "cstdint"
+#include "cstring"
+
+// An io_uring instance: a Submission Queue the process fills with operations and a Completion Queue the kernel fills with
+// their results, both shared through mapped memory. Operations taken with GetSubmissionEntry only reach the kernel on the
+// next Submit, so any number of them cost a single system call, which can also wait for completions.
+// Queue indices are shared with the kernel and accessed through atomic builtins. A ring is only ever used by one thread.
+struct LinuxIoUring
+{
+	int RingHandle = -1;
+
+	unsigned* SubmissionHead = nullptr;
+	unsigned* SubmissionTail = nullptr;
+	unsigned SubmissionMask = 0;
+	unsigned SubmissionEntryCount = 0;
+	io_uring_sqe* SubmissionEntries = nullptr;
+	unsigned PreparedTail = 0; // Entries between *SubmissionTail and this one were prepared but not submitted yet.
+
+	unsigned* CompletionHead = nullptr;
+	unsigned* CompletionTail = nullptr;
+	unsigned CompletionMask = 0;
+	io_uring_cqe* CompletionEntries = nullptr;
+
+	void* RingsMemory = nullptr;
+	size_t RingsMemorySize = 0;
+	void* SubmissionEntriesMemory = nullptr;
+	size_t SubmissionEntriesMemorySize = 0;
+
+	// Creates the ring with room for SubmissionCount pending operations and CompletionCount unread results. Both counts
+	// are rounded up to powers of two by the kernel. Returns false with errno set if the kernel refuses.
+	bool Initialize(unsigned SubmissionCount, unsigned CompletionCount)
+	{
+		io_uring_params Params = {};
+		Params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+		Params.cq_entries = CompletionCount;
+
+		RingHandle = static_cast<int>(syscall(__NR_io_uring_setup, SubmissionCount, &Params));
+		if (RingHandle < 0)
+		{
+			RingHandle = -1;
+			return false;
+		}
+
+		// Kernels without a single mapping for both queues are older than anything the backend needs.
+		if (!(Params.features & IORING_FEAT_SINGLE_MMAP) || !(Params.features & IORING_FEAT_NODROP))
+		{
+			Shutdown();
+			errno = ENOSYS;
+			return false;
+		}
+
+		size_t SubmissionRingSize = Params.sq_off.array + Params.sq_entries * sizeof(unsigned);
+		size_t CompletionRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(io_uring_cqe);
+		RingsMemorySize = SubmissionRingSize > CompletionRingSize ? SubmissionRingSize : CompletionRingSize;
+		RingsMemory = mmap(nullptr, RingsMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingHandle, IORING_OFF_SQ_RING);
+		if (MAP_FAILED == RingsMemory)
+		{
+			RingsMemory = nullptr;
+			Shutdown();
+			return false;
+		}
+
+		SubmissionEntriesMemorySize = Params.sq_entries * sizeof(io_uring_sqe);
+		SubmissionEntriesMemory = mmap(nullptr, SubmissionEntriesMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingHandle, IORING_OFF_SQES);
+		if (MAP_FAILED == SubmissionEntriesMemory)
+		{
+			SubmissionEntriesMemory = nullptr;
+			Shutdown();
+			return false;
+		}
+
+		char* Rings = static_cast<char*>(RingsMemory);
+		SubmissionHead = reinterpret_cast<unsigned*>(Rings + Params.sq_off.head);
+		SubmissionTail = reinterpret_cast<unsigned*>(Rings + Params.sq_off.tail);
+		SubmissionMask = *reinterpret_cast<unsigned*>(Rings + Params.sq_off.ring_mask);
+		SubmissionEntryCount = Params.sq_entries;
+		SubmissionEntries = static_cast<io_uring_sqe*>(SubmissionEntriesMemory);
+		PreparedTail = *SubmissionTail;
+
+		// Submission entries are always used in order, so the indirection array maps each slot to itself once and for all.
+		unsigned* SubmissionArray = reinterpret_cast<unsigned*>(Rings + Params.sq_off.array);
+		for (unsigned EntryIndex = 0; EntryIndex < SubmissionEntryCount; EntryIndex++)
+		{
+			SubmissionArray[EntryIndex] = EntryIndex;
+		}
+
+		CompletionHead = reinterpret_cast<unsigned*>(Rings + Params.cq_off.head);
+		CompletionTail = reinterpret_cast<unsigned*>(Rings + Params.cq_off.tail);
+		CompletionMask = *reinterpret_cast<unsigned*>(Rings + Params.cq_off.ring_mask);
+		CompletionEntries = reinterpret_cast<io_uring_cqe*>(Rings + Params.cq_off.cqes);
+		return true;
+	}
+
+	void Shutdown()
+	{
+		if (nullptr != SubmissionEntriesMemory)
+		{
+			munmap(SubmissionEntriesMemory, SubmissionEntriesMemorySize);
+			SubmissionEntriesMemory = nullptr;
+		}
+		if (nullptr != RingsMemory)
+		{
+			munmap(RingsMemory, RingsMemorySize);
+			RingsMemory = nullptr;
+		}
+		if (RingHandle != -1)
+		{
+			close(RingHandle);
+			RingHandle = -1;
+		}
+	}
+
+	// Returns whether the kernel supports every passed operation.
+	bool SupportsOperations(const uint8_t* Operations, size_t OperationCount)
+	{
+		alignas(io_uring_probe) uint8_t ProbeMemory[sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op)] = {};
+		io_uring_probe* Probe = reinterpret_cast<io_uring_probe*>(ProbeMemory);
+
+		if (syscall(__NR_io_uring_register, RingHandle, IORING_REGISTER_PROBE, Probe, 256) < 0)
+		{
+			return false;
+		}
+
+		for (size_t OperationIndex = 0; OperationIndex < OperationCount; OperationIndex++)
+		{
+			uint8_t Operation = Operations[OperationIndex];
+			if (Operation > Probe->last_op || !(Probe->ops[Operation].flags & IO_URING_OP_SUPPORTED))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Returns a cleared Submission Queue entry to describe an operation with, submitting the prepared ones first if the
+	// queue is full. The operation only starts on the next Submit. Returns null if the kernel won't take any more entries.
+	io_uring_sqe* GetSubmissionEntry()
+	{
+		if (PreparedTail - __atomic_load_n(SubmissionHead, __ATOMIC_ACQUIRE) >= SubmissionEntryCount)
+		{
+			Submit(0);
+			if (PreparedTail - __atomic_load_n(SubmissionHead, __ATOMIC_ACQUIRE) >= SubmissionEntryCount)
+			{
+				return nullptr;
+			}
+		}
+
+		io_uring_sqe* Entry = &SubmissionEntries[PreparedTail & SubmissionMask];
+		memset(Entry, 0, sizeof(*Entry));
+		PreparedTail++;
+		return Entry;
+	}
+
+	// Hands every prepared operation over to the kernel, then waits until at least WaitCount completions are available.
+	// Returns the result of the system call: the number of submitted operations, or a negative errno. The wait may end
+	// early on a signal, so callers needing every completion have to check how many they actually got.
+	int Submit(unsigned WaitCount)
+	{
+		unsigned SubmittedCount = PreparedTail - *SubmissionTail;
+		__atomic_store_n(SubmissionTail, PreparedTail, __ATOMIC_RELEASE);
+		if (SubmittedCount == 0 && WaitCount == 0)
+		{
+			return 0;
+		}
+
+		while (true)
+		{
+			long Result = syscall(__NR_io_uring_enter, RingHandle, SubmittedCount, WaitCount, WaitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+			if (Result >= 0)
+			{
+				return static_cast<int>(Result);
+			}
+			if (errno != EINTR)
+			{
+				return -errno;
+			}
+		}
+	}
+
+	// Calls OnCompletion(const io_uring_cqe&) for every available completion, in order. Returns how many were handled.
+	template<typename CompletionHandler>
+	unsigned HandleCompletions(CompletionHandler&& OnCompletion)
+	{
+		unsigned Head = *CompletionHead;
+		unsigned Tail = __atomic_load_n(CompletionTail, __ATOMIC_ACQUIRE);
+		for (unsigned Index = Head; Index != Tail; Index++)
+		{
+			// Free each entry before handling it, so the queue has room for whatever the handler submits.
+			io_uring_cqe Completion = CompletionEntries[Index & CompletionMask];
+			__atomic_store_n(CompletionHead, Index + 1, __ATOMIC_RELEASE);
+			OnCompletion(Completion);
+		}
+		return Tail - Head;
+	}
+};
+
+// Buffers handed to the kernel for operations to pick from when they complete, rather than being chosen on submission.
+// A receive only takes a buffer once data arrived, so idle connections don't each hold one. Buffers come back to the
+// kernel through Provide once their data was handled.
+struct LinuxIoUringBufferRing
+{
+	io_uring_buf_ring* Ring = nullptr;
+	io_uring_buf* Entries = nullptr; // Same memory as Ring, which C++ can't index through its flexible array.
+	uint8_t* Buffers = nullptr;
+	unsigned BufferCount = 0; // Always a power of two.
+	unsigned BufferSize = 0;
+	uint16_t GroupID = 0;
+	uint16_t ProvidedTail = 0;
+
+	void* Memory = nullptr;
+	size_t MemorySize = 0;
+
+	// Allocates BufferCount buffers of BufferSize bytes and registers them to IoUring as the group GroupID. BufferCount has
+	// to be a power of two. Returns false with errno set on failure.
+	bool Initialize(LinuxIoUring& IoUring, unsigned RingBufferCount, unsigned RingBufferSize, uint16_t RingGroupID)
+	{
+		BufferCount = RingBufferCount;
+		BufferSize = RingBufferSize;
+		GroupID = RingGroupID;
+
+		// The ring entries have to start on a page: put them first, with the buffers right after.
+		size_t RingSize = BufferCount * sizeof(io_uring_buf);
+		MemorySize = RingSize + static_cast<size_t>(BufferCount) * BufferSize;
+		Memory = mmap(nullptr, MemorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (MAP_FAILED == Memory)
+		{
+			Memory = nullptr;
+			return false;
+		}
+		Ring = static_cast<io_uring_buf_ring*>(Memory);
+		Entries = static_cast<io_uring_buf*>(Memory);
+		Buffers = static_cast<uint8_t*>(Memory) + RingSize;
+
+		io_uring_buf_reg Registration = {};
+		Registration.ring_addr = reinterpret_cast<uint64_t>(Ring);
+		Registration.ring_entries = BufferCount;
+		Registration.bgid = GroupID;
+		if (syscall(__NR_io_uring_register, IoUring.RingHandle, IORING_REGISTER_PBUF_RING, &Registration, 1) < 0)
+		{
+			Shutdown();
+			return false;
+		}
+
+		ProvidedTail = 0;
+		for (unsigned BufferID = 0; BufferID < BufferCount; BufferID++)
+		{
+			Provide(static_cast<uint16_t>(BufferID));
+		}
+		return true;
+	}
+
+	// Unmaps the buffers. The ring they were registered to has to be shut down already.
+	void Shutdown()
+	{
+		if (nullptr != Memory)
+		{
+			munmap(Memory, MemorySize);
+			Memory = nullptr;
+		}
+	}
+
+	uint8_t* GetBuffer(uint16_t BufferID) const
+	{
+		return Buffers + static_cast<size_t>(BufferID) * BufferSize;
+	}
+
+	// Gives a buffer back to the kernel, to be picked by upcoming operations.
+	void Provide(uint16_t BufferID)
+	{
+		io_uring_buf& Entry = Entries[ProvidedTail & (BufferCount - 1)];
+		Entry.addr = reinterpret_cast<uint64_t>(GetBuffer(BufferID));
+		Entry.len = BufferSize;
+		Entry.bid = BufferID;
+		ProvidedTail++;
+		__atomic_store_n(&Ring->tail, ProvidedTail, __ATOMIC_RELEASE);
+	}
+};
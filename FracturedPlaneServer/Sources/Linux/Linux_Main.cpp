@@ -0,0 +1,334 @@
+// Linux_Main.cpp
+// Main Entry point of program when running on Linux.
+
+#include "ServerFramework/PlatformThreadTable.h"
+#include "ServerFramework/ServerPlatform.h"
+#include "ServerFramework/TickScheduler.h"
+
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cerrno"
+#include "cstdio"
+#include "iostream"
+
+static volatile sig_atomic_t bServerShutdown = 0;
+static ShutdownReason ProgramShutdownReason = ShutdownReason::UNKNOWN;
+
+// Threads are POSIX threads, joined on destruction.
+static PlatformThreadTable<pthread_t> PlatformThreads;
+
+void HandleTerminationSignal(int Signal)
+{
+	ProgramShutdownReason = ShutdownReason::PLATFORM_SHUTDOWN;
+	bServerShutdown = 1;
+}
+
+void RequestProgramShutdown()
+{
+	ProgramShutdownReason = ShutdownReason::SERVER_SHUTDOWN;
+	bServerShutdown = 1;
+}
+
+void* PlatformThread_Func(void* Param)
+{
+	PlatformThreadTable<pthread_t>::Thread& Thread = *static_cast<PlatformThreadTable<pthread_t>::Thread*>(Param);
+	Thread.Func(Thread.Param);
+	return nullptr;
+}
+
+ServerPlatform::ThreadID Linux_CreateThread(void (*Func)(void*), void* Param)
+{
+	return PlatformThreads.Create(Func, Param, [](PlatformThreadTable<pthread_t>::Thread& Thread)
+	{
+		int Error = pthread_create(&Thread.Handle, nullptr, PlatformThread_Func, &Thread);
+		if (Error != 0)
+		{
+			std::cerr << "Failed to create platform thread. Error Code: " << Error << "\n";
+			return false;
+		}
+		return true;
+	});
+}
+
+// Waits for the thread's function to return then releases its ID. The ID is set to Invalid afterwards.
+void Linux_DestroyThread(ServerPlatform::ThreadID& ThreadToDestroy)
+{
+	PlatformThreads.Destroy(ThreadToDestroy, [](pthread_t& Handle)
+	{
+		pthread_join(Handle, nullptr);
+	});
+}
+
+// Loads the file at Path (relative to the working directory) into TargetMemory.
+bool Linux_LoadStoredData(ServerPlatform::StorePath Path, size_t MaxSize, byte* TargetMemory, size_t& LoadedSize)
+{
+	LoadedSize = 0;
+
+	FILE* StoredFile = fopen(Path, "rb");
+	if (nullptr == StoredFile)
+	{
+		return false;
+	}
+
+	fseek(StoredFile, 0, SEEK_END);
+	long StoredSize = ftell(StoredFile);
+	fseek(StoredFile, 0, SEEK_SET);
+
+	bool bSuccess = StoredSize >= 0 && static_cast<size_t>(StoredSize) <= MaxSize
+		&& fread(TargetMemory, 1, StoredSize, StoredFile) == static_cast<size_t>(StoredSize);
+	if (bSuccess)
+	{
+		LoadedSize = StoredSize;
+	}
+
+	fclose(StoredFile);
+	return bSuccess;
+}
+
+// Stores data at Path (relative to the working directory). Data is written to a temporary file first then renamed so a
+// crash mid-write never leaves a truncated store behind.
+bool Linux_StoreData(ServerPlatform& Platform, ServerPlatform::StorePath Path, size_t Size, byte* SourceMemory)
+{
+	char TempPath[4096];
+	if (snprintf(TempPath, sizeof(TempPath), "%s.tmp", Path) >= static_cast<int>(sizeof(TempPath)))
+	{
+		return false;
+	}
+
+	FILE* StoredFile = fopen(TempPath, "wb");
+	if (nullptr == StoredFile)
+	{
+		return false;
+	}
+
+	bool bSuccess = fwrite(SourceMemory, 1, Size, StoredFile) == Size;
+	bSuccess = fclose(StoredFile) == 0 && bSuccess;
+
+	return bSuccess && rename(TempPath, Path) == 0;
+}
+
+extern bool LinuxNet_Init(const ServerConfig& Config);
+extern void LinuxNet_RegisterPlatformFunctions(ServerPlatform& Platform);
+extern void LinuxNet_Shutdown();
+extern int LinuxNet_GetServerWorkEventHandle();
+extern void LinuxNet_AcknowledgeServerWork();
+
+// Reads the Server Config from the file at Path if there is one. Otherwise, OutConfig keeps its default values.
+// Returns false if the file exists but could not be read or parsed.
+bool Linux_LoadServerConfig(const char* Path, ServerConfig& OutConfig)
+{
+	char ConfigText[16 * 1024];
+	size_t ConfigTextLength = 0;
+	errno = 0;
+	if (!Linux_LoadStoredData(const_cast<char*>(Path), sizeof(ConfigText), reinterpret_cast<byte*>(ConfigText), ConfigTextLength))
+	{
+		if (errno == ENOENT)
+		{
+			std::cout << "No Server Config found at " << Path << ", using defaults.\n";
+			return true;
+		}
+
+		std::cerr << "Failed to read Server Config at " << Path << ".\n";
+		return false;
+	}
+
+	std::cout << "Loading Server Config from " << Path << "...\n";
+	return ParseServerConfig(ConfigText, ConfigTextLength, OutConfig);
+}
+
+// Initialize Linux Platform & return ServerPlatform data structure. Returns whether initialization was successful.
+bool Linux_InitPlatform(ServerPlatform& OutPlatform, const ServerConfig& Config)
+{
+	std::cout << "Initializing Linux Platform...\n";
+
+	// Catch termination signals so the Server gets shut down properly, and ignore broken pipes (handled on send).
+	{
+		struct sigaction TerminationAction = {};
+		TerminationAction.sa_handler = HandleTerminationSignal;
+		sigemptyset(&TerminationAction.sa_mask);
+		sigaction(SIGINT, &TerminationAction, nullptr);
+		sigaction(SIGTERM, &TerminationAction, nullptr);
+
+		signal(SIGPIPE, SIG_IGN);
+	}
+
+	OutPlatform.ShutdownProgram = RequestProgramShutdown;
+
+	// Prepare Memory footprint
+	// Provide the server with the memory its Config requires.
+	// #TODO(Marc): Should be able to pass Platform Capabilities to the Server code so it can return both whether Server
+	// can run at all, and if it can, how well and how much memory it should take up.
+	size_t RequestedServerMemory = GetRequiredServerMemory(Config);
+
+	void* MappedMemory = mmap(nullptr, RequestedServerMemory, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (MAP_FAILED == MappedMemory)
+	{
+		std::cerr << "Failed to allocate memory when initializing Linux Platform. Error Code:" << errno << "\n";
+		return false;
+	}
+	OutPlatform.Memory = static_cast<byte*>(MappedMemory);
+	OutPlatform.MemorySize = RequestedServerMemory;
+	// Anonymous mappings are backed by zero pages until first written to.
+	OutPlatform.bMemoryZeroed = true;
+
+	// Prepare Data Storage
+	OutPlatform.LoadStoredData = Linux_LoadStoredData;
+	OutPlatform.StoreData = Linux_StoreData;
+
+	// Prepare Threading Services
+	OutPlatform.CreateThread = Linux_CreateThread;
+	OutPlatform.DestroyThread = Linux_DestroyThread;
+
+	// Prepare Network Services & Data
+	if (!LinuxNet_Init(Config))
+	{
+		std::cerr << "Failed to initialize Linux Networking.\n";
+		return false;
+	}
+	LinuxNet_RegisterPlatformFunctions(OutPlatform);
+
+	return true;
+}
+
+// Free up all system resources.
+void EndProgram(ServerPlatform& Platform)
+{
+	LinuxNet_Shutdown();
+
+	if (nullptr != Platform.Memory)
+	{
+		munmap(Platform.Memory, Platform.MemorySize);
+		Platform.Memory = nullptr;
+		Platform.MemorySize = 0;
+	}
+
+	std::cout.flush();
+}
+
+double GetMonotonicTimeSeconds()
+{
+	timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return static_cast<double>(Time.tv_sec) + static_cast<double>(Time.tv_nsec) / 1e9;
+}
+
+// Sleeps until WakeTime on the monotonic clock, or until Net Threads post work for the Server if ServerWorkEventHandle is
+// valid. Termination signals cut the wait short too. Returns whether Server work was posted.
+bool Linux_WaitForTickOrServerWork(int TickTimerHandle, int ServerWorkEventHandle, double WakeTime)
+{
+	// The timer is armed on an absolute time, so that however long it takes to get here, it goes off right on time.
+	itimerspec TimerSetting = {};
+	TimerSetting.it_value.tv_sec = static_cast<time_t>(WakeTime);
+	TimerSetting.it_value.tv_nsec = static_cast<long>((WakeTime - static_cast<double>(TimerSetting.it_value.tv_sec)) * 1e9);
+	timerfd_settime(TickTimerHandle, TFD_TIMER_ABSTIME, &TimerSetting, nullptr);
+
+	pollfd WaitedHandles[2] = { { TickTimerHandle, POLLIN, 0 }, { ServerWorkEventHandle, POLLIN, 0 } };
+	nfds_t WaitedHandleCount = ServerWorkEventHandle != -1 ? 2 : 1;
+	if (poll(WaitedHandles, WaitedHandleCount, -1) <= 0)
+	{
+		return false;
+	}
+
+	if (WaitedHandles[0].revents & POLLIN)
+	{
+		uint64_t ExpirationCount;
+		read(TickTimerHandle, &ExpirationCount, sizeof(ExpirationCount));
+	}
+	return WaitedHandleCount > 1 && (WaitedHandles[1].revents & POLLIN);
+}
+
+int main(int argc, char** argv)
+{
+	// Config Loading. The Config file path can be passed as first argument.
+	ServerConfig Config;
+	const char* ConfigPath = argc > 1 ? argv[1] : "ServerConfig.cfg";
+	if (!Linux_LoadServerConfig(ConfigPath, Config))
+	{
+		std::cerr << "Invalid Server Config ! Ending program...\n";
+		return 1;
+	}
+
+	// Run a job worker per processor unless the Config asks for a given count.
+	if (Config.JobWorkerCount == 0)
+	{
+		long ProcessorCount = sysconf(_SC_NPROCESSORS_ONLN);
+		Config.JobWorkerCount = ProcessorCount > 0 ? static_cast<size_t>(ProcessorCount) : 1;
+	}
+
+	// Platform Initialization
+	ServerPlatform Platform;
+	if (!Linux_InitPlatform(Platform, Config))
+	{
+		std::cerr << "Linux Platform Initialization failed ! Ending program...\n";
+		EndProgram(Platform);
+		return 1;
+	}
+
+	// Server Initialization - Call linked InitializeServer function and retrieve a GameServerPtr pointer (void*)
+	// that can be passed to further Server Flow Control calls.
+	std::cout << "Initializing Server...\n";
+	GameServerPtr Server;
+	if (!InitializeServer(Platform, Config, Server))
+	{
+		std::cout << "Failed to initialize server. Shutting program down.\n";
+		EndProgram(Platform);
+		return 1;
+	}
+
+	// Platform & Server Main loop
+	// The Server ticks at a fixed rate, always passed the same DeltaTime. Between ticks, the main thread sleeps until the
+	// next one is due, unless the network posts work for the Server first: that work is then handled right away, by an
+	// update that lets no time pass.
+	TickScheduler Scheduler;
+	int TickTimerHandle = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (TickTimerHandle == -1 || !Scheduler.Initialize(Config.TickRate, GetMonotonicTimeSeconds()))
+	{
+		std::cerr << "Failed to schedule Server ticks. Shutting program down.\n";
+		ShutdownServer(Server, ShutdownReason::PLATFORM_SHUTDOWN);
+		EndProgram(Platform);
+		return 1;
+	}
+	int ServerWorkEventHandle = Config.TickWakeOnNetwork != 0 ? LinuxNet_GetServerWorkEventHandle() : -1;
+
+	// Timer slack would let the kernel delay every wake-up by up to 50us by default, to group them with others.
+	prctl(PR_SET_TIMERSLACK, 1);
+
+	while (!bServerShutdown)
+	{
+		bool bServerWorkPosted = Linux_WaitForTickOrServerWork(TickTimerHandle, ServerWorkEventHandle, Scheduler.NextTickTime);
+
+		double Now = GetMonotonicTimeSeconds();
+		if (Scheduler.IsTickDue(Now))
+		{
+			// Acknowledge work first: this update handles it along with anything posted before it reads net data.
+			if (ServerWorkEventHandle != -1)
+			{
+				LinuxNet_AcknowledgeServerWork();
+			}
+			UpdateServer(Server, Scheduler.BeginTick(Now));
+			Scheduler.EndTick(Now, GetMonotonicTimeSeconds());
+		}
+		else if (bServerWorkPosted)
+		{
+			LinuxNet_AcknowledgeServerWork();
+			UpdateServer(Server, 0.0);
+			Scheduler.WakeUpdateCount++;
+		}
+	}
+	close(TickTimerHandle);
+
+	// Cleanup & Shutdown
+	std::cout << "Shutting down Server...\n";
+	Scheduler.PrintStats();
+	ShutdownServer(Server, ProgramShutdownReason);
+	EndProgram(Platform);
+
+	return 0;
+}
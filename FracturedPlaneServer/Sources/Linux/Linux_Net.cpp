@@ -0,0 +1,1901 @@
+// Linux_Net.cpp
+// Network services of the Linux Platform.
+// Reception is split between Net Workers, each running its own Net Thread. A worker owns every connection it accepts: its
+// epoll instance watches its own listen socket and their sockets, and their data is received into its own Reception
+// Buffers. Listen sockets share the port through SO_REUSEPORT so the kernel spreads new connections between workers, which
+// never wait on each other except when taking a free Connection ID.
+// All sockets are non-blocking and registered as edge-triggered, so a wake-up only ever touches the sockets that are
+// actually ready.
+// Net Threads are the only threads opening and closing sockets. Connection events reach the Server through lock-free
+// rings, and other threads ask for connections to be closed by queuing a request and waking the owning worker up.
+// Every per-connection table is sized from the Server Config, and nothing scales with the connection count except when
+// handling that connection, so a single instance can hold many thousands of mostly idle connections.
+// When the Server Config asks for it and the kernel supports it, workers and the Sending Thread go through io_uring instead
+// of epoll and per-socket calls: a multishot accept and one multishot receive per connection stay armed, data lands in
+// buffers the kernel picks from a ring shared with the worker, and a Sending Slot goes out in a single submission.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "atomic"
+#include "condition_variable"
+#include "iostream"
+#include "mutex"
+#include "new"
+#include "thread"
+#include "type_traits"
+
+#include "Linux/Linux_IoUring.h"
+#include "ServerFramework/ServerPlatform.h"
+#include "ServerFramework/NetStreamReassembler.h"
+#include "ServerFramework/SPSCRing.h"
+
+#define INVALID_SOCKET_HANDLE (-1)
+
+#define LISTEN_BACKLOG SOMAXCONN
+
+// File descriptors kept for everything but connection sockets and Net Workers (stored data, standard streams...).
+#define RESERVED_FILE_DESCRIPTOR_COUNT 64
+
+// File descriptors held by each Net Worker: epoll instance or io_uring, wake-up event and listen socket.
+#define FILE_DESCRIPTORS_PER_NET_WORKER 3
+
+// Greatest NetWorkerCount allowed by the Server Config. Worker indices are stored alongside each connection in 8 bits.
+#define MAX_NET_WORKER_COUNT 64
+
+// Maximum number of ready sockets handled per wake-up of the Net Thread.
+#define MAX_EPOLL_EVENTS_PER_WAIT 256
+
+// How long a blocked send may wait for its socket to become writable again before the connection is dropped.
+#define SEND_BLOCKED_TIMEOUT_MS 1000
+
+// Epoll user data tags for the non-connection file descriptors. Connection sockets are tagged with their Connection ID,
+// which always fits in 16 bits.
+constexpr uint64_t EPOLL_TAG_LISTEN_SOCKET = 1ull << 32;
+constexpr uint64_t EPOLL_TAG_WAKE_EVENT = (1ull << 32) + 1;
+
+// io_uring backend sizing. Each Net Worker's ring can prepare this many operations between two submissions.
+#define IO_URING_SUBMISSION_COUNT 256
+
+// Buffers each Net Worker provides for receiving. A receive completion takes one, which is given back as soon as its data
+// was copied into the Reception Buffer, so only completions waiting to be handled hold any.
+#define IO_URING_RECEPTION_BUFFER_COUNT 1024
+#define IO_URING_RECEPTION_BUFFER_SIZE 4096
+#define IO_URING_RECEPTION_BUFFER_GROUP 0
+
+// Sends the Sending Thread has in flight at once. Each takes two entries of its ring: the send and its linked timeout.
+#define IO_URING_MAX_SENDS_IN_FLIGHT 512
+
+// How long a Net Worker waits before accepting again after its multishot accept failed, e.g. out of file descriptors.
+#define IO_URING_ACCEPT_RETRY_DELAY_MS 100
+
+// io_uring user data tags for everything but receptions, which are tagged with their Connection ID like epoll events.
+constexpr uint64_t IO_URING_TAG_ACCEPT = 1ull << 32;
+constexpr uint64_t IO_URING_TAG_ACCEPT_RETRY = (1ull << 32) + 1;
+constexpr uint64_t IO_URING_TAG_WAKE_EVENT = (1ull << 32) + 2;
+constexpr uint64_t IO_URING_TAG_SEND_TIMEOUT = (1ull << 32) + 3;
+
+// Operations the io_uring backend relies on. Multishot receives have no opcode of their own: they came along with
+// zero-copy sends, whose support stands for theirs.
+const uint8_t IO_URING_REQUIRED_OPERATIONS[] = { IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_READ, IORING_OP_SENDMSG,
+	IORING_OP_LINK_TIMEOUT, IORING_OP_SEND_ZC };
+
+// Set by LinuxNet_Init when the io_uring backend is in use, never changed while network threads run.
+bool bUseIoUring = false;
+
+std::atomic<bool> bNetThreadRunning = false; // Shared by the Net Threads of every worker.
+
+std::atomic<bool> bSendingThreadRunning = false;
+pthread_t SendingThreadHandle;
+
+// eventfd signaled whenever Net Threads hand the Server new work (packets, connection events), so that the main loop can
+// wake up before its next tick. Signals are coalesced: only the first one since the main loop last acknowledged work
+// writes to the eventfd, every later one only finds the flag already set.
+int ServerWorkEventHandle = INVALID_SOCKET_HANDLE;
+std::atomic<bool> bServerWorkPosted = false;
+
+struct LinuxNetConnection
+{
+	ServerPlatform::ConnectionID ID;
+
+	// Socket the Sending Thread sends to. Set to Invalid before the socket is shut down, so that the Sending Thread stops
+	// picking it up.
+	std::atomic<int> SocketHandle;
+
+	// Socket of a connection being closed, only shut down so far. Its file descriptor stays taken until the Sending
+	// Thread can't be sending to it anymore, so that it can't be handed to a new connection in the meantime.
+	int ClosingSocketHandle;
+	sockaddr_in Address;
+	char AddressString[INET_ADDRSTRLEN + 8];
+
+	// Index of the Net Worker owning the connection. Set when accepted, read by any thread wanting to close it.
+	std::atomic<uint8_t> WorkerIndex;
+
+	// Set by any thread wanting the connection closed, so that it only gets queued once.
+	std::atomic<bool> bCloseRequested;
+
+	// io_uring backend only, touched by the owning Net Thread alone. A connection keeps its socket and ID until its
+	// multishot receive has ended, so that no completion can ever reach the next connection given the same ID.
+	bool bReceptionArmed;
+	bool bClosing; // Socket was shut down, waiting for the last completion of its receive.
+};
+
+// Connection IDs are indices into every per-connection table below, which all hold MaxConnectionCount entries.
+// The tables are carved out of a single anonymous mapping: pages only get backed by memory once written to, so tables
+// indexed by ID only cost memory for the connections actually used.
+size_t MaxConnectionCount = 0;
+byte* ConnectionTablesMemory = nullptr;
+size_t ConnectionTablesMemorySize = 0;
+
+LinuxNetConnection* ActiveConnections = nullptr;
+
+// IDs available to new connections, produced by the Server in ClearNetEvents and consumed by Net Threads when accepting.
+// Net Threads take turns popping through the mutex, which is only ever held for a single pop. A closed connection's ID
+// only comes back once the Server has read its Disconnection event, so the Server never sees events of two different
+// connections mixed up.
+SPSCRing<ServerPlatform::ConnectionID> FreeConnectionIDRing;
+std::mutex Mutex_FreeConnectionIDs;
+
+// IDs whose Disconnection event was read, in order, each with the count of Sending Slots handed over to the Sending
+// Thread by then. Later slots can't reach their socket, so it gets closed and the ID freed once the Sending Thread has
+// sent that many slots. Only accessed by the Server thread.
+ServerPlatform::ConnectionID* DrainingConnectionIDs = nullptr;
+uint64_t* DrainingConnectionSlotCounts = nullptr;
+size_t FirstDrainingConnectionIndex = 0;
+size_t DrainingConnectionCount = 0;
+
+// Events handed over to the Server by the last ReadNetEvents call. Only accessed by the Server thread.
+ServerPlatform::ConnectionID* ReadConnectionEvents = nullptr;
+size_t ReadConnectionEventsCount = 0;
+ServerPlatform::ConnectionID* ReadDisconnectionEvents = nullptr;
+size_t ReadDisconnectionEventsCount = 0;
+
+// Reception Buffers are the Platform's own: the Server only ever reads the packets they describe. Data that doesn't fit
+// before the Server swaps buffers is dropped, and counted in the Net Reception stats.
+#define RECEPTION_BUFFER_SIZE (1024 * 64) // 64kb
+static_assert(RECEPTION_BUFFER_SIZE % sizeof(FPCore::Net::PacketBodySize_t) == 0, "STATIC ASSERTION FAILURE: RECEPTION_BUFFER_SIZE must be dividable by PACKET_MAX_SIZE !");
+
+// Received data is double buffered: the Net Thread fills one buffer while the Server reads the other. Buffers are swapped
+// when the Server starts reading, so reception never has to wait for the Server to be done with its data.
+#define RECEPTION_BUFFER_COUNT 2
+
+// Packets are received straight into a Reception Buffer and left there. Each is described by a Packet Descriptor, which
+// is all the Server reads before going for the body. Every packet takes at least a head's worth of data, which bounds
+// how many descriptors a buffer may need.
+#define MAX_PACKETS_PER_RECEPTION_BUFFER (RECEPTION_BUFFER_SIZE / sizeof(FPCore::Net::NetEncodedPacketHead))
+
+struct ReceptionBufferData
+{
+	alignas(FPCore::Net::NetEncodedPacketHead) uint8_t Data[RECEPTION_BUFFER_SIZE];
+	size_t ReceivedBytes; // Bytes received since this buffer was last handed over to the Server.
+
+	NetPacketDescriptor Packets[MAX_PACKETS_PER_RECEPTION_BUFFER];
+	size_t PacketCount;
+};
+
+// Received data that doesn't fit in the Reception Buffer being written to lands here, to be dropped.
+#define OVERFLOW_BUFFER_SIZE (1 << 16)
+
+#define NO_RECEPTION_BUFFER (~static_cast<size_t>(0))
+
+// A Net Thread along with everything it needs to own a share of the connections.
+struct LinuxNetWorker
+{
+	uint8_t Index;
+	pthread_t ThreadHandle;
+	bool bThreadCreated;
+
+	int EpollHandle;
+	int ListenSocketHandle;
+	int WakeEventHandle; // eventfd used to wake up the Net Thread on close requests and shutdown.
+
+	// Connection & Disconnection events of the worker's connections, consumed by the Server in ReadNetEvents.
+	// A connection ID has at most one event of each type in flight, so the rings can never be full.
+	SPSCRing<ServerPlatform::ConnectionID> ConnectionEventRing;
+	SPSCRing<ServerPlatform::ConnectionID> DisconnectionEventRing;
+
+	// ID taken from the free ring but left unused, to be given to the next accepted connection.
+	ServerPlatform::ConnectionID SpareConnectionID;
+
+	// Connections of this worker other threads asked to close, in request order. A connection is queued once per raised
+	// request flag, and a stale request may linger for a reused ID, hence room for two requests per connection.
+	std::mutex Mutex_CloseRequests;
+	ServerPlatform::ConnectionID* CloseRequests;
+	size_t CloseRequestCount;
+	ServerPlatform::ConnectionID* HandledCloseRequests; // Copy of the queue being handled. Net Thread only.
+
+	// The worker's Reception Shard: data received on its connections, double buffered.
+	// The Net Thread announces the buffer it writes to in WritingReceptionBufferIndex for as long as it writes to it. The
+	// Server swaps buffers by moving WriteReceptionBufferIndex on, then only has to wait for a write to the previous buffer
+	// that was already under way, which never spans more than a single recv. Neither side ever takes a lock, so a Net
+	// Thread busy draining its sockets can't hold the Server up.
+	ReceptionBufferData* ReceptionBuffers; // Holds RECEPTION_BUFFER_COUNT buffers.
+	std::atomic<size_t> WriteReceptionBufferIndex; // Only changed by the Server.
+	std::atomic<size_t> WritingReceptionBufferIndex; // Only changed by the Net Thread. NO_RECEPTION_BUFFER when not writing.
+
+	// Reception counters, updated by the Net Thread.
+	std::atomic<uint64_t> ReceivedPacketCount;
+	std::atomic<uint64_t> DroppedReceptionCount;
+	std::atomic<uint64_t> DroppedByteCount;
+
+	// Reception Buffer occupancy, only accessed by the Server.
+	size_t LastReadOccupancy;
+	size_t PeakReadOccupancy;
+
+	char* OverflowBuffer; // Holds OVERFLOW_BUFFER_SIZE bytes. Net Thread only.
+
+	// io_uring backend only. Used by the Net Thread alone once created.
+	LinuxIoUring IoUring;
+	LinuxIoUringBufferRing ReceptionBufferRing;
+	uint64_t WakeValue; // Where wake-up event reads land.
+};
+
+LinuxNetWorker NetWorkers[MAX_NET_WORKER_COUNT];
+size_t NetWorkerCount = 0;
+uint16_t ListenPort = 0;
+
+// Shards handed over to the Server by the last ReadNetReceptionBuffers call, one per worker.
+NetReceptionShard ReadReceptionShards[MAX_NET_WORKER_COUNT];
+
+// Incomplete packets received on each connection, waiting for the rest of their bytes. Reset when a connection is
+// accepted, otherwise only touched by the Net Thread of the worker owning the connection.
+NetStreamReassembler* ConnectionReassemblers = nullptr;
+
+// Outgoing data is written by the Server into one of several Sending Slots. Filled slots are handed over to the Sending
+// Thread, which sends them out in order then hands them back, so the Server never waits on a slow socket.
+#define SENDING_SLOT_COUNT 4
+#define INVALID_SENDING_SLOT 0xFF
+
+struct SendingSlot
+{
+	byte* Data; // SendingBufferSize bytes, starting on a packet head boundary.
+	size_t BytesToSend;
+};
+
+// Every Sending Slot is as large as the Server's Packet Write Buffer. Every packet is at least a head, which bounds how
+// many packets a single slot can hold.
+size_t SendingBufferSize = 0;
+size_t MaxPacketsPerSendingSlot = 0;
+
+SendingSlot SendingSlots[SENDING_SLOT_COUNT];
+
+FixedSPSCRing<uint8_t, SENDING_SLOT_COUNT> FilledSendingSlotRing; // Server -> Sending Thread.
+FixedSPSCRing<uint8_t, SENDING_SLOT_COUNT> FreeSendingSlotRing; // Sending Thread -> Server.
+uint8_t WriteSendingSlotIndex = INVALID_SENDING_SLOT; // Slot currently being filled. Only accessed by the Server thread.
+uint64_t HandedOverSendingSlotCount = 0; // Only accessed by the Server thread.
+std::atomic<uint64_t> SentSendingSlotCount = { 0 }; // Only written by the Sending Thread.
+
+// Per-connection bookkeeping used to group the packets of a Sending Slot by connection. Only accessed by the Sending
+// Thread, and left zeroed between slots.
+ServerPlatform::ConnectionID* DestinationConnections = nullptr; // In order of first packet.
+size_t* ConnectionPacketCounts = nullptr;
+size_t* ConnectionNextPacketIndices = nullptr;
+
+// Every packet of the slot being sent, its encoded head and the vectors sending its head then body. Only accessed by the
+// Sending Thread.
+const byte** PacketLocations = nullptr;
+FPCore::Net::NetEncodedPacketHead* EncodedPacketHeads = nullptr;
+iovec* PacketVectors = nullptr;
+
+// io_uring backend only: the Sending Thread's ring, and the send of each destination connection in DestinationConnections
+// order, its vectors consumed as data goes out.
+struct IoUringSend
+{
+	msghdr Message;
+	iovec* Vectors;
+	size_t VectorCount;
+};
+
+LinuxIoUring SendingIoUring;
+IoUringSend* DestinationSends = nullptr;
+
+// Only used for the Sending Thread to sleep until filled slots are available. Never held while sending.
+std::mutex Mutex_NetDataSending;
+std::condition_variable Event_DataReadyForSending;
+bool bDataReadyForSending = false;
+
+// Lays every per-connection, per-worker and Sending Slot table out from Base and returns the size they take altogether. Only measures
+// them when Base is null.
+size_t LayOutConnectionTables(byte* Base)
+{
+	size_t LayoutSize = 0;
+	auto PlaceTable = [Base, &LayoutSize](auto*& OutTable, size_t Count)
+	{
+		typedef typename std::remove_reference<decltype(*OutTable)>::type TableEntry;
+		LayoutSize = (LayoutSize + alignof(TableEntry) - 1) & ~(alignof(TableEntry) - 1);
+		OutTable = nullptr == Base ? nullptr : reinterpret_cast<TableEntry*>(Base + LayoutSize);
+		LayoutSize += Count * sizeof(TableEntry);
+	};
+
+	size_t EventRingCapacity = SPSCRing<ServerPlatform::ConnectionID>::GetCapacityFor(MaxConnectionCount);
+	ServerPlatform::ConnectionID* FreeConnectionIDSlots;
+	byte* ReassemblyMemory;
+
+	PlaceTable(ActiveConnections, MaxConnectionCount);
+	PlaceTable(FreeConnectionIDSlots, EventRingCapacity);
+	PlaceTable(DrainingConnectionIDs, MaxConnectionCount);
+	PlaceTable(DrainingConnectionSlotCounts, MaxConnectionCount);
+	PlaceTable(ReadConnectionEvents, MaxConnectionCount);
+	PlaceTable(ReadDisconnectionEvents, MaxConnectionCount);
+	PlaceTable(ConnectionReassemblers, MaxConnectionCount);
+	PlaceTable(DestinationConnections, MaxConnectionCount);
+	PlaceTable(ConnectionPacketCounts, MaxConnectionCount);
+	PlaceTable(ConnectionNextPacketIndices, MaxConnectionCount);
+	PlaceTable(DestinationSends, MaxConnectionCount);
+	PlaceTable(PacketLocations, MaxPacketsPerSendingSlot);
+	PlaceTable(EncodedPacketHeads, MaxPacketsPerSendingSlot);
+	PlaceTable(PacketVectors, MaxPacketsPerSendingSlot * 2);
+
+	// Any connection may end up on any worker, so each worker's tables can hold every connection.
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		ServerPlatform::ConnectionID* ConnectionEventSlots;
+		ServerPlatform::ConnectionID* DisconnectionEventSlots;
+
+		PlaceTable(ConnectionEventSlots, EventRingCapacity);
+		PlaceTable(DisconnectionEventSlots, EventRingCapacity);
+		PlaceTable(Worker.CloseRequests, MaxConnectionCount * 2);
+		PlaceTable(Worker.HandledCloseRequests, MaxConnectionCount * 2);
+		PlaceTable(Worker.ReceptionBuffers, RECEPTION_BUFFER_COUNT);
+		PlaceTable(Worker.OverflowBuffer, OVERFLOW_BUFFER_SIZE);
+
+		if (nullptr != Base)
+		{
+			Worker.ConnectionEventRing.Initialize(ConnectionEventSlots, EventRingCapacity);
+			Worker.DisconnectionEventRing.Initialize(DisconnectionEventSlots, EventRingCapacity);
+		}
+	}
+
+	PlaceTable(ReassemblyMemory, MaxConnectionCount * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+
+	// Slots are rounded up to whole packet heads, so that each one starts on a head boundary.
+	size_t SendingSlotHeadCount = (SendingBufferSize + sizeof(FPCore::Net::PacketHead) - 1) / sizeof(FPCore::Net::PacketHead);
+	FPCore::Net::PacketHead* SendingSlotMemory;
+	PlaceTable(SendingSlotMemory, SENDING_SLOT_COUNT * SendingSlotHeadCount);
+
+	if (nullptr != Base)
+	{
+		for (uint8_t SlotIndex = 0; SlotIndex < SENDING_SLOT_COUNT; SlotIndex++)
+		{
+			SendingSlots[SlotIndex].Data = reinterpret_cast<byte*>(SendingSlotMemory + SlotIndex * SendingSlotHeadCount);
+		}
+
+		FreeConnectionIDRing.Initialize(FreeConnectionIDSlots, EventRingCapacity);
+
+		for (size_t ConnectionIndex = 0; ConnectionIndex < MaxConnectionCount; ConnectionIndex++)
+		{
+			new (&ConnectionReassemblers[ConnectionIndex]) NetStreamReassembler();
+			ConnectionReassemblers[ConnectionIndex].Initialize(ReassemblyMemory + ConnectionIndex * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+		}
+	}
+
+	return LayoutSize;
+}
+
+// Returns an ID for a new connection of the worker, or INVALID_ID if every ID is in use. Only called from the worker's
+// Net Thread.
+ServerPlatform::ConnectionID FindAvailableClientIndex(LinuxNetWorker& Worker)
+{
+	ServerPlatform::ConnectionID ClientIndex = Worker.SpareConnectionID;
+	if (ClientIndex != ServerPlatform::INVALID_ID)
+	{
+		Worker.SpareConnectionID = ServerPlatform::INVALID_ID;
+		return ClientIndex;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_FreeConnectionIDs);
+		if (FreeConnectionIDRing.Pop(ClientIndex))
+		{
+			return ClientIndex;
+		}
+	}
+
+	std::cerr << "Error: Maximum number of connections reached!\n";
+	return ServerPlatform::INVALID_ID;
+}
+
+bool SetSocketNonBlocking(int SocketHandle)
+{
+	int Flags = fcntl(SocketHandle, F_GETFL, 0);
+	return Flags != -1 && fcntl(SocketHandle, F_SETFL, Flags | O_NONBLOCK) != -1;
+}
+
+// Lets the main loop know that the Server has new work. Callable from any Net Thread.
+void PostServerWork()
+{
+	if (!bServerWorkPosted.exchange(true, std::memory_order_release))
+	{
+		uint64_t PostValue = 1;
+		write(ServerWorkEventHandle, &PostValue, sizeof(PostValue));
+	}
+}
+
+// Shuts the connection's socket down and queues a Disconnection event for the Server. The socket is only closed, and the
+// connection ID released, in ClearNetEvents once the Sending Thread is done with them. Only called from the Net Thread of
+// the worker owning the connection, or once it has stopped. On io_uring, the event of a connection still receiving is
+// only queued once its receive has ended.
+void Disconnect(LinuxNetWorker& Worker, ServerPlatform::ConnectionID ConnectionID)
+{
+	if (ConnectionID >= MaxConnectionCount)
+	{
+		return;
+	}
+
+	// The Sending Thread stops picking the socket up before it gets shut down.
+	LinuxNetConnection& Connection = ActiveConnections[ConnectionID];
+	int ClosedSocketHandle = Connection.SocketHandle.exchange(INVALID_SOCKET_HANDLE);
+	if (ClosedSocketHandle != INVALID_SOCKET_HANDLE)
+	{
+		// Stop watching the socket and signal the end of the stream. Sends still under way fail from here on.
+		Connection.ClosingSocketHandle = ClosedSocketHandle;
+		if (!bUseIoUring)
+		{
+			epoll_ctl(Worker.EpollHandle, EPOLL_CTL_DEL, ClosedSocketHandle, nullptr);
+		}
+		shutdown(ClosedSocketHandle, SHUT_RDWR);
+	}
+	else if (!Connection.bClosing)
+	{
+		// Already disconnected.
+		return;
+	}
+	ClosedSocketHandle = Connection.ClosingSocketHandle;
+
+	// Shutting the socket down ends its receive, whose last completion comes back here to finish the job.
+	if (bUseIoUring && Connection.bReceptionArmed)
+	{
+		Connection.bClosing = true;
+		return;
+	}
+	Connection.bClosing = false;
+
+	// Add connection to the Disconnection ring so that its disconnection can be acknowledged by the Server, at which
+	// point its ID will be released. If the Server has not read its Connection event yet, it will read both at once.
+	if (!Worker.DisconnectionEventRing.Push(ConnectionID))
+	{
+		std::cerr << "Error: Disconnection Event ring is full ! Connection ID " << ConnectionID << " will not be released.\n";
+	}
+	PostServerWork();
+
+	// Clear connection data
+	Connection.Address = {};
+	memset(Connection.AddressString, 0, sizeof(Connection.AddressString));
+
+	std::cout << "Socket ID " << ClosedSocketHandle << " closed.\n";
+}
+
+// Platform-facing version of Disconnect, callable from any thread. Queues a close request and wakes the Net Thread of
+// the worker owning the connection up so it closes the connection.
+void CloseConnection(ServerPlatform::ConnectionID ConnectionID)
+{
+	if (ConnectionID >= MaxConnectionCount
+		|| ActiveConnections[ConnectionID].bCloseRequested.exchange(true, std::memory_order_acq_rel))
+	{
+		// Already on its way to being closed.
+		return;
+	}
+
+	LinuxNetWorker& Worker = NetWorkers[ActiveConnections[ConnectionID].WorkerIndex.load(std::memory_order_relaxed)];
+	{
+		std::lock_guard<std::mutex> Lock(Worker.Mutex_CloseRequests);
+		if (Worker.CloseRequestCount == MaxConnectionCount * 2)
+		{
+			std::cerr << "Error: Close Request queue is full ! Connection ID " << ConnectionID << " will not be closed.\n";
+			return;
+		}
+		Worker.CloseRequests[Worker.CloseRequestCount++] = ConnectionID;
+	}
+
+	uint64_t WakeValue = 1;
+	write(Worker.WakeEventHandle, &WakeValue, sizeof(WakeValue));
+}
+
+// Closes every connection of the worker queued by CloseConnection since the last wake-up. The wake-up event has to be
+// read beforehand.
+void HandleCloseRequests(LinuxNetWorker& Worker)
+{
+	size_t HandledCloseRequestCount;
+	{
+		std::lock_guard<std::mutex> Lock(Worker.Mutex_CloseRequests);
+		HandledCloseRequestCount = Worker.CloseRequestCount;
+		memcpy(Worker.HandledCloseRequests, Worker.CloseRequests, HandledCloseRequestCount * sizeof(ServerPlatform::ConnectionID));
+		Worker.CloseRequestCount = 0;
+	}
+
+	for (size_t RequestIndex = 0; RequestIndex < HandledCloseRequestCount; RequestIndex++)
+	{
+		// Requests left over from a previous connection with the same ID had their flag cleared when the ID got reused,
+		// and are left alone if the ID now belongs to another worker.
+		ServerPlatform::ConnectionID ConnectionID = Worker.HandledCloseRequests[RequestIndex];
+		if (ActiveConnections[ConnectionID].WorkerIndex.load(std::memory_order_relaxed) == Worker.Index
+			&& ActiveConnections[ConnectionID].bCloseRequested.exchange(false, std::memory_order_acquire))
+		{
+			Disconnect(Worker, ConnectionID);
+		}
+	}
+}
+
+// Receives the next bytes available on a connection and describes every packet they complete in WriteBuffer. Bytes are
+// received straight into the Reception Buffer, right after a copy of the connection's incomplete packet, so that every
+// packet body is handed to the Server where it was received.
+// When the Reception Buffer can't hold the incomplete packet once complete, bytes are received into the Overflow Buffer
+// instead and the packets they complete are dropped, which keeps the stream in sync.
+// Returns the result of the recv call.
+ssize_t ReceiveNetDataIntoBuffer(LinuxNetWorker& Worker, ReceptionBufferData& WriteBuffer, ServerPlatform::ConnectionID ConnectionID)
+{
+	NetStreamReassembler& Reassembler = ConnectionReassemblers[ConnectionID];
+	int SocketHandle = ActiveConnections[ConnectionID].SocketHandle;
+
+	bool bValidStream;
+	ssize_t ReceivedBytesCount;
+	uint64_t ReceivedPacketCount = 0;
+	uint64_t DroppedReceptionCount = 0;
+	uint64_t DroppedByteCount = 0;
+
+	size_t FreeBytes = RECEPTION_BUFFER_SIZE - WriteBuffer.ReceivedBytes;
+	size_t RequiredBytes = Reassembler.GetPendingPacketSize();
+	if (RequiredBytes <= Reassembler.PendingByteCount)
+	{
+		RequiredBytes = Reassembler.PendingByteCount + 1;
+	}
+
+	if (RequiredBytes > FreeBytes)
+	{
+		ReceivedBytesCount = recv(SocketHandle, Worker.OverflowBuffer, OVERFLOW_BUFFER_SIZE, 0);
+		if (ReceivedBytesCount <= 0)
+		{
+			return ReceivedBytesCount;
+		}
+
+		bValidStream = Reassembler.Consume(reinterpret_cast<const byte*>(Worker.OverflowBuffer), ReceivedBytesCount,
+			[&](const FPCore::Net::NetEncodedPacketHead& EncodedPacket, const byte* Body)
+			{
+				std::cerr << "Out of memory on LinuxNet Reception Buffer.\n";
+				DroppedReceptionCount++;
+				DroppedByteCount += sizeof(FPCore::Net::NetEncodedPacketHead) + EncodedPacket.BodySize;
+			});
+	}
+	else
+	{
+		byte* ReceptionStart = WriteBuffer.Data + WriteBuffer.ReceivedBytes;
+		size_t PendingByteCount = Reassembler.CopyPendingTo(ReceptionStart);
+		ReceivedBytesCount = recv(SocketHandle, ReceptionStart + PendingByteCount, FreeBytes - PendingByteCount, 0);
+		if (ReceivedBytesCount <= 0)
+		{
+			return ReceivedBytesCount;
+		}
+
+		// Describe each packet and leave it where it is. The Reception Buffer only keeps up to the end of the last complete
+		// packet: the reassembler holds on to the rest.
+		bValidStream = Reassembler.ConsumeInPlace(ReceptionStart, PendingByteCount + ReceivedBytesCount,
+			[&](const FPCore::Net::NetEncodedPacketHead& EncodedPacket, const byte* Body)
+			{
+				NetPacketDescriptor& Packet = WriteBuffer.Packets[WriteBuffer.PacketCount++];
+				Packet.ConnectionID = ConnectionID;
+				Packet.BodySize = EncodedPacket.BodySize;
+				Packet.BodyOffset = static_cast<uint32_t>(Body - WriteBuffer.Data);
+				Packet.BodyType = EncodedPacket.BodyType;
+
+				WriteBuffer.ReceivedBytes = Packet.BodyOffset + Packet.BodySize;
+				ReceivedPacketCount++;
+			});
+	}
+
+	Worker.ReceivedPacketCount.fetch_add(ReceivedPacketCount, std::memory_order_relaxed);
+	Worker.DroppedReceptionCount.fetch_add(DroppedReceptionCount, std::memory_order_relaxed);
+	Worker.DroppedByteCount.fetch_add(DroppedByteCount, std::memory_order_relaxed);
+
+	if (!bValidStream)
+	{
+		// Something didn't line up when decoding the received packets. Packets before the faulty one were kept, but
+		// nothing else can be trusted on this stream: close the connection.
+		std::cerr << "LinuxNet Error when receiving packets from Connection ID " << ConnectionID << ". Aborting reception.\n";
+		Disconnect(Worker, ConnectionID);
+	}
+
+	return ReceivedBytesCount;
+}
+
+// Returns the worker's Reception Buffer being written to, announced as such until EndWritingReceptionBuffer is called.
+ReceptionBufferData& BeginWritingReceptionBuffer(LinuxNetWorker& Worker)
+{
+	// Announce the buffer about to be written to, then make sure the Server didn't swap buffers in the meantime: if it did,
+	// it may not have seen the announcement before handling the buffer.
+	size_t WriteBufferIndex;
+	do
+	{
+		WriteBufferIndex = Worker.WriteReceptionBufferIndex.load();
+		Worker.WritingReceptionBufferIndex.store(WriteBufferIndex);
+	}
+	while (Worker.WriteReceptionBufferIndex.load() != WriteBufferIndex);
+
+	return Worker.ReceptionBuffers[WriteBufferIndex];
+}
+
+void EndWritingReceptionBuffer(LinuxNetWorker& Worker)
+{
+	Worker.WritingReceptionBufferIndex.store(NO_RECEPTION_BUFFER, std::memory_order_release);
+}
+
+// Receives the next bytes available on a connection into the worker's Reception Buffer being written to.
+// Returns the result of the recv call.
+ssize_t ReceiveNetData(LinuxNetWorker& Worker, ServerPlatform::ConnectionID ConnectionID)
+{
+	// Only this worker's Net Thread adds to its packet count.
+	uint64_t PreviousPacketCount = Worker.ReceivedPacketCount.load(std::memory_order_relaxed);
+	ssize_t ReceivedBytesCount = ReceiveNetDataIntoBuffer(Worker, BeginWritingReceptionBuffer(Worker), ConnectionID);
+	EndWritingReceptionBuffer(Worker);
+
+	if (Worker.ReceivedPacketCount.load(std::memory_order_relaxed) != PreviousPacketCount)
+	{
+		PostServerWork();
+	}
+	return ReceivedBytesCount;
+}
+
+// io_uring backend: describes every packet completed by bytes the kernel received on a connection in the worker's
+// Reception Buffer being written to. The bytes sit in a provided buffer that has to go back to the kernel right away, so
+// each packet is copied into the Reception Buffer, laid out just like epoll reception leaves it. Packets that don't fit
+// are dropped.
+void ReceiveIoUringData(LinuxNetWorker& Worker, ServerPlatform::ConnectionID ConnectionID, const byte* Data, size_t DataSize)
+{
+	uint64_t ReceivedPacketCount = 0;
+	uint64_t DroppedReceptionCount = 0;
+	uint64_t DroppedByteCount = 0;
+
+	ReceptionBufferData& WriteBuffer = BeginWritingReceptionBuffer(Worker);
+	bool bValidStream = ConnectionReassemblers[ConnectionID].Consume(Data, DataSize,
+		[&](const FPCore::Net::NetEncodedPacketHead& EncodedPacket, const byte* Body)
+		{
+			size_t PacketSize = sizeof(FPCore::Net::NetEncodedPacketHead) + EncodedPacket.BodySize;
+			if (PacketSize > RECEPTION_BUFFER_SIZE - WriteBuffer.ReceivedBytes)
+			{
+				std::cerr << "Out of memory on LinuxNet Reception Buffer.\n";
+				DroppedReceptionCount++;
+				DroppedByteCount += PacketSize;
+				return;
+			}
+
+			byte* PacketStart = WriteBuffer.Data + WriteBuffer.ReceivedBytes;
+			memcpy(PacketStart, &EncodedPacket, sizeof(EncodedPacket));
+			memcpy(PacketStart + sizeof(EncodedPacket), Body, EncodedPacket.BodySize);
+
+			NetPacketDescriptor& Packet = WriteBuffer.Packets[WriteBuffer.PacketCount++];
+			Packet.ConnectionID = ConnectionID;
+			Packet.BodySize = EncodedPacket.BodySize;
+			Packet.BodyOffset = static_cast<uint32_t>(WriteBuffer.ReceivedBytes + sizeof(EncodedPacket));
+			Packet.BodyType = EncodedPacket.BodyType;
+
+			WriteBuffer.ReceivedBytes += PacketSize;
+			ReceivedPacketCount++;
+		});
+	EndWritingReceptionBuffer(Worker);
+
+	Worker.ReceivedPacketCount.fetch_add(ReceivedPacketCount, std::memory_order_relaxed);
+	Worker.DroppedReceptionCount.fetch_add(DroppedReceptionCount, std::memory_order_relaxed);
+	Worker.DroppedByteCount.fetch_add(DroppedByteCount, std::memory_order_relaxed);
+	if (ReceivedPacketCount > 0)
+	{
+		PostServerWork();
+	}
+
+	if (!bValidStream)
+	{
+		std::cerr << "LinuxNet Error when receiving packets from Connection ID " << ConnectionID << ". Aborting reception.\n";
+		Disconnect(Worker, ConnectionID);
+	}
+}
+
+void HandleNetDisconnection(LinuxNetWorker& Worker, ServerPlatform::ConnectionID DisconnectedSocketID)
+{
+	std::cout << "Connection ID " << DisconnectedSocketID << " closed their connection." << std::endl;
+	Disconnect(Worker, DisconnectedSocketID);
+}
+
+// io_uring backend: arms a multishot receive on the connection's socket, which keeps receiving into provided buffers
+// until the connection ends or something goes wrong. Returns false if the ring has no room left.
+bool ArmIoUringReception(LinuxNetWorker& Worker, ServerPlatform::ConnectionID ConnectionID)
+{
+	io_uring_sqe* Entry = Worker.IoUring.GetSubmissionEntry();
+	if (nullptr == Entry)
+	{
+		std::cerr << "Error: io_uring Submission Queue is full ! Can't receive from Connection ID " << ConnectionID << ".\n";
+		return false;
+	}
+
+	Entry->opcode = IORING_OP_RECV;
+	Entry->fd = ActiveConnections[ConnectionID].SocketHandle;
+	Entry->ioprio = IORING_RECV_MULTISHOT;
+	Entry->flags = IOSQE_BUFFER_SELECT;
+	Entry->buf_group = IO_URING_RECEPTION_BUFFER_GROUP;
+	Entry->user_data = ConnectionID;
+	ActiveConnections[ConnectionID].bReceptionArmed = true;
+	return true;
+}
+
+// io_uring backend: arms a multishot accept on the worker's listen socket, or a timeout to do so later.
+void ArmIoUringAccept(LinuxNetWorker& Worker, bool bAfterDelay)
+{
+	static __kernel_timespec AcceptRetryDelay = { 0, IO_URING_ACCEPT_RETRY_DELAY_MS * 1000000ll };
+
+	io_uring_sqe* Entry = Worker.IoUring.GetSubmissionEntry();
+	if (nullptr == Entry)
+	{
+		std::cerr << "Error: io_uring Submission Queue is full ! Net Worker " << static_cast<int>(Worker.Index) << " stopped accepting connections.\n";
+		return;
+	}
+
+	if (bAfterDelay)
+	{
+		Entry->opcode = IORING_OP_TIMEOUT;
+		Entry->addr = reinterpret_cast<uint64_t>(&AcceptRetryDelay);
+		Entry->len = 1;
+		Entry->user_data = IO_URING_TAG_ACCEPT_RETRY;
+		return;
+	}
+
+	Entry->opcode = IORING_OP_ACCEPT;
+	Entry->fd = Worker.ListenSocketHandle;
+	Entry->ioprio = IORING_ACCEPT_MULTISHOT;
+	Entry->accept_flags = SOCK_CLOEXEC;
+	Entry->user_data = IO_URING_TAG_ACCEPT;
+}
+
+// io_uring backend: arms a read of the worker's wake-up event.
+void ArmIoUringWakeEvent(LinuxNetWorker& Worker)
+{
+	io_uring_sqe* Entry = Worker.IoUring.GetSubmissionEntry();
+	if (nullptr == Entry)
+	{
+		std::cerr << "Error: io_uring Submission Queue is full ! Net Worker " << static_cast<int>(Worker.Index) << " can't be woken up anymore.\n";
+		return;
+	}
+
+	Entry->opcode = IORING_OP_READ;
+	Entry->fd = Worker.WakeEventHandle;
+	Entry->addr = reinterpret_cast<uint64_t>(&Worker.WakeValue);
+	Entry->len = sizeof(Worker.WakeValue);
+	Entry->user_data = IO_URING_TAG_WAKE_EVENT;
+}
+
+// Gives a newly accepted socket a Connection ID, starts receiving from it and lets the Server know about it.
+void RegisterAcceptedConnection(LinuxNetWorker& Worker, int ConnectedSocket, const sockaddr_in& ConnectedAddr)
+{
+	// Attempt to find an available Client ID.
+	ServerPlatform::ConnectionID ConnectionID = FindAvailableClientIndex(Worker);
+
+	// No ID found, likely because capacity was reached. Turn down connection.
+	if (ConnectionID == ServerPlatform::INVALID_ID)
+	{
+		std::cerr << "Maximum Client Capacity reached !\n";
+
+		shutdown(ConnectedSocket, SHUT_RDWR);
+		close(ConnectedSocket);
+		return;
+	}
+
+	// Initialize newly connected Client Data
+	{
+		ActiveConnections[ConnectionID].ID = ConnectionID;
+		ActiveConnections[ConnectionID].SocketHandle.store(ConnectedSocket);
+		ActiveConnections[ConnectionID].Address = ConnectedAddr;
+		ConnectionReassemblers[ConnectionID].Reset();
+		ActiveConnections[ConnectionID].WorkerIndex.store(Worker.Index, std::memory_order_relaxed);
+		ActiveConnections[ConnectionID].bCloseRequested.store(false, std::memory_order_relaxed);
+		ActiveConnections[ConnectionID].bReceptionArmed = false;
+		ActiveConnections[ConnectionID].bClosing = false;
+
+		memset(ActiveConnections[ConnectionID].AddressString, 0, sizeof(ActiveConnections[ConnectionID].AddressString));
+		inet_ntop(AF_INET, &ConnectedAddr.sin_addr, ActiveConnections[ConnectionID].AddressString, INET_ADDRSTRLEN);
+		size_t AddressStringLen = strlen(ActiveConnections[ConnectionID].AddressString);
+		snprintf(ActiveConnections[ConnectionID].AddressString + AddressStringLen, sizeof(ActiveConnections[ConnectionID].AddressString) - AddressStringLen,
+			":%u", ntohs(ConnectedAddr.sin_port));
+	}
+
+	// Start receiving: through a multishot receive on io_uring, by registering the socket onto the epoll instance otherwise.
+	bool bReceiving;
+	if (bUseIoUring)
+	{
+		bReceiving = ArmIoUringReception(Worker, ConnectionID);
+	}
+	else
+	{
+		epoll_event SocketEvent = {};
+		SocketEvent.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+		SocketEvent.data.u64 = ConnectionID;
+		bReceiving = epoll_ctl(Worker.EpollHandle, EPOLL_CTL_ADD, ConnectedSocket, &SocketEvent) != -1;
+		if (!bReceiving)
+		{
+			std::cerr << "Error registering Connection ID " << ConnectionID << " to epoll. Error code = " << errno << "\n";
+		}
+	}
+
+	if (!bReceiving)
+	{
+		ActiveConnections[ConnectionID].SocketHandle.store(INVALID_SOCKET_HANDLE);
+		close(ConnectedSocket);
+		Worker.SpareConnectionID = ConnectionID;
+		return;
+	}
+
+	// Print newly connected socket handle & address
+	std::cout << "New Connection established. [ID " << ConnectionID
+	<< " |ADDR " << ActiveConnections[ConnectionID].AddressString
+	<< " |HANDLE " << ConnectedSocket
+	<< " |WORKER " << static_cast<int>(Worker.Index)
+	<< "]\n";
+
+	// Add Client to Connection ring for acknowledgement by the server.
+	if (!Worker.ConnectionEventRing.Push(ConnectionID))
+	{
+		std::cerr << "Error: Connection Event ring is full ! Dropping Connection ID " << ConnectionID << ".\n";
+		Disconnect(Worker, ConnectionID);
+		return;
+	}
+	PostServerWork();
+}
+
+// Accepts every connection pending on the worker's listen socket. Being edge-triggered, the listen socket has to be
+// drained until accept would block.
+void AcceptPendingConnections(LinuxNetWorker& Worker)
+{
+	while (true)
+	{
+		sockaddr_in ConnectedAddr = {};
+		socklen_t AddressLen = sizeof(ConnectedAddr);
+		int ConnectedSocket = accept4(Worker.ListenSocketHandle, reinterpret_cast<sockaddr*>(&ConnectedAddr), &AddressLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+		if (ConnectedSocket == INVALID_SOCKET_HANDLE)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				std::cerr << "Error accepting connection ! Error code = " << errno << "\n";
+			}
+			return;
+		}
+
+		RegisterAcceptedConnection(Worker, ConnectedSocket, ConnectedAddr);
+	}
+}
+
+// Reads everything available on a ready connection socket. Being edge-triggered, the socket has to be drained until recv
+// would block.
+void ReceiveConnectionData(LinuxNetWorker& Worker, ServerPlatform::ConnectionID ConnectionID)
+{
+	while (ActiveConnections[ConnectionID].SocketHandle != INVALID_SOCKET_HANDLE)
+	{
+		ssize_t ReceivedBytesCount = ReceiveNetData(Worker, ConnectionID);
+		if (ReceivedBytesCount > 0)
+		{
+			continue;
+		}
+		else if (ReceivedBytesCount == 0)
+		{
+			// Receiving 0 bytes is a signal for a "Polite goodbye".
+			HandleNetDisconnection(Worker, ConnectionID);
+		}
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			return;
+		}
+		else if (errno != EINTR)
+		{
+			// Log the error and close the connection.
+			// #TODO(Marc): Some error types are relatively normal and probably shouldn't warrant a log line.
+			std::cerr << "Error when receiving data from Connection ID " << ConnectionID << " ! Error Code: " << errno << std::endl;
+			HandleNetDisconnection(Worker, ConnectionID);
+		}
+	}
+}
+
+// Server network thread of a Net Worker, handling new connection requests and incoming data from the worker's
+// connections.
+void* NetThread_Func(void* Param)
+{
+	LinuxNetWorker& Worker = *static_cast<LinuxNetWorker*>(Param);
+	epoll_event ReadyEvents[MAX_EPOLL_EVENTS_PER_WAIT];
+
+	// Continue running until the Running boolean is externally set to false.
+	while (bNetThreadRunning)
+	{
+		int ReadyEventCount = epoll_wait(Worker.EpollHandle, ReadyEvents, MAX_EPOLL_EVENTS_PER_WAIT, -1);
+		if (ReadyEventCount == -1)
+		{
+			if (errno != EINTR)
+			{
+				std::cerr << "Error waiting on epoll. Error code = " << errno << "\n";
+			}
+			continue;
+		}
+
+		for (int EventIndex = 0; EventIndex < ReadyEventCount; EventIndex++)
+		{
+			const epoll_event& ReadyEvent = ReadyEvents[EventIndex];
+
+			if (ReadyEvent.data.u64 == EPOLL_TAG_WAKE_EVENT)
+			{
+				read(Worker.WakeEventHandle, &Worker.WakeValue, sizeof(Worker.WakeValue));
+				HandleCloseRequests(Worker);
+				continue;
+			}
+
+			if (ReadyEvent.data.u64 == EPOLL_TAG_LISTEN_SOCKET)
+			{
+				AcceptPendingConnections(Worker);
+				continue;
+			}
+
+			ServerPlatform::ConnectionID ConnectionID = static_cast<ServerPlatform::ConnectionID>(ReadyEvent.data.u64);
+			if (ActiveConnections[ConnectionID].SocketHandle == INVALID_SOCKET_HANDLE)
+			{
+				// Connection was closed earlier within this same batch of events.
+				continue;
+			}
+
+			if (ReadyEvent.events & EPOLLIN)
+			{
+				// Reading also picks up the peer closing the connection once all pending data was received.
+				ReceiveConnectionData(Worker, ConnectionID);
+			}
+			else if (ReadyEvent.events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+			{
+				HandleNetDisconnection(Worker, ConnectionID);
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+// io_uring backend: handles a completion of one of the operations kept armed on the worker's ring, and arms it again if
+// it ended.
+void HandleIoUringCompletion(LinuxNetWorker& Worker, const io_uring_cqe& Completion)
+{
+	bool bOperationEnded = !(Completion.flags & IORING_CQE_F_MORE);
+
+	if (Completion.user_data == IO_URING_TAG_WAKE_EVENT)
+	{
+		HandleCloseRequests(Worker);
+		ArmIoUringWakeEvent(Worker);
+		return;
+	}
+
+	if (Completion.user_data == IO_URING_TAG_ACCEPT_RETRY)
+	{
+		ArmIoUringAccept(Worker, false);
+		return;
+	}
+
+	if (Completion.user_data == IO_URING_TAG_ACCEPT)
+	{
+		if (Completion.res >= 0)
+		{
+			// A multishot accept can't return each peer's address, so ask for it.
+			sockaddr_in ConnectedAddr = {};
+			socklen_t AddressLen = sizeof(ConnectedAddr);
+			getpeername(Completion.res, reinterpret_cast<sockaddr*>(&ConnectedAddr), &AddressLen);
+			RegisterAcceptedConnection(Worker, Completion.res, ConnectedAddr);
+		}
+		else if (Completion.res != -ECONNABORTED && Completion.res != -EINTR)
+		{
+			std::cerr << "Error accepting connection ! Error code = " << -Completion.res << "\n";
+		}
+
+		// Failures end the multishot accept. Wait a bit before accepting again, as they tend to repeat.
+		if (bOperationEnded)
+		{
+			ArmIoUringAccept(Worker, Completion.res < 0);
+		}
+		return;
+	}
+
+	ServerPlatform::ConnectionID ConnectionID = static_cast<ServerPlatform::ConnectionID>(Completion.user_data);
+	LinuxNetConnection& Connection = ActiveConnections[ConnectionID];
+	if (bOperationEnded)
+	{
+		Connection.bReceptionArmed = false;
+	}
+
+	if (Completion.flags & IORING_CQE_F_BUFFER)
+	{
+		uint16_t BufferID = static_cast<uint16_t>(Completion.flags >> IORING_CQE_BUFFER_SHIFT);
+		if (Completion.res > 0 && !Connection.bClosing)
+		{
+			ReceiveIoUringData(Worker, ConnectionID, Worker.ReceptionBufferRing.GetBuffer(BufferID), Completion.res);
+		}
+		Worker.ReceptionBufferRing.Provide(BufferID);
+	}
+
+	if (Connection.bClosing)
+	{
+		// The worker closed the connection: finish once its receive has ended.
+		if (bOperationEnded)
+		{
+			Disconnect(Worker, ConnectionID);
+		}
+		return;
+	}
+
+	if (Connection.SocketHandle == INVALID_SOCKET_HANDLE)
+	{
+		return;
+	}
+
+	if (Completion.res == 0)
+	{
+		// Receiving 0 bytes is a signal for a "Polite goodbye".
+		HandleNetDisconnection(Worker, ConnectionID);
+	}
+	else if (Completion.res < 0 && Completion.res != -ENOBUFS)
+	{
+		std::cerr << "Error when receiving data from Connection ID " << ConnectionID << " ! Error Code: " << -Completion.res << std::endl;
+		HandleNetDisconnection(Worker, ConnectionID);
+	}
+	else if (bOperationEnded && !ArmIoUringReception(Worker, ConnectionID))
+	{
+		// The receive stopped while the connection is still open, for instance when every provided buffer was in use, and
+		// couldn't be armed again.
+		HandleNetDisconnection(Worker, ConnectionID);
+	}
+}
+
+// Server network thread of a Net Worker on the io_uring backend. Accepting, receiving and waking up stay armed on the
+// worker's ring: each wake-up handles every available completion, and the single system call submitting what they led
+// to also waits for the next ones.
+void* NetThread_IoUringFunc(void* Param)
+{
+	LinuxNetWorker& Worker = *static_cast<LinuxNetWorker*>(Param);
+	ArmIoUringAccept(Worker, false);
+	ArmIoUringWakeEvent(Worker);
+
+	// Continue running until the Running boolean is externally set to false.
+	while (bNetThreadRunning)
+	{
+		int Result = Worker.IoUring.Submit(1);
+		if (Result < 0 && Result != -EBUSY)
+		{
+			std::cerr << "Error waiting on io_uring. Error code = " << -Result << "\n";
+		}
+
+		Worker.IoUring.HandleCompletions([&Worker](const io_uring_cqe& Completion)
+			{
+				HandleIoUringCompletion(Worker, Completion);
+			});
+	}
+
+	return nullptr;
+}
+
+// Skips the vectors fully covered by SentBytes and trims the one they end in.
+void ConsumeSentVectors(iovec*& Vectors, size_t& VectorCount, size_t SentBytes)
+{
+	while (VectorCount > 0 && SentBytes >= Vectors->iov_len)
+	{
+		SentBytes -= Vectors->iov_len;
+		Vectors++;
+		VectorCount--;
+	}
+	if (VectorCount > 0)
+	{
+		Vectors->iov_base = static_cast<char*>(Vectors->iov_base) + SentBytes;
+		Vectors->iov_len -= SentBytes;
+	}
+}
+
+// Sends the entirety of the passed data vectors on a non-blocking socket, waiting for it to become writable when its send
+// buffer is full. Vectors are consumed as data goes out. Returns false if the connection should be dropped.
+bool SendAllVectors(int SocketHandle, iovec* Vectors, size_t VectorCount)
+{
+	while (VectorCount > 0)
+	{
+		msghdr Message = {};
+		Message.msg_iov = Vectors;
+		Message.msg_iovlen = VectorCount < static_cast<size_t>(IOV_MAX) ? VectorCount : IOV_MAX;
+
+		ssize_t Result = sendmsg(SocketHandle, &Message, MSG_NOSIGNAL);
+		if (Result >= 0)
+		{
+			ConsumeSentVectors(Vectors, VectorCount, static_cast<size_t>(Result));
+			continue;
+		}
+
+		if (errno == EINTR)
+		{
+			continue;
+		}
+
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			return false;
+		}
+
+		pollfd WritableEvent = { SocketHandle, POLLOUT, 0 };
+		if (poll(&WritableEvent, 1, SEND_BLOCKED_TIMEOUT_MS) <= 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// io_uring backend: sends every destination connection of a Sending Slot the vectors laid out in DestinationSends. The
+// sends of up to IO_URING_MAX_SENDS_IN_FLIGHT connections go out with a single system call, which also waits for them to
+// complete. Each send waits at most SEND_BLOCKED_TIMEOUT_MS for its socket, through a linked timeout that cancels it.
+// Connections left with data after a partial send get the rest in the next round.
+void SendDestinationsWithIoUring(size_t DestinationConnectionCount)
+{
+	static __kernel_timespec SendTimeout = { SEND_BLOCKED_TIMEOUT_MS / 1000, (SEND_BLOCKED_TIMEOUT_MS % 1000) * 1000000ll };
+
+	size_t FirstPendingIndex = 0;
+	while (true)
+	{
+		while (FirstPendingIndex < DestinationConnectionCount && DestinationSends[FirstPendingIndex].VectorCount == 0)
+		{
+			FirstPendingIndex++;
+		}
+
+		// Both entries of a send fit in the ring as long as no more than IO_URING_MAX_SENDS_IN_FLIGHT are prepared.
+		unsigned SendCount = 0;
+		for (size_t DestinationIndex = FirstPendingIndex; DestinationIndex < DestinationConnectionCount && SendCount < IO_URING_MAX_SENDS_IN_FLIGHT; DestinationIndex++)
+		{
+			IoUringSend& Send = DestinationSends[DestinationIndex];
+			if (Send.VectorCount == 0)
+			{
+				continue;
+			}
+
+			int OutgoingSocket = ActiveConnections[DestinationConnections[DestinationIndex]].SocketHandle;
+			if (OutgoingSocket == INVALID_SOCKET_HANDLE)
+			{
+				Send.VectorCount = 0;
+				continue;
+			}
+
+			Send.Message = {};
+			Send.Message.msg_iov = Send.Vectors;
+			Send.Message.msg_iovlen = Send.VectorCount < static_cast<size_t>(IOV_MAX) ? Send.VectorCount : IOV_MAX;
+
+			io_uring_sqe* SendEntry = SendingIoUring.GetSubmissionEntry();
+			SendEntry->opcode = IORING_OP_SENDMSG;
+			SendEntry->fd = OutgoingSocket;
+			SendEntry->addr = reinterpret_cast<uint64_t>(&Send.Message);
+			SendEntry->len = 1;
+			SendEntry->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+			SendEntry->flags = IOSQE_IO_LINK;
+			SendEntry->user_data = DestinationIndex;
+
+			io_uring_sqe* TimeoutEntry = SendingIoUring.GetSubmissionEntry();
+			TimeoutEntry->opcode = IORING_OP_LINK_TIMEOUT;
+			TimeoutEntry->addr = reinterpret_cast<uint64_t>(&SendTimeout);
+			TimeoutEntry->len = 1;
+			TimeoutEntry->user_data = IO_URING_TAG_SEND_TIMEOUT;
+
+			SendCount++;
+		}
+
+		if (SendCount == 0)
+		{
+			return;
+		}
+
+		// Sends and timeouts all complete, one way or the other.
+		unsigned PendingCompletionCount = SendCount * 2;
+		while (PendingCompletionCount > 0)
+		{
+			int Result = SendingIoUring.Submit(PendingCompletionCount);
+			if (Result < 0 && Result != -EBUSY)
+			{
+				std::cerr << "Error waiting on io_uring sends. Error code = " << -Result << "\n";
+			}
+
+			PendingCompletionCount -= SendingIoUring.HandleCompletions([](const io_uring_cqe& Completion)
+				{
+					if (Completion.user_data == IO_URING_TAG_SEND_TIMEOUT)
+					{
+						return;
+					}
+
+					IoUringSend& Send = DestinationSends[Completion.user_data];
+					if (Completion.res >= 0)
+					{
+						ConsumeSentVectors(Send.Vectors, Send.VectorCount, static_cast<size_t>(Completion.res));
+						return;
+					}
+
+					// Sends cut short by their timeout end up canceled.
+					ServerPlatform::ConnectionID ConnectionID = DestinationConnections[Completion.user_data];
+					std::cerr << "Error when sending data to Connection ID " << ConnectionID << " ! Error Code: " << -Completion.res << "\n";
+					CloseConnection(ConnectionID);
+					Send.VectorCount = 0;
+				});
+		}
+	}
+}
+
+// Sends out every packet contained in a filled Sending Slot.
+// Packets are grouped by connection, keeping their order, and each connection gets all of its packets in a single
+// scatter-gather call: encoded heads are built on the side and bodies are sent straight from the slot.
+void SendSlotData(const SendingSlot& Slot)
+{
+	// Find every packet to send and count them per connection.
+	size_t PacketCount = 0;
+	size_t DestinationConnectionCount = 0;
+	size_t SendingBufferReadingOffset = 0;
+	while(SendingBufferReadingOffset < Slot.BytesToSend)
+	{
+		const byte* PacketLocation = Slot.Data + SendingBufferReadingOffset;
+		const FPCore::Net::PacketHead& OutgoingPacket = *reinterpret_cast<const FPCore::Net::PacketHead*>(PacketLocation);
+		SendingBufferReadingOffset += sizeof(FPCore::Net::PacketHead) + OutgoingPacket.BodySize;
+
+		if (OutgoingPacket.ConnectionID >= MaxConnectionCount)
+		{
+			continue;
+		}
+
+		if (ConnectionPacketCounts[OutgoingPacket.ConnectionID]++ == 0)
+		{
+			DestinationConnections[DestinationConnectionCount++] = OutgoingPacket.ConnectionID;
+		}
+		PacketLocations[PacketCount++] = PacketLocation;
+	}
+
+	// Give each connection a contiguous range of packets.
+	size_t FirstPacketIndex = 0;
+	for (size_t DestinationIndex = 0; DestinationIndex < DestinationConnectionCount; DestinationIndex++)
+	{
+		ServerPlatform::ConnectionID ConnectionID = DestinationConnections[DestinationIndex];
+		ConnectionNextPacketIndices[ConnectionID] = FirstPacketIndex;
+		FirstPacketIndex += ConnectionPacketCounts[ConnectionID];
+	}
+
+	// Encode packet heads and point the vectors at them and at the bodies.
+	for (size_t PacketLocationIndex = 0; PacketLocationIndex < PacketCount; PacketLocationIndex++)
+	{
+		const byte* PacketLocation = PacketLocations[PacketLocationIndex];
+		const FPCore::Net::PacketHead& OutgoingPacket = *reinterpret_cast<const FPCore::Net::PacketHead*>(PacketLocation);
+		size_t PacketIndex = ConnectionNextPacketIndices[OutgoingPacket.ConnectionID]++;
+
+		FPCore::Net::NetEncodedPacketHead& EncodedOutgoingPacket = EncodedPacketHeads[PacketIndex];
+		EncodedOutgoingPacket.BodyType = OutgoingPacket.BodyType;
+		EncodedOutgoingPacket.BodySize = OutgoingPacket.BodySize;
+
+		PacketVectors[PacketIndex * 2] = { &EncodedOutgoingPacket, sizeof(EncodedOutgoingPacket) };
+		PacketVectors[PacketIndex * 2 + 1] = { const_cast<byte*>(PacketLocation + sizeof(FPCore::Net::PacketHead)), OutgoingPacket.BodySize };
+	}
+
+	// Send each connection its packets.
+	FirstPacketIndex = 0;
+	for (size_t DestinationIndex = 0; DestinationIndex < DestinationConnectionCount; DestinationIndex++)
+	{
+		ServerPlatform::ConnectionID ConnectionID = DestinationConnections[DestinationIndex];
+		size_t ConnectionPacketCount = ConnectionPacketCounts[ConnectionID];
+		iovec* ConnectionVectors = PacketVectors + FirstPacketIndex * 2;
+		FirstPacketIndex += ConnectionPacketCount;
+		ConnectionPacketCounts[ConnectionID] = 0;
+
+		if (bUseIoUring)
+		{
+			// Sent to every connection at once below.
+			DestinationSends[DestinationIndex].Vectors = ConnectionVectors;
+			DestinationSends[DestinationIndex].VectorCount = ConnectionPacketCount * 2;
+			continue;
+		}
+
+		int OutgoingSocket = ActiveConnections[ConnectionID].SocketHandle;
+		if (OutgoingSocket == INVALID_SOCKET_HANDLE)
+		{
+			// Skip these packets
+			continue;
+		}
+
+		if (!SendAllVectors(OutgoingSocket, ConnectionVectors, ConnectionPacketCount * 2))
+		{
+			std::cerr << "Error when sending data to Connection ID " << ConnectionID << " ! Error Code: " << errno << "\n";
+			CloseConnection(ConnectionID);
+		}
+	}
+
+	if (bUseIoUring)
+	{
+		SendDestinationsWithIoUring(DestinationConnectionCount);
+	}
+}
+
+// Server sending thread handling outgoing data to be sent to existing connections.
+void* SendingThread_Func(void* Param)
+{
+	while (bSendingThreadRunning)
+	{
+		// Wait for the event to be notified, indicating filled slots are ready to be sent out.
+		{
+			std::unique_lock<std::mutex> Lock(Mutex_NetDataSending);
+			Event_DataReadyForSending.wait(Lock, [] { return bDataReadyForSending || !bSendingThreadRunning; });
+			bDataReadyForSending = false;
+		}
+
+		// Send filled slots out in the order they were filled, then hand them back to the Server.
+		uint8_t SlotIndex;
+		while (FilledSendingSlotRing.Pop(SlotIndex))
+		{
+			SendSlotData(SendingSlots[SlotIndex]);
+
+			SendingSlots[SlotIndex].BytesToSend = 0;
+			FreeSendingSlotRing.Push(SlotIndex);
+			SentSendingSlotCount.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	return nullptr;
+}
+
+// Creates the worker's epoll instance or io_uring, wake-up event and listen socket. Every worker listens on the same port:
+// when there are several, the kernel spreads incoming connections between their listen sockets.
+bool InitNetWorker(LinuxNetWorker& Worker)
+{
+	// Create io_uring & wake-up event. io_uring waits on its own for files to be ready, so they are left blocking.
+	if (bUseIoUring)
+	{
+		unsigned CompletionCount = static_cast<unsigned>(MaxConnectionCount * 2 + IO_URING_SUBMISSION_COUNT);
+		Worker.WakeEventHandle = eventfd(0, EFD_CLOEXEC);
+		if (Worker.WakeEventHandle == INVALID_SOCKET_HANDLE
+			|| !Worker.IoUring.Initialize(IO_URING_SUBMISSION_COUNT, CompletionCount)
+			|| !Worker.ReceptionBufferRing.Initialize(Worker.IoUring, IO_URING_RECEPTION_BUFFER_COUNT, IO_URING_RECEPTION_BUFFER_SIZE, IO_URING_RECEPTION_BUFFER_GROUP))
+		{
+			std::cerr << "Error creating io_uring instance. Error Code : " << errno << "\n";
+			return false;
+		}
+	}
+	// Create epoll instance & wake-up event
+	else
+	{
+		Worker.EpollHandle = epoll_create1(EPOLL_CLOEXEC);
+		Worker.WakeEventHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (Worker.EpollHandle == INVALID_SOCKET_HANDLE || Worker.WakeEventHandle == INVALID_SOCKET_HANDLE)
+		{
+			std::cerr << "Error creating epoll instance. Error Code : " << errno << "\n";
+			return false;
+		}
+
+		epoll_event WakeEvent = {};
+		WakeEvent.events = EPOLLIN | EPOLLET;
+		WakeEvent.data.u64 = EPOLL_TAG_WAKE_EVENT;
+		epoll_ctl(Worker.EpollHandle, EPOLL_CTL_ADD, Worker.WakeEventHandle, &WakeEvent);
+	}
+
+	// Create Listen Socket
+	{
+		Worker.ListenSocketHandle = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | (bUseIoUring ? 0 : SOCK_NONBLOCK), IPPROTO_TCP);
+		if (Worker.ListenSocketHandle == INVALID_SOCKET_HANDLE)
+		{
+			std::cerr << "Error creating Listen Socket. Error Code : " << errno << "\n";
+			return false;
+		}
+
+		int ReuseAddress = 1;
+		setsockopt(Worker.ListenSocketHandle, SOL_SOCKET, SO_REUSEADDR, &ReuseAddress, sizeof(ReuseAddress));
+		if (NetWorkerCount > 1)
+		{
+			int ReusePort = 1;
+			if (setsockopt(Worker.ListenSocketHandle, SOL_SOCKET, SO_REUSEPORT, &ReusePort, sizeof(ReusePort)) == -1)
+			{
+				std::cerr << "Error sharing listen port between Net Workers. Error Code : " << errno << "\n";
+				return false;
+			}
+		}
+
+		sockaddr_in ListenSocketAddress = {};
+		ListenSocketAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+		ListenSocketAddress.sin_family = AF_INET;
+		ListenSocketAddress.sin_port = htons(ListenPort);
+
+		if (bind(Worker.ListenSocketHandle, reinterpret_cast<sockaddr*>(&ListenSocketAddress), sizeof(ListenSocketAddress)) == -1)
+		{
+			std::cerr << "Error binding listen socket. Error Code : " << errno << "\n";
+			return false;
+		}
+
+		if (listen(Worker.ListenSocketHandle, LISTEN_BACKLOG) == -1)
+		{
+			std::cerr << "Error listening on socket. Error Code : " << errno << "\n";
+			return false;
+		}
+
+		epoll_event ListenEvent = {};
+		ListenEvent.events = EPOLLIN | EPOLLET;
+		ListenEvent.data.u64 = EPOLL_TAG_LISTEN_SOCKET;
+		if (!bUseIoUring && epoll_ctl(Worker.EpollHandle, EPOLL_CTL_ADD, Worker.ListenSocketHandle, &ListenEvent) == -1)
+		{
+			std::cerr << "Error registering listen socket to epoll. Error Code : " << errno << "\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Returns whether the kernel offers everything the io_uring backend needs.
+bool IsIoUringSupported()
+{
+	LinuxIoUring ProbeIoUring;
+	if (!ProbeIoUring.Initialize(1, 1))
+	{
+		std::cerr << "io_uring is unavailable. Error Code : " << errno << "\n";
+		return false;
+	}
+
+	bool bSupported = ProbeIoUring.SupportsOperations(IO_URING_REQUIRED_OPERATIONS, sizeof(IO_URING_REQUIRED_OPERATIONS));
+	if (!bSupported)
+	{
+		std::cerr << "io_uring lacks operations required by the network backend.\n";
+	}
+
+	ProbeIoUring.Shutdown();
+	return bSupported;
+}
+
+bool LinuxNet_Init(const ServerConfig& Config)
+{
+	std::cout << "Initializing Linux Networking...\n";
+
+	// Connection IDs have to fit below INVALID_ID.
+	if (Config.MaxConnectionCount >= ServerPlatform::INVALID_ID)
+	{
+		std::cerr << "Error: Can't handle " << Config.MaxConnectionCount << " connections, the maximum is " << ServerPlatform::INVALID_ID - 1 << ".\n";
+		return false;
+	}
+
+	if (Config.NetWorkerCount == 0 || Config.NetWorkerCount > MAX_NET_WORKER_COUNT)
+	{
+		std::cerr << "Error: Can't run " << Config.NetWorkerCount << " Net Workers, the count has to be between 1 and " << MAX_NET_WORKER_COUNT << ".\n";
+		return false;
+	}
+
+	if (Config.ListenPort == 0 || Config.ListenPort > UINT16_MAX)
+	{
+		std::cerr << "Error: Can't listen on port " << Config.ListenPort << ", the port has to be between 1 and " << UINT16_MAX << ".\n";
+		return false;
+	}
+	ListenPort = static_cast<uint16_t>(Config.ListenPort);
+
+	if (Config.PacketWriteBufferSize < sizeof(FPCore::Net::PacketHead))
+	{
+		std::cerr << "Error: A Packet Write Buffer of " << Config.PacketWriteBufferSize << " bytes can't hold a single packet.\n";
+		return false;
+	}
+
+	// Pick the network backend.
+	bUseIoUring = Config.NetUseIoUring != 0 && IsIoUringSupported();
+	if (Config.NetUseIoUring != 0 && !bUseIoUring)
+	{
+		std::cerr << "Warning: Falling back to epoll.\n";
+	}
+	std::cout << "Using the " << (bUseIoUring ? "io_uring" : "epoll") << " network backend.\n";
+
+	ServerWorkEventHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (ServerWorkEventHandle == INVALID_SOCKET_HANDLE)
+	{
+		std::cerr << "Error creating the Server work event. Error Code : " << errno << "\n";
+		return false;
+	}
+
+	NetWorkerCount = Config.NetWorkerCount;
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		Worker.Index = static_cast<uint8_t>(WorkerIndex);
+		Worker.EpollHandle = INVALID_SOCKET_HANDLE;
+		Worker.ListenSocketHandle = INVALID_SOCKET_HANDLE;
+		Worker.WakeEventHandle = INVALID_SOCKET_HANDLE;
+		Worker.SpareConnectionID = ServerPlatform::INVALID_ID;
+		Worker.WritingReceptionBufferIndex.store(NO_RECEPTION_BUFFER, std::memory_order_relaxed);
+	}
+
+	// Every connection holds a file descriptor: let the process open as many as the Config asks for.
+	{
+		rlimit FileDescriptorLimit;
+		rlim_t RequiredFileDescriptorCount = Config.MaxConnectionCount + RESERVED_FILE_DESCRIPTOR_COUNT
+			+ Config.NetWorkerCount * FILE_DESCRIPTORS_PER_NET_WORKER;
+		if (getrlimit(RLIMIT_NOFILE, &FileDescriptorLimit) == 0 && FileDescriptorLimit.rlim_cur < RequiredFileDescriptorCount)
+		{
+			FileDescriptorLimit.rlim_cur = FileDescriptorLimit.rlim_max < RequiredFileDescriptorCount ? FileDescriptorLimit.rlim_max : RequiredFileDescriptorCount;
+			setrlimit(RLIMIT_NOFILE, &FileDescriptorLimit);
+			if (FileDescriptorLimit.rlim_cur < RequiredFileDescriptorCount)
+			{
+				std::cerr << "Warning: The process may only open " << FileDescriptorLimit.rlim_cur << " files, which is not enough for "
+					<< Config.MaxConnectionCount << " connections.\n";
+			}
+		}
+	}
+
+	// Allocate per-connection tables
+	{
+		MaxConnectionCount = Config.MaxConnectionCount;
+		SendingBufferSize = Config.PacketWriteBufferSize;
+		MaxPacketsPerSendingSlot = SendingBufferSize / sizeof(FPCore::Net::PacketHead);
+		ConnectionTablesMemorySize = LayOutConnectionTables(nullptr);
+
+		void* MappedMemory = mmap(nullptr, ConnectionTablesMemorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (MAP_FAILED == MappedMemory)
+		{
+			std::cerr << "Failed to allocate connection tables. Error Code : " << errno << "\n";
+			MaxConnectionCount = 0;
+			return false;
+		}
+		ConnectionTablesMemory = static_cast<byte*>(MappedMemory);
+		LayOutConnectionTables(ConnectionTablesMemory);
+	}
+
+	// Initialize Client Data
+	{
+		// Prepare connected client data. Every ID starts out free.
+		for (size_t ClientIndex = 0; ClientIndex < MaxConnectionCount; ClientIndex++)
+		{
+			new (&ActiveConnections[ClientIndex]) LinuxNetConnection{};
+			ActiveConnections[ClientIndex].ID = static_cast<ServerPlatform::ConnectionID>(ClientIndex);
+			ActiveConnections[ClientIndex].SocketHandle.store(INVALID_SOCKET_HANDLE, std::memory_order_relaxed);
+			ActiveConnections[ClientIndex].ClosingSocketHandle = INVALID_SOCKET_HANDLE;
+
+			FreeConnectionIDRing.Push(static_cast<ServerPlatform::ConnectionID>(ClientIndex));
+		}
+	}
+
+	// Every Sending Slot starts out free.
+	for (uint8_t SlotIndex = 0; SlotIndex < SENDING_SLOT_COUNT; SlotIndex++)
+	{
+		SendingSlots[SlotIndex].BytesToSend = 0;
+		FreeSendingSlotRing.Push(SlotIndex);
+	}
+	HandedOverSendingSlotCount = 0;
+	SentSendingSlotCount.store(0, std::memory_order_relaxed);
+
+	// Prepare Net Workers
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		if (!InitNetWorker(NetWorkers[WorkerIndex]))
+		{
+			std::cerr << "Net Worker " << WorkerIndex << " failed initialization. Aborting platform net initialization.\n";
+			return false;
+		}
+	}
+
+	// Create Net Threads
+	{
+		std::cout << "Creating " << NetWorkerCount << " Net Thread(s).\n";
+		bNetThreadRunning = true;
+		for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+		{
+			LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+			if (pthread_create(&Worker.ThreadHandle, nullptr, bUseIoUring ? NetThread_IoUringFunc : NetThread_Func, &Worker) != 0)
+			{
+				std::cerr << "Net thread failed initialization. Aborting platform net initialization.\n";
+				return false;
+			}
+			Worker.bThreadCreated = true;
+		}
+	}
+
+	// Create Sending Thread, along with its ring on io_uring.
+	{
+		if (bUseIoUring && !SendingIoUring.Initialize(IO_URING_MAX_SENDS_IN_FLIGHT * 2, IO_URING_MAX_SENDS_IN_FLIGHT * 2))
+		{
+			std::cerr << "Error creating Sending io_uring instance. Error Code : " << errno << "\n";
+			return false;
+		}
+
+		std::cout << "Creating Sending Thread.\n";
+		bSendingThreadRunning = true;
+		if (pthread_create(&SendingThreadHandle, nullptr, SendingThread_Func, nullptr) != 0)
+		{
+			std::cerr << "Sending thread failed initialization. Aborting platform net initialization.\n";
+			bSendingThreadRunning = false;
+			return false;
+		}
+	}
+
+	std::cout << "Awaiting Connection on port " << ListenPort << "...\n";
+	return true;
+}
+
+// Drains pending connection & disconnection events from the rings of every worker and returns them along with their
+// respective counts. Net Threads keep accepting and receiving in the meantime. The returned events stay valid until
+// ClearNetEvents().
+void ReadNetEvents(const ServerPlatform::ConnectionID*& NewConnectionIDs, size_t& OutConnectedCount,
+		const ServerPlatform::ConnectionID*& DisconnectedIDs, size_t& OutDisconnectedCount)
+{
+	// Disconnections are read first: a connection's Connection event is always pushed before its Disconnection event, by
+	// the same worker, so this guarantees the Server never reads a Disconnection without the matching Connection.
+	// A connection ID has at most one event of each type in flight across all workers, so every event fits.
+	ReadDisconnectionEventsCount = 0;
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		ReadDisconnectionEventsCount += NetWorkers[WorkerIndex].DisconnectionEventRing.PopBatch(
+			ReadDisconnectionEvents + ReadDisconnectionEventsCount, MaxConnectionCount - ReadDisconnectionEventsCount);
+	}
+
+	ReadConnectionEventsCount = 0;
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		ReadConnectionEventsCount += NetWorkers[WorkerIndex].ConnectionEventRing.PopBatch(
+			ReadConnectionEvents + ReadConnectionEventsCount, MaxConnectionCount - ReadConnectionEventsCount);
+	}
+
+	NewConnectionIDs = ReadConnectionEvents;
+	OutConnectedCount = ReadConnectionEventsCount;
+
+	DisconnectedIDs = ReadDisconnectionEvents;
+	OutDisconnectedCount = ReadDisconnectionEventsCount;
+}
+
+// Clears data associated to Connection and Disconnection events. Connections whose Disconnection was acknowledged have
+// their socket closed and their ID made available to new connections, once the Sending Thread has sent every slot that
+// may still hold packets for them.
+void ClearNetEvents()
+{
+	// Each ID drains at most once at a time, so the queue can't overflow.
+	for (size_t EventIndex = 0; EventIndex < ReadDisconnectionEventsCount; EventIndex++)
+	{
+		size_t DrainingIndex = (FirstDrainingConnectionIndex + DrainingConnectionCount++) % MaxConnectionCount;
+		DrainingConnectionIDs[DrainingIndex] = ReadDisconnectionEvents[EventIndex];
+		DrainingConnectionSlotCounts[DrainingIndex] = HandedOverSendingSlotCount;
+	}
+
+	// There are only as many IDs as the ring can hold, so this can't fail.
+	uint64_t SentSlotCount = SentSendingSlotCount.load(std::memory_order_acquire);
+	while (DrainingConnectionCount > 0 && DrainingConnectionSlotCounts[FirstDrainingConnectionIndex] <= SentSlotCount)
+	{
+		ServerPlatform::ConnectionID ConnectionID = DrainingConnectionIDs[FirstDrainingConnectionIndex];
+		close(ActiveConnections[ConnectionID].ClosingSocketHandle);
+		ActiveConnections[ConnectionID].ClosingSocketHandle = INVALID_SOCKET_HANDLE;
+		FreeConnectionIDRing.Push(ConnectionID);
+
+		FirstDrainingConnectionIndex = (FirstDrainingConnectionIndex + 1) % MaxConnectionCount;
+		DrainingConnectionCount--;
+	}
+
+	ReadConnectionEventsCount = 0;
+	ReadDisconnectionEventsCount = 0;
+}
+
+// Hands the Reception Buffer each worker filled since the last read over to the Server as one shard per worker, along
+// with the descriptors of the packets it holds. Reception carries on in the other buffers. The returned data stays valid
+// until ReleaseNetReceptionBuffers() is called.
+void ReadNetReceptionBuffers(const NetReceptionShard*& OutShards, size_t& OutShardCount)
+{
+	// Move every worker on to its next buffer first, so that writes still under way get a chance to end while the others
+	// are being swapped.
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		size_t ReadBufferIndex = Worker.WriteReceptionBufferIndex.load(std::memory_order_relaxed);
+		Worker.WriteReceptionBufferIndex.store((ReadBufferIndex + 1) % RECEPTION_BUFFER_COUNT);
+	}
+
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		size_t ReadBufferIndex = (Worker.WriteReceptionBufferIndex.load(std::memory_order_relaxed) + RECEPTION_BUFFER_COUNT - 1) % RECEPTION_BUFFER_COUNT;
+		while (Worker.WritingReceptionBufferIndex.load() == ReadBufferIndex)
+		{
+			std::this_thread::yield();
+		}
+
+		ReceptionBufferData& ReadBuffer = Worker.ReceptionBuffers[ReadBufferIndex];
+		ReadReceptionShards[WorkerIndex].Packets = ReadBuffer.Packets;
+		ReadReceptionShards[WorkerIndex].PacketCount = ReadBuffer.PacketCount;
+		ReadReceptionShards[WorkerIndex].ReceptionData = ReadBuffer.Data;
+
+		Worker.LastReadOccupancy = ReadBuffer.ReceivedBytes;
+		if (ReadBuffer.ReceivedBytes > Worker.PeakReadOccupancy)
+		{
+			Worker.PeakReadOccupancy = ReadBuffer.ReceivedBytes;
+		}
+	}
+
+	OutShards = ReadReceptionShards;
+	OutShardCount = NetWorkerCount;
+}
+
+// Empties the Reception Buffers handed over by the last read, making them available to reception again.
+// Buffers are used in turn, so the emptied buffers will not be written to before the next read.
+void ReleaseNetReceptionBuffers()
+{
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		size_t ReadBufferIndex = (Worker.WriteReceptionBufferIndex.load(std::memory_order_relaxed) + RECEPTION_BUFFER_COUNT - 1) % RECEPTION_BUFFER_COUNT;
+		Worker.ReceptionBuffers[ReadBufferIndex].ReceivedBytes = 0;
+		Worker.ReceptionBuffers[ReadBufferIndex].PacketCount = 0;
+	}
+}
+
+// Sums up the counters of every worker. Occupancies are those of the fullest shard. Only called from the Server thread.
+void ReadNetReceptionStats(NetReceptionStats& OutStats)
+{
+	OutStats = {};
+	OutStats.BufferSize = RECEPTION_BUFFER_SIZE;
+	OutStats.ShardCount = NetWorkerCount;
+
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		OutStats.ReceivedPacketCount += Worker.ReceivedPacketCount.load(std::memory_order_relaxed);
+		OutStats.DroppedReceptionCount += Worker.DroppedReceptionCount.load(std::memory_order_relaxed);
+		OutStats.DroppedByteCount += Worker.DroppedByteCount.load(std::memory_order_relaxed);
+		if (Worker.LastReadOccupancy > OutStats.LastReadOccupancy)
+		{
+			OutStats.LastReadOccupancy = Worker.LastReadOccupancy;
+		}
+		if (Worker.PeakReadOccupancy > OutStats.PeakReadOccupancy)
+		{
+			OutStats.PeakReadOccupancy = Worker.PeakReadOccupancy;
+		}
+	}
+}
+
+// Returns the pointer to the free space of the Sending Slot being filled and specifies the maximum amount of bytes that
+// can be written to it. Takes a new free slot if needed. If the Sending Thread still holds every slot, returns no space.
+void BeginWritingToSendingBuffer(byte*& OutSendingBuffer, size_t& OutMaxBytes)
+{
+	if (WriteSendingSlotIndex == INVALID_SENDING_SLOT && !FreeSendingSlotRing.Pop(WriteSendingSlotIndex))
+	{
+		OutSendingBuffer = nullptr;
+		OutMaxBytes = 0;
+		return;
+	}
+
+	SendingSlot& WriteSlot = SendingSlots[WriteSendingSlotIndex];
+	OutSendingBuffer = WriteSlot.Data + WriteSlot.BytesToSend;
+	OutMaxBytes = SendingBufferSize - WriteSlot.BytesToSend;
+}
+
+// Signal that we are done writing to the Sending Slot. If anything was written to it, the slot is handed over to the
+// Sending Thread, which is signaled to begin work.
+void EndWritingToSendingBuffer(size_t SentBytesCount)
+{
+	if (WriteSendingSlotIndex == INVALID_SENDING_SLOT)
+	{
+		return;
+	}
+
+	// While the Sending Slot does contain the data, the information of how much is lost.
+	// Restore it with the passed Sent Bytes Count parameter.
+	SendingSlots[WriteSendingSlotIndex].BytesToSend += SentBytesCount;
+	if (SendingSlots[WriteSendingSlotIndex].BytesToSend == 0)
+	{
+		// Keep the empty slot for next time.
+		return;
+	}
+
+	// There are only as many slot indices as the ring can hold, so this can't fail.
+	FilledSendingSlotRing.Push(WriteSendingSlotIndex);
+	WriteSendingSlotIndex = INVALID_SENDING_SLOT;
+	HandedOverSendingSlotCount++;
+
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_NetDataSending);
+		bDataReadyForSending = true;
+	}
+	Event_DataReadyForSending.notify_one();
+}
+
+// Registers Network-related functions onto the Server platform for use by the Server.
+void LinuxNet_RegisterPlatformFunctions(ServerPlatform& Platform)
+{
+	Platform.ReadPlatformNetEvents = ReadNetEvents;
+	Platform.ReleasePlatformNetEvents = ClearNetEvents;
+
+	Platform.ReadPlatformNetReceptionBuffers = ReadNetReceptionBuffers;
+	Platform.ReleasePlatformNetReceptionBuffers = ReleaseNetReceptionBuffers;
+	Platform.ReadPlatformNetReceptionStats = ReadNetReceptionStats;
+
+	Platform.WriteToPlatformNetSendingBuffer = BeginWritingToSendingBuffer;
+	Platform.ReleasePlatformNetSendingBuffer = EndWritingToSendingBuffer;
+
+	Platform.CloseConnection = CloseConnection;
+}
+
+// Returns the eventfd that becomes readable when Net Threads have posted work for the Server.
+int LinuxNet_GetServerWorkEventHandle()
+{
+	return ServerWorkEventHandle;
+}
+
+// Clears the Server work event, so that the next work posted signals it again. To be called before the Server reads
+// its net data, so that none can come in unsignaled in between.
+void LinuxNet_AcknowledgeServerWork()
+{
+	uint64_t PostedValue;
+	read(ServerWorkEventHandle, &PostedValue, sizeof(PostedValue));
+	bServerWorkPosted.store(false, std::memory_order_release);
+}
+
+// Stops the network threads and closes every socket.
+void LinuxNet_Shutdown()
+{
+	bNetThreadRunning = false;
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		if (Worker.bThreadCreated)
+		{
+			uint64_t WakeValue = 1;
+			write(Worker.WakeEventHandle, &WakeValue, sizeof(WakeValue));
+			pthread_join(Worker.ThreadHandle, nullptr);
+			Worker.bThreadCreated = false;
+		}
+	}
+
+	if (bSendingThreadRunning)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex_NetDataSending);
+			bSendingThreadRunning = false;
+		}
+		Event_DataReadyForSending.notify_one();
+		pthread_join(SendingThreadHandle, nullptr);
+	}
+	SendingIoUring.Shutdown();
+
+	// Every network thread is stopped, so connections can be closed from here. Rings go away along with their workers,
+	// so no receive is left to wait for.
+	for (size_t ConnectionID = 0; ConnectionID < MaxConnectionCount; ConnectionID++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[ActiveConnections[ConnectionID].WorkerIndex.load(std::memory_order_relaxed)];
+		ActiveConnections[ConnectionID].bReceptionArmed = false;
+		Disconnect(Worker, static_cast<ServerPlatform::ConnectionID>(ConnectionID));
+
+		if (ActiveConnections[ConnectionID].ClosingSocketHandle != INVALID_SOCKET_HANDLE)
+		{
+			close(ActiveConnections[ConnectionID].ClosingSocketHandle);
+			ActiveConnections[ConnectionID].ClosingSocketHandle = INVALID_SOCKET_HANDLE;
+		}
+	}
+	FirstDrainingConnectionIndex = 0;
+	DrainingConnectionCount = 0;
+
+	for (size_t WorkerIndex = 0; WorkerIndex < NetWorkerCount; WorkerIndex++)
+	{
+		LinuxNetWorker& Worker = NetWorkers[WorkerIndex];
+		close(Worker.ListenSocketHandle);
+		close(Worker.WakeEventHandle);
+		if (Worker.EpollHandle != INVALID_SOCKET_HANDLE)
+		{
+			close(Worker.EpollHandle);
+		}
+		Worker.IoUring.Shutdown();
+		Worker.ReceptionBufferRing.Shutdown();
+	}
+	NetWorkerCount = 0;
+
+	if (ServerWorkEventHandle != INVALID_SOCKET_HANDLE)
+	{
+		close(ServerWorkEventHandle);
+		ServerWorkEventHandle = INVALID_SOCKET_HANDLE;
+	}
+
+	if (nullptr != ConnectionTablesMemory)
+	{
+		munmap(ConnectionTablesMemory, ConnectionTablesMemorySize);
+		ConnectionTablesMemory = nullptr;
+		MaxConnectionCount = 0;
+	}
+}
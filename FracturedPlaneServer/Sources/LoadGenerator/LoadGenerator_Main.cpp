@@ -0,0 +1,895 @@
+// LoadGenerator_Main.cpp
+// Headless client opening many connections to a Master Server and speaking its protocol, to put load on it for capacity planning
+// or soak it with connections it has to hold.
+
+#include "FPCore/Net/Packet/PacketBodyTypeFunctionDefs.h"
+#include "ServerFramework/NetStreamReassembler.h"
+#include "Tests/ToolArguments.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "algorithm"
+#include "cerrno"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "new"
+#include "vector"
+
+#define INVALID_SOCKET_HANDLE (-1)
+
+#define MAX_EPOLL_EVENTS_PER_WAIT 256
+
+// Longest time the main loop sleeps, which is also how late a connection or message may be opened or sent.
+#define LOOP_WAIT_TIMEOUT_MS 5
+
+// Largest message body the generator sends. Keeps whatever a connection couldn't send yet in a small fixed buffer.
+#define MAX_MESSAGE_SIZE 1024
+#define MAX_UNSENT_SIZE (sizeof(FPCore::Net::NetEncodedPacketHead) + MAX_MESSAGE_SIZE)
+
+// Size of the buffer every connection receives into before decoding.
+#define RECEIVE_BUFFER_SIZE (1024 * 64)
+
+enum class LoadGeneratorMode : uint8_t
+{
+	LOAD = 0, // Connections are opened, authenticated and send messages until the end of the run.
+	SOAK, // Every connection has to be opened, authenticated and held until the end of the run, or the run fails.
+	STORM, // Every connection closes as soon as it is authenticated and opens again, until it ran all of its cycles.
+};
+
+struct LoadGeneratorSettings
+{
+	const char* Host = "127.0.0.1";
+	uint16_t Port = 25000;
+	size_t ConnectionCount = 100;
+	double ConnectRate = 1000.0; // Connections opened per second. 0 opens them all at once.
+	double Duration = 30.0; // Seconds from the first connection to the end of the run.
+	double MessageRate = 1.0; // Messages sent per second by each authenticated connection. 0 sends none.
+	size_t MessageSize = 32; // Characters in each message.
+	const char* UsernamePrefix = "LoadBot"; // Connection N authenticates as <Prefix><N>.
+	double ReportInterval = 1.0; // Seconds between progress reports. 0 only reports at the end.
+
+	LoadGeneratorMode Mode = LoadGeneratorMode::LOAD;
+	size_t StormCycleCount = 200; // Storm mode: connect, authenticate and close cycles run by every connection.
+	int ServerProcessID = 0; // Local Server process whose resident memory gets reported, if any.
+};
+
+enum class BotState : uint8_t
+{
+	IDLE = 0, // Not opened yet.
+	CONNECTING,
+	AUTHENTICATING,
+	AUTHENTICATED,
+	CLOSED, // Failed, refused or closed by the Server. Never reopened.
+};
+
+// A single simulated client.
+struct BotConnection
+{
+	BotState State;
+	bool bSynchronized; // Whether a landscape sync was received.
+	int SocketHandle;
+
+	double ConnectStartTime;
+	double AuthRequestTime;
+	double NextMessageTime;
+	size_t SentMessageCount;
+	size_t CompletedCycleCount;
+
+	NetStreamReassembler Reassembler;
+
+	// The end of a packet the socket couldn't take at once. Nothing else is sent until it is.
+	byte UnsentData[MAX_UNSENT_SIZE];
+	size_t UnsentByteCount;
+};
+
+struct LoadGeneratorStats
+{
+	uint64_t BytesSent;
+	uint64_t BytesReceived;
+	uint64_t MessagesSent;
+	uint64_t MessagesSkipped; // Messages that were due while the connection's socket was still backed up.
+	uint64_t LandscapesReceived;
+	uint64_t HeartbeatsAnswered;
+	uint64_t CompletedCycles;
+
+	uint64_t ConnectFailures;
+	uint64_t AuthRejections;
+	uint64_t ServerClosings; // Connections closed by the Server or failing after being established.
+	uint64_t DecodeErrors; // Invalid packet heads and bodies that don't decode as their type.
+	uint64_t UnexpectedPackets; // Valid packets the protocol doesn't expect at that point.
+
+	size_t OpenedCount;
+	size_t LiveCount; // Connections with a socket, from opening to closing.
+	size_t ConnectedCount;
+	size_t AuthenticatedCount;
+	size_t SynchronizedCount;
+
+	double FirstConnectTime;
+	double LastConnectedTime;
+
+	// Samples, in seconds.
+	std::vector<double> ConnectLatencies;
+	std::vector<double> AuthRoundTrips;
+	std::vector<double> SyncRoundTrips; // From the authentication request to the first landscape sync.
+	std::vector<double> CycleTimes; // Storm mode: from opening a connection to its authentication.
+};
+
+static volatile sig_atomic_t bStopRequested = 0;
+
+static LoadGeneratorSettings Settings;
+static LoadGeneratorStats Stats;
+static BotConnection* Bots = nullptr;
+static int EpollHandle = INVALID_SOCKET_HANDLE;
+static sockaddr_in ServerAddress;
+static std::vector<size_t> ReopeningBotIndices; // Storm mode: bots done with a cycle, opened again on the next loop.
+
+static FPCore::Net::PacketBodyFuncMap PacketBodyFunctionsMap;
+
+static void HandleTerminationSignal(int Signal)
+{
+	bStopRequested = 1;
+}
+
+static double GetMonotonicTimeSeconds()
+{
+	timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return static_cast<double>(Time.tv_sec) + static_cast<double>(Time.tv_nsec) / 1e9;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseArguments(int argc, char** argv, LoadGeneratorSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Host, Port, Connections, ConnectRate, Duration, MessageRate, MessageSize, Prefix, ReportInterval, Mode, Cycles, ServerPid",
+		[&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Host")) { OutSettings.Host = Argument.Value; }
+		else if (Argument.KeyIs("Port")) { OutSettings.Port = static_cast<uint16_t>(strtoul(Argument.Value, nullptr, 10)); }
+		else if (Argument.KeyIs("Connections")) { OutSettings.ConnectionCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("ConnectRate")) { OutSettings.ConnectRate = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("Duration")) { OutSettings.Duration = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("MessageRate")) { OutSettings.MessageRate = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("MessageSize")) { OutSettings.MessageSize = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Prefix")) { OutSettings.UsernamePrefix = Argument.Value; }
+		else if (Argument.KeyIs("ReportInterval")) { OutSettings.ReportInterval = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("Mode"))
+		{
+			if (strcmp(Argument.Value, "Load") == 0) { OutSettings.Mode = LoadGeneratorMode::LOAD; }
+			else if (strcmp(Argument.Value, "Soak") == 0) { OutSettings.Mode = LoadGeneratorMode::SOAK; }
+			else if (strcmp(Argument.Value, "Storm") == 0) { OutSettings.Mode = LoadGeneratorMode::STORM; }
+			else
+			{
+				std::cerr << "Unknown Mode '" << Argument.Value << "', expected Load, Soak or Storm.\n";
+				return false;
+			}
+		}
+		else if (Argument.KeyIs("Cycles")) { OutSettings.StormCycleCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("ServerPid")) { OutSettings.ServerProcessID = static_cast<int>(strtol(Argument.Value, nullptr, 10)); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+static void CloseBot(BotConnection& Bot)
+{
+	if (Bot.SocketHandle != INVALID_SOCKET_HANDLE)
+	{
+		close(Bot.SocketHandle);
+		Bot.SocketHandle = INVALID_SOCKET_HANDLE;
+		Stats.LiveCount--;
+	}
+
+	if (Bot.State == BotState::AUTHENTICATED)
+	{
+		Stats.AuthenticatedCount--;
+	}
+	Bot.State = BotState::CLOSED;
+}
+
+// Bots are told apart in epoll events by their index.
+static void WatchBotSocket(size_t BotIndex, int Operation, uint32_t Events)
+{
+	epoll_event Event = {};
+	Event.events = Events;
+	Event.data.u64 = BotIndex;
+	epoll_ctl(EpollHandle, Operation, Bots[BotIndex].SocketHandle, &Event);
+}
+
+// Sends a whole encoded packet, keeping whatever the socket doesn't take for later. Returns false if the bot was closed.
+static bool SendEncodedPacket(size_t BotIndex, const byte* Data, size_t DataSize)
+{
+	BotConnection& Bot = Bots[BotIndex];
+
+	ssize_t SentBytes = send(Bot.SocketHandle, Data, DataSize, MSG_NOSIGNAL | MSG_DONTWAIT);
+	if (SentBytes < 0)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			Stats.ServerClosings++;
+			CloseBot(Bot);
+			return false;
+		}
+		SentBytes = 0;
+	}
+	Stats.BytesSent += SentBytes;
+
+	if (static_cast<size_t>(SentBytes) < DataSize)
+	{
+		Bot.UnsentByteCount = DataSize - SentBytes;
+		memcpy(Bot.UnsentData, Data + SentBytes, Bot.UnsentByteCount);
+		WatchBotSocket(BotIndex, EPOLL_CTL_MOD, EPOLLIN | EPOLLOUT);
+	}
+	return true;
+}
+
+// Encodes the passed body def as a packet of the passed type, with the FPCore marshalling functions, and sends it.
+static bool SendPacket(size_t BotIndex, FPCore::Net::PacketBodyType BodyType, void* BodyDef)
+{
+	// A byte more than the body, as string bodies are marshalled along with a terminator that isn't sent.
+	alignas(FPCore::Net::NetEncodedPacketHead) byte PacketData[MAX_UNSENT_SIZE + 1];
+
+	size_t BodySize = PacketBodyFunctionsMap[BodyType].GetMarshalledSize(BodyDef);
+	if (BodySize > MAX_UNSENT_SIZE - sizeof(FPCore::Net::NetEncodedPacketHead))
+	{
+		return false;
+	}
+
+	FPCore::Net::NetEncodedPacketHead Head = {};
+	Head.BodyType = BodyType;
+	Head.BodySize = static_cast<FPCore::Net::PacketBodySize_t>(BodySize);
+	memcpy(PacketData, &Head, sizeof(Head));
+
+	if (!PacketBodyFunctionsMap[BodyType].MarshalTo(BodyDef, PacketData + sizeof(Head), sizeof(PacketData) - sizeof(Head)))
+	{
+		return false;
+	}
+
+	return SendEncodedPacket(BotIndex, PacketData, sizeof(Head) + BodySize);
+}
+
+static void SendAuthenticationRequest(size_t BotIndex, double Now)
+{
+	FPCore::Net::PacketBodyDef_Authentication Request = {};
+	snprintf(Request.Request.Username, sizeof(Request.Request.Username), "%s%zu", Settings.UsernamePrefix, BotIndex);
+
+	Bots[BotIndex].AuthRequestTime = Now;
+	Bots[BotIndex].State = BotState::AUTHENTICATING;
+	SendPacket(BotIndex, FPCore::Net::PacketBodyType::AUTHENTICATION, &Request);
+}
+
+static void SendMessage(size_t BotIndex)
+{
+	BotConnection& Bot = Bots[BotIndex];
+
+	char Message[MAX_MESSAGE_SIZE + 1];
+	int HeaderLength = snprintf(Message, sizeof(Message), "%s%zu message %zu ", Settings.UsernamePrefix, BotIndex, Bot.SentMessageCount);
+	size_t MessageLength = Settings.MessageSize;
+	for (size_t CharIndex = static_cast<size_t>(HeaderLength); CharIndex < MessageLength; CharIndex++)
+	{
+		Message[CharIndex] = 'a' + CharIndex % 26;
+	}
+	Message[MessageLength] = '\0';
+
+	if (SendPacket(BotIndex, FPCore::Net::PacketBodyType::MESSAGE, Message))
+	{
+		Bot.SentMessageCount++;
+		Stats.MessagesSent++;
+	}
+}
+
+// Starts connecting a bot that has no socket.
+static void OpenBotConnection(size_t BotIndex, double Now)
+{
+	BotConnection& Bot = Bots[BotIndex];
+	Bot.ConnectStartTime = Now;
+	Bot.UnsentByteCount = 0;
+	Bot.Reassembler.Reset();
+
+	Bot.SocketHandle = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_TCP);
+	if (Bot.SocketHandle == INVALID_SOCKET_HANDLE)
+	{
+		Stats.ConnectFailures++;
+		Bot.State = BotState::CLOSED;
+		return;
+	}
+	Stats.LiveCount++;
+
+	int NoDelay = 1;
+	setsockopt(Bot.SocketHandle, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+
+	if (connect(Bot.SocketHandle, reinterpret_cast<sockaddr*>(&ServerAddress), sizeof(ServerAddress)) != 0 && errno != EINPROGRESS)
+	{
+		Stats.ConnectFailures++;
+		CloseBot(Bot);
+		return;
+	}
+
+	// Connection is done once the socket becomes writable.
+	Bot.State = BotState::CONNECTING;
+	WatchBotSocket(BotIndex, EPOLL_CTL_ADD, EPOLLOUT);
+}
+
+// Starts connecting every bot due by Now, given the connect rate, and every bot starting a new storm cycle.
+static void OpenDueConnections(double Now, double StartTime)
+{
+	size_t DueCount = Settings.ConnectionCount;
+	if (Settings.ConnectRate > 0.0)
+	{
+		DueCount = std::min(Settings.ConnectionCount, static_cast<size_t>((Now - StartTime) * Settings.ConnectRate) + 1);
+	}
+
+	for (; Stats.OpenedCount < DueCount; Stats.OpenedCount++)
+	{
+		OpenBotConnection(Stats.OpenedCount, Now);
+	}
+
+	for (size_t BotIndex : ReopeningBotIndices)
+	{
+		OpenBotConnection(BotIndex, Now);
+	}
+	ReopeningBotIndices.clear();
+}
+
+// Closes a bot that was just authenticated, and has it opened again unless it ran all of its storm cycles.
+static void FinishStormCycle(size_t BotIndex, double Now)
+{
+	BotConnection& Bot = Bots[BotIndex];
+	Stats.CycleTimes.push_back(Now - Bot.ConnectStartTime);
+	Stats.CompletedCycles++;
+	CloseBot(Bot);
+
+	if (++Bot.CompletedCycleCount < Settings.StormCycleCount)
+	{
+		ReopeningBotIndices.push_back(BotIndex);
+	}
+}
+
+// Sends every message due by Now. Messages of a backed up connection are skipped rather than queued.
+static void SendDueMessages(double Now)
+{
+	if (Settings.MessageRate <= 0.0)
+	{
+		return;
+	}
+
+	double MessageInterval = 1.0 / Settings.MessageRate;
+	for (size_t BotIndex = 0; BotIndex < Stats.OpenedCount; BotIndex++)
+	{
+		BotConnection& Bot = Bots[BotIndex];
+		while (Bot.State == BotState::AUTHENTICATED && Bot.NextMessageTime <= Now)
+		{
+			Bot.NextMessageTime += MessageInterval;
+			if (Bot.UnsentByteCount > 0)
+			{
+				Stats.MessagesSkipped++;
+				continue;
+			}
+			SendMessage(BotIndex);
+		}
+	}
+}
+
+static void OnConnected(size_t BotIndex, double Now)
+{
+	BotConnection& Bot = Bots[BotIndex];
+
+	int SocketError = 0;
+	socklen_t SocketErrorSize = sizeof(SocketError);
+	if (getsockopt(Bot.SocketHandle, SOL_SOCKET, SO_ERROR, &SocketError, &SocketErrorSize) != 0 || SocketError != 0)
+	{
+		Stats.ConnectFailures++;
+		CloseBot(Bot);
+		return;
+	}
+
+	Stats.ConnectedCount++;
+	Stats.LastConnectedTime = Now;
+	Stats.ConnectLatencies.push_back(Now - Bot.ConnectStartTime);
+
+	WatchBotSocket(BotIndex, EPOLL_CTL_MOD, EPOLLIN);
+	SendAuthenticationRequest(BotIndex, Now);
+}
+
+// Decodes a single packet received by a bot.
+static void HandlePacket(size_t BotIndex, const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body, double Now)
+{
+	BotConnection& Bot = Bots[BotIndex];
+
+	// Bodies are mustered in place by FPCore, and may not be aligned where they were received: work on a copy.
+	alignas(8) static byte BodyDef[NetStreamReassembler::MAX_ENCODED_PACKET_SIZE];
+	memcpy(BodyDef, Body, Head.BodySize);
+
+	switch (Head.BodyType)
+	{
+	case FPCore::Net::PacketBodyType::AUTHENTICATION:
+		{
+			if (Head.BodySize != PacketBodyFunctionsMap[Head.BodyType].GetMarshalledSize(BodyDef)
+				|| !PacketBodyFunctionsMap[Head.BodyType].Muster(BodyDef, Head.BodySize))
+			{
+				Stats.DecodeErrors++;
+				return;
+			}
+			if (Bot.State != BotState::AUTHENTICATING)
+			{
+				Stats.UnexpectedPackets++;
+				return;
+			}
+
+			const FPCore::Net::PacketBodyDef_Authentication& Response = *reinterpret_cast<FPCore::Net::PacketBodyDef_Authentication*>(BodyDef);
+			if (!Response.Response.bAccepted)
+			{
+				Stats.AuthRejections++;
+				CloseBot(Bot);
+				return;
+			}
+
+			Stats.AuthRoundTrips.push_back(Now - Bot.AuthRequestTime);
+			if (Settings.Mode == LoadGeneratorMode::STORM)
+			{
+				FinishStormCycle(BotIndex, Now);
+				return;
+			}
+
+			Stats.AuthenticatedCount++;
+			Bot.State = BotState::AUTHENTICATED;
+
+			// Spread the first messages of every bot over a whole interval, so that they don't all send at once.
+			if (Settings.MessageRate > 0.0)
+			{
+				Bot.NextMessageTime = Now + (static_cast<double>(BotIndex % 997) / 997.0) / Settings.MessageRate;
+			}
+		}
+		break;
+	case FPCore::Net::PacketBodyType::WORLD_SYNC_LANDSCAPE:
+		{
+			if (Head.BodySize != PacketBodyFunctionsMap[Head.BodyType].GetMarshalledSize(BodyDef)
+				|| !PacketBodyFunctionsMap[Head.BodyType].Muster(BodyDef, Head.BodySize))
+			{
+				Stats.DecodeErrors++;
+				return;
+			}
+
+			Stats.LandscapesReceived++;
+			if (!Bot.bSynchronized)
+			{
+				Bot.bSynchronized = true;
+				Stats.SynchronizedCount++;
+				Stats.SyncRoundTrips.push_back(Now - Bot.AuthRequestTime);
+			}
+		}
+		break;
+	case FPCore::Net::PacketBodyType::HEARTBEAT:
+		{
+			if (Head.BodySize != PacketBodyFunctionsMap[Head.BodyType].GetMarshalledSize(BodyDef)
+				|| !PacketBodyFunctionsMap[Head.BodyType].Muster(BodyDef, Head.BodySize))
+			{
+				Stats.DecodeErrors++;
+				return;
+			}
+
+			// Send the ping back as a pong. A backed up connection skips it, the Server will ping again.
+			if (Bot.UnsentByteCount == 0 && SendPacket(BotIndex, FPCore::Net::PacketBodyType::HEARTBEAT, BodyDef))
+			{
+				Stats.HeartbeatsAnswered++;
+			}
+		}
+		break;
+	default:
+		Stats.UnexpectedPackets++;
+		break;
+	}
+}
+
+static void ReceiveBotData(size_t BotIndex, double Now)
+{
+	static byte ReceiveBuffer[RECEIVE_BUFFER_SIZE];
+	BotConnection& Bot = Bots[BotIndex];
+
+	while (Bot.State != BotState::CLOSED)
+	{
+		ssize_t ReceivedBytes = recv(Bot.SocketHandle, ReceiveBuffer, sizeof(ReceiveBuffer), MSG_DONTWAIT);
+		if (ReceivedBytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			return;
+		}
+		if (ReceivedBytes <= 0)
+		{
+			Stats.ServerClosings++;
+			CloseBot(Bot);
+			return;
+		}
+		Stats.BytesReceived += ReceivedBytes;
+
+		bool bValidStream = Bot.Reassembler.Consume(ReceiveBuffer, ReceivedBytes,
+			[&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+			{
+				// Whatever follows a packet the bot closed on is left unanswered.
+				if (Bot.State != BotState::CLOSED)
+				{
+					HandlePacket(BotIndex, Head, Body, Now);
+				}
+			});
+
+		// Nothing more can be read from a stream once a packet head is invalid.
+		if (!bValidStream)
+		{
+			Stats.DecodeErrors++;
+			CloseBot(Bot);
+			return;
+		}
+	}
+}
+
+static void FlushUnsentData(size_t BotIndex)
+{
+	BotConnection& Bot = Bots[BotIndex];
+
+	ssize_t SentBytes = send(Bot.SocketHandle, Bot.UnsentData, Bot.UnsentByteCount, MSG_NOSIGNAL | MSG_DONTWAIT);
+	if (SentBytes < 0)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			Stats.ServerClosings++;
+			CloseBot(Bot);
+		}
+		return;
+	}
+	Stats.BytesSent += SentBytes;
+
+	Bot.UnsentByteCount -= SentBytes;
+	memmove(Bot.UnsentData, Bot.UnsentData + SentBytes, Bot.UnsentByteCount);
+	if (Bot.UnsentByteCount == 0)
+	{
+		WatchBotSocket(BotIndex, EPOLL_CTL_MOD, EPOLLIN);
+	}
+}
+
+static void HandleBotEvent(size_t BotIndex, uint32_t Events, double Now)
+{
+	BotConnection& Bot = Bots[BotIndex];
+
+	// Closed earlier in the same wait.
+	if (Bot.State == BotState::CLOSED)
+	{
+		return;
+	}
+
+	if (Bot.State == BotState::CONNECTING)
+	{
+		OnConnected(BotIndex, Now);
+		return;
+	}
+
+	if (Events & EPOLLIN)
+	{
+		ReceiveBotData(BotIndex, Now);
+	}
+	else if (Events & (EPOLLERR | EPOLLHUP))
+	{
+		Stats.ServerClosings++;
+		CloseBot(Bot);
+	}
+
+	if (Bot.State != BotState::CLOSED && (Events & EPOLLOUT) && Bot.UnsentByteCount > 0)
+	{
+		FlushUnsentData(BotIndex);
+	}
+}
+
+static void PrintProgress(double Elapsed, double IntervalSeconds, uint64_t IntervalBytesSent, uint64_t IntervalBytesReceived, uint64_t IntervalMessages)
+{
+	printf("[%6.1fs] open %zu/%zu connected %zu auth %zu synced %zu | tx %.1f KB/s rx %.1f KB/s msg %.0f/s"
+		" | errors: connect %llu closed %llu decode %llu unexpected %llu\n",
+		Elapsed, Stats.OpenedCount, Settings.ConnectionCount, Stats.ConnectedCount, Stats.AuthenticatedCount, Stats.SynchronizedCount,
+		IntervalBytesSent / IntervalSeconds / 1024.0, IntervalBytesReceived / IntervalSeconds / 1024.0, IntervalMessages / IntervalSeconds,
+		static_cast<unsigned long long>(Stats.ConnectFailures), static_cast<unsigned long long>(Stats.ServerClosings),
+		static_cast<unsigned long long>(Stats.DecodeErrors), static_cast<unsigned long long>(Stats.UnexpectedPackets));
+	fflush(stdout);
+}
+
+// Prints the percentiles of the passed samples, in milliseconds.
+static void PrintLatencies(const char* Name, std::vector<double>& Samples)
+{
+	if (Samples.empty())
+	{
+		printf("%-22s no samples\n", Name);
+		return;
+	}
+
+	std::sort(Samples.begin(), Samples.end());
+	auto Percentile = [&](double Fraction) { return Samples[static_cast<size_t>(Fraction * (Samples.size() - 1) + 0.5)] * 1000.0; };
+	printf("%-22s p50 %8.3f ms  p90 %8.3f ms  p99 %8.3f ms  max %8.3f ms  (%zu samples)\n",
+		Name, Percentile(0.5), Percentile(0.9), Percentile(0.99), Samples.back() * 1000.0, Samples.size());
+}
+
+// Returns the resident memory of the process, in kilobytes, or 0 if it can't be read.
+static size_t ReadProcessResidentKilobytes(int ProcessID)
+{
+	char StatusPath[64];
+	snprintf(StatusPath, sizeof(StatusPath), "/proc/%d/status", ProcessID);
+	FILE* StatusFile = fopen(StatusPath, "r");
+	if (nullptr == StatusFile)
+	{
+		return 0;
+	}
+
+	size_t ResidentKilobytes = 0;
+	char Line[256];
+	while (fgets(Line, sizeof(Line), StatusFile))
+	{
+		if (strncmp(Line, "VmRSS:", 6) == 0)
+		{
+			ResidentKilobytes = strtoull(Line + 6, nullptr, 10);
+			break;
+		}
+	}
+	fclose(StatusFile);
+	return ResidentKilobytes;
+}
+
+// Checks that every connection of a soak run made it through to the end. Returns whether the run passed.
+static bool CheckSoakResult(size_t ServerStartKilobytes, size_t ServerEndKilobytes)
+{
+	if (Settings.ServerProcessID != 0)
+	{
+		printf("Server resident memory: %zu KB before the run, %zu KB at the end", ServerStartKilobytes, ServerEndKilobytes);
+		if (Stats.AuthenticatedCount > 0 && ServerEndKilobytes > ServerStartKilobytes)
+		{
+			printf(", %.2f KB per held connection", static_cast<double>(ServerEndKilobytes - ServerStartKilobytes) / Stats.AuthenticatedCount);
+		}
+		printf(".\n");
+	}
+
+	bool bPassed = true;
+	auto Fail = [&bPassed](const char* Reason, size_t Count)
+	{
+		printf("Soak FAILED: %zu %s.\n", Count, Reason);
+		bPassed = false;
+	};
+
+	if (Stats.OpenedCount < Settings.ConnectionCount)
+	{
+		Fail("connections never opened, the run ended first", Settings.ConnectionCount - Stats.OpenedCount);
+	}
+	if (Stats.ConnectFailures > 0)
+	{
+		Fail("connections failed to connect", Stats.ConnectFailures);
+	}
+	if (Stats.AuthRejections > 0)
+	{
+		Fail("authentications rejected", Stats.AuthRejections);
+	}
+	if (Stats.ServerClosings > 0)
+	{
+		Fail("connections closed by the Server", Stats.ServerClosings);
+	}
+	if (Stats.DecodeErrors > 0 || Stats.UnexpectedPackets > 0)
+	{
+		Fail("invalid or unexpected packets received", Stats.DecodeErrors + Stats.UnexpectedPackets);
+	}
+	if (bPassed && Stats.AuthenticatedCount < Settings.ConnectionCount)
+	{
+		Fail("connections still waiting on their authentication", Settings.ConnectionCount - Stats.AuthenticatedCount);
+	}
+
+	if (bPassed)
+	{
+		printf("Soak PASSED: all %zu connections authenticated and held until the end.\n", Settings.ConnectionCount);
+	}
+	return bPassed;
+}
+
+// Checks that every connection ran all of its storm cycles without a single error. Returns whether the run passed.
+static bool CheckStormResult()
+{
+	uint64_t ExpectedCycles = static_cast<uint64_t>(Settings.ConnectionCount) * Settings.StormCycleCount;
+	uint64_t ErrorCount = Stats.ConnectFailures + Stats.AuthRejections + Stats.ServerClosings + Stats.DecodeErrors + Stats.UnexpectedPackets;
+	if (ErrorCount > 0 || Stats.CompletedCycles < ExpectedCycles)
+	{
+		printf("Storm FAILED: %llu of %llu cycles completed, %llu errors.\n", static_cast<unsigned long long>(Stats.CompletedCycles),
+			static_cast<unsigned long long>(ExpectedCycles), static_cast<unsigned long long>(ErrorCount));
+		return false;
+	}
+
+	printf("Storm PASSED: all %llu cycles completed.\n", static_cast<unsigned long long>(ExpectedCycles));
+	return true;
+}
+
+static void PrintSummary(double Elapsed)
+{
+	double ConnectSpan = Stats.LastConnectedTime - Stats.FirstConnectTime;
+
+	printf("\nLoad Generator summary after %.1f s:\n", Elapsed);
+	printf("Connections: %zu opened, %zu established", Stats.OpenedCount, Stats.ConnectedCount);
+	if (Stats.ConnectedCount > 1 && ConnectSpan > 0.0)
+	{
+		printf(" at %.1f connections/s", Stats.ConnectedCount / ConnectSpan);
+	}
+	printf(", %zu still authenticated, %zu synchronized.\n", Stats.AuthenticatedCount, Stats.SynchronizedCount);
+
+	PrintLatencies("Connect latency:", Stats.ConnectLatencies);
+	PrintLatencies("Authentication RTT:", Stats.AuthRoundTrips);
+	PrintLatencies("Landscape sync RTT:", Stats.SyncRoundTrips);
+	if (Settings.Mode == LoadGeneratorMode::STORM)
+	{
+		printf("Storm: %llu connect, authenticate and close cycles (%.1f/s).\n", static_cast<unsigned long long>(Stats.CompletedCycles),
+			Stats.CompletedCycles / Elapsed);
+		PrintLatencies("Storm cycle:", Stats.CycleTimes);
+	}
+
+	printf("Traffic: sent %llu bytes (%.1f KB/s), received %llu bytes (%.1f KB/s), %llu messages sent (%.1f/s), %llu skipped on backed up sockets, %llu landscapes received, %llu heartbeats answered.\n",
+		static_cast<unsigned long long>(Stats.BytesSent), Stats.BytesSent / Elapsed / 1024.0,
+		static_cast<unsigned long long>(Stats.BytesReceived), Stats.BytesReceived / Elapsed / 1024.0,
+		static_cast<unsigned long long>(Stats.MessagesSent), Stats.MessagesSent / Elapsed,
+		static_cast<unsigned long long>(Stats.MessagesSkipped), static_cast<unsigned long long>(Stats.LandscapesReceived),
+		static_cast<unsigned long long>(Stats.HeartbeatsAnswered));
+	printf("Errors: %llu connect failures, %llu authentications rejected, %llu connections closed by the Server, %llu decode errors, %llu unexpected packets.\n",
+		static_cast<unsigned long long>(Stats.ConnectFailures), static_cast<unsigned long long>(Stats.AuthRejections),
+		static_cast<unsigned long long>(Stats.ServerClosings), static_cast<unsigned long long>(Stats.DecodeErrors),
+		static_cast<unsigned long long>(Stats.UnexpectedPackets));
+}
+
+int main(int argc, char** argv)
+{
+	if (!ParseArguments(argc, argv, Settings) || Settings.ConnectionCount == 0 || Settings.MessageSize > MAX_MESSAGE_SIZE
+		|| Settings.Duration <= 0.0 || Settings.StormCycleCount == 0)
+	{
+		std::cerr << "Usage: FracturedPlaneLoadGenerator [Host=127.0.0.1] [Port=25000] [Connections=100] [ConnectRate=1000] [Duration=30]\n"
+			<< "\t[MessageRate=1] [MessageSize=32] [Prefix=LoadBot] [ReportInterval=1] [Mode=Load|Soak|Storm] [Cycles=200] [ServerPid=0]\n"
+			<< "MessageSize is at most " << MAX_MESSAGE_SIZE << ".\n"
+			<< "Mode=Soak fails unless every connection is authenticated and held until the end, e.g. against a Server\n"
+			<< "configured with MaxConnectionCount = MaxClientCount = 10240:\n"
+			<< "\tMode=Soak Connections=10000 ConnectRate=1000 Duration=30 MessageRate=0 ServerPid=<Server process ID>\n"
+			<< "Mode=Storm has every connection close once authenticated and open again, Cycles times, and fails on any error.\n"
+			<< "The run ends once all cycles are done, e.g. 16 connections of 200 cycles:\n"
+			<< "\tMode=Storm Connections=16 Cycles=200 Duration=60\n";
+		return 1;
+	}
+
+	ServerAddress = {};
+	ServerAddress.sin_family = AF_INET;
+	ServerAddress.sin_port = htons(Settings.Port);
+	if (inet_pton(AF_INET, Settings.Host, &ServerAddress.sin_addr) != 1)
+	{
+		std::cerr << "Invalid Host '" << Settings.Host << "', expected an IPv4 address.\n";
+		return 1;
+	}
+
+	// Stop early but still report on interruption.
+	{
+		struct sigaction TerminationAction = {};
+		TerminationAction.sa_handler = HandleTerminationSignal;
+		sigemptyset(&TerminationAction.sa_mask);
+		sigaction(SIGINT, &TerminationAction, nullptr);
+		sigaction(SIGTERM, &TerminationAction, nullptr);
+	}
+
+	// Every connection holds a file descriptor.
+	{
+		rlimit FileDescriptorLimit;
+		rlim_t RequiredFileDescriptorCount = Settings.ConnectionCount + 64;
+		if (getrlimit(RLIMIT_NOFILE, &FileDescriptorLimit) == 0 && FileDescriptorLimit.rlim_cur < RequiredFileDescriptorCount)
+		{
+			FileDescriptorLimit.rlim_cur = std::min(FileDescriptorLimit.rlim_max, RequiredFileDescriptorCount);
+			setrlimit(RLIMIT_NOFILE, &FileDescriptorLimit);
+			if (FileDescriptorLimit.rlim_cur < RequiredFileDescriptorCount)
+			{
+				std::cerr << "Warning: The process may only open " << FileDescriptorLimit.rlim_cur << " files, which is not enough for "
+					<< Settings.ConnectionCount << " connections.\n";
+			}
+		}
+	}
+
+	FPCore::Net::InitializePacketBodyTypeFunctionsDefMap(PacketBodyFunctionsMap);
+
+	// Bots and the pending data of their reassemblers. Pages are only committed for the bots that use them.
+	size_t BotsSize = Settings.ConnectionCount * sizeof(BotConnection);
+	size_t PendingDataSize = Settings.ConnectionCount * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE;
+	void* MappedMemory = mmap(nullptr, BotsSize + PendingDataSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	EpollHandle = epoll_create1(0);
+	if (MAP_FAILED == MappedMemory || EpollHandle == INVALID_SOCKET_HANDLE)
+	{
+		std::cerr << "Failed to allocate Load Generator resources. Error Code: " << errno << "\n";
+		return 1;
+	}
+
+	Bots = static_cast<BotConnection*>(MappedMemory);
+	byte* PendingData = static_cast<byte*>(MappedMemory) + BotsSize;
+	for (size_t BotIndex = 0; BotIndex < Settings.ConnectionCount; BotIndex++)
+	{
+		new (&Bots[BotIndex]) BotConnection{};
+		Bots[BotIndex].SocketHandle = INVALID_SOCKET_HANDLE;
+		Bots[BotIndex].Reassembler.Initialize(PendingData + BotIndex * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+	}
+
+	Stats.ConnectLatencies.reserve(Settings.ConnectionCount);
+	Stats.AuthRoundTrips.reserve(Settings.ConnectionCount);
+	Stats.SyncRoundTrips.reserve(Settings.ConnectionCount);
+
+	size_t ServerStartKilobytes = Settings.ServerProcessID != 0 ? ReadProcessResidentKilobytes(Settings.ServerProcessID) : 0;
+
+	printf("Opening %zu connections to %s:%u at %.0f connections/s, %.2f messages of %zu characters per second each, for %.1f s.\n",
+		Settings.ConnectionCount, Settings.Host, Settings.Port, Settings.ConnectRate, Settings.MessageRate, Settings.MessageSize, Settings.Duration);
+
+	double StartTime = GetMonotonicTimeSeconds();
+	Stats.FirstConnectTime = StartTime;
+
+	double NextReportTime = StartTime + Settings.ReportInterval;
+	double LastReportTime = StartTime;
+	uint64_t LastReportBytesSent = 0;
+	uint64_t LastReportBytesReceived = 0;
+	uint64_t LastReportMessages = 0;
+
+	epoll_event Events[MAX_EPOLL_EVENTS_PER_WAIT];
+	double Now = StartTime;
+	while (!bStopRequested && Now - StartTime < Settings.Duration)
+	{
+		// Storm bots that all ran their cycles or failed have nothing left to do.
+		if (Settings.Mode == LoadGeneratorMode::STORM && Stats.OpenedCount == Settings.ConnectionCount && Stats.LiveCount == 0
+			&& ReopeningBotIndices.empty())
+		{
+			break;
+		}
+
+		OpenDueConnections(Now, StartTime);
+		SendDueMessages(Now);
+
+		int EventCount = epoll_wait(EpollHandle, Events, MAX_EPOLL_EVENTS_PER_WAIT, LOOP_WAIT_TIMEOUT_MS);
+		Now = GetMonotonicTimeSeconds();
+		for (int EventIndex = 0; EventIndex < EventCount; EventIndex++)
+		{
+			HandleBotEvent(static_cast<size_t>(Events[EventIndex].data.u64), Events[EventIndex].events, Now);
+		}
+
+		if (Settings.ReportInterval > 0.0 && Now >= NextReportTime)
+		{
+			PrintProgress(Now - StartTime, Now - LastReportTime, Stats.BytesSent - LastReportBytesSent,
+				Stats.BytesReceived - LastReportBytesReceived, Stats.MessagesSent - LastReportMessages);
+			LastReportTime = Now;
+			LastReportBytesSent = Stats.BytesSent;
+			LastReportBytesReceived = Stats.BytesReceived;
+			LastReportMessages = Stats.MessagesSent;
+			NextReportTime = Now + Settings.ReportInterval;
+		}
+	}
+
+	PrintSummary(Now - StartTime);
+
+	bool bPassed = true;
+	if (Settings.Mode == LoadGeneratorMode::SOAK)
+	{
+		size_t ServerEndKilobytes = Settings.ServerProcessID != 0 ? ReadProcessResidentKilobytes(Settings.ServerProcessID) : 0;
+		bPassed = !bStopRequested && CheckSoakResult(ServerStartKilobytes, ServerEndKilobytes);
+	}
+	else if (Settings.Mode == LoadGeneratorMode::STORM)
+	{
+		bPassed = CheckStormResult();
+	}
+
+	// Cleanup
+	for (size_t BotIndex = 0; BotIndex < Settings.ConnectionCount; BotIndex++)
+	{
+		if (Bots[BotIndex].SocketHandle != INVALID_SOCKET_HANDLE)
+		{
+			close(Bots[BotIndex].SocketHandle);
+		}
+	}
+	close(EpollHandle);
+	munmap(MappedMemory, BotsSize + PendingDataSize);
+
+	return bPassed ? 0 : 1;
+}
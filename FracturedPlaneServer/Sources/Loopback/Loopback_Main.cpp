@@ -0,0 +1,335 @@
+// Loopback_Main.cpp
+// Main Entry point of the Loopback benchmark, running the Server against thousands of virtual clients with a fixed DeltaTime.
+
+#include "Loopback/Loopback_Platform.h"
+
+#include "FPCore/Net/Packet/AuthenticationPackets.h"
+#include "FPCore/Net/Packet/WorldSyncPackets.h"
+#include "Tests/ToolArguments.h"
+
+#include "algorithm"
+#include "chrono"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "thread"
+#include "vector"
+
+// Updates run without every virtual client being authenticated and synchronized before giving up.
+#define MAX_SETTLING_UPDATE_COUNT 1000
+
+struct LoopbackBenchSettings
+{
+	size_t ClientCount = 4096;
+	size_t UpdateCount = 600;
+	size_t MessagesPerUpdate = 1; // Messages each virtual client sends before each measured update.
+	double DeltaTime = 1.0 / 60.0;
+	const char* ConfigPath = nullptr;
+	bool bVerbose = false; // Whether to let the Server log while updating.
+};
+
+// State of a virtual client, as seen from the packets the Server sent it.
+struct VirtualClient
+{
+	ServerPlatform::ConnectionID ConnectionID;
+	bool bAuthenticated;
+	bool bSynchronized;
+	size_t AuthenticatedUpdateIndex; // Update the authentication response was sent in.
+};
+
+struct LoopbackBenchState
+{
+	std::vector<VirtualClient> Clients;
+	std::vector<size_t> ClientIndexByConnectionID;
+
+	size_t UpdateIndex = 0; // Update whose sent packets are being read.
+	size_t AuthenticatedCount = 0;
+	size_t SynchronizedCount = 0;
+	size_t LateSynchronizedCount = 0; // Clients whose landscape sync failed at least once, only coming in a later update.
+	uint64_t ReadPacketCount = 0;
+	uint64_t ReadByteCount = 0;
+	uint32_t SentDataHash = 2166136261u; // FNV-1a of every packet the Server sent, to compare runs with.
+};
+
+static void HashBytes(uint32_t& Hash, const void* Data, size_t Size)
+{
+	const byte* Bytes = static_cast<const byte*>(Data);
+	for (size_t ByteIndex = 0; ByteIndex < Size; ByteIndex++)
+	{
+		Hash = (Hash ^ Bytes[ByteIndex]) * 16777619u;
+	}
+}
+
+// Context = Loopback Bench State
+static void HandleSentPacket(const LoopbackSentPacket& Packet, void* Context)
+{
+	LoopbackBenchState& State = *static_cast<LoopbackBenchState*>(Context);
+
+	State.ReadPacketCount++;
+	State.ReadByteCount += Packet.BodySize;
+	HashBytes(State.SentDataHash, &Packet.ConnectionID, sizeof(Packet.ConnectionID));
+	HashBytes(State.SentDataHash, &Packet.BodyType, sizeof(Packet.BodyType));
+	HashBytes(State.SentDataHash, Packet.Body, Packet.BodySize);
+
+	VirtualClient& Client = State.Clients[State.ClientIndexByConnectionID[Packet.ConnectionID]];
+	switch (Packet.BodyType)
+	{
+	case FPCore::Net::PacketBodyType::AUTHENTICATION:
+		{
+			FPCore::Net::PacketBodyDef_Authentication Response;
+			memcpy(&Response, Packet.Body, sizeof(Response) < Packet.BodySize ? sizeof(Response) : Packet.BodySize);
+			if (Response.Response.bAccepted && !Client.bAuthenticated)
+			{
+				Client.bAuthenticated = true;
+				Client.AuthenticatedUpdateIndex = State.UpdateIndex;
+				State.AuthenticatedCount++;
+			}
+		}
+		break;
+	case FPCore::Net::PacketBodyType::WORLD_SYNC_LANDSCAPE:
+		if (!Client.bSynchronized)
+		{
+			// The Server syncs Clients in the update that authenticates them: a later sync means it failed at first.
+			Client.bSynchronized = true;
+			State.SynchronizedCount++;
+			if (!Client.bAuthenticated || Client.AuthenticatedUpdateIndex != State.UpdateIndex)
+			{
+				State.LateSynchronizedCount++;
+			}
+		}
+		break;
+	case FPCore::Net::PacketBodyType::HEARTBEAT:
+		// Answer pings as is, received by the Server on the next update.
+		Loopback_SendPacket(Packet.ConnectionID, FPCore::Net::PacketBodyType::HEARTBEAT, Packet.Body, Packet.BodySize);
+		break;
+	default:
+		break;
+	}
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseBenchArguments(int argc, char** argv, LoopbackBenchSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Clients, Updates, Messages, DeltaTime, Config, Verbose", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Clients")) { OutSettings.ClientCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Updates")) { OutSettings.UpdateCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Messages")) { OutSettings.MessagesPerUpdate = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("DeltaTime")) { OutSettings.DeltaTime = strtod(Argument.Value, nullptr); }
+		else if (Argument.KeyIs("Config")) { OutSettings.ConfigPath = Argument.Value; }
+		else if (Argument.KeyIs("Verbose")) { OutSettings.bVerbose = strtoull(Argument.Value, nullptr, 10) != 0; }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+// Reads the Server Config from the file at Path. Returns false if it could not be read or parsed.
+static bool LoadServerConfigFile(const char* Path, ServerConfig& OutConfig)
+{
+	char ConfigText[16 * 1024];
+
+	FILE* ConfigFile = fopen(Path, "rb");
+	if (nullptr == ConfigFile)
+	{
+		std::cerr << "Failed to open Server Config at " << Path << ".\n";
+		return false;
+	}
+	size_t ConfigTextLength = fread(ConfigText, 1, sizeof(ConfigText), ConfigFile);
+	bool bReadWhole = feof(ConfigFile) != 0;
+	fclose(ConfigFile);
+
+	if (!bReadWhole)
+	{
+		std::cerr << "Failed to read Server Config at " << Path << ".\n";
+		return false;
+	}
+
+	return ParseServerConfig(ConfigText, ConfigTextLength, OutConfig);
+}
+
+// Runs a single Server update, timed, then reads back what it sent. Returns the duration of UpdateServer in seconds.
+static double RunUpdate(GameServerPtr Server, const LoopbackBenchSettings& Settings, LoopbackBenchState& State)
+{
+	// Server logs are left out of the measurements: with thousands of clients, they would be all there is to measure.
+	std::streambuf* CoutBuffer = Settings.bVerbose ? nullptr : std::cout.rdbuf(nullptr);
+
+	auto UpdateBeginTime = std::chrono::steady_clock::now();
+	UpdateServer(Server, Settings.DeltaTime);
+	auto UpdateEndTime = std::chrono::steady_clock::now();
+
+	if (!Settings.bVerbose)
+	{
+		std::cout.rdbuf(CoutBuffer);
+		std::cout.clear();
+	}
+
+	Loopback_ReadSentPackets(HandleSentPacket, &State);
+	State.UpdateIndex++;
+	return std::chrono::duration<double>(UpdateEndTime - UpdateBeginTime).count();
+}
+
+static double GetPercentile(std::vector<double>& SortedValues, double Percentile)
+{
+	size_t Index = static_cast<size_t>(Percentile * (SortedValues.size() - 1) + 0.5);
+	return SortedValues[Index];
+}
+
+int main(int argc, char** argv)
+{
+	LoopbackBenchSettings Settings;
+	if (!ParseBenchArguments(argc, argv, Settings) || Settings.ClientCount == 0 || Settings.DeltaTime <= 0.0)
+	{
+		std::cerr << "Usage: FracturedPlaneLoopback [Clients=4096] [Updates=600] [Messages=1] [DeltaTime=0.016667] [Config=Path] [Verbose=0]\n";
+		return 1;
+	}
+
+	// Config Loading. Limits are raised to fit every virtual client if needed.
+	ServerConfig Config;
+	if (nullptr != Settings.ConfigPath && !LoadServerConfigFile(Settings.ConfigPath, Config))
+	{
+		std::cerr << "Invalid Server Config ! Ending program...\n";
+		return 1;
+	}
+
+	Config.MaxConnectionCount = std::max(Config.MaxConnectionCount, Settings.ClientCount);
+	Config.MaxClientCount = std::max(Config.MaxClientCount, Settings.ClientCount);
+
+	// Run a job worker per processor unless the Config asks for a given count.
+	if (Config.JobWorkerCount == 0)
+	{
+		Config.JobWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	// Runs are compared through the hash of what the Server sent, so they all have to generate the same World.
+	if (Config.WorldSeed == 0)
+	{
+		Config.WorldSeed = 1;
+	}
+
+	// Every virtual client authenticates and gets synchronized in the same update: make sure the Packet Writer can hold
+	// everything sent during that update. Nothing else is raised, so that the Server has to get by with its Config.
+	size_t SettlingBodySize = Settings.ClientCount
+		* (sizeof(FPCore::Net::PacketBodyDef_Authentication) + sizeof(FPCore::Net::PacketBodyDef_ZoneLandscapeSync));
+	Config.PacketWriteBufferSize = std::max(Config.PacketWriteBufferSize, SettlingBodySize + Settings.ClientCount * 2 * sizeof(FPCore::Net::PacketHead));
+
+	// Platform Initialization
+	ServerPlatform Platform;
+	if (!Loopback_InitPlatform(Platform, Config))
+	{
+		std::cerr << "Loopback Platform Initialization failed ! Ending program...\n";
+		Loopback_ShutdownPlatform(Platform);
+		return 1;
+	}
+
+	std::cout << "Initializing Server...\n";
+	GameServerPtr Server;
+	if (!InitializeServer(Platform, Config, Server))
+	{
+		std::cout << "Failed to initialize server. Shutting program down.\n";
+		Loopback_ShutdownPlatform(Platform);
+		return 1;
+	}
+
+	LoopbackBenchState State;
+	State.Clients.resize(Settings.ClientCount);
+	State.ClientIndexByConnectionID.resize(Config.MaxConnectionCount);
+
+	// Connect & authenticate every virtual client, then update until the Server is done answering all of them.
+	std::cout << "Connecting " << Settings.ClientCount << " virtual clients...\n";
+	for (size_t ClientIndex = 0; ClientIndex < Settings.ClientCount; ClientIndex++)
+	{
+		VirtualClient& Client = State.Clients[ClientIndex];
+		Client = {};
+		Client.ConnectionID = Loopback_Connect();
+		State.ClientIndexByConnectionID[Client.ConnectionID] = ClientIndex;
+
+		FPCore::Net::PacketBodyDef_Authentication Request = {};
+		snprintf(Request.Request.Username, sizeof(Request.Request.Username), "LoopbackBot%zu", ClientIndex);
+		snprintf(Request.Request.Password, sizeof(Request.Request.Password), "LoopbackPassword");
+		Loopback_SendPacket(Client.ConnectionID, FPCore::Net::PacketBodyType::AUTHENTICATION, &Request, sizeof(Request));
+	}
+
+	double SettlingTime = 0.0;
+	size_t SettlingUpdateCount = 0;
+	while (State.SynchronizedCount < Settings.ClientCount && SettlingUpdateCount < MAX_SETTLING_UPDATE_COUNT && !Loopback_IsShutdownRequested())
+	{
+		SettlingTime += RunUpdate(Server, Settings, State);
+		SettlingUpdateCount++;
+	}
+
+	std::cout << State.AuthenticatedCount << " clients authenticated and " << State.SynchronizedCount << " synchronized in "
+		<< SettlingUpdateCount << " update(s), " << SettlingTime * 1000.0 << " ms spent updating, "
+		<< State.LateSynchronizedCount << " synchronized late.\n";
+
+	// Failed syncs are retried on later updates, which would hide them if only the final count was checked.
+	if (State.SynchronizedCount < Settings.ClientCount || State.LateSynchronizedCount > 0)
+	{
+		std::cerr << "Not every virtual client got synchronized along with its authentication. Ending program...\n";
+		ShutdownServer(Server, ShutdownReason::UNKNOWN);
+		Loopback_ShutdownPlatform(Platform);
+		return 1;
+	}
+
+	// Measured updates: every virtual client sends its messages, then the Server updates once.
+	std::cout << "Running " << Settings.UpdateCount << " updates with a DeltaTime of " << Settings.DeltaTime << " s, "
+		<< Settings.MessagesPerUpdate << " message(s) per client per update...\n";
+
+	std::vector<double> UpdateTimes;
+	UpdateTimes.reserve(Settings.UpdateCount);
+	uint64_t SentMessageCount = 0;
+	for (size_t UpdateIndex = 0; UpdateIndex < Settings.UpdateCount && !Loopback_IsShutdownRequested(); UpdateIndex++)
+	{
+		for (size_t MessageIndex = 0; MessageIndex < Settings.MessagesPerUpdate; MessageIndex++)
+		{
+			for (size_t ClientIndex = 0; ClientIndex < Settings.ClientCount; ClientIndex++)
+			{
+				char Message[64];
+				int MessageLength = snprintf(Message, sizeof(Message), "Message %zu from bot %zu", UpdateIndex, ClientIndex);
+				if (Loopback_SendPacket(State.Clients[ClientIndex].ConnectionID, FPCore::Net::PacketBodyType::MESSAGE, Message,
+					static_cast<FPCore::Net::PacketBodySize_t>(MessageLength)))
+				{
+					SentMessageCount++;
+				}
+			}
+		}
+
+		UpdateTimes.push_back(RunUpdate(Server, Settings, State));
+	}
+
+	// Disconnect everyone and let the Server acknowledge it before shutting down.
+	for (size_t ClientIndex = 0; ClientIndex < Settings.ClientCount; ClientIndex++)
+	{
+		Loopback_Disconnect(State.Clients[ClientIndex].ConnectionID);
+	}
+	RunUpdate(Server, Settings, State);
+
+	if (!UpdateTimes.empty())
+	{
+		double TotalUpdateTime = 0.0;
+		for (double UpdateTime : UpdateTimes)
+		{
+			TotalUpdateTime += UpdateTime;
+		}
+		std::sort(UpdateTimes.begin(), UpdateTimes.end());
+
+		std::cout << "Update time (ms): mean " << TotalUpdateTime / UpdateTimes.size() * 1000.0
+			<< ", p50 " << GetPercentile(UpdateTimes, 0.5) * 1000.0
+			<< ", p99 " << GetPercentile(UpdateTimes, 0.99) * 1000.0
+			<< ", max " << UpdateTimes.back() * 1000.0 << "\n";
+		std::cout << "Throughput: " << UpdateTimes.size() / TotalUpdateTime << " updates/s, "
+			<< SentMessageCount / TotalUpdateTime << " received packets/s of update time.\n";
+	}
+	std::cout << "Read back " << State.ReadPacketCount << " sent packets (" << State.ReadByteCount << " body bytes), hash "
+		<< std::hex << State.SentDataHash << std::dec << ".\n";
+
+	// Cleanup & Shutdown
+	std::cout << "Shutting down Server...\n";
+	ShutdownServer(Server, ShutdownReason::SERVER_SHUTDOWN);
+	Loopback_ShutdownPlatform(Platform);
+
+	return 0;
+}
@@ -0,0 +1,489 @@
+// Loopback_Platform.cpp
+// Implementation of the Loopback Platform, where every Platform service is served from memory.
+
+#include "Loopback/Loopback_Platform.h"
+
+#include "ServerFramework/NetStreamReassembler.h"
+#include "ServerFramework/StdThreads.h"
+
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+
+// Data stored through the Platform only lives in memory, so that runs never depend on what a previous one left behind.
+#define MAX_STORED_DATA_COUNT 64
+#define MAX_STORE_PATH_LENGTH 256
+
+struct LoopbackStoredData
+{
+	char Path[MAX_STORE_PATH_LENGTH];
+	byte* Data; // Null if the slot is free.
+	size_t Size;
+};
+
+static LoopbackStoredData StoredData[MAX_STORED_DATA_COUNT];
+
+// Everything virtual clients send lands in a single Reception Buffer, handed over to the Server as a single shard.
+// It is sized for thousands of clients sending a few packets each per update.
+#define RECEPTION_BUFFER_SIZE (1024 * 1024 * 8) // 8mb
+
+// Every packet takes at least a head's worth of data, which bounds how many descriptors the buffer may need.
+#define MAX_PACKETS_PER_RECEPTION_BUFFER (RECEPTION_BUFFER_SIZE / sizeof(FPCore::Net::NetEncodedPacketHead))
+
+enum class LoopbackConnectionState : uint8_t
+{
+	FREE = 0, // ID can be handed out by Loopback_Connect.
+	CONNECTED,
+	CLOSED, // Closed by either side, waiting for the Server to acknowledge the Disconnection event.
+};
+
+struct LoopbackNetData
+{
+	size_t MaxConnectionCount;
+	LoopbackConnectionState* ConnectionStates;
+
+	// Free Connection IDs, handed out from the top. Starts out with the lowest IDs on top.
+	ServerPlatform::ConnectionID* FreeConnectionIDs;
+	size_t FreeConnectionIDCount;
+
+	// Events waiting for the Server's next read. A connection has at most one event of each type pending.
+	ServerPlatform::ConnectionID* ConnectionEvents;
+	size_t ConnectionEventCount;
+	ServerPlatform::ConnectionID* DisconnectionEvents;
+	size_t DisconnectionEventCount;
+	size_t ReadDisconnectionEventCount; // Disconnection events handed over by the last read.
+
+	// Reception Buffer, holding packets as they were encoded by virtual clients, and their descriptors.
+	byte* ReceptionData;
+	size_t ReceivedBytes;
+	NetPacketDescriptor* ReceivedPackets;
+	size_t ReceivedPacketCount;
+	NetReceptionShard ReadReceptionShard;
+
+	uint64_t TotalReceivedPacketCount;
+	uint64_t DroppedReceptionCount;
+	uint64_t DroppedByteCount;
+	size_t LastReadOccupancy;
+	size_t PeakReadOccupancy;
+
+	// Sending Buffer, holding what the Server sent until it is read back. Written in the Platform sending format.
+	byte* SendingData;
+	size_t SendingBufferSize;
+	size_t SentBytes;
+};
+
+static LoopbackNetData Net;
+static bool bShutdownRequested = false;
+
+static void RequestProgramShutdown()
+{
+	bShutdownRequested = true;
+}
+
+bool Loopback_IsShutdownRequested()
+{
+	return bShutdownRequested;
+}
+
+// DATA STORAGE
+
+static LoopbackStoredData* FindStoredData(const char* Path)
+{
+	for (size_t StoreIndex = 0; StoreIndex < MAX_STORED_DATA_COUNT; StoreIndex++)
+	{
+		if (nullptr != StoredData[StoreIndex].Data && strncmp(StoredData[StoreIndex].Path, Path, MAX_STORE_PATH_LENGTH) == 0)
+		{
+			return &StoredData[StoreIndex];
+		}
+	}
+	return nullptr;
+}
+
+static bool Loopback_LoadStoredData(ServerPlatform::StorePath Path, size_t MaxSize, byte* TargetMemory, size_t& LoadedSize)
+{
+	LoadedSize = 0;
+
+	LoopbackStoredData* Stored = FindStoredData(Path);
+	if (nullptr == Stored || Stored->Size > MaxSize)
+	{
+		return false;
+	}
+
+	memcpy(TargetMemory, Stored->Data, Stored->Size);
+	LoadedSize = Stored->Size;
+	return true;
+}
+
+static bool Loopback_StoreData(ServerPlatform& Platform, ServerPlatform::StorePath Path, size_t Size, byte* SourceMemory)
+{
+	if (strlen(Path) >= MAX_STORE_PATH_LENGTH)
+	{
+		return false;
+	}
+
+	// Allocate at least a byte, so that empty data still marks its slot as used.
+	byte* Data = static_cast<byte*>(malloc(Size > 0 ? Size : 1));
+	if (nullptr == Data)
+	{
+		return false;
+	}
+	memcpy(Data, SourceMemory, Size);
+
+	LoopbackStoredData* Stored = FindStoredData(Path);
+	for (size_t StoreIndex = 0; nullptr == Stored && StoreIndex < MAX_STORED_DATA_COUNT; StoreIndex++)
+	{
+		if (nullptr == StoredData[StoreIndex].Data)
+		{
+			Stored = &StoredData[StoreIndex];
+			strcpy_s(Stored->Path, MAX_STORE_PATH_LENGTH, Path);
+		}
+	}
+
+	if (nullptr == Stored)
+	{
+		free(Data);
+		return false;
+	}
+
+	free(Stored->Data);
+	Stored->Data = Data;
+	Stored->Size = Size;
+	return true;
+}
+
+// NETWORK: SERVER SIDE
+
+// Hands the pending Connection & Disconnection events over to the Server. They stay valid until ClearNetEvents().
+static void ReadNetEvents(const ServerPlatform::ConnectionID*& NewConnectionIDs, size_t& OutConnectedCount,
+		const ServerPlatform::ConnectionID*& DisconnectedIDs, size_t& OutDisconnectedCount)
+{
+	NewConnectionIDs = Net.ConnectionEvents;
+	OutConnectedCount = Net.ConnectionEventCount;
+
+	DisconnectedIDs = Net.DisconnectionEvents;
+	OutDisconnectedCount = Net.DisconnectionEventCount;
+	Net.ReadDisconnectionEventCount = Net.DisconnectionEventCount;
+}
+
+// Clears the events handed over by the last read. IDs of acknowledged Disconnections become available to new connections.
+static void ClearNetEvents()
+{
+	for (size_t EventIndex = 0; EventIndex < Net.ReadDisconnectionEventCount; EventIndex++)
+	{
+		ServerPlatform::ConnectionID ConnectionID = Net.DisconnectionEvents[EventIndex];
+		Net.ConnectionStates[ConnectionID] = LoopbackConnectionState::FREE;
+		Net.FreeConnectionIDs[Net.FreeConnectionIDCount++] = ConnectionID;
+	}
+
+	// Connections the Server closed since the read are told about on the next one.
+	Net.DisconnectionEventCount -= Net.ReadDisconnectionEventCount;
+	memmove(Net.DisconnectionEvents, Net.DisconnectionEvents + Net.ReadDisconnectionEventCount,
+		Net.DisconnectionEventCount * sizeof(ServerPlatform::ConnectionID));
+
+	Net.ConnectionEventCount = 0;
+	Net.ReadDisconnectionEventCount = 0;
+}
+
+// Hands the Reception Buffer over to the Server as a single shard. It stays valid until ReleaseNetReceptionBuffers().
+static void ReadNetReceptionBuffers(const NetReceptionShard*& OutShards, size_t& OutShardCount)
+{
+	Net.ReadReceptionShard.Packets = Net.ReceivedPackets;
+	Net.ReadReceptionShard.PacketCount = Net.ReceivedPacketCount;
+	Net.ReadReceptionShard.ReceptionData = Net.ReceptionData;
+
+	Net.LastReadOccupancy = Net.ReceivedBytes;
+	if (Net.ReceivedBytes > Net.PeakReadOccupancy)
+	{
+		Net.PeakReadOccupancy = Net.ReceivedBytes;
+	}
+
+	OutShards = &Net.ReadReceptionShard;
+	OutShardCount = 1;
+}
+
+static void ReleaseNetReceptionBuffers()
+{
+	Net.ReceivedBytes = 0;
+	Net.ReceivedPacketCount = 0;
+}
+
+static void ReadNetReceptionStats(NetReceptionStats& OutStats)
+{
+	OutStats = {};
+	OutStats.ReceivedPacketCount = Net.TotalReceivedPacketCount;
+	OutStats.DroppedReceptionCount = Net.DroppedReceptionCount;
+	OutStats.DroppedByteCount = Net.DroppedByteCount;
+	OutStats.ShardCount = 1;
+	OutStats.BufferSize = RECEPTION_BUFFER_SIZE;
+	OutStats.LastReadOccupancy = Net.LastReadOccupancy;
+	OutStats.PeakReadOccupancy = Net.PeakReadOccupancy;
+}
+
+// Returns the free space of the Sending Buffer. Sent data only leaves it when read back with Loopback_ReadSentPackets.
+static void BeginWritingToSendingBuffer(byte*& OutSendingBuffer, size_t& OutMaxBytes)
+{
+	OutSendingBuffer = Net.SendingData + Net.SentBytes;
+	OutMaxBytes = Net.SendingBufferSize - Net.SentBytes;
+}
+
+static void EndWritingToSendingBuffer(size_t SentBytesCount)
+{
+	Net.SentBytes += SentBytesCount;
+}
+
+// Marks the connection as closed and tells the Server, unless it already was. Used for closings from both sides.
+static void CloseConnection(ServerPlatform::ConnectionID ConnectionID)
+{
+	if (ConnectionID >= Net.MaxConnectionCount || Net.ConnectionStates[ConnectionID] != LoopbackConnectionState::CONNECTED)
+	{
+		return;
+	}
+
+	Net.ConnectionStates[ConnectionID] = LoopbackConnectionState::CLOSED;
+	Net.DisconnectionEvents[Net.DisconnectionEventCount++] = ConnectionID;
+}
+
+// NETWORK: VIRTUAL CLIENT SIDE
+
+ServerPlatform::ConnectionID Loopback_Connect()
+{
+	if (Net.FreeConnectionIDCount == 0)
+	{
+		return ServerPlatform::INVALID_ID;
+	}
+
+	ServerPlatform::ConnectionID ConnectionID = Net.FreeConnectionIDs[--Net.FreeConnectionIDCount];
+	Net.ConnectionStates[ConnectionID] = LoopbackConnectionState::CONNECTED;
+	Net.ConnectionEvents[Net.ConnectionEventCount++] = ConnectionID;
+	return ConnectionID;
+}
+
+void Loopback_Disconnect(ServerPlatform::ConnectionID ConnectionID)
+{
+	CloseConnection(ConnectionID);
+}
+
+bool Loopback_IsConnected(ServerPlatform::ConnectionID ConnectionID)
+{
+	return ConnectionID < Net.MaxConnectionCount && Net.ConnectionStates[ConnectionID] == LoopbackConnectionState::CONNECTED;
+}
+
+bool Loopback_SendData(ServerPlatform::ConnectionID ConnectionID, const byte* Data, size_t DataSize)
+{
+	constexpr size_t HeadSize = sizeof(FPCore::Net::NetEncodedPacketHead);
+
+	if (!Loopback_IsConnected(ConnectionID))
+	{
+		return false;
+	}
+
+	// Check every packet before taking any, so that the data is either received whole or not at all.
+	size_t PacketCount = 0;
+	for (size_t Offset = 0; Offset < DataSize; PacketCount++)
+	{
+		FPCore::Net::NetEncodedPacketHead Head;
+		if (DataSize - Offset < HeadSize)
+		{
+			return false;
+		}
+		memcpy(&Head, Data + Offset, HeadSize);
+		if (!NetStreamReassembler::IsValidHead(Head) || DataSize - Offset - HeadSize < Head.BodySize)
+		{
+			return false;
+		}
+		Offset += HeadSize + Head.BodySize;
+	}
+
+	if (DataSize > RECEPTION_BUFFER_SIZE - Net.ReceivedBytes)
+	{
+		Net.DroppedReceptionCount += PacketCount;
+		Net.DroppedByteCount += DataSize;
+		return false;
+	}
+
+	// Copy the packets as they were encoded, and describe each of them.
+	byte* ReceptionStart = Net.ReceptionData + Net.ReceivedBytes;
+	memcpy(ReceptionStart, Data, DataSize);
+	for (size_t Offset = 0; Offset < DataSize; )
+	{
+		FPCore::Net::NetEncodedPacketHead Head;
+		memcpy(&Head, ReceptionStart + Offset, HeadSize);
+
+		NetPacketDescriptor& Descriptor = Net.ReceivedPackets[Net.ReceivedPacketCount++];
+		Descriptor.ConnectionID = ConnectionID;
+		Descriptor.BodyType = Head.BodyType;
+		Descriptor.BodySize = Head.BodySize;
+		Descriptor.BodyOffset = static_cast<uint32_t>(Net.ReceivedBytes + Offset + HeadSize);
+
+		Offset += HeadSize + Head.BodySize;
+	}
+
+	Net.ReceivedBytes += DataSize;
+	Net.TotalReceivedPacketCount += PacketCount;
+	return true;
+}
+
+bool Loopback_SendPacket(ServerPlatform::ConnectionID ConnectionID, FPCore::Net::PacketBodyType BodyType, const void* Body,
+	FPCore::Net::PacketBodySize_t BodySize)
+{
+	constexpr size_t HeadSize = sizeof(FPCore::Net::NetEncodedPacketHead);
+
+	FPCore::Net::NetEncodedPacketHead Head = {};
+	Head.BodyType = BodyType;
+	Head.BodySize = BodySize;
+	if (!Loopback_IsConnected(ConnectionID) || !NetStreamReassembler::IsValidHead(Head))
+	{
+		return false;
+	}
+
+	if (HeadSize + BodySize > RECEPTION_BUFFER_SIZE - Net.ReceivedBytes)
+	{
+		Net.DroppedReceptionCount++;
+		Net.DroppedByteCount += HeadSize + BodySize;
+		return false;
+	}
+
+	// Encode the packet straight into the Reception Buffer.
+	memcpy(Net.ReceptionData + Net.ReceivedBytes, &Head, HeadSize);
+	memcpy(Net.ReceptionData + Net.ReceivedBytes + HeadSize, Body, BodySize);
+
+	NetPacketDescriptor& Descriptor = Net.ReceivedPackets[Net.ReceivedPacketCount++];
+	Descriptor.ConnectionID = ConnectionID;
+	Descriptor.BodyType = BodyType;
+	Descriptor.BodySize = BodySize;
+	Descriptor.BodyOffset = static_cast<uint32_t>(Net.ReceivedBytes + HeadSize);
+
+	Net.ReceivedBytes += HeadSize + BodySize;
+	Net.TotalReceivedPacketCount++;
+	return true;
+}
+
+size_t Loopback_ReadSentPackets(LoopbackSentPacketHandlerFunc OnPacket, void* Context)
+{
+	size_t HandedPacketCount = 0;
+
+	// Packets are laid out back to back whatever the size of their body, so heads may not be aligned.
+	for (size_t Offset = 0; Offset + sizeof(FPCore::Net::PacketHead) <= Net.SentBytes; )
+	{
+		FPCore::Net::PacketHead Head;
+		memcpy(&Head, Net.SendingData + Offset, sizeof(Head));
+		Offset += sizeof(Head);
+
+		if (Loopback_IsConnected(Head.ConnectionID))
+		{
+			LoopbackSentPacket Packet;
+			Packet.ConnectionID = Head.ConnectionID;
+			Packet.BodyType = Head.BodyType;
+			Packet.BodySize = Head.BodySize;
+			Packet.Body = Net.SendingData + Offset;
+			OnPacket(Packet, Context);
+			HandedPacketCount++;
+		}
+
+		Offset += Head.BodySize;
+	}
+
+	Net.SentBytes = 0;
+	return HandedPacketCount;
+}
+
+// INIT & SHUTDOWN
+
+bool Loopback_InitPlatform(ServerPlatform& OutPlatform, const ServerConfig& Config)
+{
+	std::cout << "Initializing Loopback Platform...\n";
+
+	if (Config.MaxConnectionCount >= ServerPlatform::INVALID_ID)
+	{
+		std::cerr << "Error: Can't handle " << Config.MaxConnectionCount << " connections, the maximum is " << ServerPlatform::INVALID_ID - 1 << ".\n";
+		return false;
+	}
+
+	OutPlatform.ShutdownProgram = RequestProgramShutdown;
+	bShutdownRequested = false;
+
+	// Prepare Memory footprint. Large zeroed allocations are served with fresh pages, so they don't have to be cleared.
+	size_t RequestedServerMemory = GetRequiredServerMemory(Config);
+	OutPlatform.Memory = static_cast<byte*>(calloc(RequestedServerMemory, 1));
+	if (nullptr == OutPlatform.Memory)
+	{
+		std::cerr << "Failed to allocate memory when initializing Loopback Platform.\n";
+		return false;
+	}
+	OutPlatform.MemorySize = RequestedServerMemory;
+	OutPlatform.bMemoryZeroed = true;
+
+	// Prepare Data Storage
+	OutPlatform.LoadStoredData = Loopback_LoadStoredData;
+	OutPlatform.StoreData = Loopback_StoreData;
+
+	// Prepare Threading Services
+	// Threads are standard library threads, so that the Loopback Platform runs anywhere the Server compiles.
+	OutPlatform.CreateThread = StdThreads_CreateThread;
+	OutPlatform.DestroyThread = StdThreads_DestroyThread;
+
+	// Prepare Network Services & Data
+	// The Sending Buffer can hold everything the Server's Packet Writer does, so that a flush always fits in whole.
+	Net = {};
+	Net.MaxConnectionCount = Config.MaxConnectionCount;
+	Net.SendingBufferSize = Config.PacketWriteBufferSize;
+	Net.ConnectionStates = static_cast<LoopbackConnectionState*>(calloc(Net.MaxConnectionCount, sizeof(LoopbackConnectionState)));
+	Net.FreeConnectionIDs = static_cast<ServerPlatform::ConnectionID*>(calloc(Net.MaxConnectionCount, sizeof(ServerPlatform::ConnectionID)));
+	Net.ConnectionEvents = static_cast<ServerPlatform::ConnectionID*>(calloc(Net.MaxConnectionCount, sizeof(ServerPlatform::ConnectionID)));
+	Net.DisconnectionEvents = static_cast<ServerPlatform::ConnectionID*>(calloc(Net.MaxConnectionCount, sizeof(ServerPlatform::ConnectionID)));
+	Net.ReceptionData = static_cast<byte*>(malloc(RECEPTION_BUFFER_SIZE));
+	Net.ReceivedPackets = static_cast<NetPacketDescriptor*>(malloc(MAX_PACKETS_PER_RECEPTION_BUFFER * sizeof(NetPacketDescriptor)));
+	Net.SendingData = static_cast<byte*>(malloc(Net.SendingBufferSize));
+	if (nullptr == Net.ConnectionStates || nullptr == Net.FreeConnectionIDs || nullptr == Net.ConnectionEvents
+		|| nullptr == Net.DisconnectionEvents || nullptr == Net.ReceptionData || nullptr == Net.ReceivedPackets
+		|| nullptr == Net.SendingData)
+	{
+		std::cerr << "Failed to allocate Loopback Networking memory.\n";
+		return false;
+	}
+
+	// Lowest IDs go on top, so connections get IDs in order.
+	for (size_t IDIndex = 0; IDIndex < Net.MaxConnectionCount; IDIndex++)
+	{
+		Net.FreeConnectionIDs[IDIndex] = static_cast<ServerPlatform::ConnectionID>(Net.MaxConnectionCount - 1 - IDIndex);
+	}
+	Net.FreeConnectionIDCount = Net.MaxConnectionCount;
+
+	OutPlatform.ReadPlatformNetEvents = ReadNetEvents;
+	OutPlatform.ReleasePlatformNetEvents = ClearNetEvents;
+
+	OutPlatform.ReadPlatformNetReceptionBuffers = ReadNetReceptionBuffers;
+	OutPlatform.ReleasePlatformNetReceptionBuffers = ReleaseNetReceptionBuffers;
+	OutPlatform.ReadPlatformNetReceptionStats = ReadNetReceptionStats;
+
+	OutPlatform.WriteToPlatformNetSendingBuffer = BeginWritingToSendingBuffer;
+	OutPlatform.ReleasePlatformNetSendingBuffer = EndWritingToSendingBuffer;
+
+	OutPlatform.CloseConnection = CloseConnection;
+
+	return true;
+}
+
+void Loopback_ShutdownPlatform(ServerPlatform& Platform)
+{
+	free(Net.ConnectionStates);
+	free(Net.FreeConnectionIDs);
+	free(Net.ConnectionEvents);
+	free(Net.DisconnectionEvents);
+	free(Net.ReceptionData);
+	free(Net.ReceivedPackets);
+	free(Net.SendingData);
+	Net = {};
+
+	for (size_t StoreIndex = 0; StoreIndex < MAX_STORED_DATA_COUNT; StoreIndex++)
+	{
+		free(StoredData[StoreIndex].Data);
+		StoredData[StoreIndex] = {};
+	}
+
+	free(Platform.Memory);
+	Platform.Memory = nullptr;
+	Platform.MemorySize = 0;
+
+	std::cout.flush();
+}
@@ -0,0 +1,58 @@
+// Loopback_Platform.h
+// In-process Platform on which the Server talks to virtual clients living in the same program rather than to sockets.
+
+#pragma once
+
+#include "ServerFramework/ServerPlatform.h"
+
+// The Loopback Platform serves every Platform service from memory. Virtual clients are driven by the program hosting the
+// Server: it connects them, injects the packets they send, runs UpdateServer with whatever DeltaTime it likes and reads
+// back the packets the Server sent them. Nothing happens in the background, so a run only depends on what the hosting
+// program does, and no time is spent in the kernel.
+// Every function below has to be called from the thread updating the Server, outside of UpdateServer.
+
+// A packet the Server sent to a virtual client.
+struct LoopbackSentPacket
+{
+	ServerPlatform::ConnectionID ConnectionID;
+	FPCore::Net::PacketBodyType BodyType;
+	FPCore::Net::PacketBodySize_t BodySize;
+	const byte* Body; // Only valid during the handler call.
+};
+
+typedef void (*LoopbackSentPacketHandlerFunc)(const LoopbackSentPacket& Packet, void* Context);
+
+// Initializes the Loopback Platform & fills the ServerPlatform data structure. Returns whether initialization was successful.
+bool Loopback_InitPlatform(ServerPlatform& OutPlatform, const ServerConfig& Config);
+
+// Frees everything the Loopback Platform allocated, Server memory included.
+void Loopback_ShutdownPlatform(ServerPlatform& Platform);
+
+// Returns whether the Server asked for the program to be shut down.
+bool Loopback_IsShutdownRequested();
+
+// Opens a new virtual connection. The Server is told about it on its next update.
+// Returns INVALID_ID if every Connection ID is in use.
+ServerPlatform::ConnectionID Loopback_Connect();
+
+// Closes a virtual connection from the client side. The Server is told about it on its next update.
+void Loopback_Disconnect(ServerPlatform::ConnectionID ConnectionID);
+
+// Returns whether the virtual connection is still open, i.e. neither side closed it. The ID of a closed connection may
+// be handed out again by Loopback_Connect once the Server acknowledged the closing, and should not be used anymore.
+bool Loopback_IsConnected(ServerPlatform::ConnectionID ConnectionID);
+
+// Has the virtual connection send Net Encoded Packets to the Server, as they would come out of a socket. Data has to
+// hold whole packets. They are handed to the Server on its next update.
+// Returns false without sending anything if the connection is closed, a packet is invalid or incomplete, or the
+// reception buffer has no room left for all of them, in which case they are counted as dropped.
+bool Loopback_SendData(ServerPlatform::ConnectionID ConnectionID, const byte* Data, size_t DataSize);
+
+// Has the virtual connection send a single packet made of the passed, already marshalled, body. Same as Loopback_SendData.
+bool Loopback_SendPacket(ServerPlatform::ConnectionID ConnectionID, FPCore::Net::PacketBodyType BodyType, const void* Body,
+	FPCore::Net::PacketBodySize_t BodySize);
+
+// Calls OnPacket for every packet the Server sent since the last call, in sending order, then forgets them.
+// Packets sent to connections that were closed in the meantime are skipped, as a socket would have dropped them.
+// Returns how many packets were handed out. Until read, sent packets keep taking room in the sending buffer.
+size_t Loopback_ReadSentPackets(LoopbackSentPacketHandlerFunc OnPacket, void* Context);
@@ -0,0 +1,113 @@
+// CounterRandom.cpp
+// Implementation of the Counter Random service.
+
+#include "ServerFramework/CounterRandom.h"
+
+// Philox4x32 round multipliers and key schedule increments (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+static constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+static constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+static constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+static constexpr uint32_t PHILOX_ROUND_COUNT = 10;
+
+void CounterRandom::Philox4x32(const uint32_t Counter[4], uint64_t Key, uint32_t OutBits[4])
+{
+    uint32_t Word0 = Counter[0];
+    uint32_t Word1 = Counter[1];
+    uint32_t Word2 = Counter[2];
+    uint32_t Word3 = Counter[3];
+    uint32_t Key0 = static_cast<uint32_t>(Key);
+    uint32_t Key1 = static_cast<uint32_t>(Key >> 32);
+
+    for (uint32_t Round = 0; Round < PHILOX_ROUND_COUNT; Round++)
+    {
+        uint64_t Product0 = static_cast<uint64_t>(PHILOX_M0) * Word0;
+        uint64_t Product1 = static_cast<uint64_t>(PHILOX_M1) * Word2;
+        Word0 = static_cast<uint32_t>(Product1 >> 32) ^ Word1 ^ Key0;
+        Word1 = static_cast<uint32_t>(Product1);
+        Word2 = static_cast<uint32_t>(Product0 >> 32) ^ Word3 ^ Key1;
+        Word3 = static_cast<uint32_t>(Product0);
+        Key0 += PHILOX_W0;
+        Key1 += PHILOX_W1;
+    }
+
+    OutBits[0] = Word0;
+    OutBits[1] = Word1;
+    OutBits[2] = Word2;
+    OutBits[3] = Word3;
+}
+
+void CounterRandom::GetBlock(const RandomKey& Key, uint32_t BlockIndex, uint32_t OutBits[4])
+{
+    // The purpose and block index share the first counter word, so that the whole counter tells Keys apart.
+    uint32_t Counter[4] =
+    {
+        static_cast<uint32_t>(Key.Purpose) << 24 | (BlockIndex & MAX_BLOCK_INDEX),
+        Key.Tile,
+        Key.Zone,
+        Key.Island
+    };
+    Philox4x32(Counter, Key.Seed, OutBits);
+}
+
+uint32_t CounterRandom::GetBits32(const RandomKey& Key, uint32_t Index)
+{
+    uint32_t Block[4];
+    GetBlock(Key, Index / 4, Block);
+    return Block[Index % 4];
+}
+
+uint64_t CounterRandom::GetBits64(const RandomKey& Key, uint32_t Index)
+{
+    uint32_t Block[4];
+    GetBlock(Key, Index / 2, Block);
+    return static_cast<uint64_t>(Block[(Index % 2) * 2 + 1]) << 32 | Block[(Index % 2) * 2];
+}
+
+uint32_t CounterRandom::GetRange(const RandomKey& Key, uint32_t Index, uint32_t Min, uint32_t Max)
+{
+    if (Max <= Min)
+    {
+        return Min;
+    }
+
+    // Scale the bits by the range width rather than taking a modulo: no division, and a bias below 2^-32 per value.
+    uint64_t Width = static_cast<uint64_t>(Max) - Min + 1;
+    return Min + static_cast<uint32_t>((GetBits32(Key, Index) * Width) >> 32);
+}
+
+float CounterRandom::GetUnitFloat(const RandomKey& Key, uint32_t Index)
+{
+    // Keep as many bits as a float mantissa holds, so that every value is exact and below 1.
+    return static_cast<float>(GetBits32(Key, Index) >> 8) * (1.f / 16777216.f);
+}
+
+void CounterRandom::FillBits(const RandomKey& Key, uint32_t FirstIndex, uint32_t* OutBits, size_t Count)
+{
+    uint32_t Block[4];
+    uint32_t BlockIndex = FirstIndex / 4;
+    size_t WordIndex = FirstIndex % 4;
+    GetBlock(Key, BlockIndex, Block);
+
+    for (size_t OutIndex = 0; OutIndex < Count; OutIndex++)
+    {
+        if (WordIndex == 4)
+        {
+            GetBlock(Key, ++BlockIndex, Block);
+            WordIndex = 0;
+        }
+        OutBits[OutIndex] = Block[WordIndex++];
+    }
+}
+
+void CounterRandom::FillTileBits(const RandomKey& Key, uint32_t FirstTile, uint32_t* OutBits, size_t Count)
+{
+    RandomKey TileKey = Key;
+    uint32_t Block[4];
+    for (size_t OutIndex = 0; OutIndex < Count; OutIndex++)
+    {
+        TileKey.Tile = FirstTile + static_cast<uint32_t>(OutIndex);
+        GetBlock(TileKey, 0, Block);
+        OutBits[OutIndex] = Block[0];
+    }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// CounterRandom.h
+// Declares the Counter Random service, mapping world coordinates and a purpose to random bits without any shared state.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// What random bits are drawn for. Every purpose gets sequences of its own, so adding draws for one never shifts another.
+// Values are part of the generated world: append new purposes, never reorder them.
+enum class RandomPurpose : uint8_t
+{
+    ISLAND_SEED,
+    ISLAND_PLACEMENT,
+    ZONE_DEFINITION,
+    TERRAIN_NOISE
+};
+
+// Identifies a sequence of random bits. Fields that don't apply to a draw are left at 0.
+struct RandomKey
+{
+    uint64_t Seed;
+    uint32_t Island;
+    uint32_t Zone;
+    uint32_t Tile;
+    RandomPurpose Purpose;
+};
+
+// Counter based random number generation: the Index-th 32 random bits of a Key are the Philox4x32-10 block cipher applied
+// to a counter made of the Key and Index, keyed by the Key's Seed. Any draw can be computed on its own, from any thread, in
+// any order, and always comes out the same, so generation and simulation need neither a shared generator nor locking,
+// and can be replayed from their seed.
+// Every Key holds 2^26 32 bit words (2^24 Philox blocks of 4 words).
+struct CounterRandom
+{
+    static constexpr uint32_t MAX_BLOCK_INDEX = (1u << 24) - 1;
+
+    // Encrypts Counter with Key through 10 Philox4x32 rounds into OutBits.
+    static void Philox4x32(const uint32_t Counter[4], uint64_t Key, uint32_t OutBits[4]);
+
+    // Returns the 4 words of the BlockIndex-th block of Key.
+    static void GetBlock(const RandomKey& Key, uint32_t BlockIndex, uint32_t OutBits[4]);
+
+    // Returns the Index-th 32 random bits of Key.
+    static uint32_t GetBits32(const RandomKey& Key, uint32_t Index = 0);
+    // Returns the 64 random bits made of the Index-th pair of words of Key.
+    static uint64_t GetBits64(const RandomKey& Key, uint32_t Index = 0);
+
+    // Returns a value in [Min, Max], scaled from the Index-th 32 random bits of Key.
+    static uint32_t GetRange(const RandomKey& Key, uint32_t Index, uint32_t Min, uint32_t Max);
+    // Returns a value in [0, 1[, from the Index-th 32 random bits of Key.
+    static float GetUnitFloat(const RandomKey& Key, uint32_t Index = 0);
+
+    // Writes Count consecutive words of Key, starting at its FirstIndex-th, a whole block at a time.
+    static void FillBits(const RandomKey& Key, uint32_t FirstIndex, uint32_t* OutBits, size_t Count);
+    // Writes the first word of every tile's sequence, for Count tiles starting at FirstTile. The Key's Tile is ignored.
+    static void FillTileBits(const RandomKey& Key, uint32_t FirstTile, uint32_t* OutBits, size_t Count);
+};
\ No newline at end of file
@@ -0,0 +1,338 @@
+// JobSystem.cpp
+// Implementation of the Job System.
+
+#include "ServerFramework/JobSystem.h"
+
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+
+// Index of the worker running on the current thread. Threads that aren't worker threads act as worker 0.
+static thread_local uint32_t CurrentWorkerIndex = 0;
+
+// Workers beyond the maximum are ignored, and no worker at all still leaves worker 0.
+static uint32_t ClampWorkerCount(size_t Workers)
+{
+    return static_cast<uint32_t>(Workers == 0 ? 1 : Workers > JobSystem::MAX_WORKER_COUNT ? JobSystem::MAX_WORKER_COUNT : Workers);
+}
+
+size_t JobSystem::GetRequiredMemory(size_t Workers, size_t MaxJobs)
+{
+    size_t WorkerQueueCount = ClampWorkerCount(Workers);
+    return MemorySubsystem::GetAllocationSize(MaxJobs * sizeof(Job))
+        + MemorySubsystem::GetAllocationSize(MaxJobs * sizeof(JobGroup))
+        + MemorySubsystem::GetAllocationSize(WorkerQueueCount * sizeof(WorkerQueue))
+        + WorkerQueueCount * MemorySubsystem::GetAllocationSize(MaxJobs * sizeof(uint32_t))
+        + MemorySubsystem::GetAllocationSize(sizeof(SharedState));
+}
+
+bool JobSystem::Initialize(MemorySubsystem& Memory, const ServerPlatform& Platform, size_t Workers, size_t MaxJobs)
+{
+    if (MaxJobs == 0 || MaxJobs >= NO_JOB_GROUP)
+    {
+        std::cerr << "Error: Can't create a Job System of " << MaxJobs << " jobs.\n";
+        return false;
+    }
+
+    if (Workers > MAX_WORKER_COUNT)
+    {
+        std::cerr << "Warning: Running " << MAX_WORKER_COUNT << " job workers rather than " << Workers << ", the maximum.\n";
+    }
+
+    LinkedPlatform = &Platform;
+    WorkerCount = ClampWorkerCount(Workers);
+    MaxJobCount = static_cast<uint32_t>(MaxJobs);
+
+    Jobs = Memory.AllocateZeroed<Job>(MaxJobCount);
+    Groups = Memory.AllocateZeroed<JobGroup>(MaxJobCount);
+    Queues = Memory.AllocateZeroed<WorkerQueue>(WorkerCount);
+    Shared = Memory.AllocateZeroed<SharedState>();
+    if (nullptr == Jobs || nullptr == Groups || nullptr == Queues || nullptr == Shared)
+    {
+        return false;
+    }
+
+    // Synchronization primitives have to be constructed in place, zeroed memory isn't a valid state for all of them.
+    for (uint32_t GroupIndex = 0; GroupIndex < MaxJobCount; GroupIndex++)
+    {
+        new (&Groups[GroupIndex]) JobGroup();
+    }
+    for (uint32_t WorkerIndex = 0; WorkerIndex < WorkerCount; WorkerIndex++)
+    {
+        new (&Queues[WorkerIndex]) WorkerQueue();
+        Queues[WorkerIndex].JobIndices = Memory.AllocateZeroed<uint32_t>(MaxJobCount);
+        if (nullptr == Queues[WorkerIndex].JobIndices)
+        {
+            return false;
+        }
+    }
+    new (Shared) SharedState();
+    Shared->NextWorkerIndex = 1;
+    Shared->bRunning = true;
+
+    // Start worker threads. WorkerCount is final before the first one starts reading it, and never changes while they run.
+    // Whatever the Platform fails to create, the remaining workers make up for: a queue only ever gets jobs from its own
+    // worker, so the queues of workers that never started stay empty, and are merely skipped by thieves.
+    uint32_t StartedWorkerCount = 1;
+    for (uint32_t WorkerIndex = 1; WorkerIndex < WorkerCount; WorkerIndex++)
+    {
+        WorkerThreads[WorkerIndex] = ServerPlatform::INVALID_ID;
+    }
+    for (uint32_t WorkerIndex = 1; WorkerIndex < WorkerCount; WorkerIndex++)
+    {
+        WorkerThreads[WorkerIndex] = nullptr != Platform.CreateThread ? Platform.CreateThread(WorkerThread_Func, this) : ServerPlatform::INVALID_ID;
+        if (WorkerThreads[WorkerIndex] == ServerPlatform::INVALID_ID)
+        {
+            break;
+        }
+        StartedWorkerCount++;
+    }
+
+    if (StartedWorkerCount < WorkerCount)
+    {
+        std::cerr << "Warning: Only " << StartedWorkerCount << " of " << WorkerCount << " job workers could be started.\n";
+    }
+
+    std::cout << "Job System running " << StartedWorkerCount << " worker(s).\n";
+    return true;
+}
+
+void JobSystem::Shutdown()
+{
+    if (nullptr == Shared)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Shared->Mutex_Sleep);
+        Shared->bRunning = false;
+    }
+    Shared->Event_JobsQueued.notify_all();
+
+    for (uint32_t WorkerIndex = 1; WorkerIndex < WorkerCount; WorkerIndex++)
+    {
+        LinkedPlatform->DestroyThread(WorkerThreads[WorkerIndex]);
+    }
+    WorkerCount = 1;
+}
+
+JobGroupID JobSystem::Schedule(JobFunc Func, void* Context, size_t Count, size_t BatchSize, JobGroupID Dependency)
+{
+    if (Count == 0)
+    {
+        return NO_JOB_GROUP;
+    }
+
+    BatchSize = BatchSize > 0 ? BatchSize : 1;
+    size_t JobCount = (Count + BatchSize - 1) / BatchSize;
+
+    // A group only takes a group ID once its jobs fit in the pool, so that running inline doesn't use up either pool.
+    uint32_t FirstJobIndex = JobCount <= MaxJobCount ? Shared->NextJobIndex.fetch_add(static_cast<uint32_t>(JobCount)) : MaxJobCount;
+    bool bJobsFit = FirstJobIndex <= MaxJobCount && JobCount <= MaxJobCount - FirstJobIndex;
+    uint32_t GroupID = bJobsFit ? Shared->NextGroupIndex.fetch_add(1) : MaxJobCount;
+    if (!bJobsFit || GroupID >= MaxJobCount)
+    {
+        // Out of jobs or groups until the next wait point.
+        Wait(Dependency);
+        Func(Context, 0, Count);
+        return NO_JOB_GROUP;
+    }
+
+    for (size_t JobOffset = 0; JobOffset < JobCount; JobOffset++)
+    {
+        Job& NewJob = Jobs[FirstJobIndex + JobOffset];
+        NewJob.Func = Func;
+        NewJob.Context = Context;
+        NewJob.BeginIndex = JobOffset * BatchSize;
+        NewJob.EndIndex = NewJob.BeginIndex + BatchSize < Count ? NewJob.BeginIndex + BatchSize : Count;
+        NewJob.Group = GroupID;
+    }
+
+    JobGroup& NewGroup = Groups[GroupID];
+    NewGroup.UnfinishedJobCount.store(static_cast<uint32_t>(JobCount), std::memory_order_relaxed);
+    NewGroup.bComplete.store(false, std::memory_order_relaxed);
+    NewGroup.FirstJobIndex = FirstJobIndex;
+    NewGroup.JobCount = static_cast<uint32_t>(JobCount);
+    NewGroup.FirstDependentGroup = NO_JOB_GROUP;
+    NewGroup.NextDependentGroup = NO_JOB_GROUP;
+    Shared->UnfinishedJobCount.fetch_add(static_cast<uint32_t>(JobCount));
+
+    // The dependency's completion queues the group's jobs, unless it already happened.
+    if (Dependency != NO_JOB_GROUP)
+    {
+        std::lock_guard<std::mutex> Lock(Shared->Mutex_Dependencies);
+        JobGroup& DependencyGroup = Groups[Dependency];
+        if (!DependencyGroup.bComplete.load(std::memory_order_relaxed))
+        {
+            NewGroup.NextDependentGroup = DependencyGroup.FirstDependentGroup;
+            DependencyGroup.FirstDependentGroup = GroupID;
+            return GroupID;
+        }
+    }
+
+    QueueGroupJobs(GroupID);
+    return GroupID;
+}
+
+bool JobSystem::IsComplete(JobGroupID Group) const
+{
+    return Group == NO_JOB_GROUP || Groups[Group].bComplete.load(std::memory_order_acquire);
+}
+
+void JobSystem::Wait(JobGroupID Group)
+{
+    while (!IsComplete(Group))
+    {
+        if (!TryRunJob(CurrentWorkerIndex))
+        {
+            // Whatever is left is running on other workers.
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WaitForAllJobs()
+{
+    while (Shared->UnfinishedJobCount.load(std::memory_order_acquire) > 0)
+    {
+        if (!TryRunJob(0))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Every queue is empty, but workers may still be looking into them.
+    for (uint32_t WorkerIndex = 0; WorkerIndex < WorkerCount; WorkerIndex++)
+    {
+        std::lock_guard<std::mutex> Lock(Queues[WorkerIndex].Mutex);
+        Queues[WorkerIndex].Front = 0;
+        Queues[WorkerIndex].Back = 0;
+    }
+    Shared->NextJobIndex.store(0, std::memory_order_relaxed);
+    Shared->NextGroupIndex.store(0, std::memory_order_relaxed);
+}
+
+bool JobSystem::TryRunJob(uint32_t WorkerIndex)
+{
+    if (Shared->QueuedJobCount.load(std::memory_order_acquire) == 0)
+    {
+        return false;
+    }
+
+    uint32_t JobIndex = NO_JOB_GROUP;
+
+    // Newest job of the worker's own queue first.
+    {
+        WorkerQueue& OwnQueue = Queues[WorkerIndex];
+        std::lock_guard<std::mutex> Lock(OwnQueue.Mutex);
+        if (OwnQueue.Back > OwnQueue.Front)
+        {
+            JobIndex = OwnQueue.JobIndices[--OwnQueue.Back];
+        }
+    }
+
+    // Then the oldest job of any other queue, starting with the next worker's so that thieves spread out.
+    for (uint32_t Offset = 1; JobIndex == NO_JOB_GROUP && Offset < WorkerCount; Offset++)
+    {
+        WorkerQueue& VictimQueue = Queues[(WorkerIndex + Offset) % WorkerCount];
+        std::lock_guard<std::mutex> Lock(VictimQueue.Mutex);
+        if (VictimQueue.Back > VictimQueue.Front)
+        {
+            JobIndex = VictimQueue.JobIndices[VictimQueue.Front++];
+        }
+    }
+
+    if (JobIndex == NO_JOB_GROUP)
+    {
+        return false;
+    }
+
+    Shared->QueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+    RunJob(JobIndex);
+    return true;
+}
+
+void JobSystem::RunJob(uint32_t JobIndex)
+{
+    Job& RunningJob = Jobs[JobIndex];
+    RunningJob.Func(RunningJob.Context, RunningJob.BeginIndex, RunningJob.EndIndex);
+
+    // The last job of a group completes it, and queues the jobs of every group that was waiting for it.
+    JobGroupID GroupID = RunningJob.Group;
+    if (Groups[GroupID].UnfinishedJobCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        JobGroupID DependentGroup;
+        {
+            std::lock_guard<std::mutex> Lock(Shared->Mutex_Dependencies);
+            Groups[GroupID].bComplete.store(true, std::memory_order_release);
+            DependentGroup = Groups[GroupID].FirstDependentGroup;
+        }
+
+        while (DependentGroup != NO_JOB_GROUP)
+        {
+            JobGroupID NextDependentGroup = Groups[DependentGroup].NextDependentGroup;
+            QueueGroupJobs(DependentGroup);
+            DependentGroup = NextDependentGroup;
+        }
+    }
+
+    // Only counted down once everything the job set off is queued, so that wait points don't return in between.
+    Shared->UnfinishedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::QueueGroupJobs(JobGroupID Group)
+{
+    const JobGroup& QueuedGroup = Groups[Group];
+    {
+        WorkerQueue& Queue = Queues[CurrentWorkerIndex];
+        std::lock_guard<std::mutex> Lock(Queue.Mutex);
+        for (uint32_t JobOffset = 0; JobOffset < QueuedGroup.JobCount; JobOffset++)
+        {
+            Queue.JobIndices[Queue.Back++] = QueuedGroup.FirstJobIndex + JobOffset;
+        }
+    }
+    Shared->QueuedJobCount.fetch_add(QueuedGroup.JobCount);
+
+    // Sleeping workers count themselves before checking for queued jobs, so either they see these jobs or they are
+    // seen here. Taking the mutex makes sure they are waiting before being notified.
+    if (Shared->SleepingWorkerCount.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(Shared->Mutex_Sleep);
+        }
+
+        if (QueuedGroup.JobCount > 1)
+        {
+            Shared->Event_JobsQueued.notify_all();
+        }
+        else
+        {
+            Shared->Event_JobsQueued.notify_one();
+        }
+    }
+}
+
+void JobSystem::WorkerThread_Func(void* Param)
+{
+    JobSystem& System = *static_cast<JobSystem*>(Param);
+    CurrentWorkerIndex = System.Shared->NextWorkerIndex.fetch_add(1);
+
+    while (System.Shared->bRunning.load(std::memory_order_relaxed))
+    {
+        if (System.TryRunJob(CurrentWorkerIndex))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> Lock(System.Shared->Mutex_Sleep);
+        System.Shared->SleepingWorkerCount.fetch_add(1);
+        System.Shared->Event_JobsQueued.wait(Lock, [&System]()
+        {
+            return System.Shared->QueuedJobCount.load() > 0 || !System.Shared->bRunning.load(std::memory_order_relaxed);
+        });
+        System.Shared->SleepingWorkerCount.fetch_sub(1);
+    }
+}
\ No newline at end of file
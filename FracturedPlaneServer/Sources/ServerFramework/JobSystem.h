@@ -0,0 +1,132 @@
+// JobSystem.h
+// Declares the Job System, which spreads work over a pool of Platform threads.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "ServerPlatform.h"
+
+// DEPENDENCIES FORWARD DECLARATION
+struct MemorySubsystem;
+
+// Runs a job over the indices [BeginIndex, EndIndex[ of the range it was scheduled with, passed the scheduled Context.
+typedef void (*JobFunc)(void* Context, size_t BeginIndex, size_t EndIndex);
+
+// Identifies the jobs scheduled by a single Schedule call, which complete together. Only valid until the next wait point.
+typedef uint32_t JobGroupID;
+
+// Stands for a group that is already complete: waiting on it or depending on it never waits.
+static constexpr JobGroupID NO_JOB_GROUP = ~0u;
+
+// Pool of worker threads running jobs. The thread that initialized the Job System is worker 0: it runs jobs whenever it
+// waits on some, and other workers are Platform threads.
+// Every worker has its own queue of jobs ready to run. A worker pushes and pops jobs at the back of its own queue, which
+// keeps the jobs it just scheduled hot in its cache, and once it runs out it steals from the front of the others' queues.
+// Idle workers sleep until jobs get queued.
+// Jobs and groups are taken from fixed pools which are only recycled at wait points, when every scheduled job is done.
+// Only worker 0 and running jobs may schedule jobs and wait on them.
+struct JobSystem
+{
+    static constexpr uint32_t MAX_WORKER_COUNT = 64;
+
+    struct Job
+    {
+        JobFunc Func;
+        void* Context;
+        size_t BeginIndex;
+        size_t EndIndex;
+        JobGroupID Group;
+    };
+
+    struct JobGroup
+    {
+        std::atomic<uint32_t> UnfinishedJobCount;
+        std::atomic<bool> bComplete;
+        uint32_t FirstJobIndex;
+        uint32_t JobCount;
+
+        // Groups waiting for this one to complete before queuing their jobs, chained through NextDependentGroup.
+        // Guarded by Mutex_Dependencies, along with setting bComplete.
+        JobGroupID FirstDependentGroup;
+        JobGroupID NextDependentGroup;
+    };
+
+    // Jobs ready to run, in order of queuing between Front and Back. Every job is queued at most once between two wait
+    // points, so indices never go past the job pool size.
+    struct WorkerQueue
+    {
+        std::mutex Mutex;
+        uint32_t* JobIndices;
+        uint32_t Front;
+        uint32_t Back;
+    };
+
+    // Everything shared between workers, which can't be copied around with the Server State.
+    struct SharedState
+    {
+        std::atomic<uint32_t> NextJobIndex;
+        std::atomic<uint32_t> NextGroupIndex;
+        std::atomic<uint32_t> UnfinishedJobCount; // Jobs scheduled since the last wait point and not done yet.
+        std::atomic<uint32_t> QueuedJobCount; // Jobs sitting in any queue.
+        std::atomic<uint32_t> SleepingWorkerCount;
+        std::atomic<uint32_t> NextWorkerIndex; // Handed over to worker threads as they start.
+        std::atomic<bool> bRunning;
+
+        std::mutex Mutex_Dependencies;
+        std::mutex Mutex_Sleep;
+        std::condition_variable Event_JobsQueued;
+    };
+
+    const ServerPlatform* LinkedPlatform;
+    uint32_t WorkerCount; // Worker 0 included, and every worker that couldn't be started. Read by every worker thread.
+    uint32_t MaxJobCount;
+
+    Job* Jobs;
+    JobGroup* Groups; // There are as many as there are jobs, since every group has at least one.
+    WorkerQueue* Queues;
+    SharedState* Shared;
+
+    ServerPlatform::ThreadID WorkerThreads[MAX_WORKER_COUNT]; // INVALID_ID for workers that couldn't be started.
+
+    // Returns how much heap memory Initialize allocates for the passed worker count and maximum number of jobs.
+    // Worker counts are clamped between 1 and MAX_WORKER_COUNT.
+    static size_t GetRequiredMemory(size_t Workers, size_t MaxJobs);
+
+    // Starts Workers - 1 worker threads through the Platform, the calling thread being worker 0. Up to MaxJobs jobs can
+    // be scheduled between two wait points. Runs with fewer workers if the Platform can't create threads.
+    bool Initialize(MemorySubsystem& Memory, const ServerPlatform& Platform, size_t Workers, size_t MaxJobs);
+
+    // Stops and destroys every worker thread. Pending jobs are dropped.
+    void Shutdown();
+
+    // Schedules Func over the indices [0, Count[, split in jobs of up to BatchSize indices which may run in parallel.
+    // Jobs only start once the Dependency group has completed. Returns the group of the scheduled jobs.
+    // When the job pool is exhausted, Func runs over the whole range right away instead, and NO_JOB_GROUP is returned.
+    JobGroupID Schedule(JobFunc Func, void* Context, size_t Count, size_t BatchSize = 1, JobGroupID Dependency = NO_JOB_GROUP);
+
+    bool IsComplete(JobGroupID Group) const;
+
+    // Runs jobs until the group has completed.
+    void Wait(JobGroupID Group);
+
+    // Wait point: runs jobs until every scheduled job is done, then recycles the job and group pools. Every group ID
+    // handed out so far becomes invalid. Only called by worker 0, outside of any job.
+    void WaitForAllJobs();
+
+    // Pops a job from the worker's queue, or steals one from another queue, and runs it. Returns false if no job was
+    // queued anywhere.
+    bool TryRunJob(uint32_t WorkerIndex);
+
+    void RunJob(uint32_t JobIndex);
+
+    // Queues every job of a group whose dependency has completed on the calling worker's queue, and wakes workers up.
+    void QueueGroupJobs(JobGroupID Group);
+
+    // Function of every worker thread. Param = this Job System.
+    static void WorkerThread_Func(void* Param);
+};
\ No newline at end of file
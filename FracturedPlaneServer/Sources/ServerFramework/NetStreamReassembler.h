@@ -0,0 +1,157 @@
+// NetStreamReassembler.h
+// Turns the byte stream received on a single connection back into whole Net Encoded Packets.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "FPCore/Net/Packet/Packet.h"
+
+// A stream connection delivers bytes, not packets: a single read may end in the middle of a packet head or body, and may
+// contain several packets. Packets fully contained in a read are handed out in place. The bytes of the last, incomplete
+// packet are kept until later reads complete it. Only one packet can be incomplete at once, so the pending data never
+// exceeds the size of the largest encodable packet.
+// To have every packet handed out in place, including the ones spanning several reads, the incomplete packet can be
+// copied in front of where the next read will land with CopyPendingTo, and the whole data fed to ConsumeInPlace.
+// The pending data lives in memory handed over on Initialize, so that a reassembler for every possible connection can be
+// kept around without each one weighing the size of the largest packet: only connections actually left with an
+// incomplete packet ever touch theirs.
+struct NetStreamReassembler
+{
+    static constexpr size_t MAX_ENCODED_PACKET_SIZE = sizeof(FPCore::Net::NetEncodedPacketHead)
+        + static_cast<FPCore::Net::PacketBodySize_t>(~0);
+
+    byte* PendingData = nullptr; // Holds MAX_ENCODED_PACKET_SIZE bytes.
+    size_t PendingByteCount = 0;
+
+    // Makes the reassembler keep incomplete packets in PendingDataMemory, which has to hold MAX_ENCODED_PACKET_SIZE bytes.
+    void Initialize(byte* PendingDataMemory)
+    {
+        PendingData = PendingDataMemory;
+        PendingByteCount = 0;
+    }
+
+    // Forgets any incomplete packet. Has to be called whenever the connection is (re)opened.
+    void Reset()
+    {
+        PendingByteCount = 0;
+    }
+
+    // Returns the size the incomplete packet will have once complete, head included. Only the head is counted while it
+    // hasn't been fully received yet.
+    size_t GetPendingPacketSize() const
+    {
+        if (PendingByteCount < sizeof(FPCore::Net::NetEncodedPacketHead))
+        {
+            return sizeof(FPCore::Net::NetEncodedPacketHead);
+        }
+
+        FPCore::Net::NetEncodedPacketHead PendingHead;
+        memcpy(&PendingHead, PendingData, sizeof(PendingHead));
+        return sizeof(PendingHead) + PendingHead.BodySize;
+    }
+
+    // Copies the bytes of the incomplete packet to Dest, which has to have room for them. Returns how many were copied.
+    // The packet is still pending until ConsumeInPlace is called.
+    size_t CopyPendingTo(byte* Dest) const
+    {
+        memcpy(Dest, PendingData, PendingByteCount);
+        return PendingByteCount;
+    }
+
+    // Same as Consume, for Data starting with the bytes copied by the last CopyPendingTo call. Every packet completed by
+    // Data is handed out from Data itself.
+    template<typename PacketHandler>
+    bool ConsumeInPlace(const byte* Data, size_t DataSize, PacketHandler&& OnPacket)
+    {
+        PendingByteCount = 0;
+        return Consume(Data, DataSize, OnPacket);
+    }
+
+    // Feeds the next received bytes of the stream. OnPacket(const NetEncodedPacketHead&, const byte* Body) is called for
+    // every packet completed by these bytes, in stream order. The body pointer is only valid during the call.
+    // Returns false as soon as a packet head is invalid, in which case the stream can't be trusted anymore.
+    template<typename PacketHandler>
+    bool Consume(const byte* Data, size_t DataSize, PacketHandler&& OnPacket)
+    {
+        constexpr size_t HeadSize = sizeof(FPCore::Net::NetEncodedPacketHead);
+
+        // Complete the packet left over by previous reads first.
+        while (PendingByteCount > 0 && DataSize > 0)
+        {
+            FPCore::Net::NetEncodedPacketHead PendingHead;
+            bool bHasHead = PendingByteCount >= HeadSize;
+            if (bHasHead)
+            {
+                memcpy(&PendingHead, PendingData, HeadSize);
+            }
+
+            size_t MissingByteCount = bHasHead ? HeadSize + PendingHead.BodySize - PendingByteCount : HeadSize - PendingByteCount;
+            size_t CopiedByteCount = DataSize < MissingByteCount ? DataSize : MissingByteCount;
+            memcpy(PendingData + PendingByteCount, Data, CopiedByteCount);
+            PendingByteCount += CopiedByteCount;
+            Data += CopiedByteCount;
+            DataSize -= CopiedByteCount;
+
+            if (!bHasHead)
+            {
+                if (PendingByteCount < HeadSize)
+                {
+                    break;
+                }
+
+                memcpy(&PendingHead, PendingData, HeadSize);
+                if (!IsValidHead(PendingHead))
+                {
+                    return false;
+                }
+            }
+
+            if (PendingByteCount == HeadSize + PendingHead.BodySize)
+            {
+                OnPacket(PendingHead, PendingData + HeadSize);
+                PendingByteCount = 0;
+            }
+        }
+
+        // Hand out every whole packet straight from the received data.
+        while (DataSize >= HeadSize)
+        {
+            FPCore::Net::NetEncodedPacketHead Head;
+            memcpy(&Head, Data, HeadSize);
+            if (!IsValidHead(Head))
+            {
+                return false;
+            }
+
+            if (DataSize - HeadSize < Head.BodySize)
+            {
+                break;
+            }
+
+            OnPacket(Head, Data + HeadSize);
+            Data += HeadSize + Head.BodySize;
+            DataSize -= HeadSize + Head.BodySize;
+        }
+
+        // Keep whatever is left of the last packet for the next read.
+        if (DataSize > 0)
+        {
+            memcpy(PendingData + PendingByteCount, Data, DataSize);
+            PendingByteCount += DataSize;
+        }
+
+        return true;
+    }
+
+    static bool IsValidHead(const FPCore::Net::NetEncodedPacketHead& Head)
+    {
+        // Read the type as an integer, as whatever came from the network may not be a valid enum value.
+        std::underlying_type<FPCore::Net::PacketBodyType>::type BodyType;
+        memcpy(&BodyType, &Head.BodyType, sizeof(BodyType));
+        return BodyType > FPCore::Net::PacketBodyType::INVALID
+            && BodyType < FPCore::Net::PacketBodyType::PACKET_TYPE_COUNT;
+    }
+};
@@ -0,0 +1,91 @@
+// PlatformThreadTable.h
+// Bookkeeping of the threads a Platform creates on behalf of the Server, shared by every Platform implementation.
+
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <utility>
+
+#include "ServerPlatform.h"
+
+// Platform threads created on behalf of the Server. A Thread ID is an index into this table.
+// The table only hands out and takes back IDs: the Platform starts and joins the threads behind them, with its own API,
+// through the functions it passes. Threads are started under the table's mutex, but joined outside of it, so that other
+// threads can be created and destroyed while one is being waited on.
+template<typename HandleType>
+struct PlatformThreadTable
+{
+    static constexpr ServerPlatform::ThreadID MAX_THREAD_COUNT = 64;
+
+    struct Thread
+    {
+        bool bInUse;
+        HandleType Handle;
+        void (*Func)(void*);
+        void* Param;
+    };
+
+    Thread Threads[MAX_THREAD_COUNT] = {};
+    std::mutex Mutex;
+
+    // Takes a free ID for a thread running Func(Param), then calls StartThread(Thread&), which starts the thread, stores
+    // its handle and returns whether it did. Returns INVALID_ID if every ID is taken or the thread couldn't be started.
+    template<typename StartFunc>
+    ServerPlatform::ThreadID Create(void (*Func)(void*), void* Param, StartFunc StartThread)
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+
+        for (ServerPlatform::ThreadID ThreadID = 0; ThreadID < MAX_THREAD_COUNT; ThreadID++)
+        {
+            Thread& NewThread = Threads[ThreadID];
+            if (NewThread.bInUse)
+            {
+                continue;
+            }
+
+            NewThread.Func = Func;
+            NewThread.Param = Param;
+            if (!StartThread(NewThread))
+            {
+                NewThread = {};
+                return ServerPlatform::INVALID_ID;
+            }
+
+            NewThread.bInUse = true;
+            return ThreadID;
+        }
+
+        std::cerr << "Failed to create platform thread: Maximum thread count reached.\n";
+        return ServerPlatform::INVALID_ID;
+    }
+
+    // Calls JoinThread(HandleType&), which waits for the thread's function to return, then releases its ID. The ID is
+    // set to Invalid afterwards. Does nothing for IDs that aren't in use.
+    template<typename JoinFunc>
+    void Destroy(ServerPlatform::ThreadID& ThreadToDestroy, JoinFunc JoinThread)
+    {
+        if (ThreadToDestroy >= MAX_THREAD_COUNT)
+        {
+            return;
+        }
+
+        HandleType Handle;
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            if (!Threads[ThreadToDestroy].bInUse)
+            {
+                return;
+            }
+            Handle = std::move(Threads[ThreadToDestroy].Handle);
+        }
+
+        JoinThread(Handle);
+
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Threads[ThreadToDestroy] = {};
+        }
+        ThreadToDestroy = ServerPlatform::INVALID_ID;
+    }
+};
@@ -0,0 +1,101 @@
+// SPSCRing.h
+// Fixed capacity, lock-free ring buffer for passing values from exactly one producer thread to exactly one consumer thread.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Neither side ever waits on the other: Push fails when the ring is full and Pop fails when it is empty.
+// Head is only written by the consumer and Tail only by the producer. Each publishes its progress with a release store
+// that the other side picks up with an acquire load, so values are always fully written before they can be read.
+// The ring doesn't own its slots: they are handed over on Initialize, which lets its capacity be chosen at runtime.
+template<typename T>
+struct SPSCRing
+{
+    T* Slots = nullptr;
+    size_t Capacity = 0; // Always a power of two.
+
+    // Indices only ever grow and are wrapped when accessing slots. Kept on separate cache lines so the producer and
+    // consumer don't keep stealing the line from each other.
+    alignas(64) std::atomic<size_t> Head = { 0 }; // Index of the next value to be read.
+    alignas(64) std::atomic<size_t> Tail = { 0 }; // Index of the next value to be written.
+
+    // Returns the smallest valid capacity able to hold MinCapacity values.
+    static size_t GetCapacityFor(size_t MinCapacity)
+    {
+        size_t RingCapacity = 1;
+        while (RingCapacity < MinCapacity)
+        {
+            RingCapacity <<= 1;
+        }
+        return RingCapacity;
+    }
+
+    // Empties the ring and makes it use SlotMemory, which has to hold RingCapacity values. RingCapacity has to be a
+    // power of two. Must be called before either thread uses the ring.
+    bool Initialize(T* SlotMemory, size_t RingCapacity)
+    {
+        if (nullptr == SlotMemory || RingCapacity == 0 || (RingCapacity & (RingCapacity - 1)) != 0)
+        {
+            return false;
+        }
+
+        Slots = SlotMemory;
+        Capacity = RingCapacity;
+        Head.store(0, std::memory_order_relaxed);
+        Tail.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    // PRODUCER: Adds a value at the end of the ring. Returns false if the ring is full.
+    bool Push(const T& Value)
+    {
+        size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+        if (CurrentTail - Head.load(std::memory_order_acquire) >= Capacity)
+        {
+            return false;
+        }
+
+        Slots[CurrentTail & (Capacity - 1)] = Value;
+        Tail.store(CurrentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // CONSUMER: Removes up to MaxCount values from the front of the ring and copies them into OutValues, in order.
+    // Returns how many values were read.
+    size_t PopBatch(T* OutValues, size_t MaxCount)
+    {
+        size_t CurrentHead = Head.load(std::memory_order_relaxed);
+        size_t AvailableCount = Tail.load(std::memory_order_acquire) - CurrentHead;
+        size_t ReadCount = AvailableCount < MaxCount ? AvailableCount : MaxCount;
+
+        for (size_t ReadIndex = 0; ReadIndex < ReadCount; ReadIndex++)
+        {
+            OutValues[ReadIndex] = Slots[(CurrentHead + ReadIndex) & (Capacity - 1)];
+        }
+
+        Head.store(CurrentHead + ReadCount, std::memory_order_release);
+        return ReadCount;
+    }
+
+    // CONSUMER: Removes the value at the front of the ring. Returns false if the ring is empty.
+    bool Pop(T& OutValue)
+    {
+        return PopBatch(&OutValue, 1) == 1;
+    }
+};
+
+// Ring holding its own slots, for when the capacity is known at compile time.
+template<typename T, size_t FixedCapacity>
+struct FixedSPSCRing : SPSCRing<T>
+{
+    static_assert(FixedCapacity > 0 && (FixedCapacity & (FixedCapacity - 1)) == 0, "SPSC Ring Capacity must be a power of two !");
+
+    T FixedSlots[FixedCapacity];
+
+    FixedSPSCRing()
+    {
+        this->Initialize(FixedSlots, FixedCapacity);
+    }
+};
@@ -3,11 +3,15 @@
 
 #pragma once
 
+#include "JobSystem.h"
+#include "TimerWheel.h"
+
 #include "Subsystems/Core/MemorySubsystem.h"
 #include "Subsystems/Core/ConnectionsSubsystem.h"
 #include "Subsystems/Core/WorldSubsystem.h"
 
 #include "Subsystems/Net/ClientsSubsystem.h"
+#include "Subsystems/Net/HeartbeatSubsystem.h"
 #include "Subsystems/Net/WorldSynchronizationSubsystem.h"
 
 struct ServerStateData
@@ -16,12 +20,16 @@ struct ServerStateData
     bool ServerUp = false;
 
     const ServerPlatform* Platform = nullptr;
+    ServerConfig Config;
 
     // Server Subsystems
     MemorySubsystem Memory;
+    TimerWheel Timers; // Shared by every Subsystem.
+    JobSystem Jobs; // Shared by every Subsystem. Every job scheduled during an Update is done by its end.
     ConnectionsSubsystem Connections;
     WorldSubsystem World;
 
     ClientsSubsystem Clients;
+    HeartbeatSubsystem Heartbeat;
     WorldSynchronizationSubsystem WorldSynchronization;
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+// ServerConfig.cpp
+// Parsing of Server Configuration files.
+
+#include "ServerConfig.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Returns whether the character is a space or a tab.
+static bool IsBlank(char Character)
+{
+    return Character == ' ' || Character == '\t' || Character == '\r';
+}
+
+// Assigns a parsed value to the Config field named by Key. Returns whether the key is known.
+static bool AssignConfigValue(ServerConfig& Config, const char* Key, size_t KeyLength, unsigned long long Value)
+{
+    auto KeyIs = [Key, KeyLength](const char* Name)
+    {
+        return strlen(Name) == KeyLength && strncmp(Key, Name, KeyLength) == 0;
+    };
+
+    if (KeyIs("MaxConnectionCount")) { Config.MaxConnectionCount = Value; }
+    else if (KeyIs("MaxClientCount")) { Config.MaxClientCount = Value; }
+    else if (KeyIs("ListenPort")) { Config.ListenPort = Value; }
+    else if (KeyIs("NetWorkerCount")) { Config.NetWorkerCount = Value; }
+    else if (KeyIs("NetUseIoUring")) { Config.NetUseIoUring = Value; }
+    else if (KeyIs("JobWorkerCount")) { Config.JobWorkerCount = Value; }
+    else if (KeyIs("TickRate")) { Config.TickRate = Value; }
+    else if (KeyIs("TickWakeOnNetwork")) { Config.TickWakeOnNetwork = Value; }
+    else if (KeyIs("WorldSeed")) { Config.WorldSeed = Value; }
+    else if (KeyIs("IslandSlotCount")) { Config.IslandSlotCount = static_cast<int>(Value); }
+    else if (KeyIs("ExpectedIslandCount")) { Config.ExpectedIslandCount = Value; }
+    else if (KeyIs("IslandBoundsX")) { Config.IslandBoundsX = static_cast<uint16_t>(Value); }
+    else if (KeyIs("IslandBoundsY")) { Config.IslandBoundsY = static_cast<uint16_t>(Value); }
+    else if (KeyIs("MaxResidentZoneCount")) { Config.MaxResidentZoneCount = Value; }
+    else if (KeyIs("ZoneIdleTimeoutMs")) { Config.ZoneIdleTimeoutMs = Value; }
+    else if (KeyIs("PacketWriteBufferSize")) { Config.PacketWriteBufferSize = Value; }
+    else if (KeyIs("FrameArenaSize")) { Config.FrameArenaSize = Value; }
+    else if (KeyIs("MaxTimerCount")) { Config.MaxTimerCount = Value; }
+    else if (KeyIs("MaxJobCount")) { Config.MaxJobCount = Value; }
+    else if (KeyIs("HeartbeatIntervalMs")) { Config.HeartbeatIntervalMs = Value; }
+    else if (KeyIs("ConnectionIdleTimeoutMs")) { Config.ConnectionIdleTimeoutMs = Value; }
+    else if (KeyIs("MemoryHeadroomPercent")) { Config.MemoryHeadroomPercent = Value; }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool ParseServerConfig(const char* ConfigText, size_t ConfigTextLength, ServerConfig& OutConfig)
+{
+    bool bSuccess = true;
+    int LineNumber = 0;
+
+    const char* LineStart = ConfigText;
+    const char* TextEnd = ConfigText + ConfigTextLength;
+    while (LineStart < TextEnd)
+    {
+        const char* LineEnd = static_cast<const char*>(memchr(LineStart, '\n', TextEnd - LineStart));
+        if (nullptr == LineEnd)
+        {
+            LineEnd = TextEnd;
+        }
+        LineNumber++;
+
+        // Trim the line.
+        const char* Cursor = LineStart;
+        const char* End = LineEnd;
+        while (Cursor < End && IsBlank(*Cursor)) { Cursor++; }
+        while (End > Cursor && IsBlank(*(End - 1))) { End--; }
+        LineStart = LineEnd + 1;
+
+        if (Cursor == End || *Cursor == '#')
+        {
+            continue;
+        }
+
+        // Split "Key = Value".
+        const char* Separator = static_cast<const char*>(memchr(Cursor, '=', End - Cursor));
+        if (nullptr == Separator)
+        {
+            std::cerr << "Server Config line " << LineNumber << ": Expected 'Key = Value'.\n";
+            bSuccess = false;
+            continue;
+        }
+
+        const char* KeyEnd = Separator;
+        while (KeyEnd > Cursor && IsBlank(*(KeyEnd - 1))) { KeyEnd--; }
+        const char* ValueStart = Separator + 1;
+        while (ValueStart < End && IsBlank(*ValueStart)) { ValueStart++; }
+
+        // Values are all unsigned integers. Copy them out so parsing can't run past the end of the line.
+        char ValueString[32] = {};
+        size_t ValueLength = End - ValueStart;
+        char* ValueEnd = nullptr;
+        unsigned long long Value = 0;
+        if (ValueLength > 0 && ValueLength < sizeof(ValueString) && *ValueStart >= '0' && *ValueStart <= '9')
+        {
+            memcpy(ValueString, ValueStart, ValueLength);
+            Value = strtoull(ValueString, &ValueEnd, 10);
+        }
+        if (nullptr == ValueEnd || *ValueEnd != '\0')
+        {
+            std::cerr << "Server Config line " << LineNumber << ": Value is not a valid unsigned integer.\n";
+            bSuccess = false;
+            continue;
+        }
+
+        if (!AssignConfigValue(OutConfig, Cursor, KeyEnd - Cursor, Value))
+        {
+            std::cerr << "Server Config line " << LineNumber << ": Unknown key '" << std::string(Cursor, KeyEnd - Cursor) << "'.\n";
+            bSuccess = false;
+        }
+    }
+
+    return bSuccess;
+}
@@ -0,0 +1,61 @@
+// ServerConfig.h
+// Declares the Server Configuration, which determines how Subsystems are sized and thus how much memory the Server needs.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Sizing parameters of a Server. Default values describe a small development shard.
+struct ServerConfig
+{
+    size_t MaxConnectionCount = 256; // Maximum number of simultaneous Connections. Below 65535, as IDs are 16 bits wide.
+    size_t MaxClientCount = 128; // Maximum number of Clients known to the Server at once. Below 65535 as well.
+    size_t ListenPort = 25000; // TCP port the Platform accepts Connections on.
+    size_t NetWorkerCount = 1; // Number of Platform threads receiving network data, each owning a share of the Connections.
+    size_t NetUseIoUring = 0; // Linux: 1 to go through io_uring rather than epoll for networking, when the kernel allows it.
+    size_t JobWorkerCount = 0; // Threads running Server jobs, the Server thread included. 0 lets the Platform run one per processor.
+    size_t TickRate = 60; // Server updates per second. Every update is passed a DeltaTime of 1 / TickRate.
+    size_t TickWakeOnNetwork = 1; // 1 to also update the Server between ticks, with a DeltaTime of 0, as soon as network data comes in.
+
+    uint64_t WorldSeed = 0; // Seed the whole World is generated from. 0 picks one from the clock, printed so it can be replayed.
+    int IslandSlotCount = 16; // Number of Island slots in the Server's Cluster.
+    size_t ExpectedIslandCount = 1; // Number of Islands we expect to generate. Each is assumed to have the bounds below.
+    uint16_t IslandBoundsX = 10; // Expected Island bounds, in zones.
+    uint16_t IslandBoundsY = 10;
+    size_t MaxResidentZoneCount = 64; // Zones whose tiles can be resident at once, over every Island. Tiles take ~21 KB a zone.
+    size_t ZoneIdleTimeoutMs = 300000; // Zones left untouched for this long have their tiles freed. 0 keeps them until room is needed.
+
+    size_t PacketWriteBufferSize = 1024 * 64; // Size of the buffer outgoing packets are written to before being flushed to the Platform, and of each of the Platform's sending buffers.
+    size_t FrameArenaSize = 1024 * 1024; // Size of the Frame Arena used for transient data during a single Update.
+    size_t MaxTimerCount = 256; // Timers Subsystems can have pending at once, on top of the ones every Connection reserves.
+    size_t MaxJobCount = 4096; // Jobs that can be scheduled over a single Update, or over initialization.
+
+    size_t HeartbeatIntervalMs = 5000; // Authenticated Connections get pinged this often, in milliseconds. 0 disables heartbeats.
+    size_t ConnectionIdleTimeoutMs = 15000; // Authenticated Connections that don't send anything for this long are closed.
+
+    size_t MemoryHeadroomPercent = 10; // Extra memory requested on top of the computed requirements, in percent.
+};
+
+// Breakdown of the memory a Server requires, in bytes, as computed from its Config.
+struct ServerMemoryBudget
+{
+    size_t ServerState; // Server State Data, placed at the start of Platform memory.
+    size_t Timers;
+    size_t Jobs;
+    size_t Connections;
+    size_t Clients;
+    size_t Heartbeat;
+    size_t World;
+    size_t WorldSynchronization;
+    size_t FrameArena;
+    size_t HeapBookkeeping; // Memory Subsystem block bookkeeping and alignment.
+    size_t Headroom;
+
+    size_t Total;
+};
+
+// Reads "Key = Value" lines from ConfigText into OutConfig. Empty lines and lines starting with '#' are ignored, and keys
+// that are not present keep their current value.
+// Returns false if any line is malformed or names an unknown key. Valid lines are still applied.
+bool ParseServerConfig(const char* ConfigText, size_t ConfigTextLength, ServerConfig& OutConfig);
@@ -4,7 +4,15 @@
 #include "FPCore/Net/Packet/Packet.h"
 #include "ServerPlatform.h"
 #include "Server.h"
+#include "ctime"
 #include "iostream"
+#include "string"
+
+// Duration of a Timer Wheel tick, which is how precisely timers fire, in seconds.
+#define SERVER_TIMER_TICK_DURATION 0.01
+
+// Time a Connection has to get linked to a Client before being closed, in seconds.
+#define CONNECTION_AUTHENTICATION_TIMEOUT 10.0
 
 void NetPacketReceptionTable_t::AssignHandler(FPCore::Net::PacketBodyType PacketType, NetPacketReceptionHandlerFunc Handler, void* Context)
 {
@@ -38,27 +46,109 @@ void NetPacketReceptionTable_t::HandlePacket(FPCore::Net::PacketHead& Packet)
 }
 
 
-size_t GetRequiredServerMemory()
+// Returns how many timers the Timer Wheel holds: an authentication timeout and a heartbeat per Connection, an eviction
+// timer per resident zone, and what the Config asks for on top.
+static size_t GetServerTimerCount(const ServerConfig& Config)
+{
+    return 2 * Config.MaxConnectionCount + Config.MaxResidentZoneCount + Config.MaxTimerCount;
+}
+
+ServerMemoryBudget ComputeServerMemoryBudget(const ServerConfig& Config)
+{
+    ServerMemoryBudget Budget = {};
+    Budget.ServerState = sizeof(ServerStateData);
+
+    // Every figure below is what the matching Initialize / Generate call allocates from the Memory Subsystem.
+    Budget.Timers = TimerWheel::GetRequiredMemory(GetServerTimerCount(Config));
+    Budget.Jobs = JobSystem::GetRequiredMemory(Config.JobWorkerCount, Config.MaxJobCount);
+    Budget.Connections = ConnectionsSubsystem::GetRequiredMemory(Config.MaxConnectionCount, Config.PacketWriteBufferSize);
+    Budget.Clients = ClientsSubsystem::GetRequiredMemory(Config.MaxClientCount);
+    Budget.Heartbeat = HeartbeatSubsystem::GetRequiredMemory(Config.MaxConnectionCount);
+    Budget.World = WorldSubsystem::GetRequiredMemory(Config.IslandSlotCount, Config.MaxResidentZoneCount)
+        + Config.ExpectedIslandCount * WorldSubsystem::GetRequiredIslandMemory({ Config.IslandBoundsX, Config.IslandBoundsY });
+    Budget.WorldSynchronization = WorldSynchronizationSubsystem::GetRequiredMemory(Config.MaxClientCount);
+    Budget.FrameArena = MemorySubsystem::GetAllocationSize(Config.FrameArenaSize);
+
+    size_t AllocatedSize = Budget.Timers + Budget.Jobs + Budget.Connections + Budget.Clients + Budget.Heartbeat + Budget.World + Budget.WorldSynchronization + Budget.FrameArena;
+    Budget.HeapBookkeeping = MemorySubsystem::GetRequiredHeapSize(AllocatedSize) - AllocatedSize;
+
+    size_t RequiredSize = Budget.ServerState + AllocatedSize + Budget.HeapBookkeeping;
+    Budget.Headroom = RequiredSize / 100 * Config.MemoryHeadroomPercent;
+    Budget.Total = RequiredSize + Budget.Headroom;
+
+    return Budget;
+}
+
+size_t GetRequiredServerMemory(const ServerConfig& Config)
+{
+    return ComputeServerMemoryBudget(Config).Total;
+}
+
+static void PrintServerMemoryBudget(const ServerMemoryBudget& Budget)
 {
-    // Ask for enough memory to hold Server State Data + 2GB
-    return sizeof(ServerStateData) + static_cast<size_t>(1024 * 1024 * 1024) * 2;
+    std::cout << "Server Memory Budget (bytes):\n"
+        << "\tServer State:          " << Budget.ServerState << "\n"
+        << "\tTimers:                " << Budget.Timers << "\n"
+        << "\tJobs:                  " << Budget.Jobs << "\n"
+        << "\tConnections:           " << Budget.Connections << "\n"
+        << "\tClients:               " << Budget.Clients << "\n"
+        << "\tHeartbeat:             " << Budget.Heartbeat << "\n"
+        << "\tWorld:                 " << Budget.World << "\n"
+        << "\tWorld Synchronization: " << Budget.WorldSynchronization << "\n"
+        << "\tFrame Arena:           " << Budget.FrameArena << "\n"
+        << "\tHeap Bookkeeping:      " << Budget.HeapBookkeeping << "\n"
+        << "\tHeadroom:              " << Budget.Headroom << "\n"
+        << "\tTotal:                 " << Budget.Total << "\n";
+}
+
+// Deletes a Connection that is closed or being closed, setting its Client offline if it had one.
+static void ReleaseServerConnection(ServerStateData& Server, Connection& ClosedConnection)
+{
+    // If Connection was linked to a Client, set the Client as offline while displaying their info.
+    if (ClosedConnection.LinkedClient != nullptr)
+    {
+        std::cout << "Client Account Info:\n\tName: " << ClosedConnection.LinkedClient->Account.UniqueUsername << "\n";
+
+        // #TODO(Marc): Move to a function in the Clients Subsystem.
+        ClosedConnection.LinkedClient->LinkedConnection = nullptr;
+        Server.Clients.OnClientDisconnectedCallbackTable.TriggerCallbacks(*ClosedConnection.LinkedClient);
+    }
+    Server.Connections.DeleteConnection(ClosedConnection.ID);
+}
+
+// Handler for On Connection Idle event in Heartbeat Subsystem: closes the Connection, presumably to a dead peer.
+// Context = Server State Data
+static void OnConnectionIdle(Connection& IdleConnection, void* Context)
+{
+    ServerStateData& Server = *static_cast<ServerStateData*>(Context);
+
+    std::cout << "Closing idle Server Connection ID " << IdleConnection.ID << " with Platform Socket ID " << IdleConnection.PlatformConnectionID << "\n";
+    Server.Platform->CloseConnection(IdleConnection.PlatformConnectionID);
+    ReleaseServerConnection(Server, IdleConnection);
 }
 
 // PLATFORM CALL
 // Initializes a new Game Server from the passed Platform's memory and returns it in the form of void pointer through the OutGameServerPtr parameter.
 // The pointer returned here will be used in follow up Update and Shutdown calls. This allows complete separation between Server and Platform code outside the
 // major Flow functions.
-bool InitializeServer(const ServerPlatform& Platform, GameServerPtr& OutGameServerPtr)
+bool InitializeServer(const ServerPlatform& Platform, const ServerConfig& Config, GameServerPtr& OutGameServerPtr)
 {
+    ServerMemoryBudget Budget = ComputeServerMemoryBudget(Config);
+    PrintServerMemoryBudget(Budget);
+
     // Check Platform validity
-    if (Platform.Memory == nullptr || Platform.MemorySize == 0 || Platform.MemorySize < GetRequiredServerMemory())
+    if (Platform.Memory == nullptr || Platform.MemorySize == 0 || Platform.MemorySize < Budget.Total)
     {
         std::cout << "SERVER INITIALIZATION FAILED: Platform did not allocate sufficient memory.\n";
         return false;
     }
     
-    // Make sure allocated memory is entirely zeroed-out
-    memset(Platform.Memory, 0, Platform.MemorySize);
+    // Make sure allocated memory is entirely zeroed-out. Memory fresh from the OS already is, and clearing it would
+    // commit every page of it.
+    if (!Platform.bMemoryZeroed)
+    {
+        memset(Platform.Memory, 0, Platform.MemorySize);
+    }
 
     // Interpret the beginning of platform memory as the Server State Data.
     ServerStateData* OutGameServer = reinterpret_cast<ServerStateData*>(Platform.Memory);
@@ -68,6 +158,7 @@ bool InitializeServer(const ServerPlatform& Platform, GameServerPtr& OutGameServ
 
     OutGameServer->ServerUp = true;
     OutGameServer->Platform = &Platform;
+    OutGameServer->Config = Config;
     
     // Load critical Server Data & Config
     // ...
@@ -76,28 +167,52 @@ bool InitializeServer(const ServerPlatform& Platform, GameServerPtr& OutGameServ
 
     // Initialize Memory Subsystem
     // The memory it is given to manage is all of the Platform's allocated memory, minus the size of the Server State Data structure since those bytes have been used for it.
-    if (!OutGameServer->Memory.Initialize(Platform.Memory + sizeof(ServerStateData), Platform.MemorySize - sizeof(ServerStateData)))
+    if (!OutGameServer->Memory.Initialize(Platform.Memory + sizeof(ServerStateData), Platform.MemorySize - sizeof(ServerStateData), true))
     {
         std::cerr << "Fatal Error when initializing Server: Couldn't initialize Memory Subsystem !\n";
         return false;
     }
 
+    // Allocate the Frame Arena used by all Subsystems for data that doesn't need to outlive a single update.
+    if (!OutGameServer->Memory.InitializeFrameArena(Config.FrameArenaSize))
+    {
+        std::cerr << "Fatal Error when initializing Server: Couldn't initialize Frame Arena !\n";
+        return false;
+    }
+
+    if (!OutGameServer->Timers.Initialize(OutGameServer->Memory, GetServerTimerCount(Config), SERVER_TIMER_TICK_DURATION))
+    {
+        std::cerr << "Fatal Error when initializing Server: Couldn't initialize Timer Wheel !\n";
+        return false;
+    }
+
+    if (!OutGameServer->Jobs.Initialize(OutGameServer->Memory, Platform, Config.JobWorkerCount, Config.MaxJobCount))
+    {
+        std::cerr << "Fatal Error when initializing Server: Couldn't initialize Job System !\n";
+        return false;
+    }
+
     // Initialize Other Subsystems in order of dependencies.
-    if (!OutGameServer->Connections.Initialize(OutGameServer->Memory, 256))
+    if (!OutGameServer->Connections.Initialize(OutGameServer->Memory, Config.MaxConnectionCount, Config.PacketWriteBufferSize, OutGameServer->Timers))
     {
         std::cerr << "Fatal Error when initializing Server: Couldn't initialize Connections Subsystem.\n";
         return false;
     }
 
-    if (!OutGameServer->World.Initialize(OutGameServer->Memory))
+    // The World Seed is all it takes to generate the same World again.
+    uint64_t WorldSeed = Config.WorldSeed != 0 ? Config.WorldSeed : static_cast<uint64_t>(time(nullptr));
+    std::cout << "World Seed: " << WorldSeed << "\n";
+
+    if (!OutGameServer->World.Initialize(OutGameServer->Memory, Config.IslandSlotCount, WorldSeed, OutGameServer->Jobs, OutGameServer->Timers,
+        Config.MaxResidentZoneCount, Config.ZoneIdleTimeoutMs / 1000.0))
     {
         std::cerr << "Fatal Error when initializing Server: Couldn't initialize World Subsystem !\n";
         return false;
     }
 
     IslandGenerationInfo GenInfo;
-    GenInfo.BoundsSize = { 10, 10 };
-    GenInfo.ZoneCount = 10;
+    GenInfo.BoundsSize = { Config.IslandBoundsX, Config.IslandBoundsY };
+    GenInfo.ZoneCount = Config.IslandBoundsX * Config.IslandBoundsY;
     if (!OutGameServer->World.GenerateIsland(OutGameServer->Memory, GenInfo))
     {
         std::cerr << "Fatal Error when initializing Server: Couldn't generate Dev Island !\n";
@@ -106,13 +221,22 @@ bool InitializeServer(const ServerPlatform& Platform, GameServerPtr& OutGameServ
 
     std::cout << "Created dev island ID " << GenInfo.ID << " in Cluster " << GenInfo.ClusterID << "\n";
     
-    if (!OutGameServer->Clients.Initialize(OutGameServer->Memory, 128, OutGameServer->Connections))
+    if (!OutGameServer->Clients.Initialize(OutGameServer->Memory, Config.MaxClientCount, OutGameServer->Connections))
     {
         std::cerr << "Fatal Error when initializing Server: Couldn't initialize Clients Subsystem.\n";
         return false;
     }
 
     OutGameServer->Clients.OnClientAccountCreatedCallbackTable.RegisterCallback(WorldSubsystem::OnClientAccountCreated, &OutGameServer->World);
+
+    if (!OutGameServer->Heartbeat.Initialize(OutGameServer->Memory, OutGameServer->Connections, OutGameServer->Clients, OutGameServer->Timers,
+        Config.HeartbeatIntervalMs / 1000.0, Config.ConnectionIdleTimeoutMs / 1000.0))
+    {
+        std::cerr << "Fatal Error when initializing Server: Couldn't initialize Heartbeat Subsystem.\n";
+        return false;
+    }
+
+    OutGameServer->Heartbeat.OnConnectionIdleCallbackTable.RegisterCallback(OnConnectionIdle, OutGameServer);
     
     if (!OutGameServer->WorldSynchronization.Initialize(OutGameServer->Memory, OutGameServer->Clients, OutGameServer->World))
     {
@@ -120,18 +244,41 @@ bool InitializeServer(const ServerPlatform& Platform, GameServerPtr& OutGameServ
         return false;
     }
 
+    // Wait point for every job scheduled while initializing.
+    OutGameServer->Jobs.WaitForAllJobs();
+
     OutGameServerPtr = OutGameServer;
     
     std::cout << "Server initialization successful.\n";
     return true;
 }
 
+// Closes a Connection that didn't get linked to a Client in time. Its timer is cancelled as soon as it does, or when it
+// gets deleted, so it still is unauthenticated here.
+// Context = Server State Data, Payload = Server Connection ID
+static void OnConnectionAuthenticationTimeout(void* Context, uint64_t Payload)
+{
+    ServerStateData& Server = *static_cast<ServerStateData*>(Context);
+    Connection& Conn = Server.Connections.ActiveConnections[Payload];
+    Conn.AuthenticationTimeout = INVALID_TIMER_HANDLE;
+
+    std::cout << "Connection ID " << Conn.ID << " took too long to authenticate. Closing.\n";
+    Server.Platform->CloseConnection(Conn.PlatformConnectionID);
+    Server.Connections.DeleteConnection(Conn.ID);
+}
+
 // Process time passage on the server, being passed the time that has passed since the beginning of the previous update.
 void UpdateServer(GameServerPtr ServerPtr, const double& DeltaTime)
 {
     ServerStateData& Server = *static_cast<ServerStateData*>(ServerPtr);
     Server.UptimeSeconds += DeltaTime;
 
+    // Move Connections to this update's time first, so that whatever happens to them during the update is timed with it.
+    Server.Connections.UpdateConnections(DeltaTime);
+
+    // Transient data from the previous update is no longer needed.
+    Server.Memory.ResetFrameArena();
+
     // Read Net Events (Connections and Disconnections)
     {
         const ServerPlatform::ConnectionID* ConnectedSocketIDs;
@@ -161,6 +308,16 @@ void UpdateServer(GameServerPtr ServerPtr, const double& DeltaTime)
                     continue;
                 }
 
+                NewConnection->AuthenticationTimeout = Server.Timers.Schedule(CONNECTION_AUTHENTICATION_TIMEOUT,
+                    OnConnectionAuthenticationTimeout, &Server, NewConnection->ID);
+                if (!Server.Timers.IsPending(NewConnection->AuthenticationTimeout))
+                {
+                    std::cerr << "Failed to schedule the authentication timeout of a new Connection ! Socket handle: " << SocketID << "\n";
+                    Server.Platform->CloseConnection(SocketID);
+                    Server.Connections.DeleteConnection(NewConnection->ID);
+                    continue;
+                }
+
                 std::cout << "Registered Server Connection ID " << NewConnection->ID << " with Socket ID " << SocketID << "\n";
             }
         }
@@ -180,17 +337,7 @@ void UpdateServer(GameServerPtr ServerPtr, const double& DeltaTime)
                 }
                 
                 std::cout << "Acknowledging Closing of Server Connection ID " << ServerConnection->ID << " with Platform Socket ID " << SocketID << "\n";
-
-                // If Connection was linked to a Client, set the Client as offline while displaying their info.
-                if (ServerConnection->LinkedClient != nullptr)
-                {
-                    std::cout << "Client Account Info:\n\tName: " << ServerConnection->LinkedClient->Account.UniqueUsername << "\n";
-
-                    // #TODO(Marc): Move to a function in the Clients Subsystem.
-                    ServerConnection->LinkedClient->LinkedConnection = nullptr;
-                    Server.Clients.OnClientDisconnectedCallbackTable.TriggerCallbacks(*ServerConnection->LinkedClient);
-                }
-                Server.Connections.DeleteConnection(ServerConnection->ID);
+                ReleaseServerConnection(Server, *ServerConnection);
             }
             
         }
@@ -200,90 +347,74 @@ void UpdateServer(GameServerPtr ServerPtr, const double& DeltaTime)
 
     // Read Net Data Reception
     {
-        const byte* PlatformNetReceptionBuffer;
-        size_t ReceivedByteCount;
+        const NetReceptionShard* ReceptionShards;
+        size_t ReceptionShardCount;
 
-        Server.Platform->ReadPlatformNetReceptionBuffer(PlatformNetReceptionBuffer, ReceivedByteCount);
-        if (ReceivedByteCount > 0)
-        {
-            const byte* ReceptionBufferEnd = PlatformNetReceptionBuffer + ReceivedByteCount;
-
-            // Read entire buffer as packets sequentially, each time first extracting the Connection ID then extracting the
-            // Packet itself.
-            const byte* NextPacketAddress = PlatformNetReceptionBuffer;
+        Server.Platform->ReadPlatformNetReceptionBuffers(ReceptionShards, ReceptionShardCount);
 
-            do
+        // Handle every packet of every shard in turn, reading bodies straight from the Platform's reception data.
+        // A connection's packets are all in the same shard, so they are still handled in the order they were received.
+        for (size_t ShardIndex = 0; ShardIndex < ReceptionShardCount; ShardIndex++)
+        {
+            const NetReceptionShard& ReceptionShard = ReceptionShards[ShardIndex];
+            for (size_t PacketIndex = 0; PacketIndex < ReceptionShard.PacketCount; PacketIndex++)
             {
-                // Decode next packet.
-                FPCore::Net::PacketHead ReceivedPacket = {};
-                NextPacketAddress = GetNextPacketFromBuffer(NextPacketAddress, ReceptionBufferEnd, ReceivedPacket);
-                if (NextPacketAddress == nullptr)
-                {
-                    break;
-                }
+                const NetPacketDescriptor& ReceivedPacketDescriptor = ReceptionShard.Packets[PacketIndex];
+
+                FPCore::Net::PacketHead ReceivedPacket;
+                ReceivedPacket.ConnectionID = ReceivedPacketDescriptor.ConnectionID;
+                ReceivedPacket.BodyType = ReceivedPacketDescriptor.BodyType;
+                ReceivedPacket.BodySize = ReceivedPacketDescriptor.BodySize;
+                ReceivedPacket.BodyStart = const_cast<byte*>(ReceptionShard.ReceptionData + ReceivedPacketDescriptor.BodyOffset);
 
                 switch (ReceivedPacket.BodyType)
                 {
                 case(FPCore::Net::PacketBodyType::MESSAGE):
                     // Log received message.
-                    std::cout << "Received Message from Connection ID " << ReceivedPacket.ConnectionID << " :'" << static_cast<
-                        const char*>(ReceivedPacket.BodyStart) << "'\n";
+                    std::cout << "Received Message from Connection ID " << ReceivedPacket.ConnectionID << " :'" << std::string(
+                        static_cast<const char*>(ReceivedPacket.BodyStart), strnlen(static_cast<const char*>(ReceivedPacket.BodyStart), ReceivedPacket.BodySize)) << "'\n";
                     break;
                 case(FPCore::Net::PacketBodyType::INVALID):
-                    std::cerr << "Invalid packet type has been received from Connection ID " << ReceivedPacket.ConnectionID <<
-                        "! Aborting reception loop.\n";
+                    std::cerr << "Invalid packet type has been received from Connection ID " << ReceivedPacket.ConnectionID << "!\n";
                     break;
                 default:
                     Server.Connections.HandleIncomingPacket(ReceivedPacket);
                 }
             }
-            while (NextPacketAddress < ReceptionBufferEnd);
-
-            if (nullptr == NextPacketAddress)
-            {
-                std::cerr << "Error when decoding received packets on Game Server !\n";
-            }
         }
-        Server.Platform->ReleasePlatformNetReceptionBuffer();
+
+        Server.Platform->ReleasePlatformNetReceptionBuffers();
     }
 
-    // Update Connections & Eliminate non-authenticated connections that have been active for too long.
+    // Fire due timers, such as the ones eliminating non-authenticated connections that have been active for too long, or
+    // the heartbeats of authenticated ones. Only due timers are touched, however many connections there are.
     {
-        Server.Connections.UpdateConnections(DeltaTime);
-
-        for(ServerConnectionID_t ConnectionID = 0; ConnectionID < Server.Connections.MaxConnectionCount; ConnectionID++)
-        {
-            Connection& Conn = Server.Connections.ActiveConnections[ConnectionID]; 
-            if (Conn.PlatformConnectionID == ServerPlatform::INVALID_ID)
-            {
-                continue;
-            }
-
-            if (Conn.LinkedClient == nullptr && Conn.ConnectionUpTime > 10.f)
-            {
-                std::cout << "Connection ID " << Conn.ID << " took too long to authenticate. Closing.\n";
-                Server.Platform->CloseConnection(Conn.PlatformConnectionID);
-                Server.Connections.DeleteConnection(ConnectionID);
-            }
-        }
+        Server.Timers.Advance(DeltaTime);
     }
 
     // Update World & World Synchronization.
     {
         Server.WorldSynchronization.SyncClients();
     }
+
+    // Wait point for every job scheduled during the update, so that their results go out with it.
+    Server.Jobs.WaitForAllJobs();
     
     // Flush Connections Subsystem's Packet Writer and fill in the Platform Sending Buffer for sending.
+    // Whatever doesn't fit stays in the Packet Writer until next update.
     if (Server.Connections.PacketWriter.WrittenBytes > 0)
     {
         byte* OutSendingBuffer;
-        size_t OutSendingByteCount;
-        Server.Platform->WriteToPlatformNetSendingBuffer(OutSendingBuffer, OutSendingByteCount);
+        size_t OutSendingBufferSize;
+        Server.Platform->WriteToPlatformNetSendingBuffer(OutSendingBuffer, OutSendingBufferSize);
 
-        memcpy(OutSendingBuffer, Server.Connections.PacketWriter.WriteBuffer, Server.Connections.PacketWriter.WrittenBytes);
-        
-        Server.Platform->ReleasePlatformNetSendingBuffer(Server.Connections.PacketWriter.WrittenBytes);
-        Server.Connections.PacketWriter.WrittenBytes = 0;
+        size_t FlushedByteCount = 0;
+        if (OutSendingBufferSize > 0)
+        {
+            FlushedByteCount = Server.Connections.FlushSendingBufferToPlatformBuffer(OutSendingBuffer, OutSendingBufferSize);
+        }
+
+        Server.Platform->ReleasePlatformNetSendingBuffer(FlushedByteCount);
     }
 }
 
@@ -295,6 +426,15 @@ void ShutdownServer(GameServerPtr ServerPtr, const ShutdownReason& Platform)
     // Attempt to save Game World.
     // ...
     
+    NetReceptionStats ReceptionStats;
+    Server.Platform->ReadPlatformNetReceptionStats(ReceptionStats);
+    std::cout << "Net Reception: " << ReceptionStats.ReceivedPacketCount << " packets received, "
+        << ReceptionStats.DroppedReceptionCount << " packets (" << ReceptionStats.DroppedByteCount << " bytes) dropped, peak buffer occupancy "
+        << ReceptionStats.PeakReadOccupancy << " / " << ReceptionStats.BufferSize << " bytes over " << ReceptionStats.ShardCount << " shard(s).\n";
+
+    std::cout << "Frame Arena high-water mark: " << Server.Memory.FrameArena.HighWaterMark << " / " << Server.Memory.FrameArena.Size << " bytes.\n";
+
     // Cleanup server subsystems
+    Server.Jobs.Shutdown();
     Server.Memory.FreeServerHeap();
 }
\ No newline at end of file
@@ -4,6 +4,39 @@
 #pragma once
 
 #include "FPCore/Net/Packet/Packet.h"
+#include "ServerConfig.h"
+
+// Describes a packet received from the network. Its body is left where the Platform received it, at BodyOffset bytes
+// from the start of the reception data handed over along with the descriptor.
+struct NetPacketDescriptor
+{
+    FPCore::Net::PacketConnectionID_t ConnectionID; // Platform Connection ID the packet was received from.
+    FPCore::Net::PacketBodySize_t BodySize;
+    uint32_t BodyOffset;
+    FPCore::Net::PacketBodyType BodyType;
+};
+
+// Packets received from the network by a single Platform reception thread, along with the reception data their bodies lie
+// in. Every packet of a connection is received by the same thread, so it always lands in the same shard.
+struct NetReceptionShard
+{
+    const NetPacketDescriptor* Packets;
+    size_t PacketCount;
+    const byte* ReceptionData; // Body offsets of the shard's descriptors start from here.
+};
+
+// Counters describing the Platform's Net Reception path since startup, summed over every shard.
+struct NetReceptionStats
+{
+    uint64_t ReceivedPacketCount; // Packets written into reception buffers.
+    uint64_t DroppedReceptionCount; // Received packets discarded because the reception buffer was full.
+    uint64_t DroppedByteCount; // Bytes discarded along with them.
+
+    size_t ShardCount; // Number of shards handed over on each read.
+    size_t BufferSize; // Size of a single shard's reception buffer.
+    size_t LastReadOccupancy; // Bytes handed over to the Server by the last read, in the fullest shard.
+    size_t PeakReadOccupancy; // Greatest number of bytes handed over to the Server in a single shard by a single read.
+};
 
 // A set of properties and services a Platform has to provide to the Server for it to run appropriately.
 // Every function pointer needs to be assigned to something to avoid crashes.
@@ -15,6 +48,7 @@ struct ServerPlatform
     typedef char* StorePath; // Identifies path to stored data on the platform.
     
     typedef unsigned short ConnectionID; // Identifier identifying a Network Connection on the platform layer. Maximum value indicates invalid value.
+    // Connection IDs are always below the MaxConnectionCount of the Server Config the platform was initialized with.
     typedef unsigned short ThreadID; // Identifier linking to a Thread on the platform. Maximum value indicates invalid value.
     
     constexpr static unsigned short INVALID_ID = ~0; // Expresses an Invalid value for all Platform Handle types.
@@ -30,9 +64,13 @@ struct ServerPlatform
 
     // Size of memory allocated to the server by the platform. It is not possible to allocate more or free it.
     size_t MemorySize = 0;
+
+    // Whether the platform guarantees Memory is zeroed out when handed over (e.g. freshly mapped OS pages).
+    // Lets the Server skip clearing it, which would otherwise touch every page at startup.
+    bool bMemoryZeroed = false;
     
-    // Creates a new thread and assigns it the passed function.
-    ThreadID (*CreateThread)(void(*Func)()) = nullptr;
+    // Creates a new thread running the passed function, called with Param. Returns INVALID_ID on failure.
+    ThreadID (*CreateThread)(void(*Func)(void*), void* Param) = nullptr;
     // Destroys a thread.
     void (*DestroyThread)(ThreadID& ThreadToDestroy) = nullptr;
     
@@ -56,17 +94,20 @@ struct ServerPlatform
     // Signals the Platform that we are done processing Net Events and that they can be cleared and modified once more.
     void (*ReleasePlatformNetEvents)();
 
-    // Returns pointer to memory containing all data received from the network by the platform since last read.
-    // The data has to be organized as a contiguous array of Packets, with the layout being [Packet][Data] for each.
-    // As the memory that is pointed to is owned by the platform and not the server, it may get locked.
-    // Calling ReleasePlatformNetReceptionBuffer will unlock it.
-    void (*ReadPlatformNetReceptionBuffer)(const byte*& OutReceptionBuffer, size_t& OutReceivedBytesCount);
+    // Returns the Reception Shards describing all packets received from the network by the platform since last read.
+    // Packets from a same connection are all in the same shard, in the order they were received.
+    // Bodies are meant to be read in place: the memory stays valid and untouched until ReleasePlatformNetReceptionBuffers
+    // is called.
+    void (*ReadPlatformNetReceptionBuffers)(const NetReceptionShard*& OutShards, size_t& OutShardCount);
 
-    void (*ReleasePlatformNetReceptionBuffer)();
+    void (*ReleasePlatformNetReceptionBuffers)();
+
+    // Copies the current Net Reception counters into OutStats.
+    void (*ReadPlatformNetReceptionStats)(NetReceptionStats& OutStats);
 
     // Returns pointer to platform memory where data to be sent to outgoing connections should be put.
-    // As the memory that is pointed to is owned by the platform and not the server, it may get locked.
-    // Calling ReleasePlatformSendingBuffer will unlock it.
+    // The memory stays owned by the Server until ReleasePlatformSendingBuffer is called, which hands it over for sending.
+    // If the Platform is still busy sending all of its buffers, OutBufferSize is 0 and writing should be attempted later.
     // Data has to be formatted in the following way for each packet:
     // [ServerPlatform::ID: ConnectionID][PACKET_SIZE_ENCODING_TYPE: PacketSize][DATA].
     void (*WriteToPlatformNetSendingBuffer)(byte*& OutSendingBuffer, size_t& OutBufferSize);
@@ -86,18 +127,22 @@ enum class ShutdownReason
 
 // Init & Flow functions for the Server to implement, called by Platform.
 
-// Returns how much memory the game server needs at minimum.
-size_t GetRequiredServerMemory();
+// Computes how much memory a game server running with the passed Config needs, broken down per Subsystem.
+ServerMemoryBudget ComputeServerMemoryBudget(const ServerConfig& Config);
+
+// Returns how much memory a game server running with the passed Config needs at minimum, headroom included.
+size_t GetRequiredServerMemory(const ServerConfig& Config);
 typedef void* GameServerPtr;
 
 // Attempts to create a Game Server framework from the passed Platform data. If successful, returns true and sets the value of the passed
 // pointer to the beginning of the memory taken up by the Server Management Data, obfuscated from the Platform layer.
 // Otherwise, returns false.
 // The MemoryStart pointer inside the Platform data must point to a block of usable memory of appropriate size.
-// Use GetRequiredServerMemory() to find out how much it needs at minimum.
-bool InitializeServer(const ServerPlatform& Platform, GameServerPtr& OutGameServerPtr);
+// Use GetRequiredServerMemory() with the same Config to find out how much it needs at minimum.
+bool InitializeServer(const ServerPlatform& Platform, const ServerConfig& Config, GameServerPtr& OutGameServerPtr);
 
-// Runs an update tick on the server, informing it of the passage of time.
+// Runs an update tick on the server, informing it of the passage of time. Platforms tick at the Config's TickRate, and
+// may run updates with a DeltaTime of 0 in between so that network data gets handled as soon as it comes in.
 void UpdateServer(GameServerPtr Server, const double& DeltaTime);
 
 // Shuts down the server, giving it a reason.
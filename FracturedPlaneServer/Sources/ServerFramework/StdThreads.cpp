@@ -0,0 +1,36 @@
+// StdThreads.cpp
+// Implementation of the Platform thread services over standard library threads.
+
+#include "ServerFramework/StdThreads.h"
+
+#include <system_error>
+#include <thread>
+
+#include "ServerFramework/PlatformThreadTable.h"
+
+static PlatformThreadTable<std::thread> StdThreads;
+
+ServerPlatform::ThreadID StdThreads_CreateThread(void (*Func)(void*), void* Param)
+{
+    return StdThreads.Create(Func, Param, [](PlatformThreadTable<std::thread>::Thread& Thread)
+    {
+        try
+        {
+            Thread.Handle = std::thread(Thread.Func, Thread.Param);
+        }
+        catch (const std::system_error& Error)
+        {
+            std::cerr << "Failed to create platform thread. Error Code: " << Error.code().value() << "\n";
+            return false;
+        }
+        return true;
+    });
+}
+
+void StdThreads_DestroyThread(ServerPlatform::ThreadID& ThreadToDestroy)
+{
+    StdThreads.Destroy(ThreadToDestroy, [](std::thread& Handle)
+    {
+        Handle.join();
+    });
+}
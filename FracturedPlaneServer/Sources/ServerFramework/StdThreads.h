@@ -0,0 +1,15 @@
+// StdThreads.h
+// Declares the Platform thread services implemented over standard library threads.
+
+#pragma once
+
+#include "ServerPlatform.h"
+
+// Thread services for Platforms and tools that don't need native threads: the Loopback Platform and benchmarks hand these
+// to ServerPlatform::CreateThread and DestroyThread. Thread IDs come from a Platform Thread Table of their own.
+
+// Creates a new thread running Func(Param). Returns INVALID_ID on failure.
+ServerPlatform::ThreadID StdThreads_CreateThread(void (*Func)(void*), void* Param);
+
+// Waits for the thread's function to return then releases its ID. The ID is set to Invalid afterwards.
+void StdThreads_DestroyThread(ServerPlatform::ThreadID& ThreadToDestroy);
@@ -8,6 +8,7 @@
 #include <mutex>
 
 #include "ServerFramework/ServerPlatform.h"
+#include "ServerFramework/TimerWheel.h"
 
 // DEPENDENCIES FORWARD DECLARATION
 struct MemorySubsystem;
@@ -28,8 +29,10 @@ struct Connection
     // Doing it this way is conceptually better - Connections are used as bridges to the Platform Sockets,
     // and whatever we want to associate to them externally should be done fully externally.
     
-    float ConnectionUpTime; // How long has this connection been active.
-    float LastReceptionTime; // How long has this connection not sent a message for.
+    double RegistrationTime; // Connections Subsystem time at which this connection was registered.
+    TimerHandle AuthenticationTimeout; // Pending until this connection gets linked to a Client.
+    TimerHandle HeartbeatTimer; // Pending while the Heartbeat Subsystem watches this connection.
+    double LastReceptionTime; // Connections Subsystem time at which this connection last received a packet.
 };
 
 typedef void (*NetPacketReceptionHandlerFunc)(FPCore::Net::PacketHead& Packet, void* Context);
@@ -54,6 +57,17 @@ struct ConnectionsSubsystem
     Connection* ActiveConnections;
     size_t MaxConnectionCount;
 
+    double Time; // Time passed since initialization, advanced by UpdateConnections. Connection lifetimes are measured against it.
+    TimerWheel* Timers;
+
+    // Stack of the Connection IDs not in use, so registering a Connection doesn't have to look for one.
+    ServerConnectionID_t* FreeConnectionIDs;
+    size_t FreeConnectionIDCount;
+
+    // Server Connection ID bound to each Platform Connection ID, or INVALID_CONNECTION_ID. Platforms hand out Connection
+    // IDs below the Config's MaxConnectionCount, which sizes this table.
+    ServerConnectionID_t* PlatformConnectionMap;
+
     // Links Packet Types to a specific handler function to be called if any.
     NetPacketReceptionTable_t PacketReceptionTable;
     // Internal buffer regularly flushed to the Platform Sending buffer.
@@ -70,12 +84,19 @@ struct ConnectionsSubsystem
     // Initializes the Connections Subsystem, requiring a Memory subsystem to allocate the Active Connections buffer
     // for the specified number of maximum connections we want to handle at once, aswell as a Packet Reception Table
     // so the subsystem may handle authentication request packets.
-    bool Initialize(MemorySubsystem& Memory, size_t MaxConnection);
+    // Connection timers are cancelled on the passed Timer Wheel when no longer relevant.
+    // MaxConnection can't exceed INVALID_CONNECTION_ID.
+    bool Initialize(MemorySubsystem& Memory, size_t MaxConnection, size_t WriteBufferSize, TimerWheel& ServerTimers);
+
+    // Returns how much heap memory Initialize allocates with the same parameters.
+    static size_t GetRequiredMemory(size_t MaxConnection, size_t WriteBufferSize);
+
+    // Advances the time connection lifetimes are measured against. Doesn't touch any connection: heartbeats and idle
+    // connections are handled by the Heartbeat Subsystem, on timers.
+    void UpdateConnections(double UpdateDeltaTime);
 
-    // Updates lifetime data on all active connections.
-    // #TODO(Marc): Should run heartbeats / auto disconnects once subsystems acquire the ability to request the direct
-    // or indirect use of Platform Net functions.
-    void UpdateConnections(float UpdateDeltaTime);
+    // Returns how long the passed connection has been active, in seconds.
+    double GetConnectionUpTime(const Connection& Conn) const;
     
     Connection* RegisterConnection(ServerPlatform::ConnectionID ConnectedSocketID);
     void DeleteConnection(ServerConnectionID_t Connection);
@@ -85,6 +106,7 @@ struct ConnectionsSubsystem
     
     Connection* GetConnectionFromPlatformSocket(ServerPlatform::ConnectionID SocketID);
 
+    // Records the time of reception on the packet's connection and passes the packet to its handler.
     void HandleIncomingPacket(FPCore::Net::PacketHead& Packet);
     
     // Writes a packet to be sent to the passed Connection ID into the buffer. Requires successful locking of the
@@ -94,7 +116,7 @@ struct ConnectionsSubsystem
     // either contains the entirety of the packet body, or its unmarshalled version with pointers to data that need to be copied aswell.
     bool WriteOutgoingPacket(ServerConnectionID_t DestinationConnectionID, FPCore::Net::PacketBodyType BodyType, void* BodyDefPtr);
     
-    // Flushes the internal packed sending buffer to the platform sending buffer, performing appropriate checks and
-    // conversions. Returns how many bytes were written.
+    // Flushes as many whole packets as fit from the internal packed sending buffer to the platform sending buffer.
+    // Packets that didn't fit are kept for the next flush. Returns how many bytes were written.
     size_t FlushSendingBufferToPlatformBuffer(byte* PlatformWriteBuffer, size_t PlatformWriteBufferSize);
 };
\ No newline at end of file
@@ -4,32 +4,82 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 
 #define MEMORY_BLOCK_SIZE 32
 
+// Free extents are indexed in segregated lists ("size classes"), following the TLSF scheme: extents are first classified
+// by the position of their highest set bit (first level), then linearly within that power of two (second level).
+// A two-level bitmap of non-empty lists finds a fitting extent with two find-first-set operations.
+#define MEMORY_SECOND_LEVEL_LOG2 4
+#define MEMORY_SECOND_LEVEL_COUNT (1 << MEMORY_SECOND_LEVEL_LOG2)
+#define MEMORY_FIRST_LEVEL_COUNT 64
+#define MEMORY_SIZE_CLASS_COUNT (MEMORY_FIRST_LEVEL_COUNT * MEMORY_SECOND_LEVEL_COUNT)
+
 // Server Management Object handling all memory allocations outside of other Server Management objects.
 struct MemorySubsystem
 {
     uint8_t* MemoryStart = nullptr;
     size_t MemorySize = 0;
 
-    enum class MEMORY_BLOCK_STATE : uint8_t
+    enum class MEMORY_BLOCK_STATE : uint32_t
     {
         FREE, // Available for allocation.
         ALLOCATED, // Allocated as first or only block in an allocation.
         ALLOCATED_EXTRA // Allocated as a contiguous allocation, "part of" another block.
     };
-    
+
+    // Largest extent the block bookkeeping can describe (about 32GB with 32 bytes blocks).
+    static constexpr size_t MAX_EXTENT_BLOCK_COUNT = (1u << 30) - 1;
+
     struct MemoryBlock
     {
-        // #TODO(Marc): It's out of extreme laziness that I'm adding the address in here.
-        //void* Address = nullptr;
-        MEMORY_BLOCK_STATE State = MEMORY_BLOCK_STATE::FREE;
+        MEMORY_BLOCK_STATE State : 2;
+
+        // Length in blocks of the extent (allocation or maximal run of free blocks) this block is part of.
+        // Only meaningful on the first block of an allocation, and on the first and last blocks of a free extent.
+        uint32_t ExtentBlockCount : 30;
     };
+    static_assert(sizeof(MemoryBlock) == sizeof(uint32_t), "Memory Block bookkeeping should be packed into 4 bytes !");
+
     MemoryBlock* MemoryBlocks = nullptr;
     size_t MemoryBlockCount = 0;
 
-    bool Initialize(void* MemStart, size_t MemSize);
+    // Size class list links, stored inside the first block of every free extent.
+    struct FreeExtent
+    {
+        size_t PreviousFreeExtent; // Block index of the previous extent in the same size class list.
+        size_t NextFreeExtent; // Block index of the next extent in the same size class list.
+    };
+    static_assert(sizeof(FreeExtent) <= MEMORY_BLOCK_SIZE, "Free extent bookkeeping must fit within a single memory block !");
+
+    // Block index of the first free extent of each size class, or INVALID_BLOCK_INDEX if the list is empty.
+    size_t FreeExtentLists[MEMORY_SIZE_CLASS_COUNT];
+    // One bit per first level, set when at least one of its size class lists is not empty.
+    uint64_t FirstLevelBitmap = 0;
+    // One bit per size class of the first level, set when its list is not empty.
+    uint16_t SecondLevelBitmaps[MEMORY_FIRST_LEVEL_COUNT];
+    static_assert(sizeof(uint16_t) * 8 >= MEMORY_SECOND_LEVEL_COUNT, "Second level bitmaps are too small for the second level count !");
+
+    static constexpr size_t INVALID_BLOCK_INDEX = ~static_cast<size_t>(0);
+
+    // Linear "bump" allocator for transient data that only lives until the end of the current Server Update.
+    // Its memory is taken from the heap once, and it is reset at the beginning of every Update.
+    struct
+    {
+        uint8_t* Start;
+        size_t Size;
+        size_t UsedBytes; // Bytes pushed since the last reset.
+        size_t HighWaterMark; // Greatest number of bytes used over a single Update since initialization.
+    } FrameArena = {};
+
+    bool Initialize(void* MemStart, size_t MemSize, bool bMemoryZeroed = false);
+
+    // Returns how much heap memory an allocation of the passed size really takes up, once rounded up to whole blocks.
+    static size_t GetAllocationSize(size_t Size);
+    // Returns how much memory has to be passed on initialization for allocations totalling AllocatedSize bytes (as
+    // returned by GetAllocationSize) to fit, taking block bookkeeping and alignment into account.
+    static size_t GetRequiredHeapSize(size_t AllocatedSize);
     void FreeServerHeap();
 
     // Allocates the requested amount of memory, zeroing it out first.
@@ -39,7 +89,7 @@ struct MemorySubsystem
     template <typename T>
     T* AllocateAndInit(size_t Count = 1)
     {
-        T* Data = static_cast<T*>(Allocate(sizeof(T)));
+        T* Data = static_cast<T*>(Allocate(sizeof(T) * Count));
 
         if (nullptr != Data)
         {
@@ -60,5 +110,41 @@ struct MemorySubsystem
         return Data;   
     }
 
-    void Free(void* AllocatedAddress);  
+    // Frees an allocation made through this subsystem. Only the blocks of that allocation are released.
+    void Free(void* AllocatedAddress);
+
+    // Allocates the Frame Arena from the heap. Returns whether allocation was successful.
+    bool InitializeFrameArena(size_t Size);
+
+    // Releases everything pushed onto the Frame Arena. Should be called at the very beginning of a Server Update.
+    void ResetFrameArena();
+
+    // Pushes the requested amount of zeroed memory onto the Frame Arena. The memory stays valid until the next reset.
+    // Returns null if the Frame Arena is out of space.
+    void* PushFrameMemory(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    // Pushes enough zeroed memory onto the Frame Arena for the passed data type, times the requested count.
+    template <typename T>
+    T* PushFrameArray(size_t Count = 1)
+    {
+        return static_cast<T*>(PushFrameMemory(sizeof(T) * Count, alignof(T)));
+    }
+
+    // Returns the current top of the Frame Arena, for PopFrameMemory to come back to.
+    size_t GetFrameMark() const { return FrameArena.UsedBytes; }
+
+    // Releases everything pushed onto the Frame Arena since Mark was taken. Lets data that is only needed for a part of
+    // the Update, such as a packet body until it is written, not pile up over the whole Update.
+    void PopFrameMemory(size_t Mark);
+
+    // Free extent index management.
+
+    FreeExtent& GetFreeExtent(size_t FirstBlockIndex);
+
+    // Adds a free extent to the list of its size class, tagging its first and last blocks with its length.
+    void InsertFreeExtent(size_t FirstBlockIndex, size_t BlockCount);
+    // Removes a free extent from the list of its size class.
+    void RemoveFreeExtent(size_t FirstBlockIndex);
+    // Returns the first block of a free extent of at least BlockCount blocks, or INVALID_BLOCK_INDEX if there is none.
+    size_t FindFreeExtent(size_t BlockCount);
 };
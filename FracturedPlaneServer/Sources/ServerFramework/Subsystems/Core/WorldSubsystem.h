@@ -6,12 +6,32 @@
 
 #include "FPCore/World/World.h"
 #include "ServerFramework/Subsystems/Subsystem.h"
+#include "ServerFramework/TerrainNoise.h"
+#include "ServerFramework/TimerWheel.h"
 #include "Math/Math.h"
 
 // EXTERNAL DEPENDENCIES FORWARD DECLARATION
 struct MemorySubsystem;
+struct JobSystem;
 struct Client;
 
+// Tile data of a single zone, allocated as a whole once the zone is touched.
+struct ZoneTiles
+{
+    byte VoidTileBitmask[FPCore::World::TILES_PER_ZONE / 8]; // Bits for whether each tile is void or not, line by line.
+    uint16_t TileCenterElevations[FPCore::World::TILES_PER_ZONE];
+};
+
+// Residency of a zone's tile data. Tiles are allocated and generated the first time the zone is touched, and freed once it
+// has been left idle long enough, to be generated again from the Island seed if it gets touched later on.
+struct ZoneResidency
+{
+    ZoneTiles* Tiles; // Null while the zone isn't resident.
+    double LastTouchTime; // Timer Wheel time of the last touch, in seconds.
+    uint32_t ResidentSlot; // Index of the zone among the World's Resident Zones, while resident.
+    TimerHandle EvictionTimer;
+};
+
 struct CharacterCreationInfo
 {
     char Name[32];
@@ -34,13 +54,13 @@ struct Cluster
         Vec2<uint16_t> Bounds; // Rectangular bounds of the island encapsulating all of its zones.
 
         int64_t RandomGenSeed; // An Island with the same bounds and the same seed will generate the same land.
+        TerrainNoise Terrain; // Noise the tiles of every zone are generated from, seeded from the Random Gen Seed.
 
         FPCore::World::ZoneDef* Zones; // Contains all zone definitions in a contiguous sequence. TODO: Eliminate void zones from this array.
         size_t ZoneCount;
 
         // TILE DATA
-        byte* VoidTileBitmask; // Bits for whether each tile is void or not. Stored contiguously on a per zone basis, line by line.
-        uint16_t* TileCenterElevations;
+        ZoneResidency* ZoneResidencies; // Residency of every zone, in the same order as Zones.
     };
 
     // Islands buffer.
@@ -62,6 +82,9 @@ struct IslandGenerationInfo
     size_t ZoneCount = 0;   // Total number of non-void zones in the generated island. If passed as hint, will be interpreted as maximum / target zone count.
     // Hence final Island zone density should be at most ZoneCount / BoundsSize.X * BoundsSize.Y.
 
+    int64_t RandomGenSeed = 0; // Seed the Island was generated from. If passed as hint (non-zero), the Island is generated from it,
+    // otherwise the seed is drawn from the World Seed.
+
 // TODO Other island generation parameters / info (elevation min / max, temperature min / max...)
 };
 
@@ -73,7 +96,35 @@ struct WorldSubsystem
     
     Cluster IslandClusters[8];
 
-    bool Initialize(MemorySubsystem& Memory);
+    uint64_t WorldSeed; // Every random draw of the World is made from it, through Counter Random.
+
+    // Zone whose tiles are resident, in any Island.
+    struct ResidentZone
+    {
+        Cluster::Island* Island;
+        uint32_t ZoneIndex;
+    };
+
+    ResidentZone* ResidentZones;
+    size_t ResidentZoneCount;
+    size_t MaxResidentZoneCount;
+    double ZoneIdleTimeout; // In seconds. A null timeout keeps zones resident until room is needed for others.
+
+    MemorySubsystem* LinkedMemory;
+    JobSystem* Jobs;
+    TimerWheel* Timers;
+
+    // Creates a single Cluster with the passed number of Island slots, in a World generated from Seed. Generation work gets
+    // spread over the Job System. Up to MaxResidentZones zones have their tiles resident at once, over every Island, and
+    // zones left untouched for ZoneIdleTimeoutSeconds are evicted through the Timer Wheel.
+    bool Initialize(MemorySubsystem& Memory, int IslandSlotCount, uint64_t Seed, JobSystem& ServerJobs, TimerWheel& ServerTimers,
+        size_t MaxResidentZones, double ZoneIdleTimeoutSeconds);
+
+    // Returns how much heap memory Initialize allocates for the passed Island slot count, plus the tiles of as many resident
+    // zones as passed, which are allocated as zones get touched.
+    static size_t GetRequiredMemory(int IslandSlotCount, size_t MaxResidentZones);
+    // Returns how much heap memory generating an Island of the passed bounds allocates. Tiles aren't part of it.
+    static size_t GetRequiredIslandMemory(Vec2<uint16_t> BoundsSize);
 
     // Generates a new island in an automatically chosen Cluster. Returns whether the operation was a success.
     // Some parameters in the Generation Info structure have to be passed for generation to succeed
@@ -81,7 +132,37 @@ struct WorldSubsystem
     // (See IslandGenerationInfo structure comments !)
     // If anything passed as hint is required for valid generation, it should be checked afterwards, and the island deleted if need be.
     // Memory is allocated as required to generate an island of appropriate size.
+    // Only zone definitions are generated here: tiles are left to TouchZone and OpenZones, zone by zone, on demand.
     bool GenerateIsland(MemorySubsystem& Memory, IslandGenerationInfo& GenInfo);
+
+    // Returns the tiles of the zone at ZoneCoords, allocating and generating them if the zone isn't resident yet, and marks
+    // the zone as touched. Returns null if the zone is out of the Island bounds or no room could be made for its tiles.
+    // The returned tiles stay valid until another zone is made resident or the Timer Wheel advances.
+    ZoneTiles* TouchZone(Cluster::Island& Island, FPCore::World::Coordinates ZoneCoords);
+
+    // Makes every passed zone resident, generating the missing ones in parallel, and marks them all as touched.
+    // Least recently touched zones are evicted to make room if need be. Zones may be passed more than once.
+    // Returns whether every zone is resident.
+    bool OpenZones(Cluster::Island& Island, const FPCore::World::Coordinates* ZoneCoords, size_t ZoneCount);
+
+    // Evicts the least recently touched resident zone, as long as it was touched before TouchTime.
+    // Returns whether a zone was evicted.
+    bool EvictLeastRecentlyTouchedZone(double TouchTime);
+
+    // Frees the tiles of a resident zone. They get generated again, the same, if the zone is touched later on.
+    void EvictZone(Cluster::Island& Island, uint32_t ZoneIndex);
+
+    // Generates the definition of a single zone of the Island, from the zone's own random sequence.
+    static void GenerateZoneDef(Cluster::Island& Island, FPCore::World::Coordinates ZoneCoords);
+    // Generates the tiles of a single zone of the Island into OutTiles, from the Island's Terrain Noise.
+    static void GenerateZoneTiles(const Cluster::Island& Island, FPCore::World::Coordinates ZoneCoords, ZoneTiles& OutTiles);
+
+    // Job generating the tiles of zones being opened. Context = array of Zone Generation Tasks.
+    static void GenerateZoneTiles_Job(void* Context, size_t BeginTaskIndex, size_t EndTaskIndex);
+
+    // Timer Wheel callback evicting a zone if it has been idle for long enough. Payload = Cluster, Island and zone indices.
+    static void OnZoneEvictionTimer(void* Context, uint64_t Payload);
+
     // Deletes an Island from the world entirely. No event is tied to this call, so this should be done as the last step of any
     // mechanic leading to the destruction of the island !
     void DeleteIsland(FPCore::World::ClusterID, FPCore::World::IslandID); 
@@ -60,6 +60,12 @@ struct ClientsSubsystem
     Client* Clients;
     size_t MaxClientCount;
 
+    // Open-addressed hash table of Client IDs keyed by Unique Username, so a Client is found by name without going
+    // through every Client. Holds at least twice as many slots as there are Clients, and empty slots are
+    // INVALID_CLIENT_ID. Clients are never deleted, so neither are entries.
+    ClientID_t* UsernameIndex;
+    size_t UsernameIndexSize; // Always a power of two.
+
     // Callback tables for Client connection and disconnection.
     // We support up to 8 callbacks.
     CallbackTable<OnClientConnectedFunc, 8> OnClientConnectedCallbackTable;
@@ -68,11 +74,17 @@ struct ClientsSubsystem
     
     // Linked Connections Subsystem, passed on initialization.
     ConnectionsSubsystem* ServerConnectionsSubsystem;
+
+    // Linked Memory Subsystem, passed on initialization. Used for transient packet data.
+    MemorySubsystem* ServerMemorySubsystem;
     
     // Initializes the Clients Subsystem, requiring a Memory subsystem to allocate the Clients buffer and a Connections
-    // Subsystem to handle authentication and linking a Connection to a Client ID.
+    // Subsystem to handle authentication and linking a Connection to a Client ID. MaxClients can't exceed INVALID_CLIENT_ID.
     bool Initialize(MemorySubsystem& Memory, size_t MaxClients, ConnectionsSubsystem& Connections);
 
+    // Returns how much heap memory Initialize allocates for the passed maximum number of Clients.
+    static size_t GetRequiredMemory(size_t MaxClients);
+
     // Returns a Client using their account's Unique Username.
     // If no Client account with that name exists, returns null.
     Client* GetClientByUniqueUsername(Username_t Name);
@@ -0,0 +1,76 @@
+// HeartbeatSubsystem.h
+// Contains Connection liveness code: heartbeats, round trip time measurement and idle Connection detection.
+
+#pragma once
+
+#include "cstdint"
+#include "FPCore/Net/Packet/Packet.h"
+#include "ServerFramework/Subsystems/Subsystem.h"
+
+// DEPENDENCIES FORWARD DECLARATION
+struct MemorySubsystem;
+struct ConnectionsSubsystem;
+struct ClientsSubsystem;
+struct TimerWheel;
+
+struct Connection;
+struct Client;
+
+// Heartbeat data of a single Connection, stored at the index of its Server Connection ID.
+struct ConnectionHeartbeatState
+{
+    uint32_t LastPingSequence; // Sequence of the last ping sent, which a pong has to match to be measured.
+    double LastPingTime; // Connections Subsystem time at which the last ping was sent.
+    float RoundTripTime; // Last measured round trip time in seconds, to the update. Negative until the first pong.
+};
+
+// EVENT TYPE DEFINITIONS.
+
+// OnConnectionIdle: Called when a watched Connection hasn't received anything for the Idle Timeout. The Connection stops
+// being watched, and is expected to get closed by whoever registered.
+typedef void (*OnConnectionIdleFunc)(Connection& IdleConnection, void* Context);
+
+// Subsystem watching over authenticated Connections. Every watched Connection owns a timer on the Server's Timer Wheel,
+// firing every Heartbeat Interval to ping it, so only the Connections that are due get looked at in an update.
+// Connections that haven't received anything for the Idle Timeout are reported through OnConnectionIdle instead.
+struct HeartbeatSubsystem
+{
+    ConnectionHeartbeatState* HeartbeatStates;
+    size_t MaxConnectionCount;
+
+    // In seconds. A null Heartbeat Interval disables heartbeats.
+    double HeartbeatInterval;
+    double IdleTimeout;
+
+    // We support up to 8 callbacks.
+    CallbackTable<OnConnectionIdleFunc, 8> OnConnectionIdleCallbackTable;
+
+    // Linked Connections Subsystem and Timer Wheel, passed on initialization.
+    ConnectionsSubsystem* ServerConnectionsSubsystem;
+    TimerWheel* ServerTimers;
+
+    // Initializes the Heartbeat Subsystem, requiring a Memory subsystem to allocate the Heartbeat States of as many
+    // Connections as the Connections Subsystem supports. Connections start being watched once authenticated through
+    // the Clients Subsystem. Intervals are in seconds.
+    bool Initialize(MemorySubsystem& Memory, ConnectionsSubsystem& Connections, ClientsSubsystem& Clients, TimerWheel& Timers,
+        double Interval, double Timeout);
+
+    // Returns how much heap memory Initialize allocates for a Connections Subsystem supporting MaxConnection.
+    static size_t GetRequiredMemory(size_t MaxConnection);
+
+    // Starts pinging the passed Connection every Heartbeat Interval, and watching it for idleness.
+    // Returns whether the Connection is being watched.
+    bool WatchConnection(Connection& WatchedConnection);
+
+    // Timer Wheel callback, either pinging a watched Connection or reporting it idle.
+    // Context = pointer to this structure, Payload = Server Connection ID.
+    static void OnHeartbeatTimer(void* Context, uint64_t Payload);
+
+    // Packet Handlers
+
+    static void HandleHeartbeatPacket(FPCore::Net::PacketHead& Packet, void* Context);
+
+    // Handler for On Client Connected event in Clients Subsystem.
+    // Context = pointer to this structure.
+    static void OnClientConnected(Client& ConnectedClient, void* Context);
+};
\ No newline at end of file
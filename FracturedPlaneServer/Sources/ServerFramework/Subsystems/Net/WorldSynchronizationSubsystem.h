@@ -30,6 +30,7 @@ struct WorldSynchronizationSubsystem
     ClientSyncState* ClientSyncStates;
     size_t MaxClientCount;
 
+    MemorySubsystem* LinkedMemorySubsystem;
     ClientsSubsystem* LinkedClientsSubsystem;
     WorldSubsystem* LinkedWorldSubsystem;
 
@@ -37,11 +38,14 @@ struct WorldSynchronizationSubsystem
     // buffers, whose size will depend on Clients Subsystem max supported clients.
     bool Initialize(MemorySubsystem& Memory, ClientsSubsystem& Clients, WorldSubsystem& World);
 
+    // Returns how much heap memory Initialize allocates for a Clients Subsystem supporting MaxClients.
+    static size_t GetRequiredMemory(size_t MaxClients);
+
     void CreateSyncCluster(){}
 
     void SyncClients();
 
-    // Triggers synchronization of a Client's current viewed zone's landscape.
+    // Triggers synchronization of a Client's current viewed zone's landscape. Returns whether the packet was written for sending.
     bool SynchronizeZoneLandscape(Client& ClientToSync, ClientSyncState& SyncState);
     
     // Handler for On Client Connected event in Clients Subsystem.
@@ -7,26 +7,66 @@
 #include "ServerFramework/Subsystems/Core/ConnectionsSubsystem.h"
 #include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
 
+// Returns the number of Username Index slots used for the passed maximum number of Clients.
+static size_t GetUsernameIndexSize(size_t MaxClients)
+{
+    size_t IndexSize = 1;
+    while (IndexSize < MaxClients * 2)
+    {
+        IndexSize <<= 1;
+    }
+    return IndexSize;
+}
+
+// FNV-1a hash of a Username, up to its terminating character.
+static size_t HashUsername(const Username_t Name)
+{
+    uint32_t Hash = 2166136261u;
+    for (size_t CharIndex = 0; CharIndex < CLIENT_USERNAME_MAX_LENGTH && Name[CharIndex] != '\0'; CharIndex++)
+    {
+        Hash = (Hash ^ static_cast<uint8_t>(Name[CharIndex])) * 16777619u;
+    }
+    return Hash;
+}
+
+size_t ClientsSubsystem::GetRequiredMemory(size_t MaxClients)
+{
+    return MemorySubsystem::GetAllocationSize(MaxClients * sizeof(Client))
+        + MemorySubsystem::GetAllocationSize(GetUsernameIndexSize(MaxClients) * sizeof(ClientID_t));
+}
+
 bool ClientsSubsystem::Initialize(MemorySubsystem& Memory, size_t MaxClients, ConnectionsSubsystem& Connections)
 {
+    if (MaxClients >= INVALID_CLIENT_ID)
+    {
+        std::cerr << "Error: Can't handle " << MaxClients << " Clients, the maximum is " << INVALID_CLIENT_ID - 1 << ".\n";
+        return false;
+    }
+
     // Allocate Client buffer.
     MaxClientCount = MaxClients;
     Clients = static_cast<Client*>(Memory.Allocate(MaxClients * sizeof(Client)));
+    UsernameIndexSize = GetUsernameIndexSize(MaxClients);
+    UsernameIndex = static_cast<ClientID_t*>(Memory.Allocate(UsernameIndexSize * sizeof(ClientID_t)));
 
-    if (nullptr == Clients)
+    if (nullptr == Clients || nullptr == UsernameIndex)
     {
         return false;
     }
     
     memset(Clients, 0, MaxClients * sizeof(Client));
 
-    for(ClientID_t ClientID = 0; ClientID < MaxClientCount; ++ClientID)
+    for(size_t ClientID = 0; ClientID < MaxClientCount; ++ClientID)
     {
         Clients[ClientID].ID = INVALID_CLIENT_ID;
     }
 
-    // Link Connections Subsystem
+    // INVALID_CLIENT_ID has every bit set.
+    memset(UsernameIndex, 0xFF, UsernameIndexSize * sizeof(ClientID_t));
+
+    // Link Connections & Memory Subsystems
     ServerConnectionsSubsystem = &Connections;
+    ServerMemorySubsystem = &Memory;
 
     ServerConnectionsSubsystem->PacketReceptionTable.AssignHandler(FPCore::Net::PacketBodyType::AUTHENTICATION, HandleAuthenticationRequestPacket, this);
 
@@ -39,11 +79,15 @@ bool ClientsSubsystem::Initialize(MemorySubsystem& Memory, size_t MaxClients, Co
 
 Client* ClientsSubsystem::GetClientByUniqueUsername(Username_t Name)
 {
-    for(ClientID_t ClientID = 0; ClientID < MaxClientCount; ++ClientID)
+    // Probe from the name's slot until finding the Client or an empty slot. The index is never full, so this ends.
+    for (size_t IndexSlot = HashUsername(Name) & (UsernameIndexSize - 1);
+        UsernameIndex[IndexSlot] != INVALID_CLIENT_ID;
+        IndexSlot = (IndexSlot + 1) & (UsernameIndexSize - 1))
     {
-        if (strcmp(Clients[ClientID].Account.UniqueUsername, Name) == 0)
+        Client& IndexedClient = Clients[UsernameIndex[IndexSlot]];
+        if (strncmp(IndexedClient.Account.UniqueUsername, Name, CLIENT_USERNAME_MAX_LENGTH) == 0)
         {
-            return &Clients[ClientID];
+            return &IndexedClient;
         }
     }
 
@@ -52,8 +96,9 @@ Client* ClientsSubsystem::GetClientByUniqueUsername(Username_t Name)
 
 Client* ClientsSubsystem::CreateNewClient(Username_t Name)
 {
-    for(ClientID_t ClientID = 0; ClientID < MaxClientCount; ++ClientID)
+    for(size_t ClientIndex = 0; ClientIndex < MaxClientCount; ++ClientIndex)
     {
+        ClientID_t ClientID = static_cast<ClientID_t>(ClientIndex);
         if (Clients[ClientID].ID == INVALID_CLIENT_ID)
         {
             // Allocate new Client and return its address.
@@ -62,6 +107,14 @@ Client* ClientsSubsystem::CreateNewClient(Username_t Name)
 
             Clients[ClientID].Account = {};
             strcpy_s(Clients[ClientID].Account.UniqueUsername, CLIENT_USERNAME_MAX_LENGTH, Name);
+
+            // Index the Client by name in the first empty slot from the name's slot.
+            size_t IndexSlot = HashUsername(Clients[ClientID].Account.UniqueUsername) & (UsernameIndexSize - 1);
+            while (UsernameIndex[IndexSlot] != INVALID_CLIENT_ID)
+            {
+                IndexSlot = (IndexSlot + 1) & (UsernameIndexSize - 1);
+            }
+            UsernameIndex[IndexSlot] = ClientID;
     
             OnClientAccountCreatedCallbackTable.TriggerCallbacks(Clients[ClientID]);
             
@@ -150,17 +203,26 @@ void ClientsSubsystem::HandleAuthenticationRequestPacket(FPCore::Net::PacketHead
     
     // Process Authentication Request.
 
-    // Read Packet data as a Authentication Request Packet. This same data will be read by the authentication system
-    // and have its data replaced so it can be sent back as a response.
-    FPCore::Net::PacketBodyDef_Authentication AuthPacketData = AuthPacket.ReadBodyDef<
+    // Copy Packet data onto the Frame Arena as a Authentication Request Packet. This same data will be read by the
+    // authentication system and have its data replaced so it can be sent back as a response. It is popped once written,
+    // so that a burst of authentications doesn't fill the Frame Arena up.
+    size_t FrameMark = Clients->ServerMemorySubsystem->GetFrameMark();
+    FPCore::Net::PacketBodyDef_Authentication* AuthPacketData = Clients->ServerMemorySubsystem->PushFrameArray<
         FPCore::Net::PacketBodyDef_Authentication>();
+    if (nullptr == AuthPacketData)
+    {
+        std::cerr << "Error: Could not process Authentication Request from Connection ID " << AuthPacket.ConnectionID << ": Out of Frame memory.\n";
+        return;
+    }
+    *AuthPacketData = AuthPacket.ReadBodyDef<FPCore::Net::PacketBodyDef_Authentication>();
 
     Connection& ReceptionConnection = Clients->ServerConnectionsSubsystem->ActiveConnections[AuthPacket.ConnectionID];
     
     // Run Authentication Process. Return result does not interest us as the Packet will contain the appropriate response data already.
-    Clients->ProcessAuthenticationRequest(ReceptionConnection, AuthPacketData);
+    Clients->ProcessAuthenticationRequest(ReceptionConnection, *AuthPacketData);
 
     // Send Auth Response back.
-    Clients->ServerConnectionsSubsystem->WriteOutgoingPacket(ReceptionConnection.ID, FPCore::Net::PacketBodyType::AUTHENTICATION, &AuthPacketData);
+    Clients->ServerConnectionsSubsystem->WriteOutgoingPacket(ReceptionConnection.ID, FPCore::Net::PacketBodyType::AUTHENTICATION, AuthPacketData);
+    Clients->ServerMemorySubsystem->PopFrameMemory(FrameMark);
 }
 
@@ -6,38 +6,51 @@
 
 #include "FPCore/Net/Packet/PacketBodyTypeFunctionDefs.h"
 
-ServerConnectionID_t GetAvailableConnectionID(Connection* ConnectionsBuffer, size_t ConnectionsBufferSize)
+size_t ConnectionsSubsystem::GetRequiredMemory(size_t MaxConnection, size_t WriteBufferSize)
 {
-    for(ServerConnectionID_t ServerConnectionID = 0; ServerConnectionID < ConnectionsBufferSize; ServerConnectionID++)
+    return MemorySubsystem::GetAllocationSize(MaxConnection * sizeof(Connection))
+        + 2 * MemorySubsystem::GetAllocationSize(MaxConnection * sizeof(ServerConnectionID_t))
+        + MemorySubsystem::GetAllocationSize(WriteBufferSize);
+}
+
+bool ConnectionsSubsystem::Initialize(MemorySubsystem& Memory, size_t MaxConnection, size_t WriteBufferSize, TimerWheel& ServerTimers)
+{
+    if (MaxConnection >= INVALID_CONNECTION_ID)
     {
-        if (ConnectionsBuffer[ServerConnectionID].PlatformConnectionID == ServerPlatform::INVALID_ID)
-        {
-            return ServerConnectionID;
-        }
+        std::cerr << "Error: Can't handle " << MaxConnection << " Connections, the maximum is " << INVALID_CONNECTION_ID - 1 << ".\n";
+        return false;
     }
 
-    return INVALID_CONNECTION_ID;
-}
+    Time = 0.0;
+    Timers = &ServerTimers;
 
-bool ConnectionsSubsystem::Initialize(MemorySubsystem& Memory, size_t MaxConnection)
-{
     // Allocate Connection buffer.
     MaxConnectionCount = MaxConnection;
     ActiveConnections = static_cast<Connection*>(Memory.Allocate(MaxConnectionCount * sizeof(Connection)));
+    FreeConnectionIDs = static_cast<ServerConnectionID_t*>(Memory.Allocate(MaxConnectionCount * sizeof(ServerConnectionID_t)));
+    PlatformConnectionMap = static_cast<ServerConnectionID_t*>(Memory.Allocate(MaxConnectionCount * sizeof(ServerConnectionID_t)));
+
+    if (nullptr == ActiveConnections || nullptr == FreeConnectionIDs || nullptr == PlatformConnectionMap)
+    {
+        return false;
+    }
+
     memset(ActiveConnections, 0, MaxConnectionCount * sizeof(Connection));
 
-    for(ServerConnectionID_t ServerConnectionID = 0; ServerConnectionID < MaxConnectionCount; ServerConnectionID++)
+    // IDs are stacked in reverse so the lowest ones get used first.
+    FreeConnectionIDCount = MaxConnectionCount;
+    for(size_t ServerConnectionID = 0; ServerConnectionID < MaxConnectionCount; ServerConnectionID++)
     {
         ActiveConnections[ServerConnectionID].PlatformConnectionID = ServerPlatform::INVALID_ID;
         ActiveConnections[ServerConnectionID].LinkedClient = nullptr;
-    }
-    
-    if (nullptr == ActiveConnections)
-    {
-        return false;
+        ActiveConnections[ServerConnectionID].AuthenticationTimeout = INVALID_TIMER_HANDLE;
+        ActiveConnections[ServerConnectionID].HeartbeatTimer = INVALID_TIMER_HANDLE;
+
+        FreeConnectionIDs[ServerConnectionID] = static_cast<ServerConnectionID_t>(MaxConnectionCount - 1 - ServerConnectionID);
+        PlatformConnectionMap[ServerConnectionID] = INVALID_CONNECTION_ID;
     }
 
-    PacketWriter.WriteBufferSize = 1024 * 64;
+    PacketWriter.WriteBufferSize = WriteBufferSize;
     PacketWriter.WriteBuffer = static_cast<byte*>(Memory.Allocate(PacketWriter.WriteBufferSize));
     PacketWriter.WrittenBytes = 0;
 
@@ -51,74 +64,76 @@ bool ConnectionsSubsystem::Initialize(MemorySubsystem& Memory, size_t MaxConnect
     return true;
 }
 
-void ConnectionsSubsystem::UpdateConnections(float UpdateDeltaTime)
+void ConnectionsSubsystem::UpdateConnections(double UpdateDeltaTime)
 {
-    for(ServerConnectionID_t ConnectionID = 0; ConnectionID < MaxConnectionCount; ConnectionID++)
-    {
-        if (ActiveConnections[ConnectionID].PlatformConnectionID == ServerPlatform::INVALID_ID)
-        {
-            continue;
-        }
+    Time += UpdateDeltaTime;
+}
 
-        ActiveConnections[ConnectionID].ConnectionUpTime += UpdateDeltaTime;
-    }
+double ConnectionsSubsystem::GetConnectionUpTime(const Connection& Conn) const
+{
+    return Time - Conn.RegistrationTime;
 }
 
 Connection* ConnectionsSubsystem::RegisterConnection(ServerPlatform::ConnectionID ConnectedSocketID)
 {
-    ServerConnectionID_t AvailableID = GetAvailableConnectionID(ActiveConnections, MaxConnectionCount);
-    if (AvailableID == INVALID_CONNECTION_ID)
+    if (FreeConnectionIDCount == 0 || ConnectedSocketID >= MaxConnectionCount)
     {
         return nullptr;
     }
 
+    ServerConnectionID_t AvailableID = FreeConnectionIDs[--FreeConnectionIDCount];
+    PlatformConnectionMap[ConnectedSocketID] = AvailableID;
+
     ActiveConnections[AvailableID].ID = AvailableID;
     ActiveConnections[AvailableID].PlatformConnectionID = ConnectedSocketID;
 
-    ActiveConnections[AvailableID].ConnectionUpTime = 0.f;
-    ActiveConnections[AvailableID].LastReceptionTime = 0.f;
+    ActiveConnections[AvailableID].RegistrationTime = Time;
+    ActiveConnections[AvailableID].AuthenticationTimeout = INVALID_TIMER_HANDLE;
+    ActiveConnections[AvailableID].HeartbeatTimer = INVALID_TIMER_HANDLE;
+    ActiveConnections[AvailableID].LastReceptionTime = Time;
 
     return &ActiveConnections[AvailableID];
 }
 
 void ConnectionsSubsystem::DeleteConnection(ServerConnectionID_t ConnectionID)
 {
-    if (ActiveConnections[ConnectionID].PlatformConnectionID == INVALID_CONNECTION_ID)
+    if (ConnectionID >= MaxConnectionCount
+        || ActiveConnections[ConnectionID].PlatformConnectionID == ServerPlatform::INVALID_ID)
     {
         return;
     }
-        
-    ActiveConnections[ConnectionID].PlatformConnectionID = INVALID_CONNECTION_ID;
+
+    PlatformConnectionMap[ActiveConnections[ConnectionID].PlatformConnectionID] = INVALID_CONNECTION_ID;
+    FreeConnectionIDs[FreeConnectionIDCount++] = ConnectionID;
+    Timers->Cancel(ActiveConnections[ConnectionID].AuthenticationTimeout);
+    Timers->Cancel(ActiveConnections[ConnectionID].HeartbeatTimer);
+
+    ActiveConnections[ConnectionID].PlatformConnectionID = ServerPlatform::INVALID_ID;
     ActiveConnections[ConnectionID].LinkedClient = nullptr;
 }
 
 void ConnectionsSubsystem::ConnectClient(ServerConnectionID_t ConnectionID, Client* ClientToConnect)
 {
     // Make sure Connection exists, and can be linked to a Client.
-    if (ConnectionID > MaxConnectionCount
-        || ActiveConnections[ConnectionID].PlatformConnectionID == INVALID_CONNECTION_ID
+    if (ConnectionID >= MaxConnectionCount
+        || ActiveConnections[ConnectionID].PlatformConnectionID == ServerPlatform::INVALID_ID
         || ActiveConnections[ConnectionID].LinkedClient != nullptr)
     {
         return;
     }
     
     ActiveConnections[ConnectionID].LinkedClient = ClientToConnect;
+    Timers->Cancel(ActiveConnections[ConnectionID].AuthenticationTimeout);
 }
 
 Connection* ConnectionsSubsystem::GetConnectionFromPlatformSocket(ServerPlatform::ConnectionID SocketID)
 {
-    // #TODO(Marc): This is a stupid way of finding the Connection linked to a Socket. Some sort of Map implementation
-    // could be helpful.
-
-    for (ServerConnectionID_t ServerConnectionID = 0; ServerConnectionID < MaxConnectionCount; ServerConnectionID++)
+    if (SocketID >= MaxConnectionCount || PlatformConnectionMap[SocketID] == INVALID_CONNECTION_ID)
     {
-        if (ActiveConnections[ServerConnectionID].PlatformConnectionID == SocketID)
-        {
-            return &ActiveConnections[ServerConnectionID];
-        }
+        return nullptr;
     }
 
-    return nullptr;
+    return &ActiveConnections[PlatformConnectionMap[SocketID]];
 }
 
 void ConnectionsSubsystem::HandleIncomingPacket(FPCore::Net::PacketHead& Packet)
@@ -130,14 +145,6 @@ void ConnectionsSubsystem::HandleIncomingPacket(FPCore::Net::PacketHead& Packet)
         return;
     }
 
-    // Check that this message type is handled.
-    if (PacketReceptionTable.PacketReceptionHandlers[Packet.BodyType].HandlerFunc == nullptr)
-    {
-        std::cerr << "Error when handling incoming packet: Packet Body Type " << static_cast<int>(Packet.BodyType)
-        << " is not handled !\n";
-        return;
-    }
-    
     // Resolve Socket ID to a Connection ID.
     Connection* InConnection = GetConnectionFromPlatformSocket(Packet.ConnectionID);
     if (nullptr == InConnection)
@@ -147,11 +154,21 @@ void ConnectionsSubsystem::HandleIncomingPacket(FPCore::Net::PacketHead& Packet)
         return;
     }
 
+    // Whatever the packet, the connection is alive.
+    InConnection->LastReceptionTime = Time;
+
+    // Check that this message type is handled.
+    if (PacketReceptionTable.PacketReceptionHandlers[Packet.BodyType].HandlerFunc == nullptr)
+    {
+        std::cerr << "Error when handling incoming packet: Packet Body Type " << static_cast<int>(Packet.BodyType)
+        << " is not handled !\n";
+        return;
+    }
+
     // Change the Packet's Connection ID to actual Connection ID (from being a Platform Socket ID).
     Packet.ConnectionID = InConnection->ID;
     
     // Handle Packet
-    // #TODO(Marc): Record time of reception into Connection data.
     PacketReceptionTable.HandlePacket(Packet);
 }
 
@@ -221,22 +238,33 @@ bool ConnectionsSubsystem::WriteOutgoingPacket(ServerConnectionID_t DestinationC
 size_t ConnectionsSubsystem::FlushSendingBufferToPlatformBuffer(byte* PlatformWriteBuffer,
                                                                 size_t PlatformWriteBufferSize)
 {
-    // Empty write buffer into Platform buffer securely (assuming that PlatformWriteBuffer is not null).
-    memcpy_s(PlatformWriteBuffer, PlatformWriteBufferSize, PacketWriter.WriteBuffer, PacketWriter.WrittenBytes);
-    size_t WrittenBytes = PlatformWriteBufferSize < PacketWriter.WrittenBytes ? PlatformWriteBufferSize : PacketWriter.WrittenBytes;
+    // Find out how many whole packets fit: the Platform expects every packet head to be followed by its entire body.
+    size_t WrittenBytes = 0;
+    while (WrittenBytes < PacketWriter.WrittenBytes)
+    {
+        const FPCore::Net::PacketHead& Packet = *reinterpret_cast<const FPCore::Net::PacketHead*>(PacketWriter.WriteBuffer + WrittenBytes);
+        size_t PacketSize = sizeof(FPCore::Net::PacketHead) + Packet.BodySize;
+        if (PacketSize > PlatformWriteBufferSize - WrittenBytes)
+        {
+            break;
+        }
+        WrittenBytes += PacketSize;
+    }
 
-    // If we couldn't write in the entire Packet Writer buffer this time around, shift the remaining data to the beginning of the
-    // buffer so it gets sent in priority next time.
-    if (WrittenBytes < PacketWriter.WrittenBytes)
+    // Empty write buffer into Platform buffer (assuming that PlatformWriteBuffer is not null).
+    if (WrittenBytes > 0)
     {
-        size_t BytesLeft = PacketWriter.WrittenBytes - WrittenBytes;
-        memcpy(PacketWriter.WriteBuffer, PacketWriter.WriteBuffer + PacketWriter.WrittenBytes - BytesLeft, BytesLeft);
-        PacketWriter.WrittenBytes = BytesLeft;
+        memcpy(PlatformWriteBuffer, PacketWriter.WriteBuffer, WrittenBytes);
     }
-    else
+
+    // If we couldn't write in the entire Packet Writer buffer this time around, shift the remaining data to the beginning of the
+    // buffer so it gets sent in priority next time.
+    size_t BytesLeft = PacketWriter.WrittenBytes - WrittenBytes;
+    if (BytesLeft > 0)
     {
-        PacketWriter.WrittenBytes = 0;
+        memmove(PacketWriter.WriteBuffer, PacketWriter.WriteBuffer + WrittenBytes, BytesLeft);
     }
+    PacketWriter.WrittenBytes = BytesLeft;
     
     return WrittenBytes;
 }
@@ -0,0 +1,136 @@
+#include "ServerFramework/Subsystems/Net/HeartbeatSubsystem.h"
+
+#include <iostream>
+
+#include "FPCore/Net/Packet/HeartbeatPackets.h"
+#include "ServerFramework/TimerWheel.h"
+#include "ServerFramework/Subsystems/Core/ConnectionsSubsystem.h"
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+#include "ServerFramework/Subsystems/Net/ClientsSubsystem.h"
+
+size_t HeartbeatSubsystem::GetRequiredMemory(size_t MaxConnection)
+{
+    return MemorySubsystem::GetAllocationSize(MaxConnection * sizeof(ConnectionHeartbeatState));
+}
+
+bool HeartbeatSubsystem::Initialize(MemorySubsystem& Memory, ConnectionsSubsystem& Connections, ClientsSubsystem& Clients,
+    TimerWheel& Timers, double Interval, double Timeout)
+{
+    if (Interval < 0.0 || (Interval > 0.0 && Timeout <= 0.0))
+    {
+        std::cerr << "Error: Invalid Heartbeat Interval (" << Interval << " s) or Idle Timeout (" << Timeout << " s).\n";
+        return false;
+    }
+
+    ServerConnectionsSubsystem = &Connections;
+    ServerTimers = &Timers;
+
+    HeartbeatInterval = Interval;
+    IdleTimeout = Timeout;
+
+    MaxConnectionCount = Connections.MaxConnectionCount;
+    HeartbeatStates = Memory.AllocateZeroed<ConnectionHeartbeatState>(MaxConnectionCount);
+
+    Connections.PacketReceptionTable.AssignHandler(FPCore::Net::PacketBodyType::HEARTBEAT, HandleHeartbeatPacket, this);
+    Clients.OnClientConnectedCallbackTable.RegisterCallback(OnClientConnected, this);
+
+    OnConnectionIdleCallbackTable = {0};
+
+    return HeartbeatStates != nullptr;
+}
+
+bool HeartbeatSubsystem::WatchConnection(Connection& WatchedConnection)
+{
+    if (HeartbeatInterval <= 0.0 || WatchedConnection.ID >= MaxConnectionCount)
+    {
+        return false;
+    }
+
+    ConnectionHeartbeatState& HeartbeatState = HeartbeatStates[WatchedConnection.ID];
+    HeartbeatState.LastPingSequence = 0;
+    HeartbeatState.LastPingTime = 0.0;
+    HeartbeatState.RoundTripTime = -1.f;
+
+    ServerTimers->Cancel(WatchedConnection.HeartbeatTimer);
+    WatchedConnection.HeartbeatTimer = ServerTimers->Schedule(HeartbeatInterval, OnHeartbeatTimer, this, WatchedConnection.ID);
+    if (!ServerTimers->IsPending(WatchedConnection.HeartbeatTimer))
+    {
+        std::cerr << "Error(HeartbeatSubsystem): Couldn't schedule the heartbeat of Connection ID " << WatchedConnection.ID << ": Out of timers.\n";
+        return false;
+    }
+
+    return true;
+}
+
+// Context = Heartbeat Subsystem, Payload = Server Connection ID
+void HeartbeatSubsystem::OnHeartbeatTimer(void* Context, uint64_t Payload)
+{
+    HeartbeatSubsystem& Heartbeat = *static_cast<HeartbeatSubsystem*>(Context);
+    ConnectionsSubsystem& Connections = *Heartbeat.ServerConnectionsSubsystem;
+
+    // The timer is cancelled when the Connection gets deleted, so it still is the one it was scheduled for.
+    Connection& WatchedConnection = Connections.ActiveConnections[Payload];
+    WatchedConnection.HeartbeatTimer = INVALID_TIMER_HANDLE;
+
+    double IdleTime = Connections.Time - WatchedConnection.LastReceptionTime;
+    if (IdleTime >= Heartbeat.IdleTimeout)
+    {
+        std::cout << "Connection ID " << WatchedConnection.ID << " hasn't sent anything for " << IdleTime << " s. Reporting it idle.\n";
+        Heartbeat.OnConnectionIdleCallbackTable.TriggerCallbacks(WatchedConnection);
+        return;
+    }
+
+    // Ping. A ping that doesn't fit in the Packet Writer is simply skipped, the next one may.
+    ConnectionHeartbeatState& HeartbeatState = Heartbeat.HeartbeatStates[WatchedConnection.ID];
+    FPCore::Net::PacketBodyDef_Heartbeat Ping = {};
+    Ping.Sequence = HeartbeatState.LastPingSequence + 1;
+    if (Connections.WriteOutgoingPacket(WatchedConnection.ID, FPCore::Net::PacketBodyType::HEARTBEAT, &Ping))
+    {
+        HeartbeatState.LastPingSequence = Ping.Sequence;
+        HeartbeatState.LastPingTime = Connections.Time;
+    }
+
+    // Come back for the next ping, or right when the Connection would become idle if that is sooner.
+    double NextTimerDelay = Heartbeat.IdleTimeout - IdleTime < Heartbeat.HeartbeatInterval ? Heartbeat.IdleTimeout - IdleTime : Heartbeat.HeartbeatInterval;
+    WatchedConnection.HeartbeatTimer = Heartbeat.ServerTimers->Schedule(NextTimerDelay, OnHeartbeatTimer, &Heartbeat, WatchedConnection.ID);
+    if (!Heartbeat.ServerTimers->IsPending(WatchedConnection.HeartbeatTimer))
+    {
+        std::cerr << "Error(HeartbeatSubsystem): Couldn't schedule the heartbeat of Connection ID " << WatchedConnection.ID << ": Out of timers.\n";
+    }
+}
+
+// Context = Heartbeat Subsystem
+void HeartbeatSubsystem::HandleHeartbeatPacket(FPCore::Net::PacketHead& Packet, void* Context)
+{
+    HeartbeatSubsystem& Heartbeat = *static_cast<HeartbeatSubsystem*>(Context);
+
+    if (Packet.BodySize != sizeof(FPCore::Net::PacketBodyDef_Heartbeat))
+    {
+        std::cerr << "Error: Received a malformed Heartbeat from Connection ID " << Packet.ConnectionID << ".\n";
+        return;
+    }
+
+    // Reception time is recorded by the Connections Subsystem for every packet: all there is left to do is measuring the
+    // round trip time, if this is the pong of the last ping.
+    FPCore::Net::PacketBodyDef_Heartbeat Pong;
+    memcpy(&Pong, Packet.BodyStart, sizeof(Pong));
+
+    ConnectionHeartbeatState& HeartbeatState = Heartbeat.HeartbeatStates[Packet.ConnectionID];
+    if (Pong.Sequence != 0 && Pong.Sequence == HeartbeatState.LastPingSequence)
+    {
+        HeartbeatState.RoundTripTime = static_cast<float>(Heartbeat.ServerConnectionsSubsystem->Time - HeartbeatState.LastPingTime);
+    }
+}
+
+void HeartbeatSubsystem::OnClientConnected(Client& ConnectedClient, void* Context)
+{
+    HeartbeatSubsystem& Heartbeat = *static_cast<HeartbeatSubsystem*>(Context);
+
+    if (nullptr == ConnectedClient.LinkedConnection)
+    {
+        std::cerr << "Error(HeartbeatSubsystem): Client ID " << ConnectedClient.ID << " connected without a Connection !\n";
+        return;
+    }
+
+    Heartbeat.WatchConnection(*ConnectedClient.LinkedConnection);
+}
@@ -2,81 +2,283 @@
 // Implementation of Heap Memory management on the server.
 
 #include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+#include <cstring>
 #include <iostream>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-bool MemorySubsystem::Initialize(void* MemStart, size_t MemSize)
+// Bit scanning helpers. Passed values must not be 0.
+
+static inline uint32_t FindFirstSetBit(uint64_t Value)
+{
+#ifdef _MSC_VER
+    unsigned long BitIndex;
+    _BitScanForward64(&BitIndex, Value);
+    return BitIndex;
+#else
+    return __builtin_ctzll(Value);
+#endif
+}
+
+static inline uint32_t FindLastSetBit(uint64_t Value)
+{
+#ifdef _MSC_VER
+    unsigned long BitIndex;
+    _BitScanReverse64(&BitIndex, Value);
+    return BitIndex;
+#else
+    return 63 - __builtin_clzll(Value);
+#endif
+}
+
+// Maps a block count to its First Level (row) and Second Level (column) within the size class table.
+// Counts below MEMORY_SECOND_LEVEL_COUNT are mapped linearly onto the first row.
+static inline void MapBlockCountToSizeClass(size_t BlockCount, uint32_t& OutFirstLevel, uint32_t& OutSecondLevel)
+{
+    if (BlockCount < MEMORY_SECOND_LEVEL_COUNT)
+    {
+        OutFirstLevel = 0;
+        OutSecondLevel = static_cast<uint32_t>(BlockCount);
+        return;
+    }
+
+    uint32_t HighestBit = FindLastSetBit(BlockCount);
+    OutFirstLevel = HighestBit - MEMORY_SECOND_LEVEL_LOG2 + 1;
+    OutSecondLevel = static_cast<uint32_t>(BlockCount >> (HighestBit - MEMORY_SECOND_LEVEL_LOG2)) - MEMORY_SECOND_LEVEL_COUNT;
+}
+
+// Sets the state and extent length tag of a block.
+static inline void TagBlock(MemorySubsystem::MemoryBlock& Block, MemorySubsystem::MEMORY_BLOCK_STATE State, size_t ExtentBlockCount)
+{
+    Block.State = State;
+    Block.ExtentBlockCount = static_cast<uint32_t>(ExtentBlockCount);
+}
+
+bool MemorySubsystem::Initialize(void* MemStart, size_t MemSize, bool bMemoryZeroed)
 {
     // Build block bookkeeping data at the start of memory.
-    MemoryBlockCount = MemSize / (MEMORY_BLOCK_SIZE + sizeof(MemoryBlock)); // Don't forget to take into account that memory bookkeeping data is also stored in memory !
+    // Don't forget to take into account that memory bookkeeping data is also stored in memory, aswell as the padding
+    // required to align usable memory on block boundaries !
+    if (MemSize <= MEMORY_BLOCK_SIZE)
+    {
+        return false;
+    }
+    MemoryBlockCount = (MemSize - MEMORY_BLOCK_SIZE) / (MEMORY_BLOCK_SIZE + sizeof(MemoryBlock));
+    if (MemoryBlockCount > MAX_EXTENT_BLOCK_COUNT)
+    {
+        std::cerr << "Warning: Memory Subsystem can only manage " << MAX_EXTENT_BLOCK_COUNT * MEMORY_BLOCK_SIZE << " bytes. The rest will go unused.\n";
+        MemoryBlockCount = MAX_EXTENT_BLOCK_COUNT;
+    }
     MemoryBlocks = static_cast<MemoryBlock*>(MemStart);
-    for (size_t MemoryBlockIndex = 0; MemoryBlockIndex < MemoryBlockCount; MemoryBlockIndex++)
+
+    // Zeroed out bookkeeping data already reads as untagged free blocks: only touch it if it may hold garbage.
+    if (!bMemoryZeroed)
+    {
+        for (size_t MemoryBlockIndex = 0; MemoryBlockIndex < MemoryBlockCount; MemoryBlockIndex++)
+        {
+            MemoryBlocks[MemoryBlockIndex] = MemoryBlock();
+        }
+    }
+
+    // Indicate where usable memory starts at (right after the bookkeeping data, aligned on a block boundary) and its actual size
+    uintptr_t BookkeepingEnd = reinterpret_cast<uintptr_t>(MemStart) + sizeof(MemoryBlock) * MemoryBlockCount;
+    uintptr_t AlignedStart = (BookkeepingEnd + MEMORY_BLOCK_SIZE - 1) / MEMORY_BLOCK_SIZE * MEMORY_BLOCK_SIZE;
+    MemoryStart = reinterpret_cast<uint8_t*>(AlignedStart);
+    MemorySize = MemoryBlockCount * MEMORY_BLOCK_SIZE;
+
+    // Initially, the whole heap is a single free extent.
+    for (size_t SizeClass = 0; SizeClass < MEMORY_SIZE_CLASS_COUNT; SizeClass++)
     {
-        MemoryBlocks[MemoryBlockIndex] = MemoryBlock();
+        FreeExtentLists[SizeClass] = INVALID_BLOCK_INDEX;
+    }
+    memset(SecondLevelBitmaps, 0, sizeof(SecondLevelBitmaps));
+    FirstLevelBitmap = 0;
+
+    if (MemoryBlockCount > 0)
+    {
+        InsertFreeExtent(0, MemoryBlockCount);
     }
 
-    // Indicate where usable memory starts at (right after the bookkeeping data) and its actual size
-    MemoryStart = static_cast<uint8_t*>(MemStart) + sizeof(MemoryBlock) * MemoryBlockCount;
-    MemorySize = MemSize - sizeof(MemoryBlock) * MemoryBlockCount;
-    
     return MemoryBlockCount > 0;
 }
 
+size_t MemorySubsystem::GetAllocationSize(size_t Size)
+{
+    return (Size + MEMORY_BLOCK_SIZE - 1) / MEMORY_BLOCK_SIZE * MEMORY_BLOCK_SIZE;
+}
+
+size_t MemorySubsystem::GetRequiredHeapSize(size_t AllocatedSize)
+{
+    // Mirrors the block count computation in Initialize: one block worth of alignment padding, then one bookkeeping
+    // entry per block.
+    size_t BlockCount = GetAllocationSize(AllocatedSize) / MEMORY_BLOCK_SIZE;
+    return MEMORY_BLOCK_SIZE + BlockCount * (MEMORY_BLOCK_SIZE + sizeof(MemoryBlock));
+}
+
 void MemorySubsystem::FreeServerHeap()
 {
-    memset(MemoryStart, 0, MemorySize);
-    memset(MemoryBlocks, 0, MemoryBlockCount * sizeof(MemoryBlock));
+    FrameArena = {};
+
+    // Heap memory is owned by the Platform, which releases it on exit: there is no need to clear it here.
+    // Allocate zeroes out memory when handing it out instead.
+    MemoryBlocks = nullptr;
     MemoryBlockCount = 0;
+    MemoryStart = nullptr;
+    MemorySize = 0;
+
+    FirstLevelBitmap = 0;
+    memset(SecondLevelBitmaps, 0, sizeof(SecondLevelBitmaps));
 }
 
-void* MemorySubsystem::Allocate(size_t Size)
+MemorySubsystem::FreeExtent& MemorySubsystem::GetFreeExtent(size_t FirstBlockIndex)
 {
-    size_t RequiredBlockCount = Size / MEMORY_BLOCK_SIZE + (Size == MEMORY_BLOCK_SIZE ? 0 : 1);
+    return *reinterpret_cast<FreeExtent*>(MemoryStart + FirstBlockIndex * MEMORY_BLOCK_SIZE);
+}
+
+void MemorySubsystem::InsertFreeExtent(size_t FirstBlockIndex, size_t BlockCount)
+{
+    uint32_t FirstLevel, SecondLevel;
+    MapBlockCountToSizeClass(BlockCount, FirstLevel, SecondLevel);
+    size_t& ListHead = FreeExtentLists[FirstLevel * MEMORY_SECOND_LEVEL_COUNT + SecondLevel];
+
+    // Tag both ends of the extent so that it can be found from either of its neighbours.
+    TagBlock(MemoryBlocks[FirstBlockIndex], MEMORY_BLOCK_STATE::FREE, BlockCount);
+    TagBlock(MemoryBlocks[FirstBlockIndex + BlockCount - 1], MEMORY_BLOCK_STATE::FREE, BlockCount);
 
-    size_t BlockIndex;
-    // #TODO: Add extra layer of bookkeeping to more easily find "blocks of blocks" of a certain contiguous size.
-    for(BlockIndex = 0; BlockIndex < MemoryBlockCount; BlockIndex++)
+    // Push the extent at the front of its size class list.
+    FreeExtent& Extent = GetFreeExtent(FirstBlockIndex);
+    Extent.PreviousFreeExtent = INVALID_BLOCK_INDEX;
+    Extent.NextFreeExtent = ListHead;
+    if (ListHead != INVALID_BLOCK_INDEX)
     {
-        size_t LookAheadIndex = 0;
-        while(BlockIndex + LookAheadIndex < MemoryBlockCount && MemoryBlocks[BlockIndex + LookAheadIndex].State == MEMORY_BLOCK_STATE::FREE
-            && LookAheadIndex < RequiredBlockCount)
-        {
-            LookAheadIndex++;
-        }
+        GetFreeExtent(ListHead).PreviousFreeExtent = FirstBlockIndex;
+    }
+    ListHead = FirstBlockIndex;
 
-        if (LookAheadIndex == RequiredBlockCount)
-        {
-            break;
-        }
+    FirstLevelBitmap |= 1ull << FirstLevel;
+    SecondLevelBitmaps[FirstLevel] |= static_cast<uint16_t>(1u << SecondLevel);
+}
+
+void MemorySubsystem::RemoveFreeExtent(size_t FirstBlockIndex)
+{
+    FreeExtent& Extent = GetFreeExtent(FirstBlockIndex);
+
+    uint32_t FirstLevel, SecondLevel;
+    MapBlockCountToSizeClass(MemoryBlocks[FirstBlockIndex].ExtentBlockCount, FirstLevel, SecondLevel);
+    size_t& ListHead = FreeExtentLists[FirstLevel * MEMORY_SECOND_LEVEL_COUNT + SecondLevel];
+
+    if (Extent.PreviousFreeExtent != INVALID_BLOCK_INDEX)
+    {
+        GetFreeExtent(Extent.PreviousFreeExtent).NextFreeExtent = Extent.NextFreeExtent;
+    }
+    else
+    {
+        ListHead = Extent.NextFreeExtent;
     }
 
-    if (BlockIndex < MemoryBlockCount)
+    if (Extent.NextFreeExtent != INVALID_BLOCK_INDEX)
     {
-        uint8_t* AllocatableMemoryStart = MemoryStart + BlockIndex * MEMORY_BLOCK_SIZE;
-        
-        // Allocate First Block
-        MemoryBlocks[BlockIndex].State = MEMORY_BLOCK_STATE::ALLOCATED;
+        GetFreeExtent(Extent.NextFreeExtent).PreviousFreeExtent = Extent.PreviousFreeExtent;
+    }
 
-        // Allocate Extra blocks if needed
-        for(size_t ExtraBlockIndex = BlockIndex + 1; ExtraBlockIndex < BlockIndex + RequiredBlockCount; ExtraBlockIndex++)
+    // Clear bitmap bits of emptied lists.
+    if (ListHead == INVALID_BLOCK_INDEX)
+    {
+        SecondLevelBitmaps[FirstLevel] &= static_cast<uint16_t>(~(1u << SecondLevel));
+        if (SecondLevelBitmaps[FirstLevel] == 0)
         {
-            MemoryBlocks[ExtraBlockIndex].State = MEMORY_BLOCK_STATE::ALLOCATED_EXTRA;
+            FirstLevelBitmap &= ~(1ull << FirstLevel);
         }
+    }
+}
 
-        // Zero out allocated memory
-        memset(AllocatableMemoryStart, 0, MEMORY_BLOCK_SIZE * RequiredBlockCount);
-        
-        return AllocatableMemoryStart;
+size_t MemorySubsystem::FindFreeExtent(size_t BlockCount)
+{
+    // Round the requested count up to the next size class boundary, so that any extent found in the resulting class or above
+    // is guaranteed to be large enough.
+    size_t RoundedBlockCount = BlockCount;
+    if (BlockCount >= MEMORY_SECOND_LEVEL_COUNT)
+    {
+        RoundedBlockCount += (static_cast<size_t>(1) << (FindLastSetBit(BlockCount) - MEMORY_SECOND_LEVEL_LOG2)) - 1;
     }
 
-    std::cerr << "Memory allocation failed ! Requested bytes = " << Size << "\n";
-    return nullptr;
+    uint32_t FirstLevel, SecondLevel;
+    MapBlockCountToSizeClass(RoundedBlockCount, FirstLevel, SecondLevel);
+
+    // Look for a non-empty list within the same first level first, then within any greater first level.
+    uint32_t SecondLevelMap = SecondLevelBitmaps[FirstLevel] & (~0u << SecondLevel);
+    uint64_t FirstLevelMap = FirstLevel + 1 < MEMORY_FIRST_LEVEL_COUNT ? FirstLevelBitmap & (~0ull << (FirstLevel + 1)) : 0;
+    if (SecondLevelMap == 0 && FirstLevelMap != 0)
+    {
+        FirstLevel = FindFirstSetBit(FirstLevelMap);
+        SecondLevelMap = SecondLevelBitmaps[FirstLevel];
+    }
+
+    if (SecondLevelMap != 0)
+    {
+        SecondLevel = FindFirstSetBit(SecondLevelMap);
+        return FreeExtentLists[FirstLevel * MEMORY_SECOND_LEVEL_COUNT + SecondLevel];
+    }
+
+    // Nothing is guaranteed to fit. Extents of the requested count's own size class may still be large enough, which matters
+    // when the heap is close to being exhausted.
+    MapBlockCountToSizeClass(BlockCount, FirstLevel, SecondLevel);
+    size_t ExtentIndex = FreeExtentLists[FirstLevel * MEMORY_SECOND_LEVEL_COUNT + SecondLevel];
+    while (ExtentIndex != INVALID_BLOCK_INDEX && MemoryBlocks[ExtentIndex].ExtentBlockCount < BlockCount)
+    {
+        ExtentIndex = GetFreeExtent(ExtentIndex).NextFreeExtent;
+    }
+
+    return ExtentIndex;
+}
+
+void* MemorySubsystem::Allocate(size_t Size)
+{
+    size_t RequiredBlockCount = Size == 0 ? 1 : (Size + MEMORY_BLOCK_SIZE - 1) / MEMORY_BLOCK_SIZE;
+    if (RequiredBlockCount > MAX_EXTENT_BLOCK_COUNT)
+    {
+        std::cerr << "Memory allocation failed ! Requested bytes = " << Size << "\n";
+        return nullptr;
+    }
+
+    size_t BlockIndex = FindFreeExtent(RequiredBlockCount);
+    if (BlockIndex == INVALID_BLOCK_INDEX)
+    {
+        std::cerr << "Memory allocation failed ! Requested bytes = " << Size << "\n";
+        return nullptr;
+    }
+
+    // Take the extent out of the index, giving any unused blocks back to it.
+    size_t ExtentBlockCount = MemoryBlocks[BlockIndex].ExtentBlockCount;
+    RemoveFreeExtent(BlockIndex);
+    if (ExtentBlockCount > RequiredBlockCount)
+    {
+        InsertFreeExtent(BlockIndex + RequiredBlockCount, ExtentBlockCount - RequiredBlockCount);
+    }
+
+    uint8_t* AllocatableMemoryStart = MemoryStart + BlockIndex * MEMORY_BLOCK_SIZE;
+
+    // Allocate First Block, recording the length of the allocation so it can be freed without looking at other blocks.
+    TagBlock(MemoryBlocks[BlockIndex], MEMORY_BLOCK_STATE::ALLOCATED, RequiredBlockCount);
+
+    // Allocate Extra blocks if needed
+    for(size_t ExtraBlockIndex = BlockIndex + 1; ExtraBlockIndex < BlockIndex + RequiredBlockCount; ExtraBlockIndex++)
+    {
+        TagBlock(MemoryBlocks[ExtraBlockIndex], MEMORY_BLOCK_STATE::ALLOCATED_EXTRA, 0);
+    }
+
+    // Zero out allocated memory
+    memset(AllocatableMemoryStart, 0, MEMORY_BLOCK_SIZE * RequiredBlockCount);
+
+    return AllocatableMemoryStart;
 }
 
 void MemorySubsystem::Free(void* AllocatedAddress)
 {
     intptr_t AddressOffset = reinterpret_cast<intptr_t>(AllocatedAddress) - reinterpret_cast<intptr_t>(MemoryStart);
-    if (AddressOffset < 0 || static_cast<size_t>(AddressOffset) > MemorySize && AddressOffset % MEMORY_BLOCK_SIZE != 0)
+    if (AddressOffset < 0 || static_cast<size_t>(AddressOffset) >= MemorySize || AddressOffset % MEMORY_BLOCK_SIZE != 0)
     {
         std::cerr << "Failed to free memory: Passed Address is invalid.\n";
         return;
@@ -84,14 +286,86 @@ void MemorySubsystem::Free(void* AllocatedAddress)
 
     // Get Block Index from the address offset. The previous checks should guarantee that it lands on a valid value.
     size_t BlockIndex = AddressOffset / MEMORY_BLOCK_SIZE;
+    if (MemoryBlocks[BlockIndex].State != MEMORY_BLOCK_STATE::ALLOCATED)
+    {
+        std::cerr << "Failed to free memory: Passed Address is not the start of an allocation.\n";
+        return;
+    }
 
-    // Free start block then start freeing subsequent "Extra" blocks that must have been part of the same allocation.
-    MemoryBlocks[BlockIndex].State = MEMORY_BLOCK_STATE::FREE;
-    for(size_t ExtraBlockIndex = BlockIndex + 1; ExtraBlockIndex < MemoryBlockCount; ExtraBlockIndex++)
+    // Free start block and the "Extra" blocks of the same allocation, whose count was recorded on the start block.
+    size_t FreedBlockCount = MemoryBlocks[BlockIndex].ExtentBlockCount;
+    for (size_t FreedBlockIndex = BlockIndex; FreedBlockIndex < BlockIndex + FreedBlockCount; FreedBlockIndex++)
     {
-        if (MemoryBlocks[ExtraBlockIndex].State == MEMORY_BLOCK_STATE::ALLOCATED_EXTRA)
-        {
-            MemoryBlocks[ExtraBlockIndex].State = MEMORY_BLOCK_STATE::FREE;
-        }
+        TagBlock(MemoryBlocks[FreedBlockIndex], MEMORY_BLOCK_STATE::FREE, 0);
+    }
+
+    // Coalesce with the free extents directly following and preceding the freed blocks, if any. Their lengths are tagged
+    // on the blocks bordering the freed blocks.
+    size_t NextBlockIndex = BlockIndex + FreedBlockCount;
+    if (NextBlockIndex < MemoryBlockCount && MemoryBlocks[NextBlockIndex].State == MEMORY_BLOCK_STATE::FREE)
+    {
+        size_t NextExtentBlockCount = MemoryBlocks[NextBlockIndex].ExtentBlockCount;
+        RemoveFreeExtent(NextBlockIndex);
+        FreedBlockCount += NextExtentBlockCount;
     }
+
+    if (BlockIndex > 0 && MemoryBlocks[BlockIndex - 1].State == MEMORY_BLOCK_STATE::FREE)
+    {
+        size_t PreviousExtentIndex = BlockIndex - MemoryBlocks[BlockIndex - 1].ExtentBlockCount;
+        size_t PreviousExtentBlockCount = MemoryBlocks[PreviousExtentIndex].ExtentBlockCount;
+        RemoveFreeExtent(PreviousExtentIndex);
+        FreedBlockCount += PreviousExtentBlockCount;
+        BlockIndex = PreviousExtentIndex;
+    }
+
+    InsertFreeExtent(BlockIndex, FreedBlockCount);
+}
+
+bool MemorySubsystem::InitializeFrameArena(size_t Size)
+{
+    FrameArena.Start = static_cast<uint8_t*>(Allocate(Size));
+    FrameArena.Size = nullptr == FrameArena.Start ? 0 : Size;
+    FrameArena.UsedBytes = 0;
+    FrameArena.HighWaterMark = 0;
+
+    return nullptr != FrameArena.Start;
+}
+
+void MemorySubsystem::ResetFrameArena()
+{
+    FrameArena.UsedBytes = 0;
+}
+
+void MemorySubsystem::PopFrameMemory(size_t Mark)
+{
+    if (Mark <= FrameArena.UsedBytes)
+    {
+        FrameArena.UsedBytes = Mark;
+    }
+}
+
+void* MemorySubsystem::PushFrameMemory(size_t Size, size_t Alignment)
+{
+    uintptr_t ArenaStart = reinterpret_cast<uintptr_t>(FrameArena.Start);
+    uintptr_t PushAddress = (ArenaStart + FrameArena.UsedBytes + Alignment - 1) / Alignment * Alignment;
+    size_t NewUsedBytes = PushAddress - ArenaStart + Size;
+
+    if (nullptr == FrameArena.Start || NewUsedBytes > FrameArena.Size)
+    {
+        std::cerr << "Frame Arena push failed ! Requested bytes = " << Size << ", Used bytes = " << FrameArena.UsedBytes
+        << " / " << FrameArena.Size << "\n";
+        return nullptr;
+    }
+
+    FrameArena.UsedBytes = NewUsedBytes;
+    if (FrameArena.UsedBytes > FrameArena.HighWaterMark)
+    {
+        FrameArena.HighWaterMark = FrameArena.UsedBytes;
+    }
+
+    // Memory is reused every Update, zero it out.
+    void* PushedMemory = reinterpret_cast<void*>(PushAddress);
+    memset(PushedMemory, 0, Size);
+
+    return PushedMemory;
 }
@@ -1,27 +1,79 @@
 #include "ServerFramework/Subsystems/Core/WorldSubsystem.h"
 #include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
 
-#include <cstdlib>
-#include <ctime>
 #include <iostream>
 
+#include "ServerFramework/CounterRandom.h"
+#include "ServerFramework/JobSystem.h"
 #include "ServerFramework/Subsystems/Net/ClientsSubsystem.h"
 
-bool WorldSubsystem::Initialize(MemorySubsystem& Memory)
+// Terrain Noise settings of every Island: features span up to 128 tiles (3.2 km), down to details of 4 tiles (100 m).
+static constexpr uint32_t TERRAIN_CELL_SIZE_SHIFT = 7;
+static constexpr uint32_t TERRAIN_OCTAVE_COUNT = 6;
+static constexpr float TERRAIN_VOID_THRESHOLD = -0.25f;
+
+// Zones OpenZones generates in parallel at once. Tasks live on the stack, so that opening zones needs no memory of its own.
+static constexpr size_t OPEN_ZONES_BATCH_SIZE = 64;
+
+// Identifies an Island slot in World random draws.
+static uint32_t GetIslandRandomID(FPCore::World::ClusterID ClusterID, FPCore::World::IslandID IslandID)
+{
+    return static_cast<uint32_t>(ClusterID << 16 | IslandID);
+}
+
+// Tiles of a zone being opened, to be generated by a job.
+struct ZoneGenerationTask
+{
+    const Cluster::Island* Island;
+    FPCore::World::Coordinates ZoneCoords;
+    ZoneTiles* Tiles;
+};
+
+bool WorldSubsystem::Initialize(MemorySubsystem& Memory, int IslandSlotCount, uint64_t Seed, JobSystem& ServerJobs, TimerWheel& ServerTimers,
+    size_t MaxResidentZones, double ZoneIdleTimeoutSeconds)
 {
-    // Create a single Cluster with 16 Island slots.
+    if (MaxResidentZones == 0 || ZoneIdleTimeoutSeconds < 0.0)
+    {
+        std::cerr << "Error: Invalid Max Resident Zone Count (" << MaxResidentZones << ") or Zone Idle Timeout (" << ZoneIdleTimeoutSeconds << " s).\n";
+        return false;
+    }
+
+    WorldSeed = Seed;
+    LinkedMemory = &Memory;
+    Jobs = &ServerJobs;
+    Timers = &ServerTimers;
+
+    // Create a single Cluster with the requested number of Island slots.
     IslandClusters[0].ID = 0;
-    IslandClusters[0].Islands = Memory.AllocateAndInit<Cluster::Island>(16);
-    IslandClusters[0].IslandSlotCount = 16;
+    IslandClusters[0].Islands = Memory.AllocateAndInit<Cluster::Island>(IslandSlotCount);
+    IslandClusters[0].IslandSlotCount = IslandSlotCount;
 
-    return true;
+    // Tiles themselves are only allocated as zones get touched.
+    ResidentZones = Memory.AllocateZeroed<ResidentZone>(MaxResidentZones);
+    ResidentZoneCount = 0;
+    MaxResidentZoneCount = MaxResidentZones;
+    ZoneIdleTimeout = ZoneIdleTimeoutSeconds;
+
+    return IslandClusters[0].Islands != nullptr && ResidentZones != nullptr;
 }
 
-bool WorldSubsystem::GenerateIsland(MemorySubsystem& Memory, IslandGenerationInfo& GenInfo)
+size_t WorldSubsystem::GetRequiredMemory(int IslandSlotCount, size_t MaxResidentZones)
 {
-    // Prime Randomizer (TODO: Find a proper random library)
-    srand(time(NULL));
+    return MemorySubsystem::GetAllocationSize(IslandSlotCount * sizeof(Cluster::Island))
+        + MemorySubsystem::GetAllocationSize(MaxResidentZones * sizeof(ResidentZone))
+        + MaxResidentZones * MemorySubsystem::GetAllocationSize(sizeof(ZoneTiles));
+}
+
+size_t WorldSubsystem::GetRequiredIslandMemory(Vec2<uint16_t> BoundsSize)
+{
+    // Matches the allocations made by GenerateIsland.
+    size_t ZoneCount = static_cast<size_t>(BoundsSize.X) * BoundsSize.Y;
+    return MemorySubsystem::GetAllocationSize(ZoneCount * sizeof(FPCore::World::ZoneDef))
+        + MemorySubsystem::GetAllocationSize(ZoneCount * sizeof(ZoneResidency));
+}
 
+bool WorldSubsystem::GenerateIsland(MemorySubsystem& Memory, IslandGenerationInfo& GenInfo)
+{
     // Find available spot for a new Island among the existing Clusters.
     bool SpotFound = false;
 
@@ -76,7 +128,9 @@ bool WorldSubsystem::GenerateIsland(MemorySubsystem& Memory, IslandGenerationInf
     NewIsland.bActive = true;
     NewIsland.ID = GenInfo.ID;
     NewIsland.ClusterID = ChosenCluster.ID;
-    NewIsland.Position = { static_cast<unsigned short>(rand() % 2000), static_cast<unsigned short>(rand() % 2000) };
+    RandomKey PlacementKey = { WorldSeed, GetIslandRandomID(NewIsland.ClusterID, NewIsland.ID), 0, 0, RandomPurpose::ISLAND_PLACEMENT };
+    NewIsland.Position = { static_cast<uint16_t>(CounterRandom::GetRange(PlacementKey, 0, 0, 1999)),
+        static_cast<uint16_t>(CounterRandom::GetRange(PlacementKey, 1, 0, 1999)) };
     NewIsland.Bounds = GenInfo.BoundsSize;
 
     // Allocate zones
@@ -84,46 +138,222 @@ bool WorldSubsystem::GenerateIsland(MemorySubsystem& Memory, IslandGenerationInf
     NewIsland.Zones = Memory.AllocateZeroed<FPCore::World::ZoneDef>(GenInfo.BoundsSize.X * GenInfo.BoundsSize.Y);
     NewIsland.ZoneCount = GenInfo.BoundsSize.X * GenInfo.BoundsSize.Y;
 
-    // Allocate tiles (TODO: We shouldn't be allocating this much memory at once. Generation should be handled zone by zone, on demand).
-    NewIsland.VoidTileBitmask = Memory.AllocateZeroed<byte>(GenInfo.BoundsSize.X * GenInfo.BoundsSize.Y * FPCore::World::TILES_PER_ZONE / 8);
-    NewIsland.TileCenterElevations = Memory.AllocateZeroed<uint16_t>(GenInfo.BoundsSize.X * GenInfo.BoundsSize.Y * FPCore::World::TILES_PER_ZONE);
+    // Tiles are only allocated and generated once their zone gets touched, see TouchZone.
+    NewIsland.ZoneResidencies = Memory.AllocateZeroed<ZoneResidency>(NewIsland.ZoneCount);
 
-    // Generate zone 0,0 at random TODO: Zone generation should only work if the zone is "opened" by founding a site or a mission takes place there.
-    NewIsland.RandomGenSeed = time(nullptr);
-    srand(NewIsland.RandomGenSeed);
+    if (nullptr == NewIsland.Zones || nullptr == NewIsland.ZoneResidencies)
+    {
+        return false;
+    }
+
+    RandomKey SeedKey = { WorldSeed, GetIslandRandomID(NewIsland.ClusterID, NewIsland.ID), 0, 0, RandomPurpose::ISLAND_SEED };
+    NewIsland.RandomGenSeed = GenInfo.RandomGenSeed != 0 ? GenInfo.RandomGenSeed : static_cast<int64_t>(CounterRandom::GetBits64(SeedKey));
+
+    // Everything within the Island is drawn from its own seed alone.
+    uint32_t TerrainSeed = CounterRandom::GetBits32({ static_cast<uint64_t>(NewIsland.RandomGenSeed), 0, 0, 0, RandomPurpose::TERRAIN_NOISE });
+    if (!NewIsland.Terrain.Initialize(TerrainSeed, TERRAIN_CELL_SIZE_SHIFT, TERRAIN_OCTAVE_COUNT, TERRAIN_VOID_THRESHOLD))
+    {
+        return false;
+    }
 
-    // This should definitely get multithreaded
     FPCore::World::Coordinates ZoneCoords = { 0, 0 };
     for (ZoneCoords.X = 0; ZoneCoords.X < NewIsland.Bounds.X; ZoneCoords.X++)
     {
         for (ZoneCoords.Y = 0; ZoneCoords.Y < NewIsland.Bounds.Y; ZoneCoords.Y++)
         {
-            size_t ZoneStartBitIndex = (ZoneCoords.X * NewIsland.Bounds.Y + ZoneCoords.Y) * FPCore::World::TILES_PER_ZONE;
-
-            FPCore::World::Coordinates TileCoords = { 0, 0 };
-            for (TileCoords.X = 0; TileCoords.X < FPCore::World::ZONE_SIZE_TILES; TileCoords.X++)
-            {
-                for (TileCoords.Y = 0; TileCoords.Y < FPCore::World::ZONE_SIZE_TILES; TileCoords.Y++)
-                {
-                    float Epicness = 1.f;
-                    if (Epicness > 0.f)
-                    {
-                        size_t BitIndex = ZoneStartBitIndex + TileCoords.X * FPCore::World::ZONE_SIZE_TILES + TileCoords.Y;
-                        NewIsland.VoidTileBitmask[BitIndex / 8] += 1 << (BitIndex % 8);
-                    }
-                }
-            }
+            NewIsland.ZoneResidencies[ZoneCoords.X * NewIsland.Bounds.Y + ZoneCoords.Y].EvictionTimer = INVALID_TIMER_HANDLE;
+            GenerateZoneDef(NewIsland, ZoneCoords);
         }
     }
-    
 
     // Update Gen Info data
     GenInfo.ZoneCount = NewIsland.ZoneCount;
     GenInfo.BoundsSize = NewIsland.Bounds;
+    GenInfo.RandomGenSeed = NewIsland.RandomGenSeed;
+
+    return true;
+}
+
+ZoneTiles* WorldSubsystem::TouchZone(Cluster::Island& Island, FPCore::World::Coordinates ZoneCoords)
+{
+    if (!OpenZones(Island, &ZoneCoords, 1))
+    {
+        return nullptr;
+    }
+
+    return Island.ZoneResidencies[ZoneCoords.X * Island.Bounds.Y + ZoneCoords.Y].Tiles;
+}
+
+bool WorldSubsystem::OpenZones(Cluster::Island& Island, const FPCore::World::Coordinates* ZoneCoords, size_t ZoneCount)
+{
+    // Touch every zone first, resident or not, so that none of them gets evicted to make room for the others.
+    double Now = Timers->GetTime();
+    bool bEveryZoneResident = true;
+    for (size_t ZoneIndex = 0; ZoneIndex < ZoneCount; ZoneIndex++)
+    {
+        if (ZoneCoords[ZoneIndex].X >= Island.Bounds.X || ZoneCoords[ZoneIndex].Y >= Island.Bounds.Y)
+        {
+            return false;
+        }
+
+        ZoneResidency& Residency = Island.ZoneResidencies[ZoneCoords[ZoneIndex].X * Island.Bounds.Y + ZoneCoords[ZoneIndex].Y];
+        Residency.LastTouchTime = Now;
+        bEveryZoneResident = bEveryZoneResident && nullptr != Residency.Tiles;
+    }
+
+    if (bEveryZoneResident)
+    {
+        return true;
+    }
+
+    // Allocate the tiles of every missing zone from here, then generate them in parallel, a batch at a time.
+    ZoneGenerationTask Tasks[OPEN_ZONES_BATCH_SIZE];
+    size_t TaskCount = 0;
+    for (size_t ZoneIndex = 0; ZoneIndex < ZoneCount; ZoneIndex++)
+    {
+        uint32_t IslandZoneIndex = ZoneCoords[ZoneIndex].X * Island.Bounds.Y + ZoneCoords[ZoneIndex].Y;
+        ZoneResidency& Residency = Island.ZoneResidencies[IslandZoneIndex];
+        if (nullptr != Residency.Tiles)
+        {
+            // Already resident, or passed more than once and allocated on its first occurrence.
+            continue;
+        }
+
+        if (ResidentZoneCount == MaxResidentZoneCount && !EvictLeastRecentlyTouchedZone(Now))
+        {
+            std::cerr << "Error(WorldSubsystem): Couldn't open zone " << ZoneCoords[ZoneIndex].X << ", " << ZoneCoords[ZoneIndex].Y
+                << ": Every one of the " << MaxResidentZoneCount << " resident zones is in use.\n";
+            break;
+        }
+
+        Residency.Tiles = LinkedMemory->AllocateZeroed<ZoneTiles>();
+        if (nullptr == Residency.Tiles)
+        {
+            break;
+        }
+
+        Residency.ResidentSlot = static_cast<uint32_t>(ResidentZoneCount);
+        ResidentZones[ResidentZoneCount++] = { &Island, IslandZoneIndex };
 
+        // Without a timer, the zone only gets evicted when room is needed for others.
+        if (ZoneIdleTimeout > 0.0)
+        {
+            uint64_t Payload = static_cast<uint64_t>(Island.ClusterID) << 48 | static_cast<uint64_t>(Island.ID) << 32 | IslandZoneIndex;
+            Residency.EvictionTimer = Timers->Schedule(ZoneIdleTimeout, OnZoneEvictionTimer, this, Payload);
+        }
+
+        Tasks[TaskCount++] = { &Island, ZoneCoords[ZoneIndex], Residency.Tiles };
+        if (TaskCount == OPEN_ZONES_BATCH_SIZE)
+        {
+            Jobs->Wait(Jobs->Schedule(GenerateZoneTiles_Job, Tasks, TaskCount));
+            TaskCount = 0;
+        }
+    }
+
+    Jobs->Wait(Jobs->Schedule(GenerateZoneTiles_Job, Tasks, TaskCount));
+
+    for (size_t ZoneIndex = 0; ZoneIndex < ZoneCount; ZoneIndex++)
+    {
+        if (nullptr == Island.ZoneResidencies[ZoneCoords[ZoneIndex].X * Island.Bounds.Y + ZoneCoords[ZoneIndex].Y].Tiles)
+        {
+            return false;
+        }
+    }
     return true;
 }
 
+bool WorldSubsystem::EvictLeastRecentlyTouchedZone(double TouchTime)
+{
+    size_t EvictedSlot = ResidentZoneCount;
+    for (size_t ResidentSlot = 0; ResidentSlot < ResidentZoneCount; ResidentSlot++)
+    {
+        const ResidentZone& Zone = ResidentZones[ResidentSlot];
+        double LastTouchTime = Zone.Island->ZoneResidencies[Zone.ZoneIndex].LastTouchTime;
+        if (LastTouchTime < TouchTime)
+        {
+            EvictedSlot = ResidentSlot;
+            TouchTime = LastTouchTime;
+        }
+    }
+
+    if (EvictedSlot == ResidentZoneCount)
+    {
+        return false;
+    }
+
+    EvictZone(*ResidentZones[EvictedSlot].Island, ResidentZones[EvictedSlot].ZoneIndex);
+    return true;
+}
+
+void WorldSubsystem::EvictZone(Cluster::Island& Island, uint32_t ZoneIndex)
+{
+    ZoneResidency& Residency = Island.ZoneResidencies[ZoneIndex];
+    if (nullptr == Residency.Tiles)
+    {
+        return;
+    }
+
+    Timers->Cancel(Residency.EvictionTimer);
+    LinkedMemory->Free(Residency.Tiles);
+    Residency.Tiles = nullptr;
+
+    // Move the last resident zone into the freed slot.
+    ResidentZone& LastZone = ResidentZones[--ResidentZoneCount];
+    LastZone.Island->ZoneResidencies[LastZone.ZoneIndex].ResidentSlot = Residency.ResidentSlot;
+    ResidentZones[Residency.ResidentSlot] = LastZone;
+}
+
+void WorldSubsystem::GenerateZoneDef(Cluster::Island& Island, FPCore::World::Coordinates ZoneCoords)
+{
+    RandomKey ZoneKey = { static_cast<uint64_t>(Island.RandomGenSeed), 0, static_cast<uint32_t>(ZoneCoords.X) << 16 | ZoneCoords.Y, 0,
+        RandomPurpose::ZONE_DEFINITION };
+
+    FPCore::World::ZoneDef& Zone = Island.Zones[ZoneCoords.X * Island.Bounds.Y + ZoneCoords.Y];
+    Zone.MinimumElevation = static_cast<uint16_t>(CounterRandom::GetRange(ZoneKey, 0, 0, 2000));
+    Zone.MaximumElevation = static_cast<uint16_t>(CounterRandom::GetRange(ZoneKey, 1, Zone.MinimumElevation, Zone.MinimumElevation + 1000));
+    Zone.AverageTemperature = static_cast<uint16_t>(CounterRandom::GetRange(ZoneKey, 2, 0, 400));
+    Zone.AverageRainfall = static_cast<uint16_t>(CounterRandom::GetRange(ZoneKey, 3, 0, 4000));
+}
+
+void WorldSubsystem::GenerateZoneTiles(const Cluster::Island& Island, FPCore::World::Coordinates ZoneCoords, ZoneTiles& OutTiles)
+{
+    // Noise is sampled at world tile coordinates, so land and void carry on across zone borders.
+    const FPCore::World::ZoneDef& Zone = Island.Zones[ZoneCoords.X * Island.Bounds.Y + ZoneCoords.Y];
+    Island.Terrain.GenerateZone(static_cast<uint32_t>(ZoneCoords.X) * FPCore::World::ZONE_SIZE_TILES,
+        static_cast<uint32_t>(ZoneCoords.Y) * FPCore::World::ZONE_SIZE_TILES, Zone.MinimumElevation, Zone.MaximumElevation,
+        OutTiles.TileCenterElevations, OutTiles.VoidTileBitmask);
+}
+
+void WorldSubsystem::GenerateZoneTiles_Job(void* Context, size_t BeginTaskIndex, size_t EndTaskIndex)
+{
+    const ZoneGenerationTask* Tasks = static_cast<const ZoneGenerationTask*>(Context);
+    for (size_t TaskIndex = BeginTaskIndex; TaskIndex < EndTaskIndex; TaskIndex++)
+    {
+        GenerateZoneTiles(*Tasks[TaskIndex].Island, Tasks[TaskIndex].ZoneCoords, *Tasks[TaskIndex].Tiles);
+    }
+}
+
+void WorldSubsystem::OnZoneEvictionTimer(void* Context, uint64_t Payload)
+{
+    WorldSubsystem& World = *static_cast<WorldSubsystem*>(Context);
+    Cluster::Island& Island = World.IslandClusters[Payload >> 48].Islands[(Payload >> 32) & 0xFFFF];
+    uint32_t ZoneIndex = static_cast<uint32_t>(Payload);
+
+    ZoneResidency& Residency = Island.ZoneResidencies[ZoneIndex];
+    Residency.EvictionTimer = INVALID_TIMER_HANDLE;
+
+    // Touches don't reschedule the timer, it is only pushed back once it fires on a zone that was touched since.
+    double IdleTime = World.Timers->GetTime() - Residency.LastTouchTime;
+    if (IdleTime >= World.ZoneIdleTimeout)
+    {
+        World.EvictZone(Island, ZoneIndex);
+    }
+    else
+    {
+        Residency.EvictionTimer = World.Timers->Schedule(World.ZoneIdleTimeout - IdleTime, OnZoneEvictionTimer, &World, Payload);
+    }
+}
+
 void WorldSubsystem::DeleteIsland(FPCore::World::ClusterID, FPCore::World::IslandID)
 {
 }
@@ -11,8 +11,14 @@
 
 #include "FPCore/Net/Packet/WorldSyncPackets.h"
 
+size_t WorldSynchronizationSubsystem::GetRequiredMemory(size_t MaxClients)
+{
+    return MemorySubsystem::GetAllocationSize(MaxClients * sizeof(ClientSyncState));
+}
+
 bool WorldSynchronizationSubsystem::Initialize(MemorySubsystem& Memory, ClientsSubsystem& Clients, WorldSubsystem& World)
 {
+    LinkedMemorySubsystem = &Memory;
     LinkedClientsSubsystem = &Clients;
     LinkedWorldSubsystem = &World;
 
@@ -37,9 +43,10 @@ void WorldSynchronizationSubsystem::SyncClients()
             continue;
         }
 
-        if (ClientSyncStates[ClientID].bRequiresZoneUpdate)
+        // A Client whose landscape couldn't be sent is retried on the next update.
+        if (ClientSyncStates[ClientID].bRequiresZoneUpdate
+            && SynchronizeZoneLandscape(LinkedClientsSubsystem->Clients[ClientID], ClientSyncStates[ClientID]))
         {
-            SynchronizeZoneLandscape(LinkedClientsSubsystem->Clients[ClientID], ClientSyncStates[ClientID]);
             ClientSyncStates[ClientID].bRequiresZoneUpdate = false;
         }
     }
@@ -48,14 +55,32 @@ void WorldSynchronizationSubsystem::SyncClients()
 bool WorldSynchronizationSubsystem::SynchronizeZoneLandscape(Client& ClientToSync, ClientSyncState& SyncState)
 {
     // Synchronize Zone at 0,0 of Island 0 in Cluster 0.
-    FPCore::Net::PacketBodyDef_ZoneLandscapeSync LandscapeSyncPacketData = {};
-    LandscapeSyncPacketData.ZoneCoordinates = {0, 0};
+    // The packet data is too large to comfortably live on the stack and is only needed until it is written for sending,
+    // after which it is popped off the Frame Arena so that syncing many Clients in one update doesn't exhaust it.
+    size_t FrameMark = LinkedMemorySubsystem->GetFrameMark();
+    FPCore::Net::PacketBodyDef_ZoneLandscapeSync* LandscapeSyncPacketData = LinkedMemorySubsystem->PushFrameArray<
+        FPCore::Net::PacketBodyDef_ZoneLandscapeSync>();
+    if (nullptr == LandscapeSyncPacketData)
+    {
+        return false;
+    }
+    LandscapeSyncPacketData->ZoneCoordinates = {0, 0};
+
+    // Touching the zone generates its tiles if nobody looked at it for a while.
+    bool bWritten = false;
+    const ZoneTiles* Tiles = LinkedWorldSubsystem->TouchZone(LinkedWorldSubsystem->IslandClusters[0].Islands[0], LandscapeSyncPacketData->ZoneCoordinates);
+    if (nullptr != Tiles)
+    {
+        static_assert(sizeof(LandscapeSyncPacketData->VoidTileBitflag) == sizeof(Tiles->VoidTileBitmask), "Landscape sync packets carry a whole zone !");
+        memcpy(LandscapeSyncPacketData->VoidTileBitflag, Tiles->VoidTileBitmask, sizeof(LandscapeSyncPacketData->VoidTileBitflag));
 
-    memcpy(LandscapeSyncPacketData.VoidTileBitflag, LinkedWorldSubsystem->IslandClusters[0].Islands[0].VoidTileBitmask, sizeof(LandscapeSyncPacketData.VoidTileBitflag));
+        // Send full landscape data to Client's connection.
+        bWritten = LinkedClientsSubsystem->ServerConnectionsSubsystem->WriteOutgoingPacket(ClientToSync.LinkedConnection->ID,
+            FPCore::Net::PacketBodyType::WORLD_SYNC_LANDSCAPE, LandscapeSyncPacketData);
+    }
 
-    // Send full landscape data to Client's connection and return whether writing the packet for sending was a success.
-    return LinkedClientsSubsystem->ServerConnectionsSubsystem->WriteOutgoingPacket(ClientToSync.LinkedConnection->ID, 
-        FPCore::Net::PacketBodyType::WORLD_SYNC_LANDSCAPE, &LandscapeSyncPacketData);
+    LinkedMemorySubsystem->PopFrameMemory(FrameMark);
+    return bWritten;
 }
 
 void WorldSynchronizationSubsystem::OnClientConnected(Client& ConnectedClient, void* Context)
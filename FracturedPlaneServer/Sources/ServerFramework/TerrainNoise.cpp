@@ -0,0 +1,494 @@
+// TerrainNoise.cpp
+// Implementation of the Terrain Noise kernels.
+
+#include "ServerFramework/TerrainNoise.h"
+
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TERRAIN_NOISE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TERRAIN_NOISE_AVX2_TARGET
+#else
+#define TERRAIN_NOISE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define TERRAIN_NOISE_X86 0
+#endif
+
+// Kernels write the void bits of 8 tiles at once, as whole bytes.
+static_assert(FPCore::World::TILES_PER_ZONE % 8 == 0, "Zones have to hold whole bytes of void bits !");
+static_assert(FPCore::World::ZONE_SIZE_TILES > 8, "Kernels step to the next line of tiles at most once per batch !");
+
+// Lattice point hashing constants. Lattice coordinates are multiplied by their prime, combined with the octave seed, then
+// mixed so that the two top bits, picking the gradient, depend on every input bit.
+static constexpr uint32_t HASH_PRIME_X = 0x27D4EB2Du;
+static constexpr uint32_t HASH_PRIME_Y = 0x165667B1u;
+static constexpr uint32_t HASH_MIX = 0x2C1B3C6Du;
+static constexpr uint32_t OCTAVE_SEED_STEP = 0x9E3779B9u;
+static constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+// Per octave constants, shared by every kernel.
+struct TerrainNoiseOctave
+{
+    uint32_t Shift; // Cells span 2^Shift tiles.
+    uint32_t Mask; // Extracts the tile position within its cell.
+    uint32_t Seed;
+    float InvDoubleCellSize; // Scales twice the position of a tile within its cell, plus one, to its center in [0, 1].
+    float Amplitude;
+};
+
+// Fills Octaves and returns the scale mapping the sum of every octave to [-1, 1].
+static float PrepareOctaves(const TerrainNoise& Noise, TerrainNoiseOctave* Octaves)
+{
+    float AmplitudeSum = 0.f;
+    for (uint32_t OctaveIndex = 0; OctaveIndex < Noise.OctaveCount; OctaveIndex++)
+    {
+        TerrainNoiseOctave& Octave = Octaves[OctaveIndex];
+        Octave.Shift = Noise.CellSizeShift - OctaveIndex;
+        Octave.Mask = (1u << Octave.Shift) - 1;
+        Octave.Seed = Noise.Seed + OctaveIndex * OCTAVE_SEED_STEP;
+        Octave.InvDoubleCellSize = 1.f / static_cast<float>(2u << Octave.Shift);
+        Octave.Amplitude = 1.f / static_cast<float>(1u << OctaveIndex);
+        AmplitudeSum += Octave.Amplitude;
+    }
+    return 1.f / AmplitudeSum;
+}
+
+// SCALAR KERNEL
+
+static inline uint32_t HashLatticePoint(uint32_t HashX, uint32_t HashY, uint32_t Seed)
+{
+    uint32_t Hash = HashX ^ HashY ^ Seed;
+    Hash ^= Hash >> 15;
+    Hash *= HASH_MIX;
+    Hash ^= Hash >> 12;
+    return Hash;
+}
+
+static inline float FlipSign(float Value, uint32_t SignBit)
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+    Bits ^= SignBit;
+    memcpy(&Value, &Bits, sizeof(Value));
+    return Value;
+}
+
+// Dot product of the offset to a lattice point with its gradient, one of the four diagonals.
+static inline float Gradient(uint32_t Hash, float X, float Y)
+{
+    return FlipSign(X, Hash & SIGN_BIT) + FlipSign(Y, (Hash << 1) & SIGN_BIT);
+}
+
+// 6t^5 - 15t^4 + 10t^3, evaluated in the same order as the packed kernels.
+static inline float Fade(float T)
+{
+    float Polynomial = T * 6.f;
+    Polynomial = Polynomial - 15.f;
+    Polynomial = Polynomial * T;
+    Polynomial = Polynomial + 10.f;
+    float Cube = T * T;
+    Cube = Cube * T;
+    return Cube * Polynomial;
+}
+
+static float SampleNoise(const TerrainNoiseOctave* Octaves, uint32_t OctaveCount, float NoiseScale, uint32_t WorldX, uint32_t WorldY)
+{
+    float Noise = 0.f;
+    for (uint32_t OctaveIndex = 0; OctaveIndex < OctaveCount; OctaveIndex++)
+    {
+        const TerrainNoiseOctave& Octave = Octaves[OctaveIndex];
+
+        float X = static_cast<float>(static_cast<int32_t>(((WorldX & Octave.Mask) << 1) | 1)) * Octave.InvDoubleCellSize;
+        float Y = static_cast<float>(static_cast<int32_t>(((WorldY & Octave.Mask) << 1) | 1)) * Octave.InvDoubleCellSize;
+
+        uint32_t HashX0 = (WorldX >> Octave.Shift) * HASH_PRIME_X;
+        uint32_t HashY0 = (WorldY >> Octave.Shift) * HASH_PRIME_Y;
+        uint32_t HashX1 = HashX0 + HASH_PRIME_X;
+        uint32_t HashY1 = HashY0 + HASH_PRIME_Y;
+
+        float Noise00 = Gradient(HashLatticePoint(HashX0, HashY0, Octave.Seed), X, Y);
+        float Noise10 = Gradient(HashLatticePoint(HashX1, HashY0, Octave.Seed), X - 1.f, Y);
+        float Noise01 = Gradient(HashLatticePoint(HashX0, HashY1, Octave.Seed), X, Y - 1.f);
+        float Noise11 = Gradient(HashLatticePoint(HashX1, HashY1, Octave.Seed), X - 1.f, Y - 1.f);
+
+        float U = Fade(X);
+        float V = Fade(Y);
+        float Noise0 = Noise00 + U * (Noise10 - Noise00);
+        float Noise1 = Noise01 + U * (Noise11 - Noise01);
+        float OctaveNoise = Noise0 + V * (Noise1 - Noise0);
+
+        Noise = Noise + OctaveNoise * Octave.Amplitude;
+    }
+    return Noise * NoiseScale;
+}
+
+void TerrainNoise::GenerateZone_Scalar(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+    uint16_t* OutElevations, byte* OutVoidTileBitmask) const
+{
+    TerrainNoiseOctave Octaves[MAX_CELL_SIZE_SHIFT + 1];
+    float NoiseScale = PrepareOctaves(*this, Octaves);
+    float Minimum = MinimumElevation;
+    float Maximum = MaximumElevation;
+    float Range = static_cast<float>(MaximumElevation - MinimumElevation);
+
+    memset(OutVoidTileBitmask, 0, FPCore::World::TILES_PER_ZONE / 8);
+
+    for (uint32_t TileX = 0; TileX < FPCore::World::ZONE_SIZE_TILES; TileX++)
+    {
+        for (uint32_t TileY = 0; TileY < FPCore::World::ZONE_SIZE_TILES; TileY++)
+        {
+            uint32_t TileIndex = TileX * FPCore::World::ZONE_SIZE_TILES + TileY;
+            float Noise = SampleNoise(Octaves, OctaveCount, NoiseScale, OriginX + TileX, OriginY + TileY);
+
+            float Elevation = Noise * 0.5f;
+            Elevation = Elevation + 0.5f;
+            Elevation = Elevation * Range;
+            Elevation = Elevation + Minimum;
+            Elevation = Elevation < Minimum ? Minimum : Elevation;
+            Elevation = Elevation > Maximum ? Maximum : Elevation;
+            OutElevations[TileIndex] = static_cast<uint16_t>(static_cast<int32_t>(Elevation));
+
+            if (Noise >= VoidThreshold)
+            {
+                OutVoidTileBitmask[TileIndex / 8] |= 1 << (TileIndex % 8);
+            }
+        }
+    }
+}
+
+#if TERRAIN_NOISE_X86
+
+// SSE2 KERNEL
+
+// SSE2 lacks a 32 bit low multiply: multiply even and odd lanes into 64 bits, and keep the low halves.
+static inline __m128i MultiplyLow_SSE2(__m128i A, __m128i B)
+{
+    __m128i Even = _mm_mul_epu32(A, B);
+    __m128i Odd = _mm_mul_epu32(_mm_srli_epi64(A, 32), _mm_srli_epi64(B, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(Even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(Odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i HashLatticePoint_SSE2(__m128i HashX, __m128i HashY, __m128i Seed)
+{
+    __m128i Hash = _mm_xor_si128(_mm_xor_si128(HashX, HashY), Seed);
+    Hash = _mm_xor_si128(Hash, _mm_srli_epi32(Hash, 15));
+    Hash = MultiplyLow_SSE2(Hash, _mm_set1_epi32(static_cast<int32_t>(HASH_MIX)));
+    return _mm_xor_si128(Hash, _mm_srli_epi32(Hash, 12));
+}
+
+static inline __m128 Gradient_SSE2(__m128i Hash, __m128 X, __m128 Y)
+{
+    __m128i SignBit = _mm_set1_epi32(static_cast<int32_t>(SIGN_BIT));
+    __m128 FlippedX = _mm_xor_ps(X, _mm_castsi128_ps(_mm_and_si128(Hash, SignBit)));
+    __m128 FlippedY = _mm_xor_ps(Y, _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(Hash, 1), SignBit)));
+    return _mm_add_ps(FlippedX, FlippedY);
+}
+
+static inline __m128 Fade_SSE2(__m128 T)
+{
+    __m128 Polynomial = _mm_mul_ps(T, _mm_set1_ps(6.f));
+    Polynomial = _mm_sub_ps(Polynomial, _mm_set1_ps(15.f));
+    Polynomial = _mm_mul_ps(Polynomial, T);
+    Polynomial = _mm_add_ps(Polynomial, _mm_set1_ps(10.f));
+    __m128 Cube = _mm_mul_ps(T, T);
+    Cube = _mm_mul_ps(Cube, T);
+    return _mm_mul_ps(Cube, Polynomial);
+}
+
+static inline __m128 SampleNoise_SSE2(const TerrainNoiseOctave* Octaves, uint32_t OctaveCount, float NoiseScale, __m128i WorldX, __m128i WorldY)
+{
+    __m128i One = _mm_set1_epi32(1);
+    __m128 OneFloat = _mm_set1_ps(1.f);
+
+    __m128 Noise = _mm_setzero_ps();
+    for (uint32_t OctaveIndex = 0; OctaveIndex < OctaveCount; OctaveIndex++)
+    {
+        const TerrainNoiseOctave& Octave = Octaves[OctaveIndex];
+        __m128i Mask = _mm_set1_epi32(static_cast<int32_t>(Octave.Mask));
+        __m128i Shift = _mm_cvtsi32_si128(static_cast<int32_t>(Octave.Shift));
+        __m128 InvDoubleCellSize = _mm_set1_ps(Octave.InvDoubleCellSize);
+        __m128i Seed = _mm_set1_epi32(static_cast<int32_t>(Octave.Seed));
+
+        __m128 X = _mm_mul_ps(_mm_cvtepi32_ps(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(WorldX, Mask), 1), One)), InvDoubleCellSize);
+        __m128 Y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(WorldY, Mask), 1), One)), InvDoubleCellSize);
+
+        __m128i PrimeX = _mm_set1_epi32(static_cast<int32_t>(HASH_PRIME_X));
+        __m128i PrimeY = _mm_set1_epi32(static_cast<int32_t>(HASH_PRIME_Y));
+        __m128i HashX0 = MultiplyLow_SSE2(_mm_srl_epi32(WorldX, Shift), PrimeX);
+        __m128i HashY0 = MultiplyLow_SSE2(_mm_srl_epi32(WorldY, Shift), PrimeY);
+        __m128i HashX1 = _mm_add_epi32(HashX0, PrimeX);
+        __m128i HashY1 = _mm_add_epi32(HashY0, PrimeY);
+
+        __m128 X1 = _mm_sub_ps(X, OneFloat);
+        __m128 Y1 = _mm_sub_ps(Y, OneFloat);
+        __m128 Noise00 = Gradient_SSE2(HashLatticePoint_SSE2(HashX0, HashY0, Seed), X, Y);
+        __m128 Noise10 = Gradient_SSE2(HashLatticePoint_SSE2(HashX1, HashY0, Seed), X1, Y);
+        __m128 Noise01 = Gradient_SSE2(HashLatticePoint_SSE2(HashX0, HashY1, Seed), X, Y1);
+        __m128 Noise11 = Gradient_SSE2(HashLatticePoint_SSE2(HashX1, HashY1, Seed), X1, Y1);
+
+        __m128 U = Fade_SSE2(X);
+        __m128 V = Fade_SSE2(Y);
+        __m128 Noise0 = _mm_add_ps(Noise00, _mm_mul_ps(U, _mm_sub_ps(Noise10, Noise00)));
+        __m128 Noise1 = _mm_add_ps(Noise01, _mm_mul_ps(U, _mm_sub_ps(Noise11, Noise01)));
+        __m128 OctaveNoise = _mm_add_ps(Noise0, _mm_mul_ps(V, _mm_sub_ps(Noise1, Noise0)));
+
+        Noise = _mm_add_ps(Noise, _mm_mul_ps(OctaveNoise, _mm_set1_ps(Octave.Amplitude)));
+    }
+    return _mm_mul_ps(Noise, _mm_set1_ps(NoiseScale));
+}
+
+void TerrainNoise::GenerateZone_SSE2(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+    uint16_t* OutElevations, byte* OutVoidTileBitmask) const
+{
+    TerrainNoiseOctave Octaves[MAX_CELL_SIZE_SHIFT + 1];
+    float NoiseScale = PrepareOctaves(*this, Octaves);
+    __m128 Minimum = _mm_set1_ps(MinimumElevation);
+    __m128 Maximum = _mm_set1_ps(MaximumElevation);
+    __m128 Range = _mm_set1_ps(static_cast<float>(MaximumElevation - MinimumElevation));
+    __m128 Half = _mm_set1_ps(0.5f);
+    __m128 Threshold = _mm_set1_ps(VoidThreshold);
+
+    __m128i Origin_X = _mm_set1_epi32(static_cast<int32_t>(OriginX));
+    __m128i Origin_Y = _mm_set1_epi32(static_cast<int32_t>(OriginY));
+    __m128i ZoneSize = _mm_set1_epi32(FPCore::World::ZONE_SIZE_TILES);
+    __m128i LastTile = _mm_set1_epi32(FPCore::World::ZONE_SIZE_TILES - 1);
+    __m128i Step = _mm_set1_epi32(4);
+    __m128i ElevationBias = _mm_set1_epi32(32768);
+    __m128i ElevationBias16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+
+    // Tile coordinates of every lane, walking tiles line by line.
+    __m128i TileX = _mm_setzero_si128();
+    __m128i TileY = _mm_setr_epi32(0, 1, 2, 3);
+
+    for (uint32_t TileIndex = 0; TileIndex < FPCore::World::TILES_PER_ZONE; TileIndex += 8)
+    {
+        int VoidBits = 0;
+        for (uint32_t Batch = 0; Batch < 2; Batch++)
+        {
+            __m128 Noise = SampleNoise_SSE2(Octaves, OctaveCount, NoiseScale, _mm_add_epi32(Origin_X, TileX), _mm_add_epi32(Origin_Y, TileY));
+
+            __m128 Elevation = _mm_mul_ps(Noise, Half);
+            Elevation = _mm_add_ps(Elevation, Half);
+            Elevation = _mm_mul_ps(Elevation, Range);
+            Elevation = _mm_add_ps(Elevation, Minimum);
+            Elevation = _mm_max_ps(Elevation, Minimum);
+            Elevation = _mm_min_ps(Elevation, Maximum);
+
+            // SSE2 only packs with signed saturation: shift elevations into the signed range and back.
+            __m128i Elevations = _mm_sub_epi32(_mm_cvttps_epi32(Elevation), ElevationBias);
+            Elevations = _mm_xor_si128(_mm_packs_epi32(Elevations, Elevations), ElevationBias16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(OutElevations + TileIndex + Batch * 4), Elevations);
+
+            VoidBits |= _mm_movemask_ps(_mm_cmpge_ps(Noise, Threshold)) << (Batch * 4);
+
+            TileY = _mm_add_epi32(TileY, Step);
+            __m128i NextLine = _mm_cmpgt_epi32(TileY, LastTile);
+            TileY = _mm_sub_epi32(TileY, _mm_and_si128(NextLine, ZoneSize));
+            TileX = _mm_sub_epi32(TileX, NextLine);
+        }
+        OutVoidTileBitmask[TileIndex / 8] = static_cast<byte>(VoidBits);
+    }
+}
+
+// AVX2 KERNEL
+
+TERRAIN_NOISE_AVX2_TARGET static inline __m256i HashLatticePoint_AVX2(__m256i HashX, __m256i HashY, __m256i Seed)
+{
+    __m256i Hash = _mm256_xor_si256(_mm256_xor_si256(HashX, HashY), Seed);
+    Hash = _mm256_xor_si256(Hash, _mm256_srli_epi32(Hash, 15));
+    Hash = _mm256_mullo_epi32(Hash, _mm256_set1_epi32(static_cast<int32_t>(HASH_MIX)));
+    return _mm256_xor_si256(Hash, _mm256_srli_epi32(Hash, 12));
+}
+
+TERRAIN_NOISE_AVX2_TARGET static inline __m256 Gradient_AVX2(__m256i Hash, __m256 X, __m256 Y)
+{
+    __m256i SignBit = _mm256_set1_epi32(static_cast<int32_t>(SIGN_BIT));
+    __m256 FlippedX = _mm256_xor_ps(X, _mm256_castsi256_ps(_mm256_and_si256(Hash, SignBit)));
+    __m256 FlippedY = _mm256_xor_ps(Y, _mm256_castsi256_ps(_mm256_and_si256(_mm256_slli_epi32(Hash, 1), SignBit)));
+    return _mm256_add_ps(FlippedX, FlippedY);
+}
+
+TERRAIN_NOISE_AVX2_TARGET static inline __m256 Fade_AVX2(__m256 T)
+{
+    __m256 Polynomial = _mm256_mul_ps(T, _mm256_set1_ps(6.f));
+    Polynomial = _mm256_sub_ps(Polynomial, _mm256_set1_ps(15.f));
+    Polynomial = _mm256_mul_ps(Polynomial, T);
+    Polynomial = _mm256_add_ps(Polynomial, _mm256_set1_ps(10.f));
+    __m256 Cube = _mm256_mul_ps(T, T);
+    Cube = _mm256_mul_ps(Cube, T);
+    return _mm256_mul_ps(Cube, Polynomial);
+}
+
+TERRAIN_NOISE_AVX2_TARGET static inline __m256 SampleNoise_AVX2(const TerrainNoiseOctave* Octaves, uint32_t OctaveCount, float NoiseScale,
+    __m256i WorldX, __m256i WorldY)
+{
+    __m256i One = _mm256_set1_epi32(1);
+    __m256 OneFloat = _mm256_set1_ps(1.f);
+
+    __m256 Noise = _mm256_setzero_ps();
+    for (uint32_t OctaveIndex = 0; OctaveIndex < OctaveCount; OctaveIndex++)
+    {
+        const TerrainNoiseOctave& Octave = Octaves[OctaveIndex];
+        __m256i Mask = _mm256_set1_epi32(static_cast<int32_t>(Octave.Mask));
+        __m128i Shift = _mm_cvtsi32_si128(static_cast<int32_t>(Octave.Shift));
+        __m256 InvDoubleCellSize = _mm256_set1_ps(Octave.InvDoubleCellSize);
+        __m256i Seed = _mm256_set1_epi32(static_cast<int32_t>(Octave.Seed));
+
+        __m256 X = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(WorldX, Mask), 1), One)), InvDoubleCellSize);
+        __m256 Y = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(WorldY, Mask), 1), One)), InvDoubleCellSize);
+
+        __m256i PrimeX = _mm256_set1_epi32(static_cast<int32_t>(HASH_PRIME_X));
+        __m256i PrimeY = _mm256_set1_epi32(static_cast<int32_t>(HASH_PRIME_Y));
+        __m256i HashX0 = _mm256_mullo_epi32(_mm256_srl_epi32(WorldX, Shift), PrimeX);
+        __m256i HashY0 = _mm256_mullo_epi32(_mm256_srl_epi32(WorldY, Shift), PrimeY);
+        __m256i HashX1 = _mm256_add_epi32(HashX0, PrimeX);
+        __m256i HashY1 = _mm256_add_epi32(HashY0, PrimeY);
+
+        __m256 X1 = _mm256_sub_ps(X, OneFloat);
+        __m256 Y1 = _mm256_sub_ps(Y, OneFloat);
+        __m256 Noise00 = Gradient_AVX2(HashLatticePoint_AVX2(HashX0, HashY0, Seed), X, Y);
+        __m256 Noise10 = Gradient_AVX2(HashLatticePoint_AVX2(HashX1, HashY0, Seed), X1, Y);
+        __m256 Noise01 = Gradient_AVX2(HashLatticePoint_AVX2(HashX0, HashY1, Seed), X, Y1);
+        __m256 Noise11 = Gradient_AVX2(HashLatticePoint_AVX2(HashX1, HashY1, Seed), X1, Y1);
+
+        __m256 U = Fade_AVX2(X);
+        __m256 V = Fade_AVX2(Y);
+        __m256 Noise0 = _mm256_add_ps(Noise00, _mm256_mul_ps(U, _mm256_sub_ps(Noise10, Noise00)));
+        __m256 Noise1 = _mm256_add_ps(Noise01, _mm256_mul_ps(U, _mm256_sub_ps(Noise11, Noise01)));
+        __m256 OctaveNoise = _mm256_add_ps(Noise0, _mm256_mul_ps(V, _mm256_sub_ps(Noise1, Noise0)));
+
+        Noise = _mm256_add_ps(Noise, _mm256_mul_ps(OctaveNoise, _mm256_set1_ps(Octave.Amplitude)));
+    }
+    return _mm256_mul_ps(Noise, _mm256_set1_ps(NoiseScale));
+}
+
+TERRAIN_NOISE_AVX2_TARGET void TerrainNoise::GenerateZone_AVX2(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation,
+    uint16_t MaximumElevation, uint16_t* OutElevations, byte* OutVoidTileBitmask) const
+{
+    TerrainNoiseOctave Octaves[MAX_CELL_SIZE_SHIFT + 1];
+    float NoiseScale = PrepareOctaves(*this, Octaves);
+    __m256 Minimum = _mm256_set1_ps(MinimumElevation);
+    __m256 Maximum = _mm256_set1_ps(MaximumElevation);
+    __m256 Range = _mm256_set1_ps(static_cast<float>(MaximumElevation - MinimumElevation));
+    __m256 Half = _mm256_set1_ps(0.5f);
+    __m256 Threshold = _mm256_set1_ps(VoidThreshold);
+
+    __m256i Origin_X = _mm256_set1_epi32(static_cast<int32_t>(OriginX));
+    __m256i Origin_Y = _mm256_set1_epi32(static_cast<int32_t>(OriginY));
+    __m256i ZoneSize = _mm256_set1_epi32(FPCore::World::ZONE_SIZE_TILES);
+    __m256i LastTile = _mm256_set1_epi32(FPCore::World::ZONE_SIZE_TILES - 1);
+    __m256i Step = _mm256_set1_epi32(8);
+
+    // Tile coordinates of every lane, walking tiles line by line.
+    __m256i TileX = _mm256_setzero_si256();
+    __m256i TileY = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (uint32_t TileIndex = 0; TileIndex < FPCore::World::TILES_PER_ZONE; TileIndex += 8)
+    {
+        __m256 Noise = SampleNoise_AVX2(Octaves, OctaveCount, NoiseScale, _mm256_add_epi32(Origin_X, TileX), _mm256_add_epi32(Origin_Y, TileY));
+
+        __m256 Elevation = _mm256_mul_ps(Noise, Half);
+        Elevation = _mm256_add_ps(Elevation, Half);
+        Elevation = _mm256_mul_ps(Elevation, Range);
+        Elevation = _mm256_add_ps(Elevation, Minimum);
+        Elevation = _mm256_max_ps(Elevation, Minimum);
+        Elevation = _mm256_min_ps(Elevation, Maximum);
+
+        // Packing works within 128 bit halves: gather the low quarter of each half into the low half.
+        __m256i Elevations = _mm256_cvttps_epi32(Elevation);
+        Elevations = _mm256_permute4x64_epi64(_mm256_packus_epi32(Elevations, Elevations), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(OutElevations + TileIndex), _mm256_castsi256_si128(Elevations));
+
+        OutVoidTileBitmask[TileIndex / 8] = static_cast<byte>(_mm256_movemask_ps(_mm256_cmp_ps(Noise, Threshold, _CMP_GE_OQ)));
+
+        TileY = _mm256_add_epi32(TileY, Step);
+        __m256i NextLine = _mm256_cmpgt_epi32(TileY, LastTile);
+        TileY = _mm256_sub_epi32(TileY, _mm256_and_si256(NextLine, ZoneSize));
+        TileX = _mm256_sub_epi32(TileX, NextLine);
+    }
+}
+
+#else
+
+// Packed kernels only exist on x86, other processors run the scalar one.
+
+void TerrainNoise::GenerateZone_SSE2(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+    uint16_t* OutElevations, byte* OutVoidTileBitmask) const
+{
+    GenerateZone_Scalar(OriginX, OriginY, MinimumElevation, MaximumElevation, OutElevations, OutVoidTileBitmask);
+}
+
+void TerrainNoise::GenerateZone_AVX2(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+    uint16_t* OutElevations, byte* OutVoidTileBitmask) const
+{
+    GenerateZone_Scalar(OriginX, OriginY, MinimumElevation, MaximumElevation, OutElevations, OutVoidTileBitmask);
+}
+
+#endif
+
+TerrainNoiseKernel TerrainNoise::GetBestKernel()
+{
+#if TERRAIN_NOISE_X86
+#ifdef _MSC_VER
+    // AVX2 requires the processor to support it, and the OS to save the YMM registers.
+    int CpuInfo[4];
+    __cpuid(CpuInfo, 0);
+    if (CpuInfo[0] >= 7)
+    {
+        __cpuidex(CpuInfo, 7, 0);
+        bool bAVX2 = (CpuInfo[1] & (1 << 5)) != 0;
+        __cpuid(CpuInfo, 1);
+        bool bOSXSAVE = (CpuInfo[2] & (1 << 27)) != 0;
+        if (bAVX2 && bOSXSAVE && (_xgetbv(0) & 6) == 6)
+        {
+            return TerrainNoiseKernel::AVX2;
+        }
+    }
+    return TerrainNoiseKernel::SSE2;
+#else
+    return __builtin_cpu_supports("avx2") ? TerrainNoiseKernel::AVX2 : TerrainNoiseKernel::SSE2;
+#endif
+#else
+    return TerrainNoiseKernel::SCALAR;
+#endif
+}
+
+bool TerrainNoise::Initialize(uint32_t NoiseSeed, uint32_t CellShift, uint32_t Octaves, float Threshold, TerrainNoiseKernel RequestedKernel)
+{
+    if (CellShift > MAX_CELL_SIZE_SHIFT || Octaves == 0 || Octaves > CellShift + 1)
+    {
+        std::cerr << "Error: Can't create a Terrain Noise of " << Octaves << " octaves over cells of 2^" << CellShift << " tiles.\n";
+        return false;
+    }
+
+    Seed = NoiseSeed;
+    CellSizeShift = CellShift;
+    OctaveCount = Octaves;
+    VoidThreshold = Threshold;
+
+    TerrainNoiseKernel BestKernel = GetBestKernel();
+    Kernel = RequestedKernel <= BestKernel ? RequestedKernel : BestKernel;
+    return true;
+}
+
+void TerrainNoise::GenerateZone(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+    uint16_t* OutElevations, byte* OutVoidTileBitmask) const
+{
+    switch (Kernel)
+    {
+    case TerrainNoiseKernel::AVX2:
+        GenerateZone_AVX2(OriginX, OriginY, MinimumElevation, MaximumElevation, OutElevations, OutVoidTileBitmask);
+        break;
+    case TerrainNoiseKernel::SSE2:
+        GenerateZone_SSE2(OriginX, OriginY, MinimumElevation, MaximumElevation, OutElevations, OutVoidTileBitmask);
+        break;
+    default:
+        GenerateZone_Scalar(OriginX, OriginY, MinimumElevation, MaximumElevation, OutElevations, OutVoidTileBitmask);
+        break;
+    }
+}
\ No newline at end of file
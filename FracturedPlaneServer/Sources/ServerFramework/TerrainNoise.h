@@ -0,0 +1,56 @@
+// TerrainNoise.h
+// Declares the Terrain Noise, the fractal gradient noise that zone tiles are generated from.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "FPCore/World/World.h"
+
+// Implementations of the noise. They all produce the exact same bits: only their speed differs.
+enum class TerrainNoiseKernel : uint8_t
+{
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Multi-octave 2D gradient noise over world tile coordinates, continuous across zones and Islands alike.
+// Lattice cells of the first octave span 2^CellSizeShift tiles, and every further octave halves both cell size and
+// amplitude. Cells being whole powers of two tiles, lattice coordinates and positions within cells are computed exactly
+// from integer tile coordinates, however far from the origin.
+// Every kernel runs the exact same sequence of float operations per tile, without any fused multiply-add, and hashes
+// lattice points with integer arithmetic alone, so output only depends on the settings: never on the kernel, the
+// processor or the zone generation order.
+struct TerrainNoise
+{
+    static constexpr uint32_t MAX_CELL_SIZE_SHIFT = 16;
+
+    uint32_t Seed;
+    uint32_t CellSizeShift;
+    uint32_t OctaveCount; // At most CellSizeShift + 1, so that the last octave's cells are one tile wide.
+    float VoidThreshold; // Tiles whose noise, in [-1, 1], falls below this are void.
+
+    TerrainNoiseKernel Kernel;
+
+    // Returns the fastest kernel the processor running the Server supports.
+    static TerrainNoiseKernel GetBestKernel();
+
+    // Sets the noise up, running the passed kernel, or the best supported one if the passed one isn't.
+    bool Initialize(uint32_t NoiseSeed, uint32_t CellShift, uint32_t Octaves, float Threshold, TerrainNoiseKernel RequestedKernel = GetBestKernel());
+
+    // Writes the elevation and void bit of every tile of the zone whose first tile lies at world tile coordinates
+    // [OriginX, OriginY], in one pass. Tiles are ordered line by line, like the zone's tile data. Noise is mapped linearly
+    // to elevations in [MinimumElevation, MaximumElevation].
+    void GenerateZone(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+        uint16_t* OutElevations, byte* OutVoidTileBitmask) const;
+
+    // Kernels, called by GenerateZone.
+    void GenerateZone_Scalar(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+        uint16_t* OutElevations, byte* OutVoidTileBitmask) const;
+    void GenerateZone_SSE2(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+        uint16_t* OutElevations, byte* OutVoidTileBitmask) const;
+    void GenerateZone_AVX2(uint32_t OriginX, uint32_t OriginY, uint16_t MinimumElevation, uint16_t MaximumElevation,
+        uint16_t* OutElevations, byte* OutVoidTileBitmask) const;
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+// TickScheduler.cpp
+// Implementation of the Tick Scheduler.
+
+#include "ServerFramework/TickScheduler.h"
+
+#include <iostream>
+
+bool TickScheduler::Initialize(size_t TickRate, double Now)
+{
+    *this = {};
+    if (TickRate == 0)
+    {
+        std::cerr << "Error: The Server can't tick 0 times a second.\n";
+        return false;
+    }
+
+    TickDuration = 1.0 / static_cast<double>(TickRate);
+    NextTickTime = Now + TickDuration;
+    return true;
+}
+
+double TickScheduler::BeginTick(double Now)
+{
+    double Latency = Now > NextTickTime ? Now - NextTickTime : 0.0;
+    MaxTickLatency = Latency > MaxTickLatency ? Latency : MaxTickLatency;
+
+    uint64_t LatencyMicroseconds = static_cast<uint64_t>(Latency * 1e6);
+    uint32_t Bucket = 0;
+    while (LatencyMicroseconds > 0 && Bucket < LATENCY_BUCKET_COUNT - 1)
+    {
+        LatencyMicroseconds >>= 1;
+        Bucket++;
+    }
+    TickLatencyHistogram[Bucket]++;
+    TickCount++;
+
+    // Too far behind to catch up: skip every missed tick, so that the next one is due in the future again.
+    NextTickTime += TickDuration;
+    if (Now - NextTickTime > MAX_CATCH_UP_TICKS * TickDuration)
+    {
+        uint64_t SkippedTicks = static_cast<uint64_t>((Now - NextTickTime) / TickDuration) + 1;
+        NextTickTime += static_cast<double>(SkippedTicks) * TickDuration;
+        SkippedTickCount += SkippedTicks;
+    }
+
+    return TickDuration;
+}
+
+void TickScheduler::EndTick(double TickBeginTime, double Now)
+{
+    double UpdateDuration = Now - TickBeginTime;
+    MaxTickUpdateDuration = UpdateDuration > MaxTickUpdateDuration ? UpdateDuration : MaxTickUpdateDuration;
+
+    if (Now > NextTickTime)
+    {
+        OverrunCount++;
+    }
+}
+
+double TickScheduler::GetTickLatencyPercentile(double Fraction) const
+{
+    uint64_t CountedTicks = 0;
+    for (uint32_t Bucket = 0; Bucket < LATENCY_BUCKET_COUNT; Bucket++)
+    {
+        CountedTicks += TickLatencyHistogram[Bucket];
+        if (CountedTicks > 0 && static_cast<double>(CountedTicks) >= Fraction * static_cast<double>(TickCount))
+        {
+            return Bucket < LATENCY_BUCKET_COUNT - 1 ? static_cast<double>(1ull << Bucket) / 1e6 : MaxTickLatency;
+        }
+    }
+    return 0.0;
+}
+
+void TickScheduler::PrintStats() const
+{
+    std::cout << "Ticks: " << TickCount << " at " << 1.0 / TickDuration << " Hz, " << WakeUpdateCount << " network wake-up updates, "
+        << OverrunCount << " overruns, " << SkippedTickCount << " skipped.\n";
+    if (TickCount == 0)
+    {
+        return;
+    }
+
+    std::cout << "Tick latency: p50 < " << GetTickLatencyPercentile(0.5) * 1e6 << " us, p99 < " << GetTickLatencyPercentile(0.99) * 1e6
+        << " us, max " << MaxTickLatency * 1e6 << " us. Longest tick update: " << MaxTickUpdateDuration * 1e6 << " us.\n";
+    for (uint32_t Bucket = 0; Bucket < LATENCY_BUCKET_COUNT; Bucket++)
+    {
+        if (TickLatencyHistogram[Bucket] == 0)
+        {
+            continue;
+        }
+
+        uint64_t BucketStart = Bucket > 0 ? 1ull << (Bucket - 1) : 0;
+        std::cout << "    [" << BucketStart << " us, ";
+        if (Bucket < LATENCY_BUCKET_COUNT - 1)
+        {
+            std::cout << (1ull << Bucket) << " us[: ";
+        }
+        else
+        {
+            std::cout << "...[: ";
+        }
+        std::cout << TickLatencyHistogram[Bucket] << "\n";
+    }
+}
\ No newline at end of file
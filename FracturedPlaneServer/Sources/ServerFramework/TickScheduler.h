@@ -0,0 +1,48 @@
+// TickScheduler.h
+// Declares the Tick Scheduler, pacing the Platform's calls to UpdateServer at a fixed rate.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Keeps track of when the next Server tick is due and of how well ticks keep up with it. Every tick is passed the same
+// DeltaTime, whenever it actually begins: late ticks are caught up on back to back, up to MAX_CATCH_UP_TICKS behind,
+// past which the missed ticks are skipped rather than leaving the Server running ever further behind.
+// The Platform does the waiting itself, until NextTickTime or until the network has work for the Server.
+// Times are in seconds, read from the Platform's monotonic clock.
+struct TickScheduler
+{
+    // Tick latencies are counted in power of two microsecond buckets: [0, 1[, [1, 2[, [2, 4[... The last bucket also
+    // holds every longer latency.
+    static constexpr uint32_t LATENCY_BUCKET_COUNT = 20;
+    static constexpr uint32_t MAX_CATCH_UP_TICKS = 4;
+
+    double TickDuration; // Also the DeltaTime of every tick.
+    double NextTickTime;
+
+    // Stats since Initialize. A tick's latency is how long after its due time it began.
+    uint64_t TickCount;
+    uint64_t WakeUpdateCount; // Updates run between ticks for network work, passed a DeltaTime of 0.
+    uint64_t OverrunCount; // Ticks still updating when the next one was due.
+    uint64_t SkippedTickCount;
+    double MaxTickLatency;
+    double MaxTickUpdateDuration;
+    uint64_t TickLatencyHistogram[LATENCY_BUCKET_COUNT];
+
+    // Schedules the first tick TickRate times a second from Now. Fails for a TickRate of 0.
+    bool Initialize(size_t TickRate, double Now);
+
+    bool IsTickDue(double Now) const { return Now >= NextTickTime; }
+
+    // Records the due tick beginning at Now and schedules the next one. Returns the DeltaTime to update the Server with.
+    double BeginTick(double Now);
+
+    // Records the end of the update of the tick begun at TickBeginTime.
+    void EndTick(double TickBeginTime, double Now);
+
+    // Returns the latency under which at least Fraction of the ticks began, rounded up to their bucket's upper bound.
+    double GetTickLatencyPercentile(double Fraction) const;
+
+    void PrintStats() const;
+};
\ No newline at end of file
@@ -0,0 +1,206 @@
+// TimerWheel.cpp
+// Implementation of the Timer Wheel.
+
+#include "ServerFramework/TimerWheel.h"
+
+#include <cmath>
+#include <iostream>
+
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+
+size_t TimerWheel::GetRequiredMemory(size_t MaxTimers)
+{
+    return MemorySubsystem::GetAllocationSize(MaxTimers * sizeof(Timer));
+}
+
+bool TimerWheel::Initialize(MemorySubsystem& Memory, size_t MaxTimers, double TickDurationSeconds)
+{
+    if (MaxTimers >= NO_TIMER || TickDurationSeconds <= 0.0)
+    {
+        std::cerr << "Error: Can't create a Timer Wheel of " << MaxTimers << " timers ticking every " << TickDurationSeconds << " s.\n";
+        return false;
+    }
+
+    MaxTimerCount = static_cast<uint32_t>(MaxTimers);
+    Timers = static_cast<Timer*>(Memory.Allocate(MaxTimerCount * sizeof(Timer)));
+    if (nullptr == Timers && MaxTimerCount > 0)
+    {
+        return false;
+    }
+
+    // Chain every timer into the free list, lowest first.
+    for (uint32_t TimerIndex = 0; TimerIndex < MaxTimerCount; TimerIndex++)
+    {
+        Timers[TimerIndex] = {};
+        Timers[TimerIndex].Next = TimerIndex + 1 < MaxTimerCount ? TimerIndex + 1 : NO_TIMER;
+        Timers[TimerIndex].Generation = 1;
+        Timers[TimerIndex].Slot = NO_SLOT;
+    }
+    FreeTimerHead = MaxTimerCount > 0 ? 0 : NO_TIMER;
+    PendingTimerCount = 0;
+
+    for (uint32_t& SlotHead : SlotHeads)
+    {
+        SlotHead = NO_TIMER;
+    }
+
+    CurrentTick = 0;
+    TickDuration = TickDurationSeconds;
+    PendingTime = 0.0;
+    return true;
+}
+
+TimerHandle TimerWheel::Schedule(double DelaySeconds, TimerCallbackFunc Callback, void* Context, uint64_t Payload)
+{
+    // Count the delay from now, which is some way into the current tick.
+    double DelayTicks = std::ceil((DelaySeconds + PendingTime) / TickDuration);
+    return ScheduleInTicks(DelayTicks < static_cast<double>(MAX_DELAY_TICKS) ? static_cast<uint64_t>(DelayTicks) : MAX_DELAY_TICKS,
+        Callback, Context, Payload);
+}
+
+TimerHandle TimerWheel::ScheduleInTicks(uint64_t DelayTicks, TimerCallbackFunc Callback, void* Context, uint64_t Payload)
+{
+    if (FreeTimerHead == NO_TIMER || nullptr == Callback)
+    {
+        return INVALID_TIMER_HANDLE;
+    }
+
+    uint32_t TimerIndex = FreeTimerHead;
+    Timer& NewTimer = Timers[TimerIndex];
+    FreeTimerHead = NewTimer.Next;
+
+    NewTimer.ExpirationTick = CurrentTick + (DelayTicks < 1 ? 1 : DelayTicks > MAX_DELAY_TICKS ? MAX_DELAY_TICKS : DelayTicks);
+    NewTimer.Callback = Callback;
+    NewTimer.Context = Context;
+    NewTimer.Payload = Payload;
+    InsertTimer(TimerIndex);
+    PendingTimerCount++;
+
+    return { TimerIndex, NewTimer.Generation };
+}
+
+bool TimerWheel::Cancel(TimerHandle& Handle)
+{
+    bool bWasPending = IsPending(Handle);
+    if (bWasPending)
+    {
+        Timer& CancelledTimer = Timers[Handle.Index];
+        RemoveTimer(Handle.Index);
+        CancelledTimer.Generation++;
+        CancelledTimer.Next = FreeTimerHead;
+        FreeTimerHead = Handle.Index;
+        PendingTimerCount--;
+    }
+
+    Handle = INVALID_TIMER_HANDLE;
+    return bWasPending;
+}
+
+bool TimerWheel::IsPending(TimerHandle Handle) const
+{
+    return Handle.Index < MaxTimerCount
+        && Timers[Handle.Index].Generation == Handle.Generation
+        && Timers[Handle.Index].Slot != NO_SLOT;
+}
+
+void TimerWheel::Advance(double DeltaTime)
+{
+    PendingTime += DeltaTime;
+    while (PendingTime >= TickDuration)
+    {
+        PendingTime -= TickDuration;
+        Tick();
+    }
+}
+
+void TimerWheel::Tick()
+{
+    CurrentTick++;
+
+    // Every level whose previous one starts a new turn on this tick moves the timers of its current slot down, into slots
+    // that come up when they have to move again or fire. Timers due on this very tick land in the slot fired below.
+    for (uint32_t Level = LEVEL_COUNT - 1; Level > 0; Level--)
+    {
+        uint64_t LevelShift = SLOT_BITS * Level;
+        if ((CurrentTick & ((1ull << LevelShift) - 1)) != 0)
+        {
+            continue;
+        }
+
+        uint32_t Slot = Level * SLOTS_PER_LEVEL + static_cast<uint32_t>((CurrentTick >> LevelShift) & (SLOTS_PER_LEVEL - 1));
+        uint32_t TimerIndex = SlotHeads[Slot];
+        SlotHeads[Slot] = NO_TIMER;
+        while (TimerIndex != NO_TIMER)
+        {
+            uint32_t NextTimerIndex = Timers[TimerIndex].Next;
+            InsertTimer(TimerIndex);
+            TimerIndex = NextTimerIndex;
+        }
+    }
+
+    // Fire every timer of the current first level slot. Callbacks may cancel timers of this same slot, so each timer is
+    // taken off the slot right before its callback is called.
+    uint32_t Slot = static_cast<uint32_t>(CurrentTick & (SLOTS_PER_LEVEL - 1));
+    while (SlotHeads[Slot] != NO_TIMER)
+    {
+        uint32_t TimerIndex = SlotHeads[Slot];
+        Timer& DueTimer = Timers[TimerIndex];
+        RemoveTimer(TimerIndex);
+
+        TimerCallbackFunc Callback = DueTimer.Callback;
+        void* Context = DueTimer.Context;
+        uint64_t Payload = DueTimer.Payload;
+
+        DueTimer.Generation++;
+        DueTimer.Next = FreeTimerHead;
+        FreeTimerHead = TimerIndex;
+        PendingTimerCount--;
+
+        Callback(Context, Payload);
+    }
+}
+
+void TimerWheel::InsertTimer(uint32_t TimerIndex)
+{
+    Timer& InsertedTimer = Timers[TimerIndex];
+
+    // Pick the lowest level whose turn covers the remaining delay. The slot is picked from the expiration tick itself, so
+    // that it comes up exactly when the timer has to move down or fire.
+    uint64_t RemainingTicks = InsertedTimer.ExpirationTick - CurrentTick;
+    uint32_t Level = 0;
+    while (Level < LEVEL_COUNT - 1 && RemainingTicks >= (1ull << (SLOT_BITS * (Level + 1))))
+    {
+        Level++;
+    }
+
+    uint32_t Slot = Level * SLOTS_PER_LEVEL + static_cast<uint32_t>((InsertedTimer.ExpirationTick >> (SLOT_BITS * Level)) & (SLOTS_PER_LEVEL - 1));
+    InsertedTimer.Slot = static_cast<uint16_t>(Slot);
+    InsertedTimer.Previous = NO_TIMER;
+    InsertedTimer.Next = SlotHeads[Slot];
+    if (InsertedTimer.Next != NO_TIMER)
+    {
+        Timers[InsertedTimer.Next].Previous = TimerIndex;
+    }
+    SlotHeads[Slot] = TimerIndex;
+}
+
+void TimerWheel::RemoveTimer(uint32_t TimerIndex)
+{
+    Timer& RemovedTimer = Timers[TimerIndex];
+
+    if (RemovedTimer.Previous != NO_TIMER)
+    {
+        Timers[RemovedTimer.Previous].Next = RemovedTimer.Next;
+    }
+    else
+    {
+        SlotHeads[RemovedTimer.Slot] = RemovedTimer.Next;
+    }
+
+    if (RemovedTimer.Next != NO_TIMER)
+    {
+        Timers[RemovedTimer.Next].Previous = RemovedTimer.Previous;
+    }
+
+    RemovedTimer.Slot = NO_SLOT;
+}
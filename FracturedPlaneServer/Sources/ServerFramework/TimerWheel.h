@@ -0,0 +1,99 @@
+// TimerWheel.h
+// Declares the Timer Wheel, on which Subsystems schedule callbacks to run once a delay has passed.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// DEPENDENCIES FORWARD DECLARATION
+struct MemorySubsystem;
+
+// Identifies a scheduled timer. Timer slots are versioned, so a handle stays safe to cancel after its timer fired or was
+// cancelled, even once the slot is reused.
+struct TimerHandle
+{
+    uint32_t Index;
+    uint32_t Generation;
+};
+
+static constexpr TimerHandle INVALID_TIMER_HANDLE = { ~0u, 0 };
+
+// Called when a timer fires, with the Context and Payload it was scheduled with. Timers may be scheduled and cancelled
+// from within, including the ones due on the same tick.
+typedef void (*TimerCallbackFunc)(void* Context, uint64_t Payload);
+
+// Hierarchical timer wheel. Time advances in ticks of fixed duration, and every pending timer sits in a slot of the level
+// covering its remaining delay: the first level has a slot per tick, and every slot of the following levels spans a whole
+// turn of the previous one. Whenever a level starts a new turn, the timers of the next level's current slot are spread
+// over the lower levels, so a timer is moved at most once per level before firing.
+// Scheduling and cancelling take constant time. Advancing only touches the timers that are due or being moved down, never
+// the ones waiting in other slots, however many there are.
+struct TimerWheel
+{
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS_PER_LEVEL = 1u << SLOT_BITS;
+    static constexpr uint32_t LEVEL_COUNT = 4;
+    // Longest delay a timer can be scheduled with. Longer delays are shortened to it.
+    static constexpr uint64_t MAX_DELAY_TICKS = (1ull << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+    static constexpr uint32_t NO_TIMER = ~0u;
+    static constexpr uint16_t NO_SLOT = static_cast<uint16_t>(~0u);
+
+    struct Timer
+    {
+        // Neighbours in the slot's list, or in the free list (Next only).
+        uint32_t Next;
+        uint32_t Previous;
+        uint32_t Generation;
+        uint16_t Slot; // NO_SLOT when not scheduled.
+
+        uint64_t ExpirationTick;
+        TimerCallbackFunc Callback;
+        void* Context;
+        uint64_t Payload;
+    };
+
+    Timer* Timers;
+    uint32_t MaxTimerCount;
+    uint32_t PendingTimerCount;
+    uint32_t FreeTimerHead;
+
+    // First timer of every slot, level after level.
+    uint32_t SlotHeads[LEVEL_COUNT * SLOTS_PER_LEVEL];
+
+    uint64_t CurrentTick;
+    double TickDuration; // In seconds.
+    double PendingTime; // Time passed since the current tick started, in seconds.
+
+    // Returns how much heap memory Initialize allocates for the passed maximum number of timers.
+    static size_t GetRequiredMemory(size_t MaxTimers);
+
+    // Initializes the wheel to hold up to MaxTimers pending timers at once, advancing in ticks of TickDurationSeconds.
+    bool Initialize(MemorySubsystem& Memory, size_t MaxTimers, double TickDurationSeconds);
+
+    // Schedules Callback to be called with Context and Payload once DelaySeconds have passed, rounded up to the next tick.
+    // Returns INVALID_TIMER_HANDLE if every timer is already pending.
+    TimerHandle Schedule(double DelaySeconds, TimerCallbackFunc Callback, void* Context, uint64_t Payload = 0);
+
+    // Same as Schedule, with a delay of DelayTicks whole ticks from the current one. At least one tick.
+    TimerHandle ScheduleInTicks(uint64_t DelayTicks, TimerCallbackFunc Callback, void* Context, uint64_t Payload = 0);
+
+    // Cancels the timer if it is still pending, and sets the handle to INVALID_TIMER_HANDLE in any case.
+    // Returns whether a pending timer was cancelled.
+    bool Cancel(TimerHandle& Handle);
+
+    bool IsPending(TimerHandle Handle) const;
+
+    // Returns how much time the wheel was advanced by since it was initialized, in seconds.
+    double GetTime() const { return CurrentTick * TickDuration + PendingTime; }
+
+    // Lets DeltaTime seconds pass, calling the callbacks of every timer that becomes due, tick after tick.
+    void Advance(double DeltaTime);
+
+    // Moves on to the next tick and fires every timer due on it.
+    void Tick();
+
+    void InsertTimer(uint32_t TimerIndex);
+    void RemoveTimer(uint32_t TimerIndex);
+};
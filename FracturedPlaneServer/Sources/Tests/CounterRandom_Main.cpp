@@ -0,0 +1,115 @@
+// CounterRandom_Main.cpp
+// Main Entry point of the Counter Random test, checking Philox against its known answers and batched draws against single ones.
+
+#include "ServerFramework/CounterRandom.h"
+#include "Tests/ToolArguments.h"
+
+#include "cstdint"
+#include "cstdlib"
+#include "iostream"
+#include "vector"
+
+struct RandomTestSettings
+{
+	uint64_t Seed = 12345; // Seed of the keys batched draws are checked on.
+	size_t WordCount = 1000; // Words drawn per batch.
+};
+
+// Known answers of philox4x32_10, from the Random123 test vectors (kat_vectors). Keys are given as Key[1] << 32 | Key[0].
+struct PhiloxKnownAnswer
+{
+	uint32_t Counter[4];
+	uint64_t Key;
+	uint32_t Bits[4];
+};
+
+static const PhiloxKnownAnswer PhiloxKnownAnswers[] =
+{
+	{ { 0, 0, 0, 0 }, 0, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+	{ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, 0xffffffffffffffffull, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+	{ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, 0x299f31d0a4093822ull, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+};
+
+// First words batches start at: block boundaries, and every other offset within a block.
+static const uint32_t TestFirstIndices[] = { 0, 1, 2, 3, 4, 5, 4 * 1000 + 3 };
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseTestArguments(int argc, char** argv, RandomTestSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, Words", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.Seed = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Words")) { OutSettings.WordCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	RandomTestSettings Settings;
+	if (!ParseTestArguments(argc, argv, Settings))
+	{
+		std::cerr << "Usage: FracturedPlaneCounterRandom [Seed=12345] [Words=1000]\n";
+		return 1;
+	}
+
+	size_t ErrorCount = 0;
+	for (const PhiloxKnownAnswer& KnownAnswer : PhiloxKnownAnswers)
+	{
+		uint32_t Bits[4];
+		CounterRandom::Philox4x32(KnownAnswer.Counter, KnownAnswer.Key, Bits);
+		for (int WordIndex = 0; WordIndex < 4; WordIndex++)
+		{
+			if (Bits[WordIndex] != KnownAnswer.Bits[WordIndex])
+			{
+				std::cerr << "Philox4x32-10 of counter " << std::hex << KnownAnswer.Counter[0] << " and key " << KnownAnswer.Key << " gives "
+					<< Bits[WordIndex] << " instead of " << KnownAnswer.Bits[WordIndex] << std::dec << " in word " << WordIndex << ".\n";
+				ErrorCount++;
+			}
+		}
+	}
+
+	// Batches have to come out exactly as the single draws they stand for, whatever block they start and end in.
+	RandomKey Key = { Settings.Seed, 3, 77, 0, RandomPurpose::ZONE_DEFINITION };
+	std::vector<uint32_t> Bits(Settings.WordCount);
+	for (uint32_t FirstIndex : TestFirstIndices)
+	{
+		CounterRandom::FillBits(Key, FirstIndex, Bits.data(), Bits.size());
+		for (uint32_t WordIndex = 0; WordIndex < Bits.size(); WordIndex++)
+		{
+			if (Bits[WordIndex] != CounterRandom::GetBits32(Key, FirstIndex + WordIndex))
+			{
+				std::cerr << "FillBits from word " << FirstIndex << " differs from GetBits32 on word " << FirstIndex + WordIndex << ".\n";
+				ErrorCount++;
+				break;
+			}
+		}
+
+		CounterRandom::FillTileBits(Key, FirstIndex, Bits.data(), Bits.size());
+		for (uint32_t TileIndex = 0; TileIndex < Bits.size(); TileIndex++)
+		{
+			RandomKey TileKey = Key;
+			TileKey.Tile = FirstIndex + TileIndex;
+			if (Bits[TileIndex] != CounterRandom::GetBits32(TileKey))
+			{
+				std::cerr << "FillTileBits from tile " << FirstIndex << " differs from GetBits32 on tile " << FirstIndex + TileIndex << ".\n";
+				ErrorCount++;
+				break;
+			}
+		}
+	}
+
+	if (ErrorCount > 0)
+	{
+		std::cerr << "FAILED: " << ErrorCount << " Counter Random checks failed.\n";
+		return 1;
+	}
+
+	std::cout << "Passed: " << sizeof(PhiloxKnownAnswers) / sizeof(PhiloxKnownAnswers[0]) << " Philox4x32-10 known answers, "
+		<< sizeof(TestFirstIndices) / sizeof(TestFirstIndices[0]) << " FillBits and FillTileBits batches of " << Settings.WordCount << " words.\n";
+	return 0;
+}
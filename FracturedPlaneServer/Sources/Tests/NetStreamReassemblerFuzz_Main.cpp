@@ -0,0 +1,336 @@
+// NetStreamReassemblerFuzz_Main.cpp
+// Main Entry point of the Net Stream Reassembler fuzz test, feeding random streams cut at random points to the reassembler.
+
+#include "ServerFramework/NetStreamReassembler.h"
+#include "Tests/ToolArguments.h"
+
+#include "cstdint"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "vector"
+
+struct FuzzSettings
+{
+	uint64_t Seed = 1;
+	size_t StreamCount = 2000;
+};
+
+// Small, fast generator so that any failure can be replayed from the printed seed.
+struct FuzzRandom
+{
+	uint64_t State;
+
+	uint64_t Next()
+	{
+		// SplitMix64
+		uint64_t Value = (State += 0x9E3779B97F4A7C15ull);
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	// Returns a value in [Min, Max].
+	size_t Range(size_t Min, size_t Max)
+	{
+		return Min + static_cast<size_t>(Next() % (Max - Min + 1));
+	}
+};
+
+// A packet as it was written into the stream, to compare handed out packets against.
+struct ExpectedPacket
+{
+	int32_t BodyType;
+	size_t BodySize;
+	size_t BodyOffset; // Offset of the body within the stream.
+};
+
+// A stream of encoded packets, possibly ending with a garbage head the reassembler has to reject.
+struct FuzzStream
+{
+	std::vector<byte> Data;
+	std::vector<ExpectedPacket> Packets;
+	bool bEndsWithGarbage;
+};
+
+// Writes an encoded head into Stream. The type is written as a raw integer so that invalid values can be encoded too.
+static void AppendHead(std::vector<byte>& Stream, int32_t BodyType, FPCore::Net::PacketBodySize_t BodySize)
+{
+	FPCore::Net::NetEncodedPacketHead Head;
+	static_assert(sizeof(Head.BodyType) == sizeof(BodyType), "Packet Body Type is expected to be encoded on 32 bits.");
+	memcpy(&Head.BodyType, &BodyType, sizeof(BodyType));
+	Head.BodySize = BodySize;
+
+	const byte* HeadBytes = reinterpret_cast<const byte*>(&Head);
+	Stream.insert(Stream.end(), HeadBytes, HeadBytes + sizeof(Head));
+}
+
+static void GenerateStream(FuzzRandom& Random, FuzzStream& OutStream)
+{
+	OutStream.Data.clear();
+	OutStream.Packets.clear();
+
+	size_t PacketCount = Random.Range(0, 64);
+	for (size_t PacketIndex = 0; PacketIndex < PacketCount; PacketIndex++)
+	{
+		// Mostly small packets, some empty ones and a few as large as can be encoded.
+		size_t BodySize;
+		switch (Random.Range(0, 15))
+		{
+		case 0: BodySize = 0; break;
+		case 1: BodySize = static_cast<FPCore::Net::PacketBodySize_t>(~0); break;
+		case 2: BodySize = Random.Range(1024, static_cast<FPCore::Net::PacketBodySize_t>(~0)); break;
+		default: BodySize = Random.Range(1, 256); break;
+		}
+
+		int32_t BodyType = static_cast<int32_t>(Random.Range(0, FPCore::Net::PacketBodyType::PACKET_TYPE_COUNT - 1));
+		AppendHead(OutStream.Data, BodyType, static_cast<FPCore::Net::PacketBodySize_t>(BodySize));
+
+		OutStream.Packets.push_back({ BodyType, BodySize, OutStream.Data.size() });
+		for (size_t ByteIndex = 0; ByteIndex < BodySize; ByteIndex++)
+		{
+			OutStream.Data.push_back(static_cast<byte>(Random.Next()));
+		}
+	}
+
+	// A third of the streams end with a head of invalid type followed by garbage.
+	OutStream.bEndsWithGarbage = Random.Range(0, 2) == 0;
+	if (OutStream.bEndsWithGarbage)
+	{
+		int32_t InvalidTypes[] = { FPCore::Net::PacketBodyType::INVALID, FPCore::Net::PacketBodyType::PACKET_TYPE_COUNT,
+			static_cast<int32_t>(Random.Next() | 0x80000000u), static_cast<int32_t>(Random.Range(FPCore::Net::PacketBodyType::PACKET_TYPE_COUNT, 0x7FFFFFFF)) };
+		AppendHead(OutStream.Data, InvalidTypes[Random.Range(0, 3)], static_cast<FPCore::Net::PacketBodySize_t>(Random.Next()));
+
+		size_t GarbageSize = Random.Range(0, 512);
+		for (size_t ByteIndex = 0; ByteIndex < GarbageSize; ByteIndex++)
+		{
+			OutStream.Data.push_back(static_cast<byte>(Random.Next()));
+		}
+	}
+}
+
+// Cuts the stream at random points: mostly small reads, some splitting heads, some coalescing many packets.
+static void GenerateSplitPoints(FuzzRandom& Random, size_t StreamSize, std::vector<size_t>& OutReadSizes)
+{
+	OutReadSizes.clear();
+	size_t Offset = 0;
+	while (Offset < StreamSize)
+	{
+		size_t ReadSize;
+		switch (Random.Range(0, 7))
+		{
+		case 0: ReadSize = 1; break;
+		case 1: ReadSize = Random.Range(1, sizeof(FPCore::Net::NetEncodedPacketHead) * 2); break;
+		case 2: ReadSize = Random.Range(1, 1 << 18); break;
+		default: ReadSize = Random.Range(1, 4096); break;
+		}
+
+		ReadSize = ReadSize < StreamSize - Offset ? ReadSize : StreamSize - Offset;
+		OutReadSizes.push_back(ReadSize);
+		Offset += ReadSize;
+	}
+}
+
+// Checks handed out packets against the stream, in order.
+struct PacketChecker
+{
+	const FuzzStream* Stream;
+	size_t NextPacketIndex = 0;
+	bool bFailed = false;
+
+	void Check(const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+	{
+		if (NextPacketIndex >= Stream->Packets.size())
+		{
+			std::cerr << "Reassembler handed out more packets than the stream holds.\n";
+			bFailed = true;
+			return;
+		}
+
+		const ExpectedPacket& Expected = Stream->Packets[NextPacketIndex++];
+		int32_t BodyType;
+		memcpy(&BodyType, &Head.BodyType, sizeof(BodyType));
+		if (BodyType != Expected.BodyType || Head.BodySize != Expected.BodySize
+			|| memcmp(Body, Stream->Data.data() + Expected.BodyOffset, Expected.BodySize) != 0)
+		{
+			std::cerr << "Packet " << NextPacketIndex - 1 << " doesn't match the stream: type " << BodyType << " size " << Head.BodySize
+				<< ", expected type " << Expected.BodyType << " size " << Expected.BodySize << ".\n";
+			bFailed = true;
+		}
+	}
+};
+
+// Checks the outcome of feeding a whole stream. Returns whether it is the expected one.
+static bool CheckStreamEnd(const FuzzStream& Stream, const NetStreamReassembler& Reassembler, const PacketChecker& Checker, bool bValidStream)
+{
+	if (Checker.bFailed)
+	{
+		return false;
+	}
+	if (Checker.NextPacketIndex != Stream.Packets.size())
+	{
+		std::cerr << "Reassembler handed out " << Checker.NextPacketIndex << " packets out of " << Stream.Packets.size() << ".\n";
+		return false;
+	}
+	if (bValidStream == Stream.bEndsWithGarbage)
+	{
+		std::cerr << (Stream.bEndsWithGarbage ? "Garbage was accepted.\n" : "A valid stream was rejected.\n");
+		return false;
+	}
+	if (bValidStream && Reassembler.PendingByteCount != 0)
+	{
+		std::cerr << "Reassembler kept " << Reassembler.PendingByteCount << " bytes pending at the end of a whole stream.\n";
+		return false;
+	}
+	return true;
+}
+
+// Feeds every read to Consume, as the platforms do when the reception buffer is full.
+static bool FuzzConsume(const FuzzStream& Stream, const std::vector<size_t>& ReadSizes, NetStreamReassembler& Reassembler)
+{
+	PacketChecker Checker;
+	Checker.Stream = &Stream;
+	Reassembler.Reset();
+
+	// Reads are copied out so that the reassembler can't get away with reading past them.
+	std::vector<byte> Read;
+	bool bValidStream = true;
+	size_t Offset = 0;
+	for (size_t ReadIndex = 0; ReadIndex < ReadSizes.size() && bValidStream && !Checker.bFailed; ReadIndex++)
+	{
+		Read.assign(Stream.Data.begin() + Offset, Stream.Data.begin() + Offset + ReadSizes[ReadIndex]);
+		Offset += ReadSizes[ReadIndex];
+
+		bValidStream = Reassembler.Consume(Read.data(), Read.size(),
+			[&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body) { Checker.Check(Head, Body); });
+	}
+
+	return CheckStreamEnd(Stream, Reassembler, Checker, bValidStream);
+}
+
+// Copies the pending bytes in front of every read and feeds both to ConsumeInPlace, as the platforms do when receiving
+// into their reception buffer. Every packet has to be handed out from the buffer.
+static bool FuzzConsumeInPlace(const FuzzStream& Stream, const std::vector<size_t>& ReadSizes, NetStreamReassembler& Reassembler)
+{
+	PacketChecker Checker;
+	Checker.Stream = &Stream;
+	Reassembler.Reset();
+
+	std::vector<byte> ReceptionBuffer;
+	bool bValidStream = true;
+	bool bOutOfPlace = false;
+	size_t Offset = 0;
+	for (size_t ReadIndex = 0; ReadIndex < ReadSizes.size() && bValidStream && !Checker.bFailed && !bOutOfPlace; ReadIndex++)
+	{
+		ReceptionBuffer.resize(Reassembler.PendingByteCount + ReadSizes[ReadIndex]);
+		size_t PendingByteCount = Reassembler.CopyPendingTo(ReceptionBuffer.data());
+		memcpy(ReceptionBuffer.data() + PendingByteCount, Stream.Data.data() + Offset, ReadSizes[ReadIndex]);
+		Offset += ReadSizes[ReadIndex];
+
+		const byte* BufferBegin = ReceptionBuffer.data();
+		const byte* BufferEnd = BufferBegin + ReceptionBuffer.size();
+		bValidStream = Reassembler.ConsumeInPlace(ReceptionBuffer.data(), ReceptionBuffer.size(),
+			[&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+			{
+				if (Body < BufferBegin || Body + Head.BodySize > BufferEnd)
+				{
+					std::cerr << "Packet " << Checker.NextPacketIndex << " wasn't handed out in place.\n";
+					bOutOfPlace = true;
+				}
+				Checker.Check(Head, Body);
+			});
+	}
+
+	return !bOutOfPlace && CheckStreamEnd(Stream, Reassembler, Checker, bValidStream);
+}
+
+// Feeds pure noise: nothing can be checked but that the reassembler neither crashes nor hands out bodies it doesn't hold.
+static bool FuzzNoise(FuzzRandom& Random, NetStreamReassembler& Reassembler)
+{
+	Reassembler.Reset();
+
+	std::vector<byte> Read(Random.Range(1, 8192));
+	for (byte& Byte : Read)
+	{
+		Byte = static_cast<byte>(Random.Next());
+	}
+
+	bool bOutOfBounds = false;
+	Reassembler.Consume(Read.data(), Read.size(),
+		[&](const FPCore::Net::NetEncodedPacketHead& Head, const byte* Body)
+		{
+			const byte* PendingEnd = Reassembler.PendingData + NetStreamReassembler::MAX_ENCODED_PACKET_SIZE;
+			bool bInRead = Body >= Read.data() && Body + Head.BodySize <= Read.data() + Read.size();
+			bool bInPending = Body >= Reassembler.PendingData && Body + Head.BodySize <= PendingEnd;
+			bOutOfBounds |= !bInRead && !bInPending;
+		});
+
+	if (bOutOfBounds || Reassembler.PendingByteCount > NetStreamReassembler::MAX_ENCODED_PACKET_SIZE)
+	{
+		std::cerr << "Reassembler went out of bounds on noise.\n";
+		return false;
+	}
+	return true;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseFuzzArguments(int argc, char** argv, FuzzSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, Streams", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.Seed = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Streams")) { OutSettings.StreamCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	FuzzSettings Settings;
+	if (!ParseFuzzArguments(argc, argv, Settings))
+	{
+		std::cerr << "Usage: FracturedPlaneReassemblerFuzz [Seed=1] [Streams=2000]\n";
+		return 1;
+	}
+
+	std::vector<byte> PendingMemory(NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+	NetStreamReassembler Reassembler;
+	Reassembler.Initialize(PendingMemory.data());
+
+	FuzzStream Stream;
+	std::vector<size_t> ReadSizes;
+	uint64_t FedByteCount = 0;
+	uint64_t CheckedPacketCount = 0;
+	for (size_t StreamIndex = 0; StreamIndex < Settings.StreamCount; StreamIndex++)
+	{
+		// Every stream has its own seed, so a failing one can be replayed alone.
+		uint64_t StreamSeed = Settings.Seed * 0x100000001B3ull + StreamIndex;
+		FuzzRandom Random = { StreamSeed };
+
+		GenerateStream(Random, Stream);
+		GenerateSplitPoints(Random, Stream.Data.size(), ReadSizes);
+
+		bool bPassed = FuzzConsume(Stream, ReadSizes, Reassembler);
+		bPassed = bPassed && FuzzConsumeInPlace(Stream, ReadSizes, Reassembler);
+		bPassed = bPassed && FuzzNoise(Random, Reassembler);
+		if (!bPassed)
+		{
+			std::cerr << "FAILED on stream " << StreamIndex << " (stream seed " << StreamSeed << ", " << Stream.Data.size()
+				<< " bytes in " << ReadSizes.size() << " reads, " << Stream.Packets.size() << " packets"
+				<< (Stream.bEndsWithGarbage ? ", ending with garbage" : "") << ").\n";
+			return 1;
+		}
+
+		FedByteCount += Stream.Data.size() * 2;
+		CheckedPacketCount += Stream.Packets.size() * 2;
+	}
+
+	std::cout << "Passed: " << Settings.StreamCount << " streams, " << CheckedPacketCount << " packets checked out of "
+		<< FedByteCount << " bytes fed.\n";
+	return 0;
+}
@@ -0,0 +1,141 @@
+// TerrainNoiseKernels_Main.cpp
+// Main Entry point of the Terrain Noise kernel test, checking that every kernel generates the exact same zones.
+
+#include "ServerFramework/TerrainNoise.h"
+#include "Tests/ToolArguments.h"
+
+#include "cstdint"
+#include "cstdlib"
+#include "cstring"
+#include "iostream"
+#include "vector"
+
+struct KernelTestSettings
+{
+	size_t ZoneCount = 40; // Zones generated per seed and noise setting.
+};
+
+#define KERNEL_COUNT 3
+
+static const char* KernelNames[KERNEL_COUNT] = { "scalar", "SSE2", "AVX2" };
+
+// Seeds covering zero, all bits set and everything in between.
+static const uint32_t TestSeeds[] = { 0, 1, 12345, 0xDEADBEEFu, 0xFFFFFFFFu };
+
+// Noise settings covering the World's, the largest and smallest cells, and a single octave.
+struct NoiseSettings
+{
+	uint32_t CellSizeShift;
+	uint32_t OctaveCount;
+	float VoidThreshold;
+};
+
+static const NoiseSettings TestNoiseSettings[] =
+{
+	{ 7, 6, -0.25f },
+	{ TerrainNoise::MAX_CELL_SIZE_SHIFT, TerrainNoise::MAX_CELL_SIZE_SHIFT + 1, 0.f },
+	{ 0, 1, -1.f },
+	{ 3, 2, 0.5f },
+};
+
+// Origin of the ZoneIndex-th zone tested: the world origin, the farthest zone, then zones spread all over the world.
+static void GetTestZoneOrigin(size_t ZoneIndex, uint32_t& OutOriginX, uint32_t& OutOriginY)
+{
+	const uint32_t MaxZoneCoordinate = UINT16_MAX - 1;
+	uint32_t ZoneX = ZoneIndex == 0 ? 0 : ZoneIndex == 1 ? MaxZoneCoordinate : static_cast<uint32_t>(ZoneIndex * 7919u) % MaxZoneCoordinate;
+	uint32_t ZoneY = ZoneIndex == 0 ? 0 : ZoneIndex == 1 ? MaxZoneCoordinate : static_cast<uint32_t>(ZoneIndex * 104729u) % MaxZoneCoordinate;
+	OutOriginX = ZoneX * FPCore::World::ZONE_SIZE_TILES;
+	OutOriginY = ZoneY * FPCore::World::ZONE_SIZE_TILES;
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseTestArguments(int argc, char** argv, KernelTestSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Zones", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Zones")) { OutSettings.ZoneCount = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	KernelTestSettings Settings;
+	if (!ParseTestArguments(argc, argv, Settings))
+	{
+		std::cerr << "Usage: FracturedPlaneTerrainNoiseKernels [Zones=40]\n";
+		return 1;
+	}
+
+	// The scalar kernel is the reference, and runs everywhere.
+	TerrainNoiseKernel BestKernel = TerrainNoise::GetBestKernel();
+	for (int KernelIndex = 1; KernelIndex < KERNEL_COUNT; KernelIndex++)
+	{
+		if (KernelIndex > static_cast<int>(BestKernel))
+		{
+			std::cout << "Warning: the " << KernelNames[KernelIndex] << " kernel isn't supported here and won't be checked.\n";
+		}
+	}
+
+	std::vector<uint16_t> Elevations[KERNEL_COUNT];
+	std::vector<byte> VoidTileBitmasks[KERNEL_COUNT];
+	for (int KernelIndex = 0; KernelIndex < KERNEL_COUNT; KernelIndex++)
+	{
+		Elevations[KernelIndex].resize(FPCore::World::TILES_PER_ZONE);
+		VoidTileBitmasks[KernelIndex].resize(FPCore::World::TILES_PER_ZONE / 8);
+	}
+
+	size_t CheckedZoneCount = 0;
+	for (const NoiseSettings& Noise : TestNoiseSettings)
+	{
+		for (uint32_t Seed : TestSeeds)
+		{
+			for (size_t ZoneIndex = 0; ZoneIndex < Settings.ZoneCount; ZoneIndex++)
+			{
+				uint32_t OriginX;
+				uint32_t OriginY;
+				GetTestZoneOrigin(ZoneIndex, OriginX, OriginY);
+
+				// Flat, regular and the widest elevation ranges.
+				uint16_t MinimumElevation = ZoneIndex % 3 == 2 ? 0 : 500;
+				uint16_t MaximumElevation = ZoneIndex % 3 == 2 ? UINT16_MAX : ZoneIndex % 3 == 1 ? 500 : 3000;
+
+				for (int KernelIndex = 0; KernelIndex <= static_cast<int>(BestKernel); KernelIndex++)
+				{
+					TerrainNoise Terrain;
+					if (!Terrain.Initialize(Seed, Noise.CellSizeShift, Noise.OctaveCount, Noise.VoidThreshold, static_cast<TerrainNoiseKernel>(KernelIndex)))
+					{
+						return 1;
+					}
+
+					// Every kernel starts from different garbage, so that a tile left unwritten can't match by chance.
+					memset(Elevations[KernelIndex].data(), 0xA0 + KernelIndex, Elevations[KernelIndex].size() * sizeof(uint16_t));
+					memset(VoidTileBitmasks[KernelIndex].data(), 0xC0 + KernelIndex, VoidTileBitmasks[KernelIndex].size());
+					Terrain.GenerateZone(OriginX, OriginY, MinimumElevation, MaximumElevation, Elevations[KernelIndex].data(),
+						VoidTileBitmasks[KernelIndex].data());
+				}
+
+				for (int KernelIndex = 1; KernelIndex <= static_cast<int>(BestKernel); KernelIndex++)
+				{
+					if (memcmp(Elevations[0].data(), Elevations[KernelIndex].data(), Elevations[0].size() * sizeof(uint16_t)) != 0
+						|| memcmp(VoidTileBitmasks[0].data(), VoidTileBitmasks[KernelIndex].data(), VoidTileBitmasks[0].size()) != 0)
+					{
+						std::cerr << "FAILED: the " << KernelNames[KernelIndex] << " kernel differs from the scalar one on the zone at tile "
+							<< OriginX << ", " << OriginY << " (seed " << Seed << ", cells of 2^" << Noise.CellSizeShift << " tiles, "
+							<< Noise.OctaveCount << " octaves, elevations " << MinimumElevation << " to " << MaximumElevation << ").\n";
+						return 1;
+					}
+				}
+				CheckedZoneCount++;
+			}
+		}
+	}
+
+	std::cout << "Passed: " << CheckedZoneCount << " zones generated the same by every supported kernel, up to "
+		<< KernelNames[static_cast<int>(BestKernel)] << ".\n";
+	return 0;
+}
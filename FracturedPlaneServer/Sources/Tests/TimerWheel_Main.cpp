@@ -0,0 +1,250 @@
+// TimerWheel_Main.cpp
+// Main Entry point of the Timer Wheel test, checking random timers against a sorted reference queue, tick after tick.
+
+#include "ServerFramework/Subsystems/Core/MemorySubsystem.h"
+#include "ServerFramework/TimerWheel.h"
+#include "Tests/ToolArguments.h"
+
+#include "cstdint"
+#include "cstdlib"
+#include "iostream"
+#include "set"
+#include "utility"
+#include "vector"
+
+struct TimerTestSettings
+{
+	uint64_t Seed = 1;
+	size_t TimerCount = 100000; // Timers scheduled over the whole run, callbacks included.
+	uint64_t MaxDelayTicks = 300000; // Crosses into the last level of the wheel.
+};
+
+#define TEST_TICK_DURATION 0.01
+#define MAX_SCHEDULED_PER_TICK 8
+
+// Small, fast generator so that a failing run can be replayed from the printed seed.
+struct TestRandom
+{
+	uint64_t State;
+
+	uint64_t Next()
+	{
+		// SplitMix64
+		uint64_t Value = (State += 0x9E3779B97F4A7C15ull);
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	// Returns a value in [Min, Max].
+	uint64_t Range(uint64_t Min, uint64_t Max)
+	{
+		return Min + Next() % (Max - Min + 1);
+	}
+};
+
+struct TestTimer
+{
+	TimerHandle Handle;
+	uint64_t ExpirationTick;
+	bool bPending;
+};
+
+// The wheel under test, and every timer it was given in scheduling order. Reference holds the pending ones, sorted by
+// expiration tick then scheduling order.
+struct TimerTestState
+{
+	TimerTestSettings Settings;
+	TestRandom Random;
+	TimerWheel Wheel;
+	std::vector<TestTimer> Timers;
+	std::set<std::pair<uint64_t, uint32_t>> Reference;
+
+	size_t ErrorCount = 0;
+	size_t FiredCount = 0;
+	size_t CancelledCount = 0;
+	size_t CascadeCancelledCount = 0; // Cancelled from callbacks, on ticks where the wheel moved timers down.
+	size_t LevelCrossingCount = 0; // Scheduled past the first level.
+};
+
+static void ReportError(TimerTestState& State, const char* Error, uint32_t TimerID)
+{
+	if (State.ErrorCount++ < 10)
+	{
+		std::cerr << "Tick " << State.Wheel.CurrentTick << ", timer " << TimerID << ": " << Error << "\n";
+	}
+}
+
+// Picks a delay on either side of a level boundary, one making the timer expire around a tick where a level starts a
+// new turn, or any delay up to the maximum.
+static uint64_t PickDelay(TimerTestState& State)
+{
+	uint64_t MaxDelay = State.Settings.MaxDelayTicks;
+	uint64_t Delay;
+	switch (State.Random.Range(0, 3))
+	{
+	case 0:
+		Delay = (1ull << (TimerWheel::SLOT_BITS * State.Random.Range(1, TimerWheel::LEVEL_COUNT - 1))) + State.Random.Range(0, 2) - 1;
+		break;
+	case 1:
+	{
+		uint64_t TurnTicks = 1ull << (TimerWheel::SLOT_BITS * State.Random.Range(1, TimerWheel::LEVEL_COUNT - 1));
+		uint64_t NextTurnTick = (State.Wheel.CurrentTick / TurnTicks + State.Random.Range(1, 2)) * TurnTicks;
+		Delay = NextTurnTick + State.Random.Range(0, 2) - 1 - State.Wheel.CurrentTick;
+		break;
+	}
+	case 2:
+		Delay = State.Random.Range(1, TimerWheel::SLOTS_PER_LEVEL);
+		break;
+	default:
+		Delay = State.Random.Range(1, MaxDelay);
+		break;
+	}
+	return Delay < 1 ? 1 : Delay > MaxDelay ? MaxDelay : Delay;
+}
+
+static void OnTimerFired(void* Context, uint64_t Payload);
+
+static void ScheduleTestTimer(TimerTestState& State)
+{
+	uint32_t TimerID = static_cast<uint32_t>(State.Timers.size());
+	uint64_t Delay = PickDelay(State);
+	TimerHandle Handle = State.Wheel.ScheduleInTicks(Delay, OnTimerFired, &State, TimerID);
+	if (Handle.Index == INVALID_TIMER_HANDLE.Index)
+	{
+		ReportError(State, "couldn't be scheduled.", TimerID);
+		return;
+	}
+
+	State.Timers.push_back({ Handle, State.Wheel.CurrentTick + Delay, true });
+	State.Reference.insert({ State.Wheel.CurrentTick + Delay, TimerID });
+	State.LevelCrossingCount += Delay >= TimerWheel::SLOTS_PER_LEVEL ? 1 : 0;
+}
+
+// Cancels the timer through a copy of its handle, which has to succeed exactly when the reference has it pending.
+static void CancelTestTimer(TimerTestState& State, uint32_t TimerID)
+{
+	TestTimer& Timer = State.Timers[TimerID];
+	TimerHandle Handle = Timer.Handle;
+	if (State.Wheel.Cancel(Handle) != Timer.bPending)
+	{
+		ReportError(State, Timer.bPending ? "wasn't pending anymore when cancelled." : "was cancelled after it fired or was cancelled.", TimerID);
+	}
+
+	if (Timer.bPending)
+	{
+		Timer.bPending = false;
+		State.Reference.erase({ Timer.ExpirationTick, TimerID });
+		State.CancelledCount++;
+	}
+}
+
+static void OnTimerFired(void* Context, uint64_t Payload)
+{
+	TimerTestState& State = *static_cast<TimerTestState*>(Context);
+	uint32_t TimerID = static_cast<uint32_t>(Payload);
+	TestTimer& Timer = State.Timers[TimerID];
+	if (!Timer.bPending)
+	{
+		ReportError(State, "fired after it fired or was cancelled.", TimerID);
+		return;
+	}
+	if (Timer.ExpirationTick != State.Wheel.CurrentTick)
+	{
+		ReportError(State, "fired on the wrong tick.", TimerID);
+	}
+
+	Timer.bPending = false;
+	State.Reference.erase({ Timer.ExpirationTick, TimerID });
+	State.FiredCount++;
+
+	// On ticks where a level starts a new turn, cancel the next timers due, which were just moved down or are due on this
+	// very tick, and schedule new ones in their place.
+	if (State.Wheel.CurrentTick % TimerWheel::SLOTS_PER_LEVEL == 0 && State.Random.Range(0, 1) == 0)
+	{
+		if (!State.Reference.empty())
+		{
+			CancelTestTimer(State, State.Reference.begin()->second);
+			State.CascadeCancelledCount++;
+		}
+		if (State.Timers.size() < State.Settings.TimerCount)
+		{
+			ScheduleTestTimer(State);
+		}
+	}
+}
+
+// Reads "Key=Value" arguments into OutSettings. Returns false on any unknown key or invalid value.
+static bool ParseTestArguments(int argc, char** argv, TimerTestSettings& OutSettings)
+{
+	return ParseToolArguments(argc, argv, "Seed, Timers, MaxDelay", [&OutSettings](const ToolArgument& Argument)
+	{
+		if (Argument.KeyIs("Seed")) { OutSettings.Seed = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("Timers")) { OutSettings.TimerCount = strtoull(Argument.Value, nullptr, 10); }
+		else if (Argument.KeyIs("MaxDelay")) { OutSettings.MaxDelayTicks = strtoull(Argument.Value, nullptr, 10); }
+		else
+		{
+			return false;
+		}
+		return true;
+	});
+}
+
+int main(int argc, char** argv)
+{
+	TimerTestState State;
+	if (!ParseTestArguments(argc, argv, State.Settings) || State.Settings.TimerCount == 0 || State.Settings.MaxDelayTicks == 0
+		|| State.Settings.MaxDelayTicks > TimerWheel::MAX_DELAY_TICKS)
+	{
+		std::cerr << "Usage: FracturedPlaneTimerWheel [Seed=1] [Timers=100000] [MaxDelay=300000]\n";
+		std::cerr << "MaxDelay is at most " << TimerWheel::MAX_DELAY_TICKS << " ticks.\n";
+		return 1;
+	}
+	State.Random = { State.Settings.Seed };
+	State.Timers.reserve(State.Settings.TimerCount);
+
+	// Every timer may be pending at once.
+	std::vector<uint8_t> Heap(MemorySubsystem::GetRequiredHeapSize(TimerWheel::GetRequiredMemory(State.Settings.TimerCount)));
+	MemorySubsystem Memory;
+	if (!Memory.Initialize(Heap.data(), Heap.size()) || !State.Wheel.Initialize(Memory, State.Settings.TimerCount, TEST_TICK_DURATION))
+	{
+		std::cerr << "Failed to initialize the Timer Wheel.\n";
+		return 1;
+	}
+
+	while (State.ErrorCount == 0 && (State.Timers.size() < State.Settings.TimerCount || !State.Reference.empty()))
+	{
+		for (uint64_t NewTimer = State.Random.Range(0, MAX_SCHEDULED_PER_TICK); NewTimer > 0 && State.Timers.size() < State.Settings.TimerCount; NewTimer--)
+		{
+			ScheduleTestTimer(State);
+		}
+
+		// Cancel any timer given so far: pending ones have to go, the others must be left alone.
+		if (!State.Timers.empty() && State.Random.Range(0, 3) == 0)
+		{
+			CancelTestTimer(State, static_cast<uint32_t>(State.Random.Range(0, State.Timers.size() - 1)));
+		}
+
+		State.Wheel.Tick();
+
+		if (!State.Reference.empty() && State.Reference.begin()->first <= State.Wheel.CurrentTick)
+		{
+			ReportError(State, "didn't fire when due.", State.Reference.begin()->second);
+		}
+		if (State.Wheel.PendingTimerCount != State.Reference.size() && State.ErrorCount++ < 10)
+		{
+			std::cerr << "Tick " << State.Wheel.CurrentTick << ": " << State.Wheel.PendingTimerCount << " timers pending instead of "
+				<< State.Reference.size() << ".\n";
+		}
+	}
+
+	std::cout << State.Timers.size() << " timers over " << State.Wheel.CurrentTick << " ticks: " << State.FiredCount << " fired, "
+		<< State.CancelledCount << " cancelled (" << State.CascadeCancelledCount << " from callbacks on cascading ticks), "
+		<< State.LevelCrossingCount << " scheduled past the first level.\n";
+	if (State.ErrorCount > 0)
+	{
+		std::cerr << "FAILED: " << State.ErrorCount << " timers disagreed with the reference queue (seed " << State.Settings.Seed << ").\n";
+		return 1;
+	}
+	return 0;
+}
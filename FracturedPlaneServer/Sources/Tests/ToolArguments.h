@@ -0,0 +1,49 @@
+// ToolArguments.h
+// Parsing of the "Key=Value" command line arguments taken by the Server's tools, benchmarks and tests.
+
+#pragma once
+
+#include "cstddef"
+#include "cstring"
+#include "iostream"
+
+// A single "Key=Value" argument. Value points right after the '=' within Text.
+struct ToolArgument
+{
+	const char* Text;
+	size_t KeyLength;
+	const char* Value;
+
+	bool KeyIs(const char* Key) const
+	{
+		return strlen(Key) == KeyLength && strncmp(Text, Key, KeyLength) == 0;
+	}
+};
+
+// Hands every argument to ReadArgument(const ToolArgument&), which returns false for unknown keys and invalid values.
+// KnownKeys is listed to the user when an argument can't be read. Returns false on the first argument that isn't in
+// Key=Value form or that ReadArgument rejects.
+template<typename ReaderType>
+bool ParseToolArguments(int argc, char** argv, const char* KnownKeys, ReaderType ReadArgument)
+{
+	for (int ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+	{
+		ToolArgument Argument;
+		Argument.Text = argv[ArgIndex];
+		Argument.Value = strchr(Argument.Text, '=');
+		if (nullptr == Argument.Value)
+		{
+			std::cerr << "Invalid argument '" << Argument.Text << "', expected Key=Value.\n";
+			return false;
+		}
+		Argument.KeyLength = Argument.Value - Argument.Text;
+		Argument.Value++;
+
+		if (!ReadArgument(Argument))
+		{
+			std::cerr << "Invalid argument '" << Argument.Text << "'. Known keys: " << KnownKeys << ".\n";
+			return false;
+		}
+	}
+	return true;
+}
@@ -1,7 +1,9 @@
 // Win32_Main.cpp
 // Main Entry point of program when running on Windows.
 
+#include "ServerFramework/PlatformThreadTable.h"
 #include "ServerFramework/ServerPlatform.h"
+#include "ServerFramework/TickScheduler.h"
 #include "iostream"
 
 #define WIN32_LEAN_AND_MEAN
@@ -23,7 +25,41 @@ void OutputDebugStreamToSystemDebug()
 static bool bServerShutdown = false;
 static SYSTEM_INFO SystemInfo;
 
-void EndProgram()
+// Threads are Win32 threads, whose handles are closed once they have been waited on.
+static PlatformThreadTable<HANDLE> PlatformThreads;
+
+DWORD WINAPI PlatformThread_Func(void* Param)
+{
+	PlatformThreadTable<HANDLE>::Thread& Thread = *static_cast<PlatformThreadTable<HANDLE>::Thread*>(Param);
+	Thread.Func(Thread.Param);
+	return 0;
+}
+
+ServerPlatform::ThreadID Win32_CreateThread(void (*Func)(void*), void* Param)
+{
+	return PlatformThreads.Create(Func, Param, [](PlatformThreadTable<HANDLE>::Thread& Thread)
+	{
+		Thread.Handle = CreateThread(nullptr, 0, PlatformThread_Func, &Thread, 0, nullptr);
+		if (nullptr == Thread.Handle)
+		{
+			std::cerr << "Failed to create platform thread. Error Code: " << GetLastError() << "\n";
+			return false;
+		}
+		return true;
+	});
+}
+
+// Waits for the thread's function to return then releases its ID. The ID is set to Invalid afterwards.
+void Win32_DestroyThread(ServerPlatform::ThreadID& ThreadToDestroy)
+{
+	PlatformThreads.Destroy(ThreadToDestroy, [](HANDLE& Handle)
+	{
+		WaitForSingleObject(Handle, INFINITE);
+		CloseHandle(Handle);
+	});
+}
+
+void EndProgram(ServerPlatform& Platform)
 {
 	// Make sure to flush all debug before exiting process.
 
@@ -34,14 +70,21 @@ void EndProgram()
 #endif
 
 	// Free up all system resources
-	// ...
+	// Release Server memory as a whole rather than having the Server clear it.
+	if (nullptr != Platform.Memory)
+	{
+		VirtualFree(Platform.Memory, 0, MEM_RELEASE);
+		Platform.Memory = nullptr;
+		Platform.MemorySize = 0;
+	}
 }
 
-extern bool Win32Net_Init();
+extern bool Win32Net_Init(const ServerConfig& Config);
 extern void Win32Net_RegisterPlatformFunctions(ServerPlatform& Platform);
+extern HANDLE Win32Net_GetServerWorkEvent();
 
 // Initialize Win32 Platform & return ServerPlatform data structure. Returns whether initialization was successful.
-bool Win32_InitPlatform(ServerPlatform& OutPlatform)
+bool Win32_InitPlatform(ServerPlatform& OutPlatform, const ServerConfig& Config)
 {
 	std::cout << "Initializing Win32 Platform...\n";
 
@@ -56,11 +99,13 @@ bool Win32_InitPlatform(ServerPlatform& OutPlatform)
 	// can run at all, and if it can, how well and how much memory it should take up.
 	// In turn the resources the server requests should depend on what we want it to do (game world size, max player
 	// count...)
-	size_t RequestedServerMemory = GetRequiredServerMemory();
+	size_t RequestedServerMemory = GetRequiredServerMemory(Config);
 
 	// Allocate memory at minimum application address.
 	OutPlatform.Memory = static_cast<byte*>(VirtualAlloc(nullptr, RequestedServerMemory, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));	
 	OutPlatform.MemorySize = RequestedServerMemory;
+	// Committed pages are zero-initialized by the OS, and only get backed by physical memory when first accessed.
+	OutPlatform.bMemoryZeroed = true;
 
 	if (nullptr == OutPlatform.Memory)
 	{
@@ -71,9 +116,11 @@ bool Win32_InitPlatform(ServerPlatform& OutPlatform)
 	// Prepare Data Storage
 
 	// Prepare Threading Services
+	OutPlatform.CreateThread = Win32_CreateThread;
+	OutPlatform.DestroyThread = Win32_DestroyThread;
 
 	// Prepare Network Services & Data
-	if (!Win32Net_Init())
+	if (!Win32Net_Init(Config))
 	{
 		std::cerr << "Failed to initialize Win32 Networking.\n";
 		return false;
@@ -104,40 +151,69 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 #endif
 
 	
+	// Server Config. Not loaded from a file on Windows yet, defaults are used.
+	ServerConfig Config;
+
+	// Run a job worker per processor.
+	{
+		SYSTEM_INFO ProcessorInfo;
+		GetSystemInfo(&ProcessorInfo);
+		Config.JobWorkerCount = ProcessorInfo.dwNumberOfProcessors;
+	}
+
 	// Platform Initialization
 	ServerPlatform Platform;
-	if (!Win32_InitPlatform(Platform))
+	if (!Win32_InitPlatform(Platform, Config))
 	{
 		std::cerr << "Win32 Platform Initialization failed ! Ending program...\n";
-		EndProgram();
+		EndProgram(Platform);
 		return 1;
 	}
 
 	// Initialize Time Tracking Data
-	LARGE_INTEGER LastUpdateBeginCounter, CurrentUpdateBeginCounter;
-	QueryPerformanceCounter(&LastUpdateBeginCounter);
-	QueryPerformanceCounter(&CurrentUpdateBeginCounter);
-
-	double dCounterFrequency = 0.f;
 	LARGE_INTEGER iCounterFreq;
+	QueryPerformanceFrequency(&iCounterFreq);
+	double dCounterFrequency = static_cast<double>(iCounterFreq.QuadPart);
+
+	auto GetMonotonicTimeSeconds = [dCounterFrequency]()
 	{
-		QueryPerformanceFrequency(&iCounterFreq);
-		dCounterFrequency = static_cast<float>(iCounterFreq.QuadPart);
-	}
+		LARGE_INTEGER Counter;
+		QueryPerformanceCounter(&Counter);
+		return static_cast<double>(Counter.QuadPart) / dCounterFrequency;
+	};
 
 	// Server Initialization - Call linked InitializeServer function and retrieve a GameServerPtr pointer (void*)
 	// that can be passed to further Server Flow Control calls.
 	std::cout << "Initializing Server...\n";
 	GameServerPtr Server;
-	if (!InitializeServer(Platform, Server))
+	if (!InitializeServer(Platform, Config, Server))
 	{
 		std::cout << "Failed to initialize server. Shutting program down.\n";
-		EndProgram();
+		EndProgram(Platform);
 		return 1;
 	}
 
 	// Platform & Server Main loop
-	double UpdateDeltaTime = 0.f;
+	// The Server ticks at a fixed rate, always passed the same DeltaTime. Between ticks, the main thread sleeps on a
+	// waitable timer until the next one is due, unless window messages come in or the network posts work for the Server
+	// first: that work is then handled right away, by an update that lets no time pass.
+	TickScheduler Scheduler;
+	// High resolution timers go off on time rather than on the next system timer interrupt, up to 15.6ms later.
+	HANDLE TickTimer = CreateWaitableTimerEx(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (nullptr == TickTimer)
+	{
+		TickTimer = CreateWaitableTimer(nullptr, false, nullptr);
+	}
+	if (nullptr == TickTimer || !Scheduler.Initialize(Config.TickRate, GetMonotonicTimeSeconds()))
+	{
+		std::cerr << "Failed to schedule Server ticks. Shutting program down.\n";
+		ShutdownServer(Server, ShutdownReason::PLATFORM_SHUTDOWN);
+		EndProgram(Platform);
+		return 1;
+	}
+
+	HANDLE WaitedHandles[2] = { TickTimer, Win32Net_GetServerWorkEvent() };
+	DWORD WaitedHandleCount = Config.TickWakeOnNetwork != 0 ? 2 : 1;
 	while (!bServerShutdown)
 	{
 		// Catch window events
@@ -147,25 +223,40 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 			TranslateMessage(&WindowMessage);
 			DispatchMessage(&WindowMessage);
 		}
-		
-		QueryPerformanceCounter(&CurrentUpdateBeginCounter);
-		int Delta = CurrentUpdateBeginCounter.QuadPart - LastUpdateBeginCounter.QuadPart;
-		UpdateDeltaTime = static_cast<double>(Delta) / dCounterFrequency;
-		
-		// Enforce a time between updates of at least 1ms. We don't need such a larger level of precision for time updates on the main thread.
-		if (Delta < iCounterFreq.QuadPart / 1000) 
+
+		double Now = GetMonotonicTimeSeconds();
+		if (!Scheduler.IsTickDue(Now))
+		{
+			// Due times are relative when negative, in 100ns units.
+			LARGE_INTEGER DueTime;
+			DueTime.QuadPart = -static_cast<LONGLONG>((Scheduler.NextTickTime - Now) * 1e7) - 1;
+			SetWaitableTimer(TickTimer, &DueTime, 0, nullptr, nullptr, false);
+
+			DWORD WaitResult = MsgWaitForMultipleObjects(WaitedHandleCount, WaitedHandles, false, INFINITE, QS_ALLINPUT);
+			Now = GetMonotonicTimeSeconds();
+			if (WaitResult == WAIT_OBJECT_0 + 1 && !Scheduler.IsTickDue(Now))
+			{
+				// The Server Work event reset itself when ending the wait.
+				UpdateServer(Server, 0.0);
+				Scheduler.WakeUpdateCount++;
+				continue;
+			}
+		}
+
+		if (Scheduler.IsTickDue(Now))
 		{
-			// Sleeping and ensuring updates don't happen too often should help avoid pointlessly consuming power for a level of precision we do not require.
-			Sleep(1);
-			UpdateDeltaTime += 0.001;
+			// This update handles any work posted before it reads net data.
+			ResetEvent(WaitedHandles[1]);
+			UpdateServer(Server, Scheduler.BeginTick(Now));
+			Scheduler.EndTick(Now, GetMonotonicTimeSeconds());
 		}
-		UpdateServer(Server, UpdateDeltaTime);
-		LastUpdateBeginCounter = CurrentUpdateBeginCounter;
 	}
+	CloseHandle(TickTimer);
 
 	// Cleanup & Shutdown
+	Scheduler.PrintStats();
 	ShutdownServer(Server, ShutdownReason::UNKNOWN);
-	EndProgram();
+	EndProgram(Platform);
 
 #ifdef USE_CONSOLE
 	system("pause");
@@ -4,12 +4,15 @@
 #include "Windows.h"
 #include "WinSock2.h"
 
+#include "atomic"
 #include "iostream"
 #include "mutex"
+#include "new"
+#include "type_traits"
 
 #include "ServerFramework/ServerPlatform.h"
-
-#define MAX_ACTIVE_CONNECTION_COUNT 256
+#include "ServerFramework/NetStreamReassembler.h"
+#include "ServerFramework/SPSCRing.h"
 
 bool bListenThreadRunning = false;
 HANDLE ListenThreadHandle = 0;
@@ -27,161 +30,480 @@ struct Win32NetConnection
 	SOCKET SocketHandle;
 	sockaddr_in Address;
 	char AddressString[128];
+
+	// Set by any thread wanting the connection closed, so that it only gets queued once.
+	std::atomic<bool> bCloseRequested;
+
+	// Zero byte receive, completing on the Reception Completion Port once data is available. Touched by the Reception
+	// Thread alone. A connection keeps its ID until its receive has completed, so that no completion can ever reach the
+	// next connection given the same ID.
+	WSAOVERLAPPED ReceptionOverlapped;
+	bool bReceptionArmed;
+	bool bClosing; // Socket was closed, waiting for the completion of its receive.
 };
 
-std::mutex Mutex_ClientConnectionData;
+// Connection IDs are indices into every per-connection table below, which all hold MaxConnectionCount entries. The
+// tables are carved out of a single allocation made when initializing, sized from the Server Config.
+size_t MaxConnectionCount = 0;
+byte* ConnectionTablesMemory = nullptr;
 
-Win32NetConnection ActiveConnections[MAX_ACTIVE_CONNECTION_COUNT];
-WSAEVENT ConnectionEventHandles[MAX_ACTIVE_CONNECTION_COUNT];
+Win32NetConnection* ActiveConnections = nullptr;
 
-// Contains IDs of Sockets that are awaiting Acknowledgement by the Server.
-ServerPlatform::ConnectionID PendingConnectionEvents[MAX_ACTIVE_CONNECTION_COUNT];
-int PendingConnectionEventsCount = 0;
+// IDs available to new connections, produced by the Server in ClearNetEvents and consumed by the Reception Thread. A
+// closed connection's ID only comes back once the Server has read its Disconnection event, so the Server never sees
+// events of two different connections mixed up.
+SPSCRing<ServerPlatform::ConnectionID> FreeConnectionIDRing;
 
-// Contains IDs of Sockets that have disconnected and need to noticed by the Server and cleaned up. 
-ServerPlatform::ConnectionID PendingDisconnectionEvents[MAX_ACTIVE_CONNECTION_COUNT];
-int PendingDisconnectionEventsCount = 0;
+// ID taken from the free ring but left unused, to be given to the next accepted connection. Reception Thread only.
+ServerPlatform::ConnectionID SpareConnectionID = ServerPlatform::INVALID_ID;
 
-std::mutex Mutex_NetDataReception;
+// A socket accepted by the Listen Thread, waiting for the Reception Thread to give it a connection ID.
+struct Win32AcceptedSocket
+{
+	SOCKET SocketHandle;
+	sockaddr_in Address;
+	int AddressLength;
+};
+
+// Sockets accepted by the Listen Thread, handed over to the Reception Thread. The Listen Thread never touches connection
+// data, which is owned by the Reception Thread alone.
+SPSCRing<Win32AcceptedSocket> AcceptedSocketRing;
+
+// Connection & Disconnection events, only ever pushed by the Reception Thread and consumed by the Server in
+// ReadNetEvents. A connection ID has at most one event of each type in flight, so the rings can never be full.
+SPSCRing<ServerPlatform::ConnectionID> ConnectionEventRing;
+SPSCRing<ServerPlatform::ConnectionID> DisconnectionEventRing;
+
+// Events handed over to the Server by the last ReadNetEvents call. Only accessed by the Server thread.
+ServerPlatform::ConnectionID* ReadConnectionEvents = nullptr;
+size_t ReadConnectionEventsCount = 0;
+ServerPlatform::ConnectionID* ReadDisconnectionEvents = nullptr;
+size_t ReadDisconnectionEventsCount = 0;
+
+// Connections other threads asked to close, in request order, closed by the Reception Thread when it wakes up. A
+// connection is queued once per raised request flag, and a stale request may linger for a reused ID, hence room for two
+// requests per connection.
+std::mutex Mutex_CloseRequests;
+ServerPlatform::ConnectionID* CloseRequests = nullptr;
+size_t CloseRequestCount = 0;
+ServerPlatform::ConnectionID* HandledCloseRequests = nullptr; // Copy of the queue being handled. Reception Thread only.
+
+// Every connection's socket is associated with the Reception Completion Port, with its ID as completion key. The
+// Reception Thread blocks on the port until a connection has data, or until another thread wakes it up by posting the
+// wake key, however many connections are open.
+HANDLE ReceptionCompletionPort = nullptr;
+#define RECEPTION_WAKE_COMPLETION_KEY (~static_cast<ULONG_PTR>(0))
+
+// Completions dequeued by a single wait.
+#define RECEPTION_COMPLETION_BATCH_SIZE 64
 
 // #TODO(Marc): Read those from config file ! + Define on Server Platform as Server will also need to know the encoding type for packet size.
 #define RECEPTION_BUFFER_SIZE (1024 * 64) // 64kb
 static_assert(RECEPTION_BUFFER_SIZE % sizeof(FPCore::Net::PacketBodySize_t) == 0, "STATIC ASSERTION FAILURE: RECEPTION_BUFFER_SIZE must be dividable by PACKET_MAX_SIZE !");
 
-uint8_t ReceptionBuffer[RECEPTION_BUFFER_SIZE];
-size_t ReceivedBytes = 0; // Bytes received since last Reception Buffer Clear.
+// Received data is double buffered: the Reception Thread fills one buffer while the Server reads the other. Buffers are
+// swapped when the Server starts reading, so reception never has to wait for the Server to be done with its data.
+#define RECEPTION_BUFFER_COUNT 2
 
-std::mutex Mutex_NetDataSending;
-HANDLE Event_DataReadyForSending; // When signaled, the Sending Thread will seek to send out data while locking access to the Sending Buffer in the process.
+// Packets are received straight into a Reception Buffer and left there. Each is described by a Packet Descriptor, which
+// is all the Server reads before going for the body. Every packet takes at least a head's worth of data, which bounds
+// how many descriptors a buffer may need.
+#define MAX_PACKETS_PER_RECEPTION_BUFFER (RECEPTION_BUFFER_SIZE / sizeof(FPCore::Net::NetEncodedPacketHead))
+
+struct ReceptionBufferData
+{
+	alignas(FPCore::Net::NetEncodedPacketHead) uint8_t Data[RECEPTION_BUFFER_SIZE];
+	size_t ReceivedBytes; // Bytes received since this buffer was last handed over to the Server.
+
+	NetPacketDescriptor Packets[MAX_PACKETS_PER_RECEPTION_BUFFER];
+	size_t PacketCount;
+};
+
+ReceptionBufferData ReceptionBuffers[RECEPTION_BUFFER_COUNT];
+
+// Only guards the index of the buffer being written to, the writing itself and the counters. Never held while the Server
+// processes received data.
+std::mutex Mutex_NetDataReception;
+size_t WriteReceptionBufferIndex = 0;
+NetReceptionStats ReceptionStats = {};
+
+// Incomplete packets received on each connection, waiting for the rest of their bytes. Reset when a connection is
+// accepted, otherwise only touched by the thread receiving data.
+NetStreamReassembler* ConnectionReassemblers = nullptr;
 
 // #TODO(Marc): Read those from config file !
 #define SENDING_BUFFER_SIZE (1024 * 64)
 
-// Contains all data to be sent to active net connections. Sent continuously by the Sending thread.
-uint8_t SendingBuffer[SENDING_BUFFER_SIZE];
-size_t BytesToSend = 0;
+// Outgoing data is written by the Server into one of several Sending Slots. Filled slots are handed over to the Sending
+// Thread, which sends them out in order then hands them back, so the Server never waits on a slow socket.
+#define SENDING_SLOT_COUNT 4
+#define INVALID_SENDING_SLOT 0xFF
 
-// #TODO(Marc): Should the Reception or even the Connection & Disconnection buffers be Double-buffered instead of locked ?
-// I guess it depends on how long the server is going to take to process the data. We don't want to risk losing connections because we take too long to receive data
-// in a TCP context.
+// Every packet is at least a head, which bounds how many packets a single Sending Slot can hold.
+#define MAX_PACKETS_PER_SENDING_SLOT (SENDING_BUFFER_SIZE / sizeof(FPCore::Net::PacketHead))
 
-ServerPlatform::ConnectionID FindAvailableClientIndex()
+struct SendingSlot
+{
+	alignas(FPCore::Net::PacketHead) uint8_t Data[SENDING_BUFFER_SIZE];
+	size_t BytesToSend;
+};
+
+SendingSlot SendingSlots[SENDING_SLOT_COUNT];
+
+FixedSPSCRing<uint8_t, SENDING_SLOT_COUNT> FilledSendingSlotRing; // Server -> Sending Thread.
+FixedSPSCRing<uint8_t, SENDING_SLOT_COUNT> FreeSendingSlotRing; // Sending Thread -> Server.
+uint8_t WriteSendingSlotIndex = INVALID_SENDING_SLOT; // Slot currently being filled. Only accessed by the Server thread.
+
+// Per-connection bookkeeping used to group the packets of a Sending Slot by connection. Only accessed by the Sending
+// Thread, and left zeroed between slots.
+ServerPlatform::ConnectionID* DestinationConnections = nullptr; // In order of first packet.
+size_t* ConnectionPacketCounts = nullptr;
+size_t* ConnectionNextPacketIndices = nullptr;
+
+HANDLE Event_DataReadyForSending; // When signaled, the Sending Thread will send out every filled slot.
+HANDLE Event_ServerWorkPosted; // Signaled whenever network threads hand the Server new work, waking the main loop up before its next tick.
+
+// Lays every per-connection table out from Base and returns the size they take altogether. Only measures them when Base
+// is null.
+size_t LayOutConnectionTables(byte* Base)
 {
-	for (ServerPlatform::ConnectionID ClientIndex = 0; ClientIndex < MAX_ACTIVE_CONNECTION_COUNT; ClientIndex++)
+	size_t LayoutSize = 0;
+	auto PlaceTable = [Base, &LayoutSize](auto*& OutTable, size_t Count)
+	{
+		typedef typename std::remove_reference<decltype(*OutTable)>::type TableEntry;
+		LayoutSize = (LayoutSize + alignof(TableEntry) - 1) & ~(alignof(TableEntry) - 1);
+		OutTable = nullptr == Base ? nullptr : reinterpret_cast<TableEntry*>(Base + LayoutSize);
+		LayoutSize += Count * sizeof(TableEntry);
+	};
+
+	size_t EventRingCapacity = SPSCRing<ServerPlatform::ConnectionID>::GetCapacityFor(MaxConnectionCount);
+	ServerPlatform::ConnectionID* FreeConnectionIDSlots;
+	Win32AcceptedSocket* AcceptedSocketSlots;
+	ServerPlatform::ConnectionID* ConnectionEventSlots;
+	ServerPlatform::ConnectionID* DisconnectionEventSlots;
+	byte* ReassemblyMemory;
+
+	PlaceTable(ActiveConnections, MaxConnectionCount);
+	PlaceTable(FreeConnectionIDSlots, EventRingCapacity);
+	PlaceTable(AcceptedSocketSlots, EventRingCapacity);
+	PlaceTable(ConnectionEventSlots, EventRingCapacity);
+	PlaceTable(DisconnectionEventSlots, EventRingCapacity);
+	PlaceTable(ReadConnectionEvents, MaxConnectionCount);
+	PlaceTable(ReadDisconnectionEvents, MaxConnectionCount);
+	PlaceTable(CloseRequests, MaxConnectionCount * 2);
+	PlaceTable(HandledCloseRequests, MaxConnectionCount * 2);
+	PlaceTable(ConnectionReassemblers, MaxConnectionCount);
+	PlaceTable(DestinationConnections, MaxConnectionCount);
+	PlaceTable(ConnectionPacketCounts, MaxConnectionCount);
+	PlaceTable(ConnectionNextPacketIndices, MaxConnectionCount);
+	PlaceTable(ReassemblyMemory, MaxConnectionCount * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
+
+	if (nullptr != Base)
 	{
-		if (ActiveConnections[ClientIndex].SocketHandle == INVALID_SOCKET)
+		FreeConnectionIDRing.Initialize(FreeConnectionIDSlots, EventRingCapacity);
+		AcceptedSocketRing.Initialize(AcceptedSocketSlots, EventRingCapacity);
+		ConnectionEventRing.Initialize(ConnectionEventSlots, EventRingCapacity);
+		DisconnectionEventRing.Initialize(DisconnectionEventSlots, EventRingCapacity);
+
+		for (size_t ConnectionIndex = 0; ConnectionIndex < MaxConnectionCount; ConnectionIndex++)
 		{
-			return ClientIndex;
+			new (&ConnectionReassemblers[ConnectionIndex]) NetStreamReassembler();
+			ConnectionReassemblers[ConnectionIndex].Initialize(ReassemblyMemory + ConnectionIndex * NetStreamReassembler::MAX_ENCODED_PACKET_SIZE);
 		}
 	}
 
+	return LayoutSize;
+}
+
+// Returns an ID for a new connection, or INVALID_ID if every ID is in use. Only called from the Reception Thread.
+ServerPlatform::ConnectionID FindAvailableClientIndex()
+{
+	ServerPlatform::ConnectionID ClientIndex = SpareConnectionID;
+	if (ClientIndex != ServerPlatform::INVALID_ID)
+	{
+		SpareConnectionID = ServerPlatform::INVALID_ID;
+		return ClientIndex;
+	}
+
+	if (FreeConnectionIDRing.Pop(ClientIndex))
+	{
+		return ClientIndex;
+	}
+
 	std::cerr << "Error: Maximum number of connections reached!\n";
-	return -1;
+	return ServerPlatform::INVALID_ID;
+}
+
+// Wakes the Reception Thread up so it handles work other threads handed over. Callable from any thread.
+void WakeReceptionThread()
+{
+	PostQueuedCompletionStatus(ReceptionCompletionPort, 0, RECEPTION_WAKE_COMPLETION_KEY, nullptr);
+}
+
+// Queues a Disconnection event for the Server, so that the disconnection can be acknowledged, at which point the ID will
+// be released. If the Server has not read the Connection event yet, it will read both at once.
+void QueueDisconnectionEvent(ServerPlatform::ConnectionID ConnectionID)
+{
+	if (!DisconnectionEventRing.Push(ConnectionID))
+	{
+		std::cerr << "Error: Disconnection Event ring is full ! Connection ID " << ConnectionID << " will not be released.\n";
+	}
+	SetEvent(Event_ServerWorkPosted);
 }
 
-// Disconnects / handles disconnection without clearing the associated data unless it has not been acknowledged
-// by the Server yet. Assumes the Client Connection Data Mutex has been appropriately locked.
+// Closes the connection's socket and queues a Disconnection event for the Server. The connection ID stays reserved
+// until the Server has read the event. Only called from the Reception Thread. A connection still receiving only gets its
+// event queued once the aborted receive has completed.
 void Disconnect(ServerPlatform::ConnectionID ConnectionID)
 {
-	if (ActiveConnections[ConnectionID].SocketHandle == INVALID_SOCKET)
+	if (ConnectionID >= MaxConnectionCount || ActiveConnections[ConnectionID].SocketHandle == INVALID_SOCKET)
 	{
 		return;
 	}
 
 	WSASendDisconnect(ActiveConnections[ConnectionID].SocketHandle, nullptr);
 	
-	// Close the associated socket.
+	// Close the associated socket, which aborts its receive.
 	closesocket(ActiveConnections[ConnectionID].SocketHandle);
 
-	// Close associated Event handle.
-	WSACloseEvent(ConnectionEventHandles[ConnectionID]);
-	
-	// Check that disconnected Connection isn't within the Pending Connection Events queue.
-	// If it is, then set the handle in the queue as Invalid and immediately clear the Client Data.
-	int QueueIndex;
-	for(QueueIndex = 0; QueueIndex < PendingConnectionEventsCount; QueueIndex++)
-	{
-		if (PendingConnectionEvents[QueueIndex] == ActiveConnections[ConnectionID].ID)
-		{
-			PendingConnectionEvents[QueueIndex] = ServerPlatform::INVALID_ID;
-			break;
-		}
-	}
-	
-	// If not, Add client to Disconnection queue so that its disconnection can be acknowledged by the Server, at
-	// which point its data will be cleared.
-	if (QueueIndex == PendingConnectionEventsCount)
-	{
-		PendingDisconnectionEvents[PendingDisconnectionEventsCount] = ConnectionID;
-		PendingDisconnectionEventsCount++;
-	}
-
 	// Clear connection data
-	ServerPlatform::ConnectionID ClosedSocketHandle = ActiveConnections[ConnectionID].SocketHandle;
+	SOCKET ClosedSocketHandle = ActiveConnections[ConnectionID].SocketHandle;
 	ActiveConnections[ConnectionID].SocketHandle = INVALID_SOCKET;
 	ActiveConnections[ConnectionID].Address = {};
 	memset(ActiveConnections[ConnectionID].AddressString, 0, sizeof(ActiveConnections[ConnectionID].AddressString));
-	
-	ConnectionEventHandles[ConnectionID] = 0;
 
 	std::cout << "Socket ID " << ClosedSocketHandle << " closed.\n"; 
+
+	if (ActiveConnections[ConnectionID].bReceptionArmed)
+	{
+		ActiveConnections[ConnectionID].bClosing = true;
+		return;
+	}
+	QueueDisconnectionEvent(ConnectionID);
+}
+
+// Posts a zero byte receive on the connection, which completes on the Reception Completion Port as soon as data is
+// available, without holding any buffer while waiting. Returns false if the receive could not be posted.
+bool ArmReception(ServerPlatform::ConnectionID ConnectionID)
+{
+	Win32NetConnection& Connection = ActiveConnections[ConnectionID];
+
+	WSABUF EmptyBuffer = { 0, nullptr };
+	DWORD ReceivedBytesCount = 0;
+	DWORD Flags = 0;
+	memset(&Connection.ReceptionOverlapped, 0, sizeof(Connection.ReceptionOverlapped));
+	if (WSARecv(Connection.SocketHandle, &EmptyBuffer, 1, &ReceivedBytesCount, &Flags, &Connection.ReceptionOverlapped, nullptr) == SOCKET_ERROR
+		&& WSAGetLastError() != WSA_IO_PENDING)
+	{
+		std::cerr << "Error when posting a receive on Connection ID " << ConnectionID << " ! Error Code: " << WSAGetLastError() << "\n";
+		return false;
+	}
+
+	Connection.bReceptionArmed = true;
+	return true;
 }
 
-void HandleNetData(ServerPlatform::ConnectionID ConnectionID, const char* DataPtr, size_t DataSize)
+// Platform-facing version of Disconnect, callable from any thread. Queues a close request and wakes the Reception Thread
+// up so it closes the connection.
+void CloseConnection(ServerPlatform::ConnectionID ConnectionID)
 {
-	// Check that we have enough memory left in the Reception Buffer for the data itself plus the Connection ID and Data Size indicators.
-	size_t TotalRequiredBytes = DataSize + sizeof(FPCore::Net::NetEncodedPacketHead) + sizeof(ServerPlatform::ConnectionID);
-	if (TotalRequiredBytes > RECEPTION_BUFFER_SIZE - ReceivedBytes)
+	if (ConnectionID >= MaxConnectionCount
+		|| ActiveConnections[ConnectionID].bCloseRequested.exchange(true, std::memory_order_acq_rel))
 	{
-		std::cerr << "Out of memory on Win32Net Reception Buffer.\n";
+		// Already on its way to being closed.
 		return;
 	}
 
-	// Lock access to Reception Buffer for reminder of the function.
-	std::lock_guard<std::mutex> Lock(Mutex_NetDataReception);
-	
-	// Write received data into reception buffer.
 	{
-		bool AbortReception = false;
+		std::lock_guard<std::mutex> Lock(Mutex_CloseRequests);
+		if (CloseRequestCount == MaxConnectionCount * 2)
+		{
+			std::cerr << "Error: Close Request queue is full ! Connection ID " << ConnectionID << " will not be closed.\n";
+			return;
+		}
+		CloseRequests[CloseRequestCount++] = ConnectionID;
+	}
+
+	WakeReceptionThread();
+}
+
+// Closes every connection queued by CloseConnection since the last wake-up. Only called from the Reception Thread.
+void HandleCloseRequests()
+{
+	size_t HandledCloseRequestCount;
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_CloseRequests);
+		HandledCloseRequestCount = CloseRequestCount;
+		memcpy(HandledCloseRequests, CloseRequests, HandledCloseRequestCount * sizeof(ServerPlatform::ConnectionID));
+		CloseRequestCount = 0;
+	}
 
-		// Cache the current state of the Reception Buffer in case we need to abort the entire reception midway through.
-		size_t PreReadReceivedBytes = ReceivedBytes;
-		size_t ReadBytes = 0;
-		while(ReadBytes < DataSize)
+	for (size_t RequestIndex = 0; RequestIndex < HandledCloseRequestCount; RequestIndex++)
+	{
+		// Requests left over from a previous connection with the same ID had their flag cleared when the ID got reused.
+		ServerPlatform::ConnectionID ConnectionID = HandledCloseRequests[RequestIndex];
+		if (ActiveConnections[ConnectionID].bCloseRequested.exchange(false, std::memory_order_acquire))
 		{
-			const byte* ReadAddress = reinterpret_cast<const byte*>(DataPtr) + ReadBytes;
+			Disconnect(ConnectionID);
+		}
+	}
+}
 
-			// Extract a Net Encoded Packet. If it is valid, build a final Packet from it and add it to the Reception buffer.
+// Gives every socket the Listen Thread accepted since the last wake-up a connection ID, starts receiving on it and queues
+// its Connection event for the Server. Pushing both event types from this thread alone keeps a connection's Connection
+// event ahead of its Disconnection event. Only called from the Reception Thread.
+void HandleAcceptedSockets()
+{
+	Win32AcceptedSocket AcceptedSocket;
+	while (AcceptedSocketRing.Pop(AcceptedSocket))
+	{
+		// Attempt to find an available Client ID.
+		ServerPlatform::ConnectionID ConnectionID = FindAvailableClientIndex();
+
+		// No ID found, likely because capacity was reached. Turn down connection.
+		if (ConnectionID == ServerPlatform::INVALID_ID)
+		{
+			std::cerr << "Maximum Client Capacity reached !\n";
 			
-			const FPCore::Net::NetEncodedPacketHead& EncodedPacket = *reinterpret_cast<const FPCore::Net::NetEncodedPacketHead*>(ReadAddress);
-			if (EncodedPacket.BodyType == FPCore::Net::PacketBodyType::INVALID
-				|| EncodedPacket.BodyType >= FPCore::Net::PacketBodyType::PACKET_TYPE_COUNT)
+			WSASendDisconnect(AcceptedSocket.SocketHandle, nullptr);
+			closesocket(AcceptedSocket.SocketHandle);
+			continue;
+		}
+
+		// Initialize newly connected Client Data
+		{
+			ActiveConnections[ConnectionID].ID = ConnectionID;
+			ActiveConnections[ConnectionID].SocketHandle = AcceptedSocket.SocketHandle;
+			ActiveConnections[ConnectionID].Address = AcceptedSocket.Address;
+			ConnectionReassemblers[ConnectionID].Reset();
+			ActiveConnections[ConnectionID].bCloseRequested.store(false, std::memory_order_relaxed);
+			ActiveConnections[ConnectionID].bReceptionArmed = false;
+			ActiveConnections[ConnectionID].bClosing = false;
+
+			memset(ActiveConnections[ConnectionID].AddressString, 0, sizeof(ActiveConnections[ConnectionID].AddressString));
+			DWORD AddressStringLen = sizeof(ActiveConnections[ConnectionID].AddressString);
+			WSAAddressToStringA(reinterpret_cast<sockaddr*>(&AcceptedSocket.Address), AcceptedSocket.AddressLength, NULL, ActiveConnections[ConnectionID].AddressString, &AddressStringLen);
+		}
+
+		// Start receiving. Reception drains sockets until they would block, and sends never wait on a slow client.
+		{
+			ULONG NonBlocking = 1;
+			bool bReceiving = ioctlsocket(AcceptedSocket.SocketHandle, FIONBIO, &NonBlocking) == 0
+				&& nullptr != CreateIoCompletionPort(reinterpret_cast<HANDLE>(AcceptedSocket.SocketHandle), ReceptionCompletionPort, ConnectionID, 0)
+				&& ArmReception(ConnectionID);
+			if (!bReceiving)
 			{
-				AbortReception = true;
-				break;
+				std::cerr << "Error when starting reception on Connection ID " << ConnectionID << " ! Error Code: " << WSAGetLastError() << "\n";
+				closesocket(AcceptedSocket.SocketHandle);
+				ActiveConnections[ConnectionID].SocketHandle = INVALID_SOCKET;
+				SpareConnectionID = ConnectionID;
+				continue;
 			}
+		}
 
-			FPCore::Net::PacketHead* WritePacketAddress = reinterpret_cast<FPCore::Net::PacketHead*>(ReceptionBuffer + ReceivedBytes);
-			WritePacketAddress->ConnectionID = ConnectionID;
-			WritePacketAddress->BodyType = EncodedPacket.BodyType;
-			WritePacketAddress->BodySize = EncodedPacket.BodySize;
+		// Print newly connected socket handle & address
+		std::cout << "New Connection established. [ID " << ConnectionID
+		<< " |ADDR " << ActiveConnections[ConnectionID].AddressString
+		<< " |HANDLE " << ActiveConnections[ConnectionID].SocketHandle
+		<< "]\n";
 
-			memcpy(ReceptionBuffer + ReceivedBytes + sizeof(FPCore::Net::PacketHead), ReadAddress + sizeof(FPCore::Net::NetEncodedPacketHead), WritePacketAddress->BodySize);
-			WritePacketAddress->BodyStart = ReceptionBuffer + ReceivedBytes + sizeof(FPCore::Net::PacketHead);
-			
-			ReadBytes += sizeof(FPCore::Net::NetEncodedPacketHead) + EncodedPacket.BodySize;
-			ReceivedBytes += sizeof(FPCore::Net::PacketHead) + WritePacketAddress->BodySize;
-		}
-		
-		if (AbortReception)
+		// Add Client to Connection ring for acknowledgement by the server.
+		if (!ConnectionEventRing.Push(ConnectionID))
 		{
-			// Something didn't line up when decoding the received packets. In this case, abort the entire reception.
-			// And close the connection.
-			ReceivedBytes = PreReadReceivedBytes;
-			std::cerr << "Win32Net Error when receiving packets from Connection ID " << ConnectionID << ". Aborting reception.\n";
+			std::cerr << "Error: Connection Event ring is full ! Dropping Connection ID " << ConnectionID << ".\n";
 			Disconnect(ConnectionID);
+			continue;
+		}
+		SetEvent(Event_ServerWorkPosted);
+	}
+}
+
+// Receives the next bytes available on a connection and describes every packet they complete in the Reception Buffer
+// being written to. Bytes are received straight into the Reception Buffer, right after a copy of the connection's
+// incomplete packet, so that every packet body is handed to the Server where it was received.
+// When the Reception Buffer can't hold the incomplete packet once complete, bytes are received into the Overflow Buffer
+// instead and the packets they complete are dropped, which keeps the stream in sync.
+// Returns the result of the WSARecv call, and the received byte count in OutReceivedBytesCount.
+int ReceiveNetData(ServerPlatform::ConnectionID ConnectionID, char* OverflowBuffer, size_t OverflowBufferSize, DWORD& OutReceivedBytesCount)
+{
+	// Lock access to the Reception Buffer being written to for reminder of the function.
+	std::lock_guard<std::mutex> Lock(Mutex_NetDataReception);
+
+	ReceptionBufferData& WriteBuffer = ReceptionBuffers[WriteReceptionBufferIndex];
+	NetStreamReassembler& Reassembler = ConnectionReassemblers[ConnectionID];
+	SOCKET SocketHandle = ActiveConnections[ConnectionID].SocketHandle;
+
+	bool bValidStream;
+	DWORD Flags = 0;
+	OutReceivedBytesCount = 0;
+
+	size_t FreeBytes = RECEPTION_BUFFER_SIZE - WriteBuffer.ReceivedBytes;
+	size_t RequiredBytes = Reassembler.GetPendingPacketSize();
+	if (RequiredBytes <= Reassembler.PendingByteCount)
+	{
+		RequiredBytes = Reassembler.PendingByteCount + 1;
+	}
+
+	if (RequiredBytes > FreeBytes)
+	{
+		WSABUF WSAReceptionBuffer;
+		WSAReceptionBuffer.buf = OverflowBuffer;
+		WSAReceptionBuffer.len = static_cast<ULONG>(OverflowBufferSize);
+
+		int Result = WSARecv(SocketHandle, &WSAReceptionBuffer, 1, &OutReceivedBytesCount, &Flags, NULL, NULL);
+		if (Result != 0 || OutReceivedBytesCount == 0)
+		{
+			return Result;
+		}
+
+		bValidStream = Reassembler.Consume(reinterpret_cast<const byte*>(OverflowBuffer), OutReceivedBytesCount,
+			[&](const FPCore::Net::NetEncodedPacketHead& EncodedPacket, const byte* Body)
+			{
+				std::cerr << "Out of memory on Win32Net Reception Buffer.\n";
+				ReceptionStats.DroppedReceptionCount++;
+				ReceptionStats.DroppedByteCount += sizeof(FPCore::Net::NetEncodedPacketHead) + EncodedPacket.BodySize;
+			});
+	}
+	else
+	{
+		byte* ReceptionStart = WriteBuffer.Data + WriteBuffer.ReceivedBytes;
+		size_t PendingByteCount = Reassembler.CopyPendingTo(ReceptionStart);
+
+		WSABUF WSAReceptionBuffer;
+		WSAReceptionBuffer.buf = reinterpret_cast<CHAR*>(ReceptionStart + PendingByteCount);
+		WSAReceptionBuffer.len = static_cast<ULONG>(FreeBytes - PendingByteCount);
+
+		int Result = WSARecv(SocketHandle, &WSAReceptionBuffer, 1, &OutReceivedBytesCount, &Flags, NULL, NULL);
+		if (Result != 0 || OutReceivedBytesCount == 0)
+		{
+			return Result;
 		}
+
+		// Describe each packet and leave it where it is. The Reception Buffer only keeps up to the end of the last complete
+		// packet: the reassembler holds on to the rest.
+		bValidStream = Reassembler.ConsumeInPlace(ReceptionStart, PendingByteCount + OutReceivedBytesCount,
+			[&](const FPCore::Net::NetEncodedPacketHead& EncodedPacket, const byte* Body)
+			{
+				NetPacketDescriptor& Packet = WriteBuffer.Packets[WriteBuffer.PacketCount++];
+				Packet.ConnectionID = ConnectionID;
+				Packet.BodySize = EncodedPacket.BodySize;
+				Packet.BodyOffset = static_cast<uint32_t>(Body - WriteBuffer.Data);
+				Packet.BodyType = EncodedPacket.BodyType;
+
+				WriteBuffer.ReceivedBytes = Packet.BodyOffset + Packet.BodySize;
+				ReceptionStats.ReceivedPacketCount++;
+			});
+	}
+
+	if (!bValidStream)
+	{
+		// Something didn't line up when decoding the received packets. Packets before the faulty one were kept, but
+		// nothing else can be trusted on this stream: close the connection.
+		std::cerr << "Win32Net Error when receiving packets from Connection ID " << ConnectionID << ". Aborting reception.\n";
+		Disconnect(ConnectionID);
 	}
+
+	return 0;
 }
 
 void HandleNetDisconnection(ServerPlatform::ConnectionID DisconnectedSocketID)
@@ -190,11 +512,62 @@ void HandleNetDisconnection(ServerPlatform::ConnectionID DisconnectedSocketID)
 	Disconnect(DisconnectedSocketID);
 }
 
+// Handles the completion of a connection's zero byte receive: receives everything available on the connection then posts
+// the next receive, or finishes closing the connection if it was closed in the meantime.
+void HandleReceptionCompletion(ServerPlatform::ConnectionID ConnectionID, char* OverflowBuffer, size_t OverflowBufferSize)
+{
+	Win32NetConnection& Connection = ActiveConnections[ConnectionID];
+	Connection.bReceptionArmed = false;
+
+	if (Connection.bClosing)
+	{
+		// Last completion of a closed connection: nothing can reach this ID anymore, let the Server release it.
+		Connection.bClosing = false;
+		QueueDisconnectionEvent(ConnectionID);
+		return;
+	}
+
+	// Receive data into reception buffer until the socket would block. Errors the zero byte receive completed with are
+	// reported by the first actual receive.
+	while (Connection.SocketHandle != INVALID_SOCKET)
+	{
+		DWORD ReceivedBytesCount = 0;
+		if (ReceiveNetData(ConnectionID, OverflowBuffer, OverflowBufferSize, ReceivedBytesCount) != 0)
+		{
+			int ErrorCode = WSAGetLastError();
+			if (ErrorCode == WSAEWOULDBLOCK)
+			{
+				if (!ArmReception(ConnectionID))
+				{
+					Disconnect(ConnectionID);
+				}
+				return;
+			}
+
+			// Log the error and close the connection.
+			// #TODO(Marc): Some error types are relatively normal and probably shouldn't warrant a log line.
+			std::cerr << "Error when receiving data from Connection ID " << ConnectionID << " ! Error Code: " << ErrorCode << std::endl;
+			HandleNetDisconnection(ConnectionID);
+			return;
+		}
+
+		// It is possible to receive 0 bytes which is a signal for a "Polite goodbye".
+		if (ReceivedBytesCount == 0)
+		{
+			HandleNetDisconnection(ConnectionID);
+			return;
+		}
+
+		SetEvent(Event_ServerWorkPosted);
+	}
+}
+
 // Server listener thread handling new connection requests coming in.
 DWORD WINAPI ListenThread_Func(void* Param)
 {
 	// Create Listen Socket
-	SOCKET ListenSocket = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, nullptr, 0, 0);
+	// Accepted sockets inherit its attributes: they have to support overlapped receives.
+	SOCKET ListenSocket = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, nullptr, 0, WSA_FLAG_OVERLAPPED);
 	if (ListenSocket == INVALID_SOCKET)
 	{
 		std::cerr << "Error creating Listen Socket. Error Code : " << WSAGetLastError() << "\n";
@@ -234,51 +607,16 @@ DWORD WINAPI ListenThread_Func(void* Param)
 			continue;
 		}
 
-		// Lock access to Client Connection Data for the remainder of the scope.
-		std::lock_guard<std::mutex> lock(Mutex_ClientConnectionData);
-		
-		// Attempt to find an available Client ID.
-		ServerPlatform::ConnectionID ConnectionID = FindAvailableClientIndex();
-
-		// Safety checks that could lead to early-refusal of connection.
-		if (ConnectionID < 0 // No ID found, likely because capacity was reached. Turn down connection.
-			|| PendingConnectionEventsCount >= MAX_ACTIVE_CONNECTION_COUNT) // Platform at capacity on pending connections. Turn down connection.
+		// Hand the socket over to the Reception Thread, which gives it an ID, starts receiving and lets the Server know.
+		if (!AcceptedSocketRing.Push({ ConnectedSocket, ConnectedAddr, AddressLen }))
 		{
-			std::cerr << "Maximum Client or Pending Connection Event Capacity reached !\n";
-			
+			std::cerr << "Accepted Socket ring is full ! Turning connection down.\n";
+
 			WSASendDisconnect(ConnectedSocket, nullptr);
 			closesocket(ConnectedSocket);
 			continue;
 		}
-
-		// Initialize newly connected Client Data
-		{
-			ActiveConnections[ConnectionID].ID = ConnectionID;
-			ActiveConnections[ConnectionID].SocketHandle = ConnectedSocket;
-			ActiveConnections[ConnectionID].Address = ConnectedAddr;
-
-			memset(ActiveConnections[ConnectionID].AddressString, 0, sizeof(ActiveConnections[ConnectionID].AddressString));
-			DWORD AddressStringLen = sizeof(ActiveConnections[ConnectionID].AddressString);
-			WSAAddressToStringA(reinterpret_cast<sockaddr*>(&ConnectedAddr), AddressLen, NULL, ActiveConnections[ConnectionID].AddressString, &AddressStringLen);
-		}
-
-		// Initialize newly connected Client Events
-		{
-			ConnectionEventHandles[ConnectionID] = WSACreateEvent();
-			WSAEventSelect(ActiveConnections[ConnectionID].SocketHandle, ConnectionEventHandles[ConnectionID], FD_READ | FD_CLOSE);
-		}
-		
-		// Print newly connected socket handle & address
-		std::cout << "New Connection established. [ID " << ConnectionID
-		<< " |ADDR " << ActiveConnections[ConnectionID].AddressString
-		<< " |HANDLE " << ActiveConnections[ConnectionID].SocketHandle
-		<< "]\n";
-
-		// Add Client to Connection Queue for acknowledgement by the server.
-		{
-			PendingConnectionEvents[PendingConnectionEventsCount] = ConnectionID;
-			PendingConnectionEventsCount++;
-		}
+		WakeReceptionThread();
 	}
 
 	bListenThreadRunning = false;
@@ -290,11 +628,8 @@ DWORD WINAPI ListenThread_Func(void* Param)
 // Server reception thread handling incoming data from existing connections.
 DWORD WINAPI ReceptionThread_Func(void* Param)
 {
-	char PacketReceptionBuffer[1 << 16];
-
-	WSABUF WSAReceptionBuffer;
-	WSAReceptionBuffer.buf = PacketReceptionBuffer;
-	WSAReceptionBuffer.len = sizeof(PacketReceptionBuffer);
+	static char OverflowBuffer[1 << 16];
+	static OVERLAPPED_ENTRY Completions[RECEPTION_COMPLETION_BATCH_SIZE];
 
 	bReceptionThreadRunning = true;
 	
@@ -302,78 +637,117 @@ DWORD WINAPI ReceptionThread_Func(void* Param)
 	// Data races on this are not really a concern since only this thread ever sets this to true and only initially.
 	while (bReceptionThreadRunning)
 	{
-		// Continually check for events signaling data is ready to be received.
-
-		WSANETWORKEVENTS NetworkEvents = { 0 };
+		// Catch up on work other threads handed over since the last wake-up.
+		HandleAcceptedSockets();
+		HandleCloseRequests();
 
-		// Build an array containing all currently active event handles in sequence and count how many there are.
-		WSAEVENT ActiveHandles[MAX_ACTIVE_CONNECTION_COUNT];
-		int ActiveHandleCount = 0;
-
-		for (WSAEVENT& ConnectedClientEventHandle : ConnectionEventHandles)
+		// Wait for connections to have data, or for the thread to be woken up.
+		ULONG CompletionCount = 0;
+		if (!GetQueuedCompletionStatusEx(ReceptionCompletionPort, Completions, RECEPTION_COMPLETION_BATCH_SIZE, &CompletionCount, INFINITE, false))
 		{
-			if (nullptr != ConnectedClientEventHandle)
-			{
-				ActiveHandles[ActiveHandleCount] = ConnectedClientEventHandle;
-				ActiveHandleCount++;
-			}
+			std::cerr << "Error when waiting on the Reception Completion Port ! Error Code: " << GetLastError() << "\n";
+			continue;
 		}
-		
-		// Wait for up to one second for new events to come in.
-		DWORD WaitResult = WSAWaitForMultipleEvents(ActiveHandleCount, ActiveHandles, false, 1000, false);
-		
-		if (WaitResult >= WSA_WAIT_EVENT_0 && WaitResult < WSA_WAIT_EVENT_0 + MAX_ACTIVE_CONNECTION_COUNT)
-		{
-			// Event successfuly came in.
-			
-			// Lock access to Client Connection Data for the remainder of the scope.
-			std::lock_guard<std::mutex> lock(Mutex_ClientConnectionData);
-			
-			// Client ID == Event Handle Index so a direct conversion is good.
-			ServerPlatform::ConnectionID ConnectionID = WaitResult - WSA_WAIT_EVENT_0;
 
-			// Determine which event(s) were triggered.
-			WSAEnumNetworkEvents(ActiveConnections[ConnectionID].SocketHandle, ConnectionEventHandles[ConnectionID], &NetworkEvents);
-
-			if (NetworkEvents.lNetworkEvents && FD_READ)
-			{
-				// Receive data into reception buffer and broadcast it.
-				DWORD ReceivedBytesCount = 0;
-				DWORD Flags = 0;
-				if (WSARecv(ActiveConnections[ConnectionID].SocketHandle, &WSAReceptionBuffer, 1, &ReceivedBytesCount, &Flags, NULL, NULL) == 0)
-				{
-					// It is possible to receive 0 bytes which is a signal for a "Polite goodbye".
-					if (ReceivedBytesCount > 0)
-					{
-						HandleNetData(ConnectionID, WSAReceptionBuffer.buf, ReceivedBytesCount);
-					}
-					else
-					{
-						HandleNetDisconnection(ConnectionID);
-					}
-				}
-				else
-				{
-					// Log the error and close the connection.
-					// #TODO(Marc): Some error types are relatively normal and probably shouldn't warrant a log line.
-					std::cerr << "Error when receiving data from Connection ID " << ConnectionID << " ! Error Code: " << WSAGetLastError() << std::endl;
-					HandleNetDisconnection(ConnectionID);
-				}
-			}
-			else if (NetworkEvents.lNetworkEvents && FD_CLOSE)
+		for (ULONG CompletionIndex = 0; CompletionIndex < CompletionCount; CompletionIndex++)
+		{
+			// Wake-ups only make the thread catch up at the top of the loop.
+			if (Completions[CompletionIndex].lpCompletionKey != RECEPTION_WAKE_COMPLETION_KEY)
 			{
-				HandleNetDisconnection(ConnectionID);
+				ServerPlatform::ConnectionID ConnectionID = static_cast<ServerPlatform::ConnectionID>(Completions[CompletionIndex].lpCompletionKey);
+				HandleReceptionCompletion(ConnectionID, OverflowBuffer, sizeof(OverflowBuffer));
 			}
 		}
 
 		// No matter what, simply loop back and start waiting again unless the Reception thread was disabled for some reason.
-		memset(PacketReceptionBuffer, 0, sizeof(PacketReceptionBuffer));
 	}
 	
 	bReceptionThreadRunning = false;
 	return 0;
 }
 
+// Sends out every packet contained in a filled Sending Slot.
+// Packets are grouped by connection, keeping their order, and each connection gets all of its packets in a single
+// scatter-gather call: encoded heads are built on the side and bodies are sent straight from the slot.
+void SendSlotData(const SendingSlot& Slot)
+{
+	static const byte* PacketLocations[MAX_PACKETS_PER_SENDING_SLOT];
+	static FPCore::Net::NetEncodedPacketHead EncodedPacketHeads[MAX_PACKETS_PER_SENDING_SLOT];
+	static WSABUF PacketBuffers[MAX_PACKETS_PER_SENDING_SLOT * 2]; // Head then body of each packet.
+
+	// Find every packet to send and count them per connection.
+	size_t PacketCount = 0;
+	size_t DestinationConnectionCount = 0;
+	size_t SendingBufferReadingOffset = 0;
+	while(SendingBufferReadingOffset < Slot.BytesToSend)
+	{
+		const byte* PacketLocation = Slot.Data + SendingBufferReadingOffset;
+		const FPCore::Net::PacketHead& OutgoingPacket = *reinterpret_cast<const FPCore::Net::PacketHead*>(PacketLocation);
+		SendingBufferReadingOffset += sizeof(FPCore::Net::PacketHead) + OutgoingPacket.BodySize;
+
+		if (OutgoingPacket.ConnectionID >= MaxConnectionCount)
+		{
+			continue;
+		}
+
+		if (ConnectionPacketCounts[OutgoingPacket.ConnectionID]++ == 0)
+		{
+			DestinationConnections[DestinationConnectionCount++] = OutgoingPacket.ConnectionID;
+		}
+		PacketLocations[PacketCount++] = PacketLocation;
+	}
+
+	// Give each connection a contiguous range of packets.
+	size_t FirstPacketIndex = 0;
+	for (size_t DestinationIndex = 0; DestinationIndex < DestinationConnectionCount; DestinationIndex++)
+	{
+		ServerPlatform::ConnectionID ConnectionID = DestinationConnections[DestinationIndex];
+		ConnectionNextPacketIndices[ConnectionID] = FirstPacketIndex;
+		FirstPacketIndex += ConnectionPacketCounts[ConnectionID];
+	}
+
+	// Encode packet heads and point the buffers at them and at the bodies.
+	for (size_t PacketLocationIndex = 0; PacketLocationIndex < PacketCount; PacketLocationIndex++)
+	{
+		const byte* PacketLocation = PacketLocations[PacketLocationIndex];
+		const FPCore::Net::PacketHead& OutgoingPacket = *reinterpret_cast<const FPCore::Net::PacketHead*>(PacketLocation);
+		size_t PacketIndex = ConnectionNextPacketIndices[OutgoingPacket.ConnectionID]++;
+
+		FPCore::Net::NetEncodedPacketHead& EncodedOutgoingPacket = EncodedPacketHeads[PacketIndex];
+		EncodedOutgoingPacket.BodyType = OutgoingPacket.BodyType;
+		EncodedOutgoingPacket.BodySize = OutgoingPacket.BodySize;
+
+		PacketBuffers[PacketIndex * 2].buf = reinterpret_cast<CHAR*>(&EncodedOutgoingPacket);
+		PacketBuffers[PacketIndex * 2].len = sizeof(EncodedOutgoingPacket);
+		PacketBuffers[PacketIndex * 2 + 1].buf = reinterpret_cast<CHAR*>(const_cast<byte*>(PacketLocation + sizeof(FPCore::Net::PacketHead)));
+		PacketBuffers[PacketIndex * 2 + 1].len = OutgoingPacket.BodySize;
+	}
+
+	// Send each connection its packets.
+	FirstPacketIndex = 0;
+	for (size_t DestinationIndex = 0; DestinationIndex < DestinationConnectionCount; DestinationIndex++)
+	{
+		ServerPlatform::ConnectionID ConnectionID = DestinationConnections[DestinationIndex];
+		size_t ConnectionPacketCount = ConnectionPacketCounts[ConnectionID];
+		WSABUF* ConnectionBuffers = PacketBuffers + FirstPacketIndex * 2;
+		FirstPacketIndex += ConnectionPacketCount;
+		ConnectionPacketCounts[ConnectionID] = 0;
+
+		SOCKET OutgoingSocket = ActiveConnections[ConnectionID].SocketHandle;
+		if (OutgoingSocket == INVALID_SOCKET)
+		{
+			// Skip these packets
+			continue;
+		}
+
+		DWORD SentBytesCount = 0;
+		if (WSASend(OutgoingSocket, ConnectionBuffers, static_cast<DWORD>(ConnectionPacketCount * 2), &SentBytesCount, 0, nullptr, nullptr) == SOCKET_ERROR)
+		{
+			std::cerr << "Error when sending data to Connection ID " << ConnectionID << " ! Error Code: " << WSAGetLastError() << "\n";
+		}
+	}
+}
+
 DWORD WINAPI SendingThread_Func(void* Param)
 // Server sending thread handling outgoing data to be sent to existing connections.
 {
@@ -389,58 +763,24 @@ DWORD WINAPI SendingThread_Func(void* Param)
 	bSendingThreadRunning = true;
 	while (bSendingThreadRunning)
 	{
-		// Wait for the event object to be signaled, indicating data is ready to be sent out. When doing so,
-		// lock access to the Sending Buffer and send everything out.
-		// #TODO(Marc): Double buffer the whole process somehow so throughput isn't limited as much.
+		// Wait for the event object to be signaled, indicating filled slots are ready to be sent out.
 		WaitForSingleObject(Event_DataReadyForSending, INFINITE);
 
-		// Lock access to the Sending Buffer until next loop begins.
-		Mutex_NetDataSending.lock();
-
-		// The Sending Buffer contains non-encoded packets to be encoded and sent to the relevant connection.
-		// Read each packet one by one and send them in separate send calls.
-		// #TODO(Marc): Investigate whether there are any performance concerns for sending a lot of small packets to the same connection.
-
-		size_t SendingBufferReadingOffset = 0;
-		while(SendingBufferReadingOffset < BytesToSend)
+		// Send filled slots out in the order they were filled, then hand them back to the Server.
+		uint8_t SlotIndex;
+		while (FilledSendingSlotRing.Pop(SlotIndex))
 		{
-			byte* PacketLocation = SendingBuffer + SendingBufferReadingOffset;
-			FPCore::Net::PacketHead OutgoingPacket = *reinterpret_cast<FPCore::Net::PacketHead*>(PacketLocation);
-			
-			SOCKET OutgoingSocket = ActiveConnections[OutgoingPacket.ConnectionID].SocketHandle;
-			if (OutgoingSocket == INVALID_SOCKET)
-			{
-				// Skip this packet
-				SendingBufferReadingOffset += sizeof(FPCore::Net::PacketHead) + OutgoingPacket.BodySize;
-				continue;
-			}
-
-			char PacketSendingBuffer[1 << 16];
-			memset(PacketSendingBuffer, 0, sizeof(PacketSendingBuffer));
-			
-			FPCore::Net::NetEncodedPacketHead& EncodedOutgoingPacket = *reinterpret_cast<FPCore::Net::NetEncodedPacketHead*>(PacketSendingBuffer);
-			EncodedOutgoingPacket.BodyType = OutgoingPacket.BodyType;
-			EncodedOutgoingPacket.BodySize = OutgoingPacket.BodySize;
+			SendSlotData(SendingSlots[SlotIndex]);
 
-			memcpy_s(PacketSendingBuffer + sizeof(EncodedOutgoingPacket),
-				sizeof(PacketSendingBuffer) - sizeof(EncodedOutgoingPacket),
-				PacketLocation + sizeof(FPCore::Net::PacketHead), OutgoingPacket.BodySize);
-			
-			size_t TotalSendSize = sizeof(EncodedOutgoingPacket) + EncodedOutgoingPacket.BodySize;
-			send(OutgoingSocket, PacketSendingBuffer, static_cast<int>(TotalSendSize), NULL);
-
-			SendingBufferReadingOffset += sizeof(FPCore::Net::PacketHead) + OutgoingPacket.BodySize;
+			SendingSlots[SlotIndex].BytesToSend = 0;
+			FreeSendingSlotRing.Push(SlotIndex);
 		}
-
-		// Once all data is sent, set the buffer size back to 0 and zero out its memory.
-		memset(SendingBuffer, 0, sizeof(SendingBuffer));
-		BytesToSend = 0;
-
-		Mutex_NetDataSending.unlock();
 	}
+
+	return 0;
 }
 
-bool Win32Net_Init()
+bool Win32Net_Init(const ServerConfig& Config)
 {
 	// Initialize WSA
 	std::cout << "Initializing WinSock Library...\n";
@@ -455,17 +795,60 @@ bool Win32Net_Init()
 		return false;
 	}
 	
+	// Reception runs on a single thread on this platform, handing the Server a single Reception Shard.
+	if (Config.NetWorkerCount != 1)
+	{
+		std::cout << "Warning: Win32 Networking receives on a single thread, ignoring NetWorkerCount = " << Config.NetWorkerCount << ".\n";
+	}
+
+	// Allocate per-connection tables. Committed pages are zero-initialized and only get backed by physical memory when
+	// first accessed, so tables indexed by ID only cost memory for the connections actually used.
+	{
+		if (Config.MaxConnectionCount >= ServerPlatform::INVALID_ID)
+		{
+			std::cerr << "Error: Can't handle " << Config.MaxConnectionCount << " connections, the maximum is " << ServerPlatform::INVALID_ID - 1 << ".\n";
+			return false;
+		}
+
+		MaxConnectionCount = Config.MaxConnectionCount;
+		ConnectionTablesMemory = static_cast<byte*>(VirtualAlloc(nullptr, LayOutConnectionTables(nullptr), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+		if (nullptr == ConnectionTablesMemory)
+		{
+			std::cerr << "Failed to allocate connection tables. Error Code : " << GetLastError() << "\n";
+			MaxConnectionCount = 0;
+			return false;
+		}
+		LayOutConnectionTables(ConnectionTablesMemory);
+	}
+
 	// Initialize Client Data
 	{
-		// Prepare connected client data
-		memset(ActiveConnections, 0, sizeof(ActiveConnections));
-		for (int ClientIndex = 0; ClientIndex < MAX_ACTIVE_CONNECTION_COUNT; ClientIndex++)
+		// Prepare connected client data. Every ID starts out free, the lowest ones getting used first.
+		for (size_t ClientIndex = 0; ClientIndex < MaxConnectionCount; ClientIndex++)
 		{
-			ActiveConnections[ClientIndex].ID = ClientIndex;
+			ActiveConnections[ClientIndex].ID = static_cast<ServerPlatform::ConnectionID>(ClientIndex);
 			ActiveConnections[ClientIndex].SocketHandle = INVALID_SOCKET;
+
+			FreeConnectionIDRing.Push(static_cast<ServerPlatform::ConnectionID>(ClientIndex));
 		}
 	}
 
+	// Set up the event waking the main loop up for Server work, before any thread can post some.
+	Event_ServerWorkPosted = CreateEvent(nullptr, false, false, nullptr);
+	if (nullptr == Event_ServerWorkPosted)
+	{
+		std::cerr << "Error when creating Server Work Posted Event. Error code: " << GetLastError() << "\n";
+		return false;
+	}
+
+	// Set up the port the Reception Thread waits on, before the Listen Thread can accept anything.
+	ReceptionCompletionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+	if (nullptr == ReceptionCompletionPort)
+	{
+		std::cerr << "Error when creating Reception Completion Port. Error code: " << GetLastError() << "\n";
+		return false;
+	}
+
 	// Create Listen Thread
 	{
 		std::cout << "Creating Listening Thread.\n";
@@ -495,6 +878,13 @@ bool Win32Net_Init()
 		}
 	}
 
+	// Every Sending Slot starts out free.
+	for (uint8_t SlotIndex = 0; SlotIndex < SENDING_SLOT_COUNT; SlotIndex++)
+	{
+		SendingSlots[SlotIndex].BytesToSend = 0;
+		FreeSendingSlotRing.Push(SlotIndex);
+	}
+
 	// Create Sending Thread
 	{
 		std::cout << "Creating Sending Thread.\n";
@@ -513,73 +903,121 @@ bool Win32Net_Init()
 	return true;
 }
 
-// Returns the pointers to pending connection & disconnection events and specifies their respective counts.
-// Locks access to Connected Client Data and Event buffers until ClearNetEvents() is called.
+// Drains pending connection & disconnection events from their rings and returns them along with their respective counts.
+// The Listen & Reception Threads keep accepting and receiving in the meantime. The returned events stay valid until
+// ClearNetEvents().
 void ReadNetEvents(const ServerPlatform::ConnectionID*& NewConnectionIDs, size_t& OutConnectedCount,
 		const ServerPlatform::ConnectionID*& DisconnectedIDs, size_t& OutDisconnectedCount)
 {
-	// Lock access to Client Connection Data until ClearNetEvents is called.
-	Mutex_ClientConnectionData.lock();
+	// Disconnections are read first: a connection's Connection event is always pushed before its Disconnection event, so
+	// this guarantees the Server never reads a Disconnection without the matching Connection.
+	ReadDisconnectionEventsCount = DisconnectionEventRing.PopBatch(ReadDisconnectionEvents, MaxConnectionCount);
+	ReadConnectionEventsCount = ConnectionEventRing.PopBatch(ReadConnectionEvents, MaxConnectionCount);
 
-	NewConnectionIDs = PendingConnectionEvents;
-	OutConnectedCount = PendingConnectionEventsCount;
+	NewConnectionIDs = ReadConnectionEvents;
+	OutConnectedCount = ReadConnectionEventsCount;
 
-	DisconnectedIDs = PendingDisconnectionEvents;
-	OutDisconnectedCount = PendingDisconnectionEventsCount;
+	DisconnectedIDs = ReadDisconnectionEvents;
+	OutDisconnectedCount = ReadDisconnectionEventsCount;
 }
 
-// Clears data associated to Connection and Disconnection events. Unlocks access to Connected Client Data.
+// Clears data associated to Connection and Disconnection events. IDs of acknowledged Disconnections become available
+// to new connections.
 void ClearNetEvents()
-{	
-	// Clear Pending Connection & Disconnection event arrays and unlock access to Connected Client Data on the platform.
+{
+	// There are only as many IDs as the ring can hold, so this can't fail.
+	for (size_t EventIndex = 0; EventIndex < ReadDisconnectionEventsCount; EventIndex++)
+	{
+		FreeConnectionIDRing.Push(ReadDisconnectionEvents[EventIndex]);
+	}
 
-	memset(PendingConnectionEvents, 0, sizeof(PendingConnectionEvents));
-	memset(PendingDisconnectionEvents, 0, sizeof(PendingDisconnectionEvents));
+	ReadConnectionEventsCount = 0;
+	ReadDisconnectionEventsCount = 0;
+}
 
-	PendingConnectionEventsCount = 0;
-	PendingDisconnectionEventsCount = 0;
+// Hands the Reception Buffer filled since the last read over to the Server as its only shard, along with the descriptors
+// of the packets it holds. Reception carries on in the other buffer. The returned data stays valid until
+// ReleaseNetReceptionBuffers() is called.
+void ReadNetReceptionBuffers(const NetReceptionShard*& OutShards, size_t& OutShardCount)
+{
+	static NetReceptionShard ReadReceptionShard;
+
+	std::lock_guard<std::mutex> Lock(Mutex_NetDataReception);
 
-	Mutex_ClientConnectionData.unlock();
+	ReceptionBufferData& ReadBuffer = ReceptionBuffers[WriteReceptionBufferIndex];
+	WriteReceptionBufferIndex = (WriteReceptionBufferIndex + 1) % RECEPTION_BUFFER_COUNT;
+
+	ReadReceptionShard.Packets = ReadBuffer.Packets;
+	ReadReceptionShard.PacketCount = ReadBuffer.PacketCount;
+	ReadReceptionShard.ReceptionData = ReadBuffer.Data;
+	OutShards = &ReadReceptionShard;
+	OutShardCount = 1;
+
+	ReceptionStats.LastReadOccupancy = ReadBuffer.ReceivedBytes;
+	if (ReadBuffer.ReceivedBytes > ReceptionStats.PeakReadOccupancy)
+	{
+		ReceptionStats.PeakReadOccupancy = ReadBuffer.ReceivedBytes;
+	}
 }
 
-// Returns the pointer to pending Reception Buffer Data and specifies the total amount of received bytes.
-// Locks access to the Reception Buffer until ReleaseNetReceptionBuffer() is called.
-void ReadNetReceptionBuffer(const byte*& OutReceptionBuffer, size_t& OutReceivedBytesCount)
+// Empties the Reception Buffer handed over by the last read, making it available to reception again.
+// Buffers are used in turn, so the emptied buffer will not be written to before the next read.
+void ReleaseNetReceptionBuffers()
 {
-	Mutex_NetDataReception.lock();
-	
-	OutReceptionBuffer = ReceptionBuffer;
-	OutReceivedBytesCount = ReceivedBytes;
+	std::lock_guard<std::mutex> Lock(Mutex_NetDataReception);
+
+	size_t ReadBufferIndex = (WriteReceptionBufferIndex + RECEPTION_BUFFER_COUNT - 1) % RECEPTION_BUFFER_COUNT;
+	ReceptionBuffers[ReadBufferIndex].ReceivedBytes = 0;
+	ReceptionBuffers[ReadBufferIndex].PacketCount = 0;
 }
 
-// Clears the Reception Buffer of all data (by resetting the Received Bytes count to 0) and unlocks access to it.
-void ReleaseNetReceptionBuffer()
+void ReadNetReceptionStats(NetReceptionStats& OutStats)
 {
-	ReceivedBytes = 0;
-	
-	Mutex_NetDataReception.unlock();
+	std::lock_guard<std::mutex> Lock(Mutex_NetDataReception);
+
+	OutStats = ReceptionStats;
+	OutStats.ShardCount = 1;
+	OutStats.BufferSize = RECEPTION_BUFFER_SIZE;
 }
 
-// Returns the pointer to pending Sending Buffer Data and specifies the maximum amount of bytes that can be sent.
-// Locks access to the Sending Buffer until ReleaseNetSendingBuffer() is called.
+// Returns the pointer to the free space of the Sending Slot being filled and specifies the maximum amount of bytes that
+// can be written to it. Takes a new free slot if needed. If the Sending Thread still holds every slot, returns no space.
 void BeginWritingToSendingBuffer(byte*& OutSendingBuffer, size_t& OutMaxBytes)
 {
-	Mutex_NetDataSending.lock();
-	
-	OutSendingBuffer = SendingBuffer + BytesToSend;
-	OutMaxBytes = SENDING_BUFFER_SIZE - BytesToSend;
+	if (WriteSendingSlotIndex == INVALID_SENDING_SLOT && !FreeSendingSlotRing.Pop(WriteSendingSlotIndex))
+	{
+		OutSendingBuffer = nullptr;
+		OutMaxBytes = 0;
+		return;
+	}
+
+	SendingSlot& WriteSlot = SendingSlots[WriteSendingSlotIndex];
+	OutSendingBuffer = WriteSlot.Data + WriteSlot.BytesToSend;
+	OutMaxBytes = SENDING_BUFFER_SIZE - WriteSlot.BytesToSend;
 }
 
-// Signal that we are done writing to the Sending Buffer, which will trigger the sending of the data to outgoing
-// connections, while releasing access to the Sending Buffer and signaling the Sending Thread to begin work.
+// Signal that we are done writing to the Sending Slot. If anything was written to it, the slot is handed over to the
+// Sending Thread, which is signaled to begin work.
 void EndWritingToSendingBuffer(size_t SentBytesCount)
 {
-	// While the Sending Buffer does contain the data, the information of how much is lost.
+	if (WriteSendingSlotIndex == INVALID_SENDING_SLOT)
+	{
+		return;
+	}
+
+	// While the Sending Slot does contain the data, the information of how much is lost.
 	// Restore it with the passed Sent Bytes Count parameter.
-	BytesToSend += SentBytesCount;
-	
-	// Unlock access to the Sending Buffer and signal the Sending Thread to begin work.
-	Mutex_NetDataSending.unlock();
+	SendingSlots[WriteSendingSlotIndex].BytesToSend += SentBytesCount;
+	if (SendingSlots[WriteSendingSlotIndex].BytesToSend == 0)
+	{
+		// Keep the empty slot for next time.
+		return;
+	}
+
+	// There are only as many slot indices as the ring can hold, so this can't fail.
+	FilledSendingSlotRing.Push(WriteSendingSlotIndex);
+	WriteSendingSlotIndex = INVALID_SENDING_SLOT;
+
 	SetEvent(Event_DataReadyForSending);
 }
 
@@ -589,19 +1027,27 @@ void Win32Net_RegisterPlatformFunctions(ServerPlatform& Platform)
 	Platform.ReadPlatformNetEvents = ReadNetEvents;
 	Platform.ReleasePlatformNetEvents = ClearNetEvents;
 	
-	Platform.ReadPlatformNetReceptionBuffer = ReadNetReceptionBuffer;
-	Platform.ReleasePlatformNetReceptionBuffer = ReleaseNetReceptionBuffer;
+	Platform.ReadPlatformNetReceptionBuffers = ReadNetReceptionBuffers;
+	Platform.ReleasePlatformNetReceptionBuffers = ReleaseNetReceptionBuffers;
+	Platform.ReadPlatformNetReceptionStats = ReadNetReceptionStats;
 	
 	Platform.WriteToPlatformNetSendingBuffer = BeginWritingToSendingBuffer;
 	Platform.ReleasePlatformNetSendingBuffer = EndWritingToSendingBuffer;
 
-	Platform.CloseConnection = Disconnect;
+	Platform.CloseConnection = CloseConnection;
+}
+
+// Returns the auto-reset event signaled when network threads have posted work for the Server.
+HANDLE Win32Net_GetServerWorkEvent()
+{
+	return Event_ServerWorkPosted;
 }
 
 void ShutdownServer()
 {
 	bListenThreadRunning = false;
 	bReceptionThreadRunning = false;
+	WakeReceptionThread();
 
 	WaitForSingleObject(ListenThreadHandle, INFINITE);
 	WaitForSingleObject(ReceptionThreadHandle, INFINITE);
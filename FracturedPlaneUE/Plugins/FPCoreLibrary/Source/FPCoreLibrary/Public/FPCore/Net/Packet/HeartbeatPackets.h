@@ -0,0 +1,20 @@
+// HeartbeatPackets.h
+// Contains common Packet Data Types related to Connection Heartbeats.
+
+#pragma once
+
+#include "Packet.h"
+
+namespace FPCore
+{
+    namespace Net
+    {
+        // Data linked to a HEARTBEAT type packet.
+        // Sent by the Server as a ping, which the Client sends back as is as a pong. This lets the Server know the
+        // Connection is still alive, and measure its round trip time.
+        struct PacketBodyDef_Heartbeat
+        {
+            uint32_t Sequence; // Identifies the ping, so that its pong can be matched with it.
+        };
+    }
+}
\ No newline at end of file
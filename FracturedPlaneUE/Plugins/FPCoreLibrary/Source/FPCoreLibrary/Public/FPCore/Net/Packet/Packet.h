@@ -24,6 +24,7 @@ namespace FPCore
             AUTHENTICATION, // When received on the Server, is a request. When received on the client, is a response.
             WORLD_SYNC_LANDSCAPE, // Server to Client packet containing data about the landscape of a chunk of the map.
             WORLD_SYNC_ENTITIES,
+            HEARTBEAT, // When received on the Client, is a ping to send back as is. When received on the Server, is that pong.
             PACKET_TYPE_COUNT
         };
 
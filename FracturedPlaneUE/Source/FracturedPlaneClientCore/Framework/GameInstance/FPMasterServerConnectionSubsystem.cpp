@@ -6,6 +6,7 @@
 
 #include "FPCore/Net/Packet/AuthenticationPackets.h"
 #include "FPCore/Net/Packet/WorldSyncPackets.h"
+#include "FPCore/Net/Packet/HeartbeatPackets.h"
 
 #include "FPCore/Net/Packet/PacketBodyTypeFunctionDefs.h"
 
@@ -21,6 +22,7 @@ void UFPMasterServerConnectionSubsystem::Initialize(FSubsystemCollectionBase& Co
 	
 	OnPacketReceived[static_cast<int>(FPCore::Net::PacketBodyType::AUTHENTICATION)].BindUObject(this, &UFPMasterServerConnectionSubsystem::HandleAuthenticationResponsePacket);
 	OnPacketReceived[static_cast<int>(FPCore::Net::PacketBodyType::WORLD_SYNC_LANDSCAPE)].BindUObject(this, &UFPMasterServerConnectionSubsystem::OnWorldZoneSyncPacketReceived);
+	OnPacketReceived[static_cast<int>(FPCore::Net::PacketBodyType::HEARTBEAT)].BindUObject(this, &UFPMasterServerConnectionSubsystem::HandleHeartbeatPacket);
 	
 	FPCore::Net::InitializePacketBodyTypeFunctionsDefMap(PacketBodyTypeFunctionsMap);
 }
@@ -269,4 +271,33 @@ void UFPMasterServerConnectionSubsystem::OnWorldZoneSyncPacketReceived(FPCore::N
 
 	// Call Zone Change event.
 	TargetWorldStateObject->OnWorldStateZoneChange.Broadcast();
+}
+
+void UFPMasterServerConnectionSubsystem::HandleHeartbeatPacket(FPCore::Net::PacketHead& Packet)
+{
+	if (!IsConnected())
+	{
+		return;
+	}
+
+	// The pong is the ping sent back as is.
+	FPCore::Net::PacketBodyDef_Heartbeat HeartbeatPacketData = Packet.ReadBodyDef<FPCore::Net::PacketBodyDef_Heartbeat>();
+
+	FPCore::Net::NetEncodedPacketHead HeartbeatPacket_Encoded;
+	HeartbeatPacket_Encoded.BodyType = FPCore::Net::PacketBodyType::HEARTBEAT;
+	HeartbeatPacket_Encoded.BodySize = PacketBodyTypeFunctionsMap[FPCore::Net::PacketBodyType::HEARTBEAT].GetMarshalledSize(&HeartbeatPacketData);
+
+	byte SendBuffer[sizeof(HeartbeatPacket_Encoded) + sizeof(HeartbeatPacketData)];
+
+	memcpy(SendBuffer, &HeartbeatPacket_Encoded, sizeof(HeartbeatPacket_Encoded));
+
+	// Marshal body directly into send buffer.
+	PacketBodyTypeFunctionsMap[HeartbeatPacket_Encoded.BodyType].MarshalTo(&HeartbeatPacketData, SendBuffer + sizeof(HeartbeatPacket_Encoded)
+		, sizeof(SendBuffer) - sizeof(FPCore::Net::NetEncodedPacketHead));
+
+	int32 BytesSent;
+	if (!ConnectionSocket->Send(SendBuffer, sizeof(SendBuffer), BytesSent))
+	{
+		UE_LOG(FLogFPClientServerConnectionSubsystem, Warning, TEXT("Failed to answer Master Server heartbeat !"));
+	}
 }
\ No newline at end of file
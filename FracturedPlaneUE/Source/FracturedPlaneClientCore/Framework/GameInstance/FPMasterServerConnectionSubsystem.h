@@ -103,6 +103,9 @@ private:
 
 	void OnWorldZoneSyncPacketReceived(FPCore::Net::PacketHead& Packet);
 
+	// Sends Master Server pings back as pongs, so that it keeps our connection open.
+	void HandleHeartbeatPacket(FPCore::Net::PacketHead& Packet);
+
 	
 
 	